@@ -254,6 +254,89 @@ ClassDB::APIType ClassDB::get_current_api() {
 	return current_api;
 }
 
+void ClassDB::_count_lookup_table(ClassInfo *p_class, int p_delta) {
+
+	for (ClassInfo *check = p_class; check; check = check->inherits_ptr) {
+		check->lookup_tables += p_delta;
+	}
+}
+
+void ClassDB::_build_lookup_table(ClassInfo *p_class) {
+
+	if (p_class->lookup_valid) {
+		_count_lookup_table(p_class, -1);
+	}
+
+	HashMap<StringName, MethodBind *> methods;
+	HashMap<StringName, const PropertySetGet *> properties;
+
+	// Walk from the class up, so the entries closest to it win, as when
+	// looking up without the tables.
+	for (ClassInfo *check = p_class; check; check = check->inherits_ptr) {
+
+		const StringName *K = NULL;
+		while ((K = check->method_map.next(K))) {
+			MethodBind *method = check->method_map[*K];
+			if (method && !methods.has(*K)) {
+				methods[*K] = method;
+			}
+		}
+
+		K = NULL;
+		while ((K = check->property_setget.next(K))) {
+			if (!properties.has(*K)) {
+				properties[*K] = check->property_setget.getptr(*K);
+			}
+		}
+	}
+
+	p_class->lookup_valid = p_class->method_lookup.build(methods) && p_class->property_lookup.build(properties);
+	if (p_class->lookup_valid) {
+		_count_lookup_table(p_class, 1);
+	} else {
+		p_class->method_lookup.clear();
+		p_class->property_lookup.clear();
+	}
+}
+
+void ClassDB::_invalidate_lookup_tables(ClassInfo *p_class) {
+
+	if (p_class->lookup_tables == 0) {
+		return; // No table includes this class, as while registering classes.
+	}
+
+	// Binding after the tables were built, drop the tables that include
+	// this class, they go back to walking the inheritance chain.
+	const StringName *K = NULL;
+	while (p_class->lookup_tables > 0 && (K = classes.next(K))) {
+
+		ClassInfo *info = classes.getptr(*K);
+		if (!info->lookup_valid) {
+			continue;
+		}
+
+		for (ClassInfo *check = info; check; check = check->inherits_ptr) {
+			if (check == p_class) {
+				_count_lookup_table(info, -1);
+				info->lookup_valid = false;
+				info->method_lookup.clear();
+				info->property_lookup.clear();
+				break;
+			}
+		}
+	}
+}
+
+void ClassDB::build_lookup_tables() {
+
+	OBJTYPE_WLOCK;
+
+	const StringName *K = NULL;
+	while ((K = classes.next(K))) {
+		_build_lookup_table(classes.getptr(*K));
+	}
+}
+
 HashMap<StringName, ClassDB::ClassInfo> ClassDB::classes;
 HashMap<StringName, StringName> ClassDB::resource_base_extensions;
 HashMap<StringName, StringName> ClassDB::compat_classes;
@@ -263,6 +346,8 @@ ClassDB::ClassInfo::ClassInfo() {
 	api = API_NONE;
 	creation_func = NULL;
 	inherits_ptr = NULL;
+	lookup_valid = false;
+	lookup_tables = 0;
 	disabled = false;
 	exposed = false;
 }
@@ -560,6 +645,30 @@ Object *ClassDB::instance(const StringName &p_class) {
 #endif
 	return ti->creation_func();
 }
+
+ClassDB::CreationFunc ClassDB::get_creation_func(const StringName &p_class, StringName *r_class) {
+
+	OBJTYPE_RLOCK;
+
+	ClassInfo *ti = classes.getptr(p_class);
+	if (!ti || ti->disabled || !ti->creation_func) {
+		const StringName *compat = compat_classes.getptr(p_class);
+		if (compat) {
+			ti = classes.getptr(*compat);
+		}
+	}
+
+	if (!ti || ti->disabled || !ti->creation_func)
+		return NULL;
+#ifdef TOOLS_ENABLED
+	if (ti->api == API_EDITOR && !Engine::get_singleton()->is_editor_hint())
+		return NULL;
+#endif
+
+	if (r_class)
+		*r_class = ti->name;
+	return ti->creation_func;
+}
 bool ClassDB::can_instance(const StringName &p_class) {
 
 	OBJTYPE_RLOCK;
@@ -677,6 +786,11 @@ MethodBind *ClassDB::get_method(StringName p_class, StringName p_name) {
 
 	ClassInfo *type = classes.getptr(p_class);
 
+	if (type && type->lookup_valid) {
+		MethodBind *const *method = type->method_lookup.getptr(p_name);
+		return method ? *method : NULL;
+	}
+
 	while (type) {
 
 		MethodBind **method = type->method_map.getptr(p_name);
@@ -986,6 +1100,7 @@ void ClassDB::add_property(StringName p_class, const PropertyInfo &p_pinfo, cons
 	psg.type = p_pinfo.type;
 
 	type->property_setget[p_pinfo.name] = psg;
+	_invalidate_lookup_tables(type);
 }
 
 void ClassDB::set_property_default_value(StringName p_class, const StringName &p_name, const Variant &p_default) {
@@ -1019,79 +1134,120 @@ void ClassDB::get_property_list(StringName p_class, List<PropertyInfo> *p_list,
 		check = check->inherits_ptr;
 	}
 }
+bool ClassDB::_set_property(Object *p_object, const PropertySetGet *p_psg, const Variant &p_value, bool *r_valid) {
+
+	if (!p_psg->setter) {
+		if (r_valid)
+			*r_valid = false;
+		return true; //return true but do nothing
+	}
+
+	Callable::CallError ce;
+
+	if (p_psg->index >= 0) {
+		Variant index = p_psg->index;
+		const Variant *arg[2] = { &index, &p_value };
+		//p_object->call(p_psg->setter,arg,2,ce);
+		if (p_psg->_setptr) {
+			p_psg->_setptr->call(p_object, arg, 2, ce);
+		} else {
+			p_object->call(p_psg->setter, arg, 2, ce);
+		}
+
+	} else {
+		const Variant *arg[1] = { &p_value };
+		if (p_psg->_setptr) {
+			p_psg->_setptr->call(p_object, arg, 1, ce);
+		} else {
+			p_object->call(p_psg->setter, arg, 1, ce);
+		}
+	}
+
+	if (r_valid)
+		*r_valid = ce.error == Callable::CallError::CALL_OK;
+
+	return true;
+}
+
+bool ClassDB::_get_property(Object *p_object, const PropertySetGet *p_psg, Variant &r_value) {
+
+	if (!p_psg->getter)
+		return true; //return true but do nothing
+
+	if (p_psg->index >= 0) {
+		Variant index = p_psg->index;
+		const Variant *arg[1] = { &index };
+		Callable::CallError ce;
+		r_value = p_object->call(p_psg->getter, arg, 1, ce);
+
+	} else {
+
+		Callable::CallError ce;
+		if (p_psg->_getptr) {
+
+			r_value = p_psg->_getptr->call(p_object, NULL, 0, ce);
+		} else {
+			r_value = p_object->call(p_psg->getter, NULL, 0, ce);
+		}
+	}
+	return true;
+}
+
 bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid) {
 
 	ClassInfo *type = classes.getptr(p_object->get_class_name());
+
+	if (type && type->lookup_valid) {
+		const PropertySetGet *const *psg = type->property_lookup.getptr(p_property);
+		return psg ? _set_property(p_object, *psg, p_value, r_valid) : false;
+	}
+
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
 		if (psg) {
+			return _set_property(p_object, psg, p_value, r_valid);
+		}
 
-			if (!psg->setter) {
-				if (r_valid)
-					*r_valid = false;
-				return true; //return true but do nothing
-			}
-
-			Callable::CallError ce;
+		check = check->inherits_ptr;
+	}
 
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[2] = { &index, &p_value };
-				//p_object->call(psg->setter,arg,2,ce);
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 2, ce);
-				} else {
-					p_object->call(psg->setter, arg, 2, ce);
-				}
+	return false;
+}
 
-			} else {
-				const Variant *arg[1] = { &p_value };
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 1, ce);
-				} else {
-					p_object->call(psg->setter, arg, 1, ce);
-				}
-			}
+const ClassDB::PropertySetGet *ClassDB::get_property_setget(const StringName &p_class, const StringName &p_property) {
 
-			if (r_valid)
-				*r_valid = ce.error == Callable::CallError::CALL_OK;
+	OBJTYPE_RLOCK;
 
-			return true;
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			return psg;
 		}
 
 		check = check->inherits_ptr;
 	}
 
-	return false;
+	return NULL;
 }
+
 bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 
 	ClassInfo *type = classes.getptr(p_object->get_class_name());
+
+	if (type && type->lookup_valid) {
+		const PropertySetGet *const *psg = type->property_lookup.getptr(p_property);
+		if (psg) {
+			return _get_property(p_object, *psg, r_value);
+		}
+	}
+
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
 		if (psg) {
-			if (!psg->getter)
-				return true; //return true but do nothing
-
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[1] = { &index };
-				Callable::CallError ce;
-				r_value = p_object->call(psg->getter, arg, 1, ce);
-
-			} else {
-
-				Callable::CallError ce;
-				if (psg->_getptr) {
-
-					r_value = psg->_getptr->call(p_object, NULL, 0, ce);
-				} else {
-					r_value = p_object->call(psg->getter, NULL, 0, ce);
-				}
-			}
-			return true;
+			return _get_property(p_object, psg, r_value);
 		}
 
 		const int *c = check->constant_map.getptr(p_property); //constants count
@@ -1280,6 +1436,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 #endif
 
 	type->method_map[mdname] = p_bind;
+	_invalidate_lookup_tables(type);
 
 	Vector<Variant> defvals;
 
@@ -34,6 +34,7 @@
 #include "core/method_bind.h"
 #include "core/object.h"
 #include "core/print_string.h"
+#include "core/string_name_perfect_map.h"
 
 /** To bind more then 6 parameters include this:
  *  #include "core/method_bind_ext.gen.inc"
@@ -131,6 +132,14 @@ public:
 #endif
 		HashMap<StringName, PropertySetGet> property_setget;
 
+		// Methods and properties of the class and its parents, filled by
+		// build_lookup_tables(). Until then, or once the class or a parent
+		// binds something new, lookups walk the inheritance chain.
+		StringNamePerfectMap<MethodBind *> method_lookup;
+		StringNamePerfectMap<const PropertySetGet *> property_lookup;
+		bool lookup_valid;
+		int lookup_tables; // Valid tables of this class and the classes inheriting from it.
+
 		StringName inherits;
 		StringName name;
 		bool disabled;
@@ -158,6 +167,12 @@ public:
 
 	static APIType current_api;
 
+	static void _count_lookup_table(ClassInfo *p_class, int p_delta);
+	static void _build_lookup_table(ClassInfo *p_class);
+	static void _invalidate_lookup_tables(ClassInfo *p_class);
+	static bool _set_property(Object *p_object, const PropertySetGet *p_psg, const Variant &p_value, bool *r_valid);
+	static bool _get_property(Object *p_object, const PropertySetGet *p_psg, Variant &r_value);
+
 	static void _add_class2(const StringName &p_class, const StringName &p_inherits);
 
 	static HashMap<StringName, HashMap<StringName, Variant> > default_values;
@@ -225,6 +240,10 @@ public:
 	static bool is_parent_class(const StringName &p_class, const StringName &p_inherits);
 	static bool can_instance(const StringName &p_class);
 	static Object *instance(const StringName &p_class);
+	// For code instancing a class many times, NULL if it can't be instanced. r_class is the class
+	// the function creates, which differs from p_class for compatibility classes.
+	typedef Object *(*CreationFunc)();
+	static CreationFunc get_creation_func(const StringName &p_class, StringName *r_class = NULL);
 	static APIType get_api_type(const StringName &p_class);
 
 	static uint64_t get_api_hash(APIType p_api);
@@ -334,6 +353,7 @@ public:
 			ERR_FAIL_V_MSG(NULL, "Method already bound: " + instance_type + "::" + p_name + ".");
 		}
 		type->method_map[p_name] = bind;
+		_invalidate_lookup_tables(type);
 #ifdef DEBUG_METHODS_ENABLED
 		// FIXME: <reduz> set_return_type is no longer in MethodBind, so I guess it should be moved to vararg method bind
 		//bind->set_return_type("Variant");
@@ -353,6 +373,10 @@ public:
 	static void set_property_default_value(StringName p_class, const StringName &p_name, const Variant &p_default);
 	static void get_property_list(StringName p_class, List<PropertyInfo> *p_list, bool p_no_inheritance = false, const Object *p_validator = NULL);
 	static bool set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid = NULL);
+	// For code setting a property many times, NULL if the class doesn't bind it. The result
+	// must only be used with objects of exactly p_class, and without script instance.
+	static const PropertySetGet *get_property_setget(const StringName &p_class, const StringName &p_property);
+	static bool set_property_setget(Object *p_object, const PropertySetGet *p_psg, const Variant &p_value, bool *r_valid = NULL) { return _set_property(p_object, p_psg, p_value, r_valid); }
 	static bool get_property(Object *p_object, const StringName &p_property, Variant &r_value);
 	static bool has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance = false);
 	static int get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid = NULL);
@@ -395,6 +419,7 @@ public:
 
 	static void set_current_api(APIType p_api);
 	static APIType get_current_api();
+	static void build_lookup_tables();
 	static void cleanup_defaults();
 	static void cleanup();
 };
@@ -30,8 +30,19 @@
 
 #include "file_access_compressed.h"
 
+#include "core/io/marshalls.h"
+#include "core/os/copymem.h"
+#include "core/os/os.h"
 #include "core/print_string.h"
 
+#define READ_AHEAD_MAX_THREADS 4
+
+Mutex FileAccessCompressed::read_ahead_mutex;
+Semaphore FileAccessCompressed::read_ahead_queued;
+List<FileAccessCompressed::ReadAheadSlot *> FileAccessCompressed::read_ahead_jobs;
+Vector<Thread *> FileAccessCompressed::read_ahead_threads;
+bool FileAccessCompressed::read_ahead_exit = false;
+
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, int p_block_size) {
 
 	magic = p_magic.ascii().get_data();
@@ -46,6 +57,291 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 	block_size = p_block_size;
 }
 
+void FileAccessCompressed::set_read_ahead(int p_blocks) {
+
+	ERR_FAIL_COND(p_blocks < 0);
+	ERR_FAIL_COND_MSG(read_ahead_slots, "Read-ahead can't be changed while reading.");
+	read_ahead = p_blocks;
+}
+
+Vector<uint8_t> FileAccessCompressed::compress_buffer(const uint8_t *p_data, int p_size, const String &p_magic, Compression::Mode p_mode, int p_block_size) {
+
+	CharString mgc = p_magic.ascii();
+	ERR_FAIL_COND_V(mgc.length() != 4, Vector<uint8_t>());
+	ERR_FAIL_COND_V(p_block_size <= 0, Vector<uint8_t>());
+
+	int bc = (p_size / p_block_size) + 1;
+	int header_size = 16 + bc * 4;
+
+	int max_size = header_size + 4;
+	for (int i = 0; i < bc; i++) {
+		int bl = i == (bc - 1) ? p_size % p_block_size : p_block_size;
+		max_size += Compression::get_max_compressed_buffer_size(bl, p_mode);
+	}
+
+	Vector<uint8_t> ret;
+	ret.resize(max_size);
+	uint8_t *w = ret.ptrw();
+
+	copymem(w, mgc.get_data(), 4); //header
+	encode_uint32(p_mode, &w[4]); //compression mode
+	encode_uint32(p_block_size, &w[8]); //block size
+	encode_uint32(p_size, &w[12]); //uncompressed size
+
+	int ofs = header_size;
+	for (int i = 0; i < bc; i++) {
+
+		int bl = i == (bc - 1) ? p_size % p_block_size : p_block_size;
+		int s = Compression::compress(&w[ofs], &p_data[i * p_block_size], bl, p_mode);
+		encode_uint32(s, &w[16 + i * 4]); //compressed size of the block
+		ofs += s;
+	}
+
+	copymem(&w[ofs], mgc.get_data(), 4); //magic at the end too
+	ret.resize(ofs + 4);
+
+	return ret;
+}
+
+void FileAccessCompressed::_read_ahead_thread_func(void *p_userdata) {
+
+	while (true) {
+
+		read_ahead_queued.wait();
+
+		read_ahead_mutex.lock();
+		if (read_ahead_exit) {
+			read_ahead_mutex.unlock();
+			break;
+		}
+
+		if (read_ahead_jobs.empty()) {
+			// Taken back by its reader meanwhile.
+			read_ahead_mutex.unlock();
+			continue;
+		}
+
+		// Files queue their blocks in order, so the nearest ones are decompressed first.
+		ReadAheadSlot *slot = read_ahead_jobs.front()->get();
+		read_ahead_jobs.pop_front();
+		slot->job = NULL;
+		slot->state = ReadAheadSlot::DECOMPRESSING;
+		read_ahead_mutex.unlock();
+
+		Compression::decompress(slot->data.ptrw(), slot->size, slot->src, slot->src_size, slot->owner->cmode);
+
+		read_ahead_mutex.lock();
+		slot->state = ReadAheadSlot::READY;
+		// Posted with the lock held, the file may stop its read-ahead as soon as it's released.
+		slot->owner->read_ahead_ready.post();
+		read_ahead_mutex.unlock();
+	}
+}
+
+void FileAccessCompressed::finalize_read_ahead() {
+
+	read_ahead_mutex.lock();
+	read_ahead_exit = true;
+	for (int i = 0; i < read_ahead_threads.size(); i++) {
+		read_ahead_queued.post();
+	}
+	read_ahead_mutex.unlock();
+
+	for (int i = 0; i < read_ahead_threads.size(); i++) {
+		Thread::wait_to_finish(read_ahead_threads[i]);
+		memdelete(read_ahead_threads[i]);
+	}
+	read_ahead_threads.clear();
+
+	// Blocks still queued are taken back by their readers.
+}
+
+void FileAccessCompressed::_load_block(int p_block) const {
+
+	bool sequential = read_block >= 0 && p_block == read_block + 1;
+
+	read_block = p_block;
+	read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+
+	bool loaded = false;
+
+	if (read_ahead_slots) {
+
+		MutexLock lock(read_ahead_mutex);
+
+		for (int i = 0; i < read_ahead; i++) {
+
+			ReadAheadSlot &slot = read_ahead_slots[i];
+			if (slot.state == ReadAheadSlot::FREE || slot.block != p_block) {
+				continue;
+			}
+
+			if (slot.state == ReadAheadSlot::QUEUED) {
+				// Not started yet, faster to decompress it here than to wait.
+				read_ahead_jobs.erase(slot.job);
+				slot.job = NULL;
+				slot.state = ReadAheadSlot::FREE;
+				break;
+			}
+
+			while (slot.state != ReadAheadSlot::READY) {
+				read_ahead_mutex.unlock();
+				read_ahead_ready.wait();
+				read_ahead_mutex.lock();
+			}
+
+			SWAP(buffer, slot.data);
+			slot.state = ReadAheadSlot::FREE;
+			loaded = true;
+			break;
+		}
+	}
+
+	if (!loaded) {
+
+		int csize = read_blocks[read_block].csize;
+		f->seek(read_blocks[read_block].offset);
+
+		// Decompress straight from the mapped file when possible.
+		const uint8_t *src = f->get_buffer_ptr(csize);
+		if (!src) {
+			f->get_buffer(comp_buffer.ptrw(), csize);
+			src = comp_buffer.ptr();
+		}
+
+		Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, src, csize, cmode);
+	}
+
+	read_ptr = buffer.ptrw();
+
+	if (read_ahead > 0 && (sequential || read_ahead_slots)) {
+		_queue_read_ahead();
+	}
+}
+
+void FileAccessCompressed::_queue_read_ahead() const {
+
+#ifndef NO_THREADS
+	if (!read_ahead_slots && read_block_count - read_block <= 2) {
+		return; // Not worth it.
+	}
+
+	MutexLock lock(read_ahead_mutex);
+
+	if (read_ahead_threads.empty()) {
+
+		if (read_ahead_exit) {
+			return; // Finalized, blocks are only decompressed when read.
+		}
+
+		int thread_count = CLAMP(OS::get_singleton()->get_processor_count(), 1, READ_AHEAD_MAX_THREADS);
+		for (int i = 0; i < thread_count; i++) {
+			Thread *thread = Thread::create(_read_ahead_thread_func, NULL);
+			if (!thread) {
+				break;
+			}
+			read_ahead_threads.push_back(thread);
+		}
+
+		if (read_ahead_threads.empty()) {
+			return;
+		}
+	}
+
+	if (!read_ahead_slots) {
+
+		read_ahead_slots = memnew_arr(ReadAheadSlot, read_ahead);
+		for (int i = 0; i < read_ahead; i++) {
+			read_ahead_slots[i].state = ReadAheadSlot::FREE;
+			read_ahead_slots[i].block = -1;
+			read_ahead_slots[i].owner = this;
+			read_ahead_slots[i].job = NULL;
+		}
+	}
+
+	int last = MIN(read_block_count - 1, read_block + read_ahead);
+	for (int b = read_block + 1; b <= last; b++) {
+
+		ReadAheadSlot *slot = NULL;
+		bool queued = false;
+
+		for (int i = 0; i < read_ahead; i++) {
+
+			ReadAheadSlot &s = read_ahead_slots[i];
+			if (s.state != ReadAheadSlot::FREE && s.block == b) {
+				queued = true;
+				break;
+			}
+
+			// Slots left behind by a seek can be reused unless they are being decompressed.
+			if (!slot && (s.state == ReadAheadSlot::FREE || (s.state != ReadAheadSlot::DECOMPRESSING && (s.block <= read_block || s.block > last)))) {
+				slot = &s;
+			}
+		}
+
+		if (queued) {
+			continue;
+		}
+		if (!slot) {
+			break;
+		}
+
+		int csize = read_blocks[b].csize;
+		f->seek(read_blocks[b].offset);
+
+		slot->src = f->get_buffer_ptr(csize);
+		if (!slot->src) {
+			slot->compressed.resize(csize);
+			f->get_buffer(slot->compressed.ptrw(), csize);
+			slot->src = slot->compressed.ptr();
+		}
+
+		slot->src_size = csize;
+		slot->size = block_size;
+		slot->data.resize(block_size);
+		slot->block = b;
+
+		if (slot->state != ReadAheadSlot::QUEUED) {
+			// A slot reused while still queued keeps its place.
+			slot->state = ReadAheadSlot::QUEUED;
+			slot->job = read_ahead_jobs.push_back(slot);
+			read_ahead_queued.post();
+		}
+	}
+#endif
+}
+
+void FileAccessCompressed::_stop_read_ahead() const {
+
+	if (!read_ahead_slots) {
+		return;
+	}
+
+	read_ahead_mutex.lock();
+
+	for (int i = 0; i < read_ahead; i++) {
+
+		ReadAheadSlot &slot = read_ahead_slots[i];
+		if (slot.state == ReadAheadSlot::QUEUED) {
+			read_ahead_jobs.erase(slot.job);
+			slot.job = NULL;
+			slot.state = ReadAheadSlot::FREE;
+		}
+
+		// The workers may still be writing to the others.
+		while (slot.state == ReadAheadSlot::DECOMPRESSING) {
+			read_ahead_mutex.unlock();
+			read_ahead_ready.wait();
+			read_ahead_mutex.lock();
+		}
+	}
+
+	read_ahead_mutex.unlock();
+
+	memdelete_arr(read_ahead_slots);
+	read_ahead_slots = NULL;
+}
+
 #define WRITE_FIT(m_bytes)                                  \
 	{                                                       \
 		if (write_pos + (m_bytes) > write_max) {            \
@@ -83,15 +379,11 @@ Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
-	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
-
-	Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
+	read_block = -1;
+	_load_block(0);
 	read_pos = 0;
 
 	return OK;
@@ -146,41 +438,14 @@ void FileAccessCompressed::close() {
 	if (writing) {
 		//save block table and all compressed blocks
 
-		CharString mgc = magic.utf8();
-		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //write header 4
-		f->store_32(cmode); //write compression mode 4
-		f->store_32(block_size); //write block size 4
-		f->store_32(write_max); //max amount of data written 4
-		int bc = (write_max / block_size) + 1;
-
-		for (int i = 0; i < bc; i++) {
-			f->store_32(0); //compressed sizes, will update later
-		}
-
-		Vector<int> block_sizes;
-		for (int i = 0; i < bc; i++) {
-
-			int bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
-
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
-
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
-		}
-
-		f->seek(16); //ok write block sizes
-		for (int i = 0; i < bc; i++)
-			f->store_32(block_sizes[i]);
-		f->seek_end();
-		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //magic at the end too
+		Vector<uint8_t> data = compress_buffer(write_ptr, write_max, magic, cmode, block_size);
+		f->store_buffer(data.ptr(), data.size());
 
 		buffer.clear();
 
 	} else {
 
+		_stop_read_ahead();
 		comp_buffer.clear();
 		buffer.clear();
 		read_blocks.clear();
@@ -214,12 +479,7 @@ void FileAccessCompressed::seek(size_t p_position) {
 			read_eof = false;
 			int block_idx = p_position / block_size;
 			if (block_idx != read_block) {
-
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_load_block(block_idx);
 			}
 
 			read_pos = p_position % block_size;
@@ -284,17 +544,13 @@ uint8_t FileAccessCompressed::get_8() const {
 
 	read_pos++;
 	if (read_pos >= read_block_size) {
-		read_block++;
 
-		if (read_block < read_block_count) {
+		if (read_block + 1 < read_block_count) {
 			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+			_load_block(read_block + 1);
 			read_pos = 0;
 
 		} else {
-			read_block--;
 			at_end = true;
 		}
 	}
@@ -311,26 +567,26 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const {
 		return 0;
 	}
 
-	for (int i = 0; i < p_length; i++) {
+	int copied = 0;
+	while (copied < p_length) {
+
+		int to_copy = MIN(p_length - copied, read_block_size - read_pos);
+		copymem(&p_dst[copied], &read_ptr[read_pos], to_copy);
+		copied += to_copy;
+		read_pos += to_copy;
 
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
 		if (read_pos >= read_block_size) {
-			read_block++;
 
-			if (read_block < read_block_count) {
+			if (read_block + 1 < read_block_count) {
 				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_load_block(read_block + 1);
 				read_pos = 0;
 
 			} else {
-				read_block--;
 				at_end = true;
-				if (i < p_length - 1)
+				if (copied < p_length)
 					read_eof = true;
-				return i;
+				return copied;
 			}
 		}
 	}
@@ -405,7 +661,9 @@ FileAccessCompressed::FileAccessCompressed() :
 		read_pos(0),
 		read_total(0),
 		magic("GCMP"),
-		f(NULL) {
+		f(NULL),
+		read_ahead(0),
+		read_ahead_slots(NULL) {
 }
 
 FileAccessCompressed::~FileAccessCompressed() {
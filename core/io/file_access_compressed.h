@@ -32,7 +32,11 @@
 #define FILE_ACCESS_COMPRESSED_H
 
 #include "core/io/compression.h"
+#include "core/list.h"
 #include "core/os/file_access.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 
 class FileAccessCompressed : public FileAccess {
 
@@ -52,7 +56,7 @@ class FileAccessCompressed : public FileAccess {
 	};
 
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr;
+	mutable uint8_t *read_ptr;
 	mutable int read_block;
 	int read_block_count;
 	mutable int read_block_size;
@@ -64,8 +68,53 @@ class FileAccessCompressed : public FileAccess {
 	mutable Vector<uint8_t> buffer;
 	FileAccess *f;
 
+	// When reading sequentially, the blocks following the current one are
+	// decompressed while it is being read, by a few worker threads shared by
+	// all files.
+	struct ReadAheadSlot {
+		enum State {
+			FREE,
+			QUEUED,
+			DECOMPRESSING,
+			READY,
+		};
+
+		State state;
+		int block;
+		int size;
+		const uint8_t *src; // Compressed data, in the mapped file or in compressed.
+		int src_size;
+		Vector<uint8_t> compressed;
+		Vector<uint8_t> data;
+		const FileAccessCompressed *owner;
+		List<ReadAheadSlot *>::Element *job; // While queued.
+	};
+
+	int read_ahead;
+	mutable ReadAheadSlot *read_ahead_slots;
+	Semaphore read_ahead_ready; // Posted when a slot of this file is decompressed.
+
+	// Guards the job list and the state of the slots of every file.
+	static Mutex read_ahead_mutex;
+	static Semaphore read_ahead_queued;
+	static List<ReadAheadSlot *> read_ahead_jobs;
+	static Vector<Thread *> read_ahead_threads;
+	static bool read_ahead_exit;
+
+	static void _read_ahead_thread_func(void *p_userdata);
+	void _load_block(int p_block) const;
+	void _queue_read_ahead() const;
+	void _stop_read_ahead() const;
+
 public:
 	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, int p_block_size = 4096);
+	// Number of blocks decompressed ahead of sequential reads, 0 (the default) disables it.
+	void set_read_ahead(int p_blocks);
+	// Stops the read-ahead threads, files still open decompress their blocks in place.
+	static void finalize_read_ahead();
+
+	// Returns p_data in the format written by this class, including the magic at both ends.
+	static Vector<uint8_t> compress_buffer(const uint8_t *p_data, int p_size, const String &p_magic, Compression::Mode p_mode, int p_block_size);
 
 	Error open_after_magic(FileAccess *p_base);
 
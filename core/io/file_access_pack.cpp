@@ -30,6 +30,8 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/file_access_compressed.h"
+#include "core/io/marshalls.h"
 #include "core/version.h"
 
 #include <stdio.h>
@@ -47,12 +49,9 @@ Error PackedData::add_pack(const String &p_path, bool p_replace_files) {
 	return ERR_FILE_UNRECOGNIZED;
 };
 
-void PackedData::add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files) {
-
-	PathMD5 pmd5(path.md5_buffer());
-	//printf("adding path %ls, %lli, %lli\n", path.c_str(), pmd5.a, pmd5.b);
+bool PackedData::_add_file(const PathMD5 &p_path_md5, const String &pkg_path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, uint32_t p_flags, PackSource *p_src, bool p_replace_files) {
 
-	bool exists = files.has(pmd5);
+	bool exists = files.has(p_path_md5);
 
 	PackedFile pf;
 	pf.pack = pkg_path;
@@ -60,40 +59,140 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	pf.size = size;
 	for (int i = 0; i < 16; i++)
 		pf.md5[i] = p_md5[i];
+	pf.flags = p_flags;
 	pf.src = p_src;
 
 	if (!exists || p_replace_files)
-		files[pmd5] = pf;
+		files[p_path_md5] = pf;
+
+	return !exists;
+}
+
+void PackedData::add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files) {
+
+	PathMD5 pmd5(path.md5_buffer());
+	//printf("adding path %ls, %lli, %lli\n", path.c_str(), pmd5.a, pmd5.b);
+
+	if (_add_file(pmd5, pkg_path, ofs, size, p_md5, 0, p_src, p_replace_files)) {
+		MutexLock lock(dirs_mutex);
+		pending_paths.push_back(path);
+	}
+}
+
+void PackedData::add_path_hashed(const String &pkg_path, const uint8_t *p_path_md5, uint64_t ofs, uint64_t size, const uint8_t *p_md5, uint32_t p_flags, PackSource *p_src, bool p_replace_files) {
+
+	_add_file(PathMD5(p_path_md5), pkg_path, ofs, size, p_md5, p_flags, p_src, p_replace_files);
+}
+
+bool PackedData::get_file_location(const String &p_path, String &r_pack_path, uint64_t &r_offset, uint64_t &r_size) {
+
+	PathMD5 pmd5(p_path.md5_buffer());
+	PackedFile *pf = files.getptr(pmd5);
+	if (!pf || pf->offset == 0)
+		return false;
+
+	if (!pf->src->get_file_location(pf, r_pack_path, r_offset))
+		return false;
+
+	if (access_trace)
+		_trace_access(p_path, pmd5);
+
+	r_size = pf->size;
+	return true;
+}
+
+void PackedData::add_path_table(const Vector<uint8_t> &p_table) {
+
+	MutexLock lock(dirs_mutex);
+	pending_path_tables.push_back(p_table);
+}
+
+void PackedData::_add_dir_path(const String &p_path) {
 
-	if (!exists) {
-		//search for dir
-		String p = path.replace_first("res://", "");
-		PackedDir *cd = root;
+	//search for dir
+	String p = p_path.replace_first("res://", "");
+	PackedDir *cd = root;
 
-		if (p.find("/") != -1) { //in a subdir
+	if (p.find("/") != -1) { //in a subdir
 
-			Vector<String> ds = p.get_base_dir().split("/");
+		Vector<String> ds = p.get_base_dir().split("/");
 
-			for (int j = 0; j < ds.size(); j++) {
+		for (int j = 0; j < ds.size(); j++) {
 
-				if (!cd->subdirs.has(ds[j])) {
+			if (!cd->subdirs.has(ds[j])) {
 
-					PackedDir *pd = memnew(PackedDir);
-					pd->name = ds[j];
-					pd->parent = cd;
-					cd->subdirs[pd->name] = pd;
-					cd = pd;
-				} else {
-					cd = cd->subdirs[ds[j]];
-				}
+				PackedDir *pd = memnew(PackedDir);
+				pd->name = ds[j];
+				pd->parent = cd;
+				cd->subdirs[pd->name] = pd;
+				cd = pd;
+			} else {
+				cd = cd->subdirs[ds[j]];
 			}
 		}
-		String filename = path.get_file();
-		// Don't add as a file if the path points to a directory
-		if (!filename.empty()) {
-			cd->files.insert(filename);
+	}
+	String filename = p_path.get_file();
+	// Don't add as a file if the path points to a directory
+	if (!filename.empty()) {
+		cd->files.insert(filename);
+	}
+}
+
+PackedData::PackedDir *PackedData::_get_root() {
+
+	MutexLock lock(dirs_mutex);
+
+	for (int i = 0; i < pending_paths.size(); i++) {
+		_add_dir_path(pending_paths[i]);
+	}
+	pending_paths.clear();
+
+	for (int i = 0; i < pending_path_tables.size(); i++) {
+		const Vector<uint8_t> &table = pending_path_tables[i];
+		const char *ptr = (const char *)table.ptr();
+		int from = 0;
+		for (int j = 0; j < table.size(); j++) {
+			if (ptr[j] == 0) {
+				String path;
+				path.parse_utf8(ptr + from, j - from);
+				_add_dir_path(path);
+				from = j + 1;
+			}
 		}
 	}
+	pending_path_tables.clear();
+
+	return root;
+}
+
+Error PackedData::set_access_trace(const String &p_path) {
+
+	MutexLock lock(trace_mutex);
+
+	if (access_trace) {
+		memdelete(access_trace);
+		access_trace = NULL;
+	}
+	traced_paths.clear();
+
+	if (p_path == "") {
+		return OK;
+	}
+
+	Error err;
+	access_trace = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(!access_trace, err, "Cannot open pack access trace file '" + p_path + "'.");
+	return OK;
+}
+
+void PackedData::_trace_access(const String &p_path, const PathMD5 &p_path_md5) {
+
+	MutexLock lock(trace_mutex);
+
+	if (access_trace && !traced_paths.has(p_path_md5)) {
+		traced_paths.insert(p_path_md5);
+		access_trace->store_line(p_path);
+	}
 }
 
 void PackedData::add_pack_source(PackSource *p_source) {
@@ -110,6 +209,7 @@ PackedData::PackedData() {
 	singleton = this;
 	root = memnew(PackedDir);
 	root->parent = NULL;
+	access_trace = NULL;
 	disabled = false;
 
 	add_pack_source(memnew(PackedSourcePCK));
@@ -124,6 +224,10 @@ void PackedData::_free_packed_dirs(PackedDir *p_dir) {
 
 PackedData::~PackedData() {
 
+	if (access_trace) {
+		memdelete(access_trace);
+	}
+
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
@@ -170,7 +274,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files)
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // patch number, not used for validation.
 
-	if (version != PACK_FORMAT_VERSION) {
+	if (version != PACK_FORMAT_VERSION && version != PACK_FORMAT_VERSION_NO_FLAGS && version != PACK_FORMAT_VERSION_INLINE_PATHS) {
 		f->close();
 		memdelete(f);
 		ERR_FAIL_V_MSG(false, "Pack version unsupported: " + itos(version) + ".");
@@ -186,25 +290,81 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files)
 		f->get_32();
 	}
 
-	int file_count = f->get_32();
+	uint32_t file_count = f->get_32();
 
-	for (int i = 0; i < file_count; i++) {
+	if (version == PACK_FORMAT_VERSION_INLINE_PATHS) {
 
-		uint32_t sl = f->get_32();
-		CharString cs;
-		cs.resize(sl + 1);
-		f->get_buffer((uint8_t *)cs.ptr(), sl);
-		cs[sl] = 0;
+		for (uint32_t i = 0; i < file_count; i++) {
 
-		String path;
-		path.parse_utf8(cs.ptr());
+			uint32_t sl = f->get_32();
+			CharString cs;
+			cs.resize(sl + 1);
+			f->get_buffer((uint8_t *)cs.ptr(), sl);
+			cs[sl] = 0;
 
-		uint64_t ofs = f->get_64();
-		uint64_t size = f->get_64();
-		uint8_t md5[16];
-		f->get_buffer(md5, 16);
-		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this, p_replace_files);
-	};
+			String path;
+			path.parse_utf8(cs.ptr());
+
+			uint64_t ofs = f->get_64();
+			uint64_t size = f->get_64();
+			uint8_t md5[16];
+			f->get_buffer(md5, 16);
+			PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this, p_replace_files);
+		};
+
+	} else {
+
+		// The index and the path table are each read at once, the paths are
+		// only parsed if the directories of the pack are listed.
+		uint32_t path_table_size = f->get_32();
+		bool has_flags = version != PACK_FORMAT_VERSION_NO_FLAGS;
+		uint32_t entry_size = has_flags ? PACK_INDEX_ENTRY_SIZE : PACK_INDEX_ENTRY_SIZE_NO_FLAGS;
+
+		if (file_count > INT32_MAX / entry_size || path_table_size > INT32_MAX) {
+			f->close();
+			memdelete(f);
+			ERR_FAIL_V_MSG(false, "Pack index is too large: " + p_path + ".");
+		}
+
+		Vector<uint8_t> index;
+		index.resize(file_count * entry_size);
+		Vector<uint8_t> path_table;
+		path_table.resize(path_table_size);
+
+		if (f->get_buffer(index.ptrw(), index.size()) != index.size() || f->get_buffer(path_table.ptrw(), path_table.size()) != path_table.size()) {
+			f->close();
+			memdelete(f);
+			ERR_FAIL_V_MSG(false, "Pack index is truncated: " + p_path + ".");
+		}
+
+		const uint8_t *entry = index.ptr();
+		for (uint32_t i = 0; i < file_count; i++) {
+
+			uint64_t ofs = decode_uint64(entry + 16);
+			uint64_t size = decode_uint64(entry + 24);
+			uint32_t flags = has_flags ? decode_uint32(entry + 48) : 0;
+			PackedData::get_singleton()->add_path_hashed(p_path, entry, ofs, size, entry + 32, flags, this, p_replace_files);
+			entry += entry_size;
+		}
+
+		PackedData::get_singleton()->add_path_table(path_table);
+	}
+
+	// Keep the pack mapped when the platform can, its files are then read
+	// straight from memory.
+	if (!mapped_packs.has(p_path)) {
+		f->seek(0);
+		uint64_t size = f->get_len();
+		const uint8_t *data = f->get_buffer_ptr(size);
+		if (data) {
+			MappedPack mapped;
+			mapped.file = f;
+			mapped.data = data;
+			mapped.size = size;
+			mapped_packs[p_path] = mapped;
+			return true;
+		}
+	}
 
 	f->close();
 	memdelete(f);
@@ -213,9 +373,49 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files)
 
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
 
-	return memnew(FileAccessPack(p_path, *p_file));
+	FileAccess *f;
+
+	Map<String, MappedPack>::Element *E = mapped_packs.find(p_file->pack);
+	if (E && p_file->offset <= E->get().size && p_file->size <= E->get().size - p_file->offset) {
+		f = memnew(FileAccessPack(p_path, *p_file, E->get().data));
+	} else {
+		f = memnew(FileAccessPack(p_path, *p_file));
+	}
+
+	if (p_file->flags & PACK_FILE_COMPRESSED) {
+
+		uint8_t magic[4];
+		FileAccessCompressed *fac = memnew(FileAccessCompressed);
+		fac->set_read_ahead(PACK_COMPRESSED_READ_AHEAD);
+		if (f->get_buffer(magic, 4) != 4 || memcmp(magic, PACK_COMPRESSED_MAGIC, 4) != 0 || fac->open_after_magic(f) != OK) {
+			memdelete(fac);
+			memdelete(f);
+			ERR_FAIL_V_MSG(NULL, "Compressed file in pack is corrupted: " + p_path + ".");
+		}
+		return fac;
+	}
+
+	return f;
 };
 
+bool PackedSourcePCK::get_file_location(const PackedData::PackedFile *p_file, String &r_pack_path, uint64_t &r_offset) {
+
+	if (p_file->flags & PACK_FILE_COMPRESSED)
+		return false;
+
+	r_pack_path = p_file->pack;
+	r_offset = p_file->offset;
+	return true;
+}
+
+PackedSourcePCK::~PackedSourcePCK() {
+
+	for (Map<String, MappedPack>::Element *E = mapped_packs.front(); E; E = E->next()) {
+		E->get().file->close();
+		memdelete(E->get().file);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -226,12 +426,15 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 
 void FileAccessPack::close() {
 
-	f->close();
+	if (f) {
+		f->close();
+	}
+	open = false;
 }
 
 bool FileAccessPack::is_open() const {
 
-	return f->is_open();
+	return f ? f->is_open() : open;
 }
 
 void FileAccessPack::seek(size_t p_position) {
@@ -242,7 +445,9 @@ void FileAccessPack::seek(size_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (f) {
+		f->seek(pf.offset + p_position);
+	}
 	pos = p_position;
 }
 void FileAccessPack::seek_end(int64_t p_position) {
@@ -270,6 +475,10 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (data) {
+		return data[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
@@ -285,18 +494,36 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 		to_read = int64_t(pf.size) - int64_t(pos);
 	}
 
+	size_t read_pos = pos;
 	pos += p_length;
 
 	if (to_read <= 0)
 		return 0;
-	f->get_buffer(p_dst, to_read);
+	if (data) {
+		copymem(p_dst, data + read_pos, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_buffer_ptr(uint64_t p_length) const {
+
+	if (!data || eof || pos > pf.size || p_length > pf.size - pos) {
+		return NULL;
+	}
+
+	const uint8_t *ptr = data + pos;
+	pos += p_length;
+	return ptr;
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f) {
+		f->set_endian_swap(p_swap);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -326,15 +553,24 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_pack_data) :
 		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		f(NULL),
+		data(NULL),
+		open(true) {
 
+	pos = 0;
+	eof = false;
+
+	if (p_pack_data) {
+		data = p_pack_data + pf.offset;
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(!f, "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -348,6 +584,8 @@ FileAccessPack::~FileAccessPack() {
 
 Error DirAccessPack::list_dir_begin() {
 
+	PackedData::get_singleton()->_get_root(); // Adds the files of packs mounted since.
+
 	list_dirs.clear();
 	list_files.clear();
 
@@ -423,11 +661,9 @@ Error DirAccessPack::change_dir(String p_dir) {
 
 	Vector<String> paths = nd.split("/");
 
-	PackedData::PackedDir *pd;
+	PackedData::PackedDir *pd = PackedData::get_singleton()->_get_root();
 
-	if (absolute)
-		pd = PackedData::get_singleton()->root;
-	else
+	if (!absolute)
 		pd = current;
 
 	for (int i = 0; i < paths.size(); i++) {
@@ -471,6 +707,7 @@ bool DirAccessPack::file_exists(String p_file) {
 
 	p_file = fix_path(p_file);
 
+	PackedData::get_singleton()->_get_root();
 	return current->files.has(p_file);
 }
 
@@ -478,6 +715,7 @@ bool DirAccessPack::dir_exists(String p_dir) {
 
 	p_dir = fix_path(p_dir);
 
+	PackedData::get_singleton()->_get_root();
 	return current->subdirs.has(p_dir);
 }
 
@@ -506,7 +744,7 @@ String DirAccessPack::get_filesystem_type() const {
 
 DirAccessPack::DirAccessPack() {
 
-	current = PackedData::get_singleton()->root;
+	current = PackedData::get_singleton()->_get_root();
 	cdir = false;
 }
 
@@ -31,16 +31,46 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "core/hash_map.h"
 #include "core/list.h"
 #include "core/map.h"
+#include "core/os/copymem.h"
 #include "core/os/dir_access.h"
 #include "core/os/file_access.h"
+#include "core/os/mutex.h"
 #include "core/print_string.h"
+#include "core/set.h"
 
 // Godot's packed file magic header ("GDPC" in ASCII).
 #define PACK_HEADER_MAGIC 0x43504447
 // The current packed file format version number.
-#define PACK_FORMAT_VERSION 1
+// Version 2 replaced the per-file entries (path, offset, size, md5) with a flat
+// index of fixed size entries, followed by a table of paths. The entries are
+// sorted by path hash so the index doesn't depend on the order of the data,
+// mounting a pack still adds each of them to PackedData.
+// Version 3 added flags to the index entries.
+#define PACK_FORMAT_VERSION 3
+// The last packed file format version storing the path in every index entry.
+#define PACK_FORMAT_VERSION_INLINE_PATHS 1
+// The last packed file format version without index entry flags.
+#define PACK_FORMAT_VERSION_NO_FLAGS 2
+// Size of an index entry: path md5, offset, size, file md5, flags and 4 reserved bytes.
+#define PACK_INDEX_ENTRY_SIZE 56
+// Size of an index entry without flags: path md5, offset, size and file md5.
+#define PACK_INDEX_ENTRY_SIZE_NO_FLAGS 48
+
+// Index entry flags.
+enum PackFileFlags {
+	// Stored as independently compressed zstd blocks with a table of their
+	// sizes (the FileAccessCompressed format), so it can still be seeked.
+	PACK_FILE_COMPRESSED = 1,
+};
+
+// Magic and block size of compressed files.
+#define PACK_COMPRESSED_MAGIC "GCPF"
+#define PACK_COMPRESSED_BLOCK_SIZE (64 * 1024)
+// Blocks decompressed ahead of sequential reads of compressed files.
+#define PACK_COMPRESSED_READ_AHEAD 4
 
 class PackSource;
 
@@ -56,6 +86,7 @@ public:
 		uint64_t offset; //if offset is ZERO, the file was ERASED
 		uint64_t size;
 		uint8_t md5[16];
+		uint32_t flags; // PackFileFlags.
 		PackSource *src;
 	};
 
@@ -91,23 +122,49 @@ private:
 			a = *((uint64_t *)&p_buf[0]);
 			b = *((uint64_t *)&p_buf[8]);
 		};
+
+		PathMD5(const uint8_t *p_buf) {
+			copymem(&a, p_buf, 8);
+			copymem(&b, p_buf + 8, 8);
+		};
+
+		static _FORCE_INLINE_ uint32_t hash(const PathMD5 &p_md5) {
+			return hash_one_uint64(p_md5.a ^ p_md5.b);
+		}
 	};
 
-	Map<PathMD5, PackedFile> files;
+	HashMap<PathMD5, PackedFile, PathMD5> files;
 
 	Vector<PackSource *> sources;
 
+	// The directory tree is only needed to list directories, so it's built
+	// from the paths of the mounted packs the first time it's used.
 	PackedDir *root;
-	//Map<String,PackedDir*> dirs;
+	Vector<String> pending_paths;
+	Vector<Vector<uint8_t> > pending_path_tables;
+	Mutex dirs_mutex;
+
+	FileAccess *access_trace;
+	Set<PathMD5> traced_paths;
+	Mutex trace_mutex;
 
 	static PackedData *singleton;
 	bool disabled;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	bool _add_file(const PathMD5 &p_path_md5, const String &pkg_path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, uint32_t p_flags, PackSource *p_src, bool p_replace_files);
+	void _add_dir_path(const String &p_path);
+	PackedDir *_get_root();
+	void _trace_access(const String &p_path, const PathMD5 &p_path_md5);
 
 public:
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files); // for PackSource
+	void add_path_hashed(const String &pkg_path, const uint8_t *p_path_md5, uint64_t ofs, uint64_t size, const uint8_t *p_md5, uint32_t p_flags, PackSource *p_src, bool p_replace_files); // for PackSource
+	void add_path_table(const Vector<uint8_t> &p_table); // NUL terminated UTF-8 paths, for PackSource
+
+	// Records the path of every file opened from a pack, once, in the order they are first opened.
+	Error set_access_trace(const String &p_path);
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -117,6 +174,9 @@ public:
 
 	_FORCE_INLINE_ FileAccess *try_open_path(const String &p_path);
 	_FORCE_INLINE_ bool has_path(const String &p_path);
+	// Where the contents of a packed file are stored, for reading them without a FileAccess.
+	// Fails if they aren't stored as-is in a file (e.g. compressed).
+	bool get_file_location(const String &p_path, String &r_pack_path, uint64_t &r_offset, uint64_t &r_size);
 
 	PackedData();
 	~PackedData();
@@ -127,14 +187,28 @@ class PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files) = 0;
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file) = 0;
+	virtual bool get_file_location(const PackedData::PackedFile *p_file, String &r_pack_path, uint64_t &r_offset) { return false; }
 	virtual ~PackSource() {}
 };
 
 class PackedSourcePCK : public PackSource {
 
+	// Packs mapped in memory, their files are read from the mapping rather
+	// than through a FileAccess opened for each of them.
+	struct MappedPack {
+		FileAccess *file;
+		const uint8_t *data;
+		uint64_t size;
+	};
+
+	Map<String, MappedPack> mapped_packs;
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+	virtual bool get_file_location(const PackedData::PackedFile *p_file, String &r_pack_path, uint64_t &r_offset);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -145,6 +219,8 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *data; // The file in the mapped pack, or NULL to read through f.
+	bool open;
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -164,6 +240,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_buffer_ptr(uint64_t p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -176,20 +253,23 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_pack_data = NULL);
 	~FileAccessPack();
 };
 
 FileAccess *PackedData::try_open_path(const String &p_path) {
 
 	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
-	if (!E)
+	PackedFile *pf = files.getptr(pmd5);
+	if (!pf)
 		return NULL; //not found
-	if (E->get().offset == 0)
+	if (pf->offset == 0)
 		return NULL; //was erased
 
-	return E->get().src->get_file(p_path, &E->get());
+	if (access_trace)
+		_trace_access(p_path, pmd5);
+
+	return pf->src->get_file(p_path, pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
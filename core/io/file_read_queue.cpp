@@ -0,0 +1,305 @@
+/*************************************************************************/
+/*  file_read_queue.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_read_queue.h"
+
+#include "core/io/file_access_pack.h"
+#include "core/os/file_access.h"
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "core/project_settings.h"
+
+#define POOL_MAX_THREADS 4
+
+FileReadQueue *(*FileReadQueue::_create)() = NULL;
+
+Vector<Thread *> FileReadQueue::pool_threads;
+List<FileReadQueue::Read *> FileReadQueue::pool_reads;
+Mutex FileReadQueue::pool_mutex;
+Semaphore FileReadQueue::pool_semaphore;
+bool FileReadQueue::pool_exit = false;
+
+static void _read_file(const String &p_path, uint64_t p_offset, uint8_t *p_dst, int p_length, int &r_result, Error &r_error) {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::READ, &r_error);
+	if (!f) {
+		r_result = -1;
+		return;
+	}
+
+	f->seek(p_offset);
+	r_result = f->get_buffer(p_dst, p_length);
+	r_error = OK;
+	memdelete(f);
+}
+
+void FileReadQueue::_pool_thread_func(void *p_userdata) {
+
+	while (true) {
+
+		pool_semaphore.wait();
+
+		pool_mutex.lock();
+		if (pool_exit) {
+			pool_mutex.unlock();
+			break;
+		}
+		Read *read = pool_reads.front()->get();
+		pool_reads.pop_front();
+		pool_mutex.unlock();
+
+		int result;
+		Error error;
+		_read_file(read->path, read->offset, read->dst, read->length, result, error);
+		read->queue->_complete(read, result, error);
+	}
+}
+
+void FileReadQueue::_complete(Read *p_read, int p_result, Error p_error) {
+
+	MutexLock lock(mutex);
+	p_read->result = p_result;
+	p_read->error = p_error;
+	p_read->done = true;
+	// Posted with the lock held, the read and the queue may be freed as soon as it's released.
+	completed.post();
+}
+
+bool FileReadQueue::_get_os_location(const String &p_path, uint64_t p_offset, int p_length, String &r_os_path, uint64_t &r_os_offset, int &r_length) {
+
+	PackedData *packed_data = PackedData::get_singleton();
+	if (packed_data && !packed_data->is_disabled() && packed_data->has_path(p_path)) {
+
+		String pack_path;
+		uint64_t offset;
+		uint64_t size;
+		if (!packed_data->get_file_location(p_path, pack_path, offset, size))
+			return false;
+
+		r_os_path = ProjectSettings::get_singleton()->globalize_path(pack_path);
+		r_os_offset = offset + MIN(p_offset, size);
+		r_length = p_offset < size ? (int)MIN((uint64_t)p_length, size - p_offset) : 0;
+		return true;
+	}
+
+	r_os_path = ProjectSettings::get_singleton()->globalize_path(p_path);
+	r_os_offset = p_offset;
+	r_length = p_length;
+	return true;
+}
+
+FileReadQueue::ReadID FileReadQueue::queue_read(const String &p_path, uint64_t p_offset, uint8_t *p_dst, int p_length) {
+
+	ERR_FAIL_COND_V(p_length < 0, 0);
+	ERR_FAIL_COND_V(!p_dst && p_length > 0, 0);
+
+	Read *read = memnew(Read);
+	read->id = ++last_id;
+	read->path = p_path;
+	read->offset = p_offset;
+	read->dst = p_dst;
+	read->length = p_length;
+	read->native = false;
+	read->done = false;
+	read->result = 0;
+	read->error = OK;
+	read->queue = this;
+
+	reads[read->id] = read;
+	queued.push_back(read);
+	return read->id;
+}
+
+void FileReadQueue::submit() {
+
+	if (queued.empty())
+		return;
+
+	Vector<Read *> to_submit = queued;
+	queued.clear();
+
+	bool has_native = false;
+	Vector<Read *> pool;
+	for (int i = 0; i < to_submit.size(); i++) {
+		Read *read = to_submit[i];
+		read->native = _submit_native(read);
+		has_native = has_native || read->native;
+		if (!read->native)
+			pool.push_back(read);
+	}
+
+	if (has_native)
+		_flush_native();
+
+	if (!pool.empty())
+		_submit_to_pool(pool);
+}
+
+void FileReadQueue::_submit_to_pool(const Vector<Read *> &p_reads) {
+
+	for (int i = 0; i < p_reads.size(); i++) {
+		p_reads[i]->native = false;
+	}
+
+	pool_mutex.lock();
+
+	if (pool_threads.empty() && !pool_exit) {
+		int thread_count = CLAMP(OS::get_singleton()->get_processor_count(), 1, POOL_MAX_THREADS);
+		for (int i = 0; i < thread_count; i++) {
+			Thread *thread = Thread::create(_pool_thread_func, NULL);
+			if (!thread)
+				break;
+			pool_threads.push_back(thread);
+		}
+	}
+
+	if (pool_threads.empty()) {
+		// No threads (disabled or already finalized), read right away.
+		pool_mutex.unlock();
+		for (int i = 0; i < p_reads.size(); i++) {
+			Read *read = p_reads[i];
+			int result;
+			Error error;
+			_read_file(read->path, read->offset, read->dst, read->length, result, error);
+			_complete(read, result, error);
+		}
+		return;
+	}
+
+	for (int i = 0; i < p_reads.size(); i++) {
+		pool_reads.push_back(p_reads[i]);
+		pool_semaphore.post();
+	}
+
+	pool_mutex.unlock();
+}
+
+bool FileReadQueue::is_done(ReadID p_id) {
+
+	Read **read = reads.getptr(p_id);
+	ERR_FAIL_COND_V_MSG(!read, true, "Invalid read ID.");
+
+	if ((*read)->native && !(*read)->done)
+		_poll_native(false);
+
+	MutexLock lock(mutex);
+	return (*read)->done;
+}
+
+int FileReadQueue::wait(ReadID p_id, Error *r_error) {
+
+	Read **readp = reads.getptr(p_id);
+	if (!readp) {
+		if (r_error)
+			*r_error = ERR_INVALID_PARAMETER;
+		ERR_FAIL_V_MSG(-1, "Invalid read ID.");
+	}
+	Read *read = *readp;
+
+	if (queued.find(read) != -1)
+		submit();
+
+	while (true) {
+		mutex.lock();
+		bool done = read->done;
+		mutex.unlock();
+		if (done)
+			break;
+
+		if (read->native)
+			_poll_native(true);
+		else
+			completed.wait();
+	}
+
+	if (r_error)
+		*r_error = read->error;
+	int result = read->result;
+
+	reads.erase(p_id);
+	memdelete(read);
+
+	return result;
+}
+
+void FileReadQueue::wait_all() {
+
+	submit();
+
+	while (true) {
+		const ReadID *id = reads.next(NULL);
+		if (!id)
+			break;
+		wait(*id);
+	}
+}
+
+FileReadQueue *FileReadQueue::create() {
+
+	if (_create)
+		return _create();
+	return memnew(FileReadQueue);
+}
+
+void FileReadQueue::finalize() {
+
+	pool_mutex.lock();
+	pool_exit = true;
+	for (int i = 0; i < pool_threads.size(); i++)
+		pool_semaphore.post();
+	pool_mutex.unlock();
+
+	for (int i = 0; i < pool_threads.size(); i++) {
+		Thread::wait_to_finish(pool_threads[i]);
+		memdelete(pool_threads[i]);
+	}
+	pool_threads.clear();
+
+	// Reads queued after the threads stopped are done in place by submit(), but complete any left over.
+	while (pool_reads.size()) {
+		Read *read = pool_reads.front()->get();
+		pool_reads.pop_front();
+		int result;
+		Error error;
+		_read_file(read->path, read->offset, read->dst, read->length, result, error);
+		read->queue->_complete(read, result, error);
+	}
+}
+
+FileReadQueue::FileReadQueue() {
+
+	last_id = 0;
+}
+
+FileReadQueue::~FileReadQueue() {
+
+	// Derived classes must wait for their reads in their own destructor, before their state is gone.
+	wait_all();
+}
@@ -0,0 +1,121 @@
+/*************************************************************************/
+/*  file_read_queue.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_READ_QUEUE_H
+#define FILE_READ_QUEUE_H
+
+#include "core/hash_map.h"
+#include "core/list.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/ustring.h"
+
+// Reads parts of files in the background. Reads are queued, started together
+// with submit(), and complete in any order while the caller does other work.
+//
+// A queue must only be used by one thread at a time. The default implementation
+// runs the reads on a small pool of threads shared by all queues, platforms can
+// provide one using the native asynchronous I/O of the OS instead.
+class FileReadQueue {
+public:
+	typedef uint64_t ReadID;
+
+protected:
+	struct Read {
+		ReadID id;
+		String path;
+		uint64_t offset;
+		uint8_t *dst;
+		int length;
+
+		bool native; // Handled by the platform, not the thread pool.
+		bool done;
+		int result; // Bytes read.
+		Error error;
+
+		FileReadQueue *queue;
+	};
+
+	static FileReadQueue *(*_create)();
+
+	// Offers a read to the platform implementation, returns false to run it on the thread pool.
+	virtual bool _submit_native(Read *p_read) { return false; }
+	// Starts the reads accepted by _submit_native() since the last call.
+	virtual void _flush_native() {}
+	// Completes the finished native reads, waiting for at least one if p_block is true.
+	virtual void _poll_native(bool p_block) {}
+
+	void _complete(Read *p_read, int p_result, Error p_error);
+	// Runs reads on the thread pool, also used by platforms for the native reads they can't finish.
+	void _submit_to_pool(const Vector<Read *> &p_reads);
+
+	// Where to read a part of a file from in the OS file system, or false if it can't be read
+	// directly (a compressed file in a pack, a file in a ZIP archive...).
+	static bool _get_os_location(const String &p_path, uint64_t p_offset, int p_length, String &r_os_path, uint64_t &r_os_offset, int &r_length);
+
+private:
+	HashMap<ReadID, Read *> reads;
+	Vector<Read *> queued;
+	ReadID last_id;
+
+	// Guard the completion of reads, which happens on other threads.
+	Mutex mutex;
+	Semaphore completed;
+
+	static Vector<Thread *> pool_threads;
+	static List<Read *> pool_reads;
+	static Mutex pool_mutex;
+	static Semaphore pool_semaphore;
+	static bool pool_exit;
+
+	static void _pool_thread_func(void *p_userdata);
+
+public:
+	// Queues reading p_length bytes at p_offset of p_path into p_dst, which must stay valid until
+	// the read is waited for. Returns 0 on failure.
+	ReadID queue_read(const String &p_path, uint64_t p_offset, uint8_t *p_dst, int p_length);
+	// Starts all the queued reads.
+	void submit();
+
+	bool is_done(ReadID p_id);
+	// Waits until the read is completed and returns the amount of bytes read (less than requested
+	// at the end of the file), or -1 on error. The ID is no longer valid afterwards.
+	int wait(ReadID p_id, Error *r_error = NULL);
+	void wait_all();
+
+	static FileReadQueue *create();
+	static void finalize();
+
+	FileReadQueue();
+	virtual ~FileReadQueue();
+};
+
+#endif // FILE_READ_QUEUE_H
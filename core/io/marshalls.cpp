@@ -60,6 +60,14 @@ EncodedObjectAsID::EncodedObjectAsID() {
 #define ERR_FAIL_ADD_OF(a, b, err) ERR_FAIL_COND_V(_S(b) < 0 || _S(a) < 0 || _S(a) > INT_MAX - _S(b), err)
 #define ERR_FAIL_MUL_OF(a, b, err) ERR_FAIL_COND_V(_S(a) < 0 || _S(b) <= 0 || _S(a) > INT_MAX / _S(b), err)
 
+// The encoding is little endian, packed arrays are copied as they are in memory when the host is too.
+#ifndef BIG_ENDIAN_ENABLED
+#define COPY_PACKED_ARRAYS
+#ifndef REAL_T_IS_DOUBLE
+#define COPY_PACKED_VECTOR_ARRAYS
+#endif
+#endif
+
 #define ENCODE_MASK 0xFF
 #define ENCODE_FLAG_64 1 << 16
 #define ENCODE_FLAG_OBJECT_AS_ID 1 << 16
@@ -636,10 +644,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				int32_t *w = data.ptrw();
+#ifdef COPY_PACKED_ARRAYS
+				copymem(w, buf, count * sizeof(int32_t));
+#else
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i] = decode_uint32(&buf[i * 4]);
 				}
+#endif
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -650,7 +662,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 		case Variant::PACKED_INT64_ARRAY: {
 
 			ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
-			int64_t count = decode_uint64(buf);
+			int32_t count = decode_uint32(buf);
 			buf += 4;
 			len -= 4;
 			ERR_FAIL_MUL_OF(count, 8, ERR_INVALID_DATA);
@@ -662,10 +674,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				int64_t *w = data.ptrw();
+#ifdef COPY_PACKED_ARRAYS
+				copymem(w, buf, count * sizeof(int64_t));
+#else
 				for (int64_t i = 0; i < count; i++) {
 
 					w[i] = decode_uint64(&buf[i * 8]);
 				}
+#endif
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -688,10 +704,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				//const float*rbuf=(const float*)buf;
 				data.resize(count);
 				float *w = data.ptrw();
+#ifdef COPY_PACKED_ARRAYS
+				copymem(w, buf, count * sizeof(float));
+#else
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i] = decode_float(&buf[i * 4]);
 				}
+#endif
 			}
 			r_variant = data;
 
@@ -715,10 +735,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				//const double*rbuf=(const double*)buf;
 				data.resize(count);
 				double *w = data.ptrw();
+#ifdef COPY_PACKED_ARRAYS
+				copymem(w, buf, count * sizeof(double));
+#else
 				for (int64_t i = 0; i < count; i++) {
 
 					w[i] = decode_double(&buf[i * 8]);
 				}
+#endif
 			}
 			r_variant = data;
 
@@ -772,11 +796,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				varray.resize(count);
 				Vector2 *w = varray.ptrw();
 
+#ifdef COPY_PACKED_VECTOR_ARRAYS
+				copymem(w, buf, count * sizeof(Vector2));
+#else
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i].x = decode_float(buf + i * 4 * 2 + 4 * 0);
 					w[i].y = decode_float(buf + i * 4 * 2 + 4 * 1);
 				}
+#endif
 
 				int adv = 4 * 2 * count;
 
@@ -807,12 +835,16 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				varray.resize(count);
 				Vector3 *w = varray.ptrw();
 
+#ifdef COPY_PACKED_VECTOR_ARRAYS
+				copymem(w, buf, count * sizeof(Vector3));
+#else
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i].x = decode_float(buf + i * 4 * 3 + 4 * 0);
 					w[i].y = decode_float(buf + i * 4 * 3 + 4 * 1);
 					w[i].z = decode_float(buf + i * 4 * 3 + 4 * 2);
 				}
+#endif
 
 				int adv = 4 * 3 * count;
 
@@ -843,6 +875,9 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				carray.resize(count);
 				Color *w = carray.ptrw();
 
+#ifdef COPY_PACKED_ARRAYS
+				copymem(w, buf, count * sizeof(Color));
+#else
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i].r = decode_float(buf + i * 4 * 4 + 4 * 0);
@@ -850,6 +885,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					w[i].b = decode_float(buf + i * 4 * 4 + 4 * 2);
 					w[i].a = decode_float(buf + i * 4 * 4 + 4 * 3);
 				}
+#endif
 
 				int adv = 4 * 4 * count;
 
@@ -868,31 +904,69 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 	return OK;
 }
 
-static void _encode_string(const String &p_string, uint8_t *&buf, int &r_len) {
+// Where encode_variant() puts the encoding. Without a buffer it only measures it, a fixed buffer must be
+// large enough already, and a growable one is resized while encoding so it's done in a single pass.
+struct _VariantEncoder {
 
-	CharString utf8 = p_string.utf8();
+	uint8_t *buffer;
+	Vector<uint8_t> *growable;
+	int offset;
+	int len;
+	bool full_objects;
 
-	if (buf) {
-		encode_uint32(utf8.length(), buf);
-		buf += 4;
-		copymem(buf, utf8.get_data(), utf8.length());
-		buf += utf8.length();
+	// Claims the next p_size bytes and returns where to write them, or NULL when only measuring.
+	// The pointer is valid until the next call, growing the buffer may move it.
+	_FORCE_INLINE_ uint8_t *reserve(int p_size) {
+
+		int pos = len;
+		len += p_size;
+
+		if (growable) {
+			if (unlikely(growable->size() < offset + len)) {
+				growable->resize(next_power_of_2(offset + len));
+			}
+			return growable->ptrw() + offset + pos;
+		}
+
+		return buffer ? buffer + pos : NULL;
+	}
+
+	_VariantEncoder(uint8_t *p_buffer, Vector<uint8_t> *p_growable, int p_offset, bool p_full_objects) {
+
+		buffer = p_buffer;
+		growable = p_growable;
+		offset = p_offset;
+		len = 0;
+		full_objects = p_full_objects;
 	}
+};
 
-	r_len += 4 + utf8.length();
-	while (r_len % 4) {
-		r_len++; //pad
-		if (buf) {
-			*(buf++) = 0;
+// Length prefixed bytes, padded to 4.
+static void _encode_bytes(const uint8_t *p_data, int p_size, _VariantEncoder &p_encoder) {
+
+	int pad = 0;
+	if (p_size % 4)
+		pad = 4 - p_size % 4;
+
+	uint8_t *buf = p_encoder.reserve(4 + p_size + pad);
+	if (buf) {
+		encode_uint32(p_size, buf);
+		buf += 4;
+		copymem(buf, p_data, p_size);
+		buf += p_size;
+		for (int i = 0; i < pad; i++) {
+			buf[i] = 0;
 		}
 	}
 }
 
-Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects) {
+static void _encode_string(const String &p_string, _VariantEncoder &p_encoder) {
 
-	uint8_t *buf = r_buffer;
+	CharString utf8 = p_string.utf8();
+	_encode_bytes((const uint8_t *)utf8.get_data(), utf8.length(), p_encoder);
+}
 
-	r_len = 0;
+static Error _encode_variant(const Variant &p_variant, _VariantEncoder &p_encoder) {
 
 	uint32_t flags = 0;
 
@@ -918,14 +992,14 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			Object *obj = p_variant.get_validated_object();
 			if (!obj) {
 				// Object is invalid, send a NULL instead.
+				uint8_t *buf = p_encoder.reserve(4);
 				if (buf) {
 					encode_uint32(Variant::NIL, buf);
 				}
-				r_len += 4;
 				return OK;
 			}
 
-			if (!p_full_objects) {
+			if (!p_encoder.full_objects) {
 				flags |= ENCODE_FLAG_OBJECT_AS_ID;
 			}
 		} break;
@@ -933,11 +1007,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} // nothing to do at this stage
 	}
 
+	uint8_t *buf = p_encoder.reserve(4);
 	if (buf) {
 		encode_uint32(p_variant.get_type() | flags, buf);
-		buf += 4;
 	}
-	r_len += 4;
 
 	switch (p_variant.get_type()) {
 
@@ -947,52 +1020,48 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} break;
 		case Variant::BOOL: {
 
+			buf = p_encoder.reserve(4);
 			if (buf) {
 				encode_uint32(p_variant.operator bool(), buf);
 			}
 
-			r_len += 4;
-
 		} break;
 		case Variant::INT: {
 
 			if (flags & ENCODE_FLAG_64) {
 				//64 bits
+				buf = p_encoder.reserve(8);
 				if (buf) {
 					encode_uint64(p_variant.operator int64_t(), buf);
 				}
-
-				r_len += 8;
 			} else {
+				buf = p_encoder.reserve(4);
 				if (buf) {
 					encode_uint32(p_variant.operator int32_t(), buf);
 				}
-
-				r_len += 4;
 			}
 		} break;
 		case Variant::FLOAT: {
 
 			if (flags & ENCODE_FLAG_64) {
+				buf = p_encoder.reserve(8);
 				if (buf) {
 					encode_double(p_variant.operator double(), buf);
 				}
 
-				r_len += 8;
-
 			} else {
 
+				buf = p_encoder.reserve(4);
 				if (buf) {
 					encode_float(p_variant.operator float(), buf);
 				}
-
-				r_len += 4;
 			}
 
 		} break;
 		case Variant::NODE_PATH: {
 
 			NodePath np = p_variant;
+			buf = p_encoder.reserve(12);
 			if (buf) {
 				encode_uint32(uint32_t(np.get_name_count()) | 0x80000000, buf); //for compatibility with the old format
 				encode_uint32(np.get_subname_count(), buf + 4);
@@ -1001,12 +1070,8 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					np_flags |= 1;
 
 				encode_uint32(np_flags, buf + 8);
-
-				buf += 12;
 			}
 
-			r_len += 12;
-
 			int total = np.get_name_count() + np.get_subname_count();
 
 			for (int i = 0; i < total; i++) {
@@ -1018,60 +1083,45 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				else
 					str = np.get_subname(i - np.get_name_count());
 
-				CharString utf8 = str.utf8();
-
-				int pad = 0;
-
-				if (utf8.length() % 4)
-					pad = 4 - utf8.length() % 4;
-
-				if (buf) {
-					encode_uint32(utf8.length(), buf);
-					buf += 4;
-					copymem(buf, utf8.get_data(), utf8.length());
-					buf += pad + utf8.length();
-				}
-
-				r_len += 4 + utf8.length() + pad;
+				_encode_string(str, p_encoder);
 			}
 
 		} break;
 		case Variant::STRING: {
 
-			_encode_string(p_variant, buf, r_len);
+			_encode_string(p_variant, p_encoder);
 
 		} break;
 		case Variant::STRING_NAME: {
 
-			_encode_string(p_variant, buf, r_len);
+			_encode_string(p_variant, p_encoder);
 
 		} break;
 
 		// math types
 		case Variant::VECTOR2: {
 
+			buf = p_encoder.reserve(2 * 4);
 			if (buf) {
 				Vector2 v2 = p_variant;
 				encode_float(v2.x, &buf[0]);
 				encode_float(v2.y, &buf[4]);
 			}
 
-			r_len += 2 * 4;
-
 		} break;
 		case Variant::VECTOR2I: {
 
+			buf = p_encoder.reserve(2 * 4);
 			if (buf) {
 				Vector2i v2 = p_variant;
 				encode_uint32(v2.x, &buf[0]);
 				encode_uint32(v2.y, &buf[4]);
 			}
 
-			r_len += 2 * 4;
-
 		} break;
 		case Variant::RECT2: {
 
+			buf = p_encoder.reserve(4 * 4);
 			if (buf) {
 				Rect2 r2 = p_variant;
 				encode_float(r2.position.x, &buf[0]);
@@ -1079,11 +1129,11 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_float(r2.size.x, &buf[8]);
 				encode_float(r2.size.y, &buf[12]);
 			}
-			r_len += 4 * 4;
 
 		} break;
 		case Variant::RECT2I: {
 
+			buf = p_encoder.reserve(4 * 4);
 			if (buf) {
 				Rect2i r2 = p_variant;
 				encode_uint32(r2.position.x, &buf[0]);
@@ -1091,11 +1141,11 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(r2.size.x, &buf[8]);
 				encode_uint32(r2.size.y, &buf[12]);
 			}
-			r_len += 4 * 4;
 
 		} break;
 		case Variant::VECTOR3: {
 
+			buf = p_encoder.reserve(3 * 4);
 			if (buf) {
 				Vector3 v3 = p_variant;
 				encode_float(v3.x, &buf[0]);
@@ -1103,11 +1153,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_float(v3.z, &buf[8]);
 			}
 
-			r_len += 3 * 4;
-
 		} break;
 		case Variant::VECTOR3I: {
 
+			buf = p_encoder.reserve(3 * 4);
 			if (buf) {
 				Vector3i v3 = p_variant;
 				encode_uint32(v3.x, &buf[0]);
@@ -1115,11 +1164,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(v3.z, &buf[8]);
 			}
 
-			r_len += 3 * 4;
-
 		} break;
 		case Variant::TRANSFORM2D: {
 
+			buf = p_encoder.reserve(6 * 4);
 			if (buf) {
 				Transform2D val = p_variant;
 				for (int i = 0; i < 3; i++) {
@@ -1130,11 +1178,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				}
 			}
 
-			r_len += 6 * 4;
-
 		} break;
 		case Variant::PLANE: {
 
+			buf = p_encoder.reserve(4 * 4);
 			if (buf) {
 				Plane p = p_variant;
 				encode_float(p.normal.x, &buf[0]);
@@ -1143,11 +1190,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_float(p.d, &buf[12]);
 			}
 
-			r_len += 4 * 4;
-
 		} break;
 		case Variant::QUAT: {
 
+			buf = p_encoder.reserve(4 * 4);
 			if (buf) {
 				Quat q = p_variant;
 				encode_float(q.x, &buf[0]);
@@ -1156,11 +1202,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_float(q.w, &buf[12]);
 			}
 
-			r_len += 4 * 4;
-
 		} break;
 		case Variant::AABB: {
 
+			buf = p_encoder.reserve(6 * 4);
 			if (buf) {
 				AABB aabb = p_variant;
 				encode_float(aabb.position.x, &buf[0]);
@@ -1171,11 +1216,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_float(aabb.size.z, &buf[20]);
 			}
 
-			r_len += 6 * 4;
-
 		} break;
 		case Variant::BASIS: {
 
+			buf = p_encoder.reserve(9 * 4);
 			if (buf) {
 				Basis val = p_variant;
 				for (int i = 0; i < 3; i++) {
@@ -1186,11 +1230,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				}
 			}
 
-			r_len += 9 * 4;
-
 		} break;
 		case Variant::TRANSFORM: {
 
+			buf = p_encoder.reserve(12 * 4);
 			if (buf) {
 				Transform val = p_variant;
 				for (int i = 0; i < 3; i++) {
@@ -1205,13 +1248,12 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_float(val.origin.z, &buf[44]);
 			}
 
-			r_len += 12 * 4;
-
 		} break;
 
 		// misc types
 		case Variant::COLOR: {
 
+			buf = p_encoder.reserve(4 * 4);
 			if (buf) {
 				Color c = p_variant;
 				encode_float(c.r, &buf[0]);
@@ -1220,8 +1262,6 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_float(c.a, &buf[12]);
 			}
 
-			r_len += 4 * 4;
-
 		} break;
 		case Variant::_RID: {
 
@@ -1234,17 +1274,17 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} break;
 		case Variant::OBJECT: {
 
-			if (p_full_objects) {
+			if (p_encoder.full_objects) {
 
 				Object *obj = p_variant;
 				if (!obj) {
+					buf = p_encoder.reserve(4);
 					if (buf) {
 						encode_uint32(0, buf);
 					}
-					r_len += 4;
 
 				} else {
-					_encode_string(obj->get_class(), buf, r_len);
+					_encode_string(obj->get_class(), p_encoder);
 
 					List<PropertyInfo> props;
 					obj->get_property_list(&props);
@@ -1257,31 +1297,26 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 						pc++;
 					}
 
+					buf = p_encoder.reserve(4);
 					if (buf) {
 						encode_uint32(pc, buf);
-						buf += 4;
 					}
 
-					r_len += 4;
-
 					for (List<PropertyInfo>::Element *E = props.front(); E; E = E->next()) {
 
 						if (!(E->get().usage & PROPERTY_USAGE_STORAGE))
 							continue;
 
-						_encode_string(E->get().name, buf, r_len);
+						_encode_string(E->get().name, p_encoder);
 
-						int len;
-						Error err = encode_variant(obj->get(E->get().name), buf, len, p_full_objects);
+						Error err = _encode_variant(obj->get(E->get().name), p_encoder);
 						if (err)
 							return err;
-						ERR_FAIL_COND_V(len % 4, ERR_BUG);
-						r_len += len;
-						if (buf)
-							buf += len;
+						ERR_FAIL_COND_V(p_encoder.len % 4, ERR_BUG);
 					}
 				}
 			} else {
+				buf = p_encoder.reserve(8);
 				if (buf) {
 
 					Object *obj = p_variant.get_validated_object();
@@ -1292,8 +1327,6 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 					encode_uint64(id, buf);
 				}
-
-				r_len += 8;
 			}
 
 		} break;
@@ -1301,43 +1334,26 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			Dictionary d = p_variant;
 
+			buf = p_encoder.reserve(4);
 			if (buf) {
 				encode_uint32(uint32_t(d.size()), buf);
-				buf += 4;
 			}
-			r_len += 4;
 
 			List<Variant> keys;
 			d.get_key_list(&keys);
 
 			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
 
-				/*
-				CharString utf8 = E->->utf8();
-
-				if (buf) {
-					encode_uint32(utf8.length()+1,buf);
-					buf+=4;
-					copymem(buf,utf8.get_data(),utf8.length()+1);
-				}
-
-				r_len+=4+utf8.length()+1;
-				while (r_len%4)
-					r_len++; //pad
-				*/
-				int len;
-				encode_variant(E->get(), buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				Error err = _encode_variant(E->get(), p_encoder);
+				if (err)
+					return err;
+				ERR_FAIL_COND_V(p_encoder.len % 4, ERR_BUG);
 				Variant *v = d.getptr(E->get());
 				ERR_FAIL_COND_V(!v, ERR_BUG);
-				encode_variant(*v, buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				err = _encode_variant(*v, p_encoder);
+				if (err)
+					return err;
+				ERR_FAIL_COND_V(p_encoder.len % 4, ERR_BUG);
 			}
 
 		} break;
@@ -1345,21 +1361,17 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			Array v = p_variant;
 
+			buf = p_encoder.reserve(4);
 			if (buf) {
 				encode_uint32(uint32_t(v.size()), buf);
-				buf += 4;
 			}
 
-			r_len += 4;
-
 			for (int i = 0; i < v.size(); i++) {
 
-				int len;
-				encode_variant(v.get(i), buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				Error err = _encode_variant(v.get(i), p_encoder);
+				if (err)
+					return err;
+				ERR_FAIL_COND_V(p_encoder.len % 4, ERR_BUG);
 			}
 
 		} break;
@@ -1367,23 +1379,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		case Variant::PACKED_BYTE_ARRAY: {
 
 			Vector<uint8_t> data = p_variant;
-			int datalen = data.size();
-			int datasize = sizeof(uint8_t);
-
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
-				const uint8_t *r = data.ptr();
-				copymem(buf, &r[0], datalen * datasize);
-				buf += datalen * datasize;
-			}
-
-			r_len += 4 + datalen * datasize;
-			while (r_len % 4) {
-				r_len++;
-				if (buf)
-					*(buf++) = 0;
-			}
+			_encode_bytes(data.ptr(), data.size(), p_encoder);
 
 		} break;
 		case Variant::PACKED_INT32_ARRAY: {
@@ -1392,16 +1388,19 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			int datalen = data.size();
 			int datasize = sizeof(int32_t);
 
+			buf = p_encoder.reserve(4 + datalen * datasize);
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const int32_t *r = data.ptr();
+#ifdef COPY_PACKED_ARRAYS
+				copymem(buf, r, datalen * datasize);
+#else
 				for (int32_t i = 0; i < datalen; i++)
 					encode_uint32(r[i], &buf[i * datasize]);
+#endif
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::PACKED_INT64_ARRAY: {
 
@@ -1409,16 +1408,19 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			int datalen = data.size();
 			int datasize = sizeof(int64_t);
 
+			buf = p_encoder.reserve(4 + datalen * datasize);
 			if (buf) {
-				encode_uint64(datalen, buf);
+				encode_uint32(datalen, buf);
 				buf += 4;
 				const int64_t *r = data.ptr();
+#ifdef COPY_PACKED_ARRAYS
+				copymem(buf, r, datalen * datasize);
+#else
 				for (int64_t i = 0; i < datalen; i++)
 					encode_uint64(r[i], &buf[i * datasize]);
+#endif
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::PACKED_FLOAT32_ARRAY: {
 
@@ -1426,16 +1428,19 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			int datalen = data.size();
 			int datasize = sizeof(float);
 
+			buf = p_encoder.reserve(4 + datalen * datasize);
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const float *r = data.ptr();
+#ifdef COPY_PACKED_ARRAYS
+				copymem(buf, r, datalen * datasize);
+#else
 				for (int i = 0; i < datalen; i++)
 					encode_float(r[i], &buf[i * datasize]);
+#endif
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::PACKED_FLOAT64_ARRAY: {
 
@@ -1443,46 +1448,34 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			int datalen = data.size();
 			int datasize = sizeof(double);
 
+			buf = p_encoder.reserve(4 + datalen * datasize);
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const double *r = data.ptr();
+#ifdef COPY_PACKED_ARRAYS
+				copymem(buf, r, datalen * datasize);
+#else
 				for (int i = 0; i < datalen; i++)
 					encode_double(r[i], &buf[i * datasize]);
+#endif
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::PACKED_STRING_ARRAY: {
 
 			Vector<String> data = p_variant;
 			int len = data.size();
 
+			buf = p_encoder.reserve(4);
 			if (buf) {
 				encode_uint32(len, buf);
-				buf += 4;
 			}
 
-			r_len += 4;
-
 			for (int i = 0; i < len; i++) {
 
 				CharString utf8 = data.get(i).utf8();
-
-				if (buf) {
-					encode_uint32(utf8.length() + 1, buf);
-					buf += 4;
-					copymem(buf, utf8.get_data(), utf8.length() + 1);
-					buf += utf8.length() + 1;
-				}
-
-				r_len += 4 + utf8.length() + 1;
-				while (r_len % 4) {
-					r_len++; //pad
-					if (buf)
-						*(buf++) = 0;
-				}
+				_encode_bytes((const uint8_t *)utf8.get_data(), utf8.length() + 1, p_encoder);
 			}
 
 		} break;
@@ -1491,15 +1484,14 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			Vector<Vector2> data = p_variant;
 			int len = data.size();
 
+			buf = p_encoder.reserve(4 + 4 * 2 * len);
 			if (buf) {
 				encode_uint32(len, buf);
 				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
 
+#ifdef COPY_PACKED_VECTOR_ARRAYS
+				copymem(buf, data.ptr(), len * sizeof(Vector2));
+#else
 				for (int i = 0; i < len; i++) {
 
 					Vector2 v = data.get(i);
@@ -1508,25 +1500,23 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_float(v.y, &buf[4]);
 					buf += 4 * 2;
 				}
+#endif
 			}
 
-			r_len += 4 * 2 * len;
-
 		} break;
 		case Variant::PACKED_VECTOR3_ARRAY: {
 
 			Vector<Vector3> data = p_variant;
 			int len = data.size();
 
+			buf = p_encoder.reserve(4 + 4 * 3 * len);
 			if (buf) {
 				encode_uint32(len, buf);
 				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
 
+#ifdef COPY_PACKED_VECTOR_ARRAYS
+				copymem(buf, data.ptr(), len * sizeof(Vector3));
+#else
 				for (int i = 0; i < len; i++) {
 
 					Vector3 v = data.get(i);
@@ -1536,25 +1526,23 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_float(v.z, &buf[8]);
 					buf += 4 * 3;
 				}
+#endif
 			}
 
-			r_len += 4 * 3 * len;
-
 		} break;
 		case Variant::PACKED_COLOR_ARRAY: {
 
 			Vector<Color> data = p_variant;
 			int len = data.size();
 
+			buf = p_encoder.reserve(4 + 4 * 4 * len);
 			if (buf) {
 				encode_uint32(len, buf);
 				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
 
+#ifdef COPY_PACKED_ARRAYS
+				copymem(buf, data.ptr(), len * sizeof(Color));
+#else
 				for (int i = 0; i < len; i++) {
 
 					Color c = data.get(i);
@@ -1565,10 +1553,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_float(c.a, &buf[12]);
 					buf += 4 * 4;
 				}
+#endif
 			}
 
-			r_len += 4 * 4 * len;
-
 		} break;
 		default: {
 			ERR_FAIL_V(ERR_BUG);
@@ -1577,3 +1564,21 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 	return OK;
 }
+
+Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects) {
+
+	_VariantEncoder encoder(r_buffer, NULL, 0, p_full_objects);
+	Error err = _encode_variant(p_variant, encoder);
+	r_len = encoder.len;
+	return err;
+}
+
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int p_offset, int &r_len, bool p_full_objects) {
+
+	ERR_FAIL_COND_V(p_offset < 0 || p_offset > r_buffer.size(), ERR_INVALID_PARAMETER);
+
+	_VariantEncoder encoder(NULL, &r_buffer, p_offset, p_full_objects);
+	Error err = _encode_variant(p_variant, encoder);
+	r_len = encoder.len;
+	return err;
+}
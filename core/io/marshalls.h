@@ -201,5 +201,8 @@ public:
 
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = false);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false);
+// Encodes at p_offset of r_buffer in a single pass, growing it when needed. The size is never reduced,
+// so the same buffer can be reused for the next message; r_len is the size of this encoding.
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int p_offset, int &r_len, bool p_full_objects = false);
 
 #endif
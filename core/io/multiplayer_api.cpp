@@ -605,76 +605,73 @@ bool MultiplayerAPI::_send_confirm_path(Node *p_node, NodePath p_path, PathSentC
 #define ENCODE_16 1 << 5
 #define ENCODE_32 2 << 5
 #define ENCODE_64 3 << 5
-Error MultiplayerAPI::_encode_and_compress_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len) {
+Error MultiplayerAPI::_encode_and_compress_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int p_ofs, int &r_len) {
 
 	// Unreachable because `VARIANT_MAX` == 27 and `ENCODE_VARIANT_MASK` == 31
 	CRASH_COND(p_variant.get_type() > VARIANT_META_TYPE_MASK);
 
-	uint8_t *buf = r_buffer;
 	r_len = 0;
 	uint8_t encode_mode = 0;
 
 	switch (p_variant.get_type()) {
 		case Variant::BOOL: {
-			if (buf) {
-				// We still have 1 free bit in the meta, so let's use it.
-				buf[0] = (p_variant.operator bool()) ? (1 << 7) : 0;
-				buf[0] |= encode_mode | p_variant.get_type();
-			}
-			r_len += 1;
+			r_len = 1;
+			if (r_buffer.size() < p_ofs + r_len)
+				r_buffer.resize(p_ofs + r_len);
+			uint8_t *buf = r_buffer.ptrw() + p_ofs;
+			// We still have 1 free bit in the meta, so let's use it.
+			buf[0] = (p_variant.operator bool()) ? (1 << 7) : 0;
+			buf[0] |= encode_mode | p_variant.get_type();
 		} break;
 		case Variant::INT: {
-			if (buf) {
-				// Reserve the first byte for the meta.
-				buf += 1;
-			}
-			r_len += 1;
+			// The first byte is reserved for the meta.
 			int64_t val = p_variant;
 			if (val <= (int64_t)INT8_MAX && val >= (int64_t)INT8_MIN) {
 				// Use 8 bit
 				encode_mode = ENCODE_8;
-				if (buf) {
-					buf[0] = val;
-				}
-				r_len += 1;
+				r_len = 1 + 1;
 			} else if (val <= (int64_t)INT16_MAX && val >= (int64_t)INT16_MIN) {
 				// Use 16 bit
 				encode_mode = ENCODE_16;
-				if (buf) {
-					encode_uint16(val, buf);
-				}
-				r_len += 2;
+				r_len = 1 + 2;
 			} else if (val <= (int64_t)INT32_MAX && val >= (int64_t)INT32_MIN) {
 				// Use 32 bit
 				encode_mode = ENCODE_32;
-				if (buf) {
-					encode_uint32(val, buf);
-				}
-				r_len += 4;
+				r_len = 1 + 4;
 			} else {
 				// Use 64 bit
 				encode_mode = ENCODE_64;
-				if (buf) {
-					encode_uint64(val, buf);
-				}
-				r_len += 8;
+				r_len = 1 + 8;
 			}
+			if (r_buffer.size() < p_ofs + r_len)
+				r_buffer.resize(p_ofs + r_len);
+			uint8_t *buf = r_buffer.ptrw() + p_ofs;
 			// Store the meta
-			if (buf) {
-				buf -= 1;
-				buf[0] = encode_mode | p_variant.get_type();
+			buf[0] = encode_mode | p_variant.get_type();
+			buf += 1;
+			switch (encode_mode) {
+				case ENCODE_8: {
+					buf[0] = val;
+				} break;
+				case ENCODE_16: {
+					encode_uint16(val, buf);
+				} break;
+				case ENCODE_32: {
+					encode_uint32(val, buf);
+				} break;
+				default: {
+					encode_uint64(val, buf);
+				}
 			}
 		} break;
 		default:
 			// Any other case is not yet compressed.
-			Error err = encode_variant(p_variant, r_buffer, r_len, allow_object_decoding);
+			Error err = encode_variant(p_variant, r_buffer, p_ofs, r_len, allow_object_decoding);
 			if (err != OK)
 				return err;
-			if (r_buffer) {
-				// The first byte is not used by the marshaling, so store the type
-				// so we know how to decompress and decode this variant.
-				r_buffer[0] = p_variant.get_type();
-			}
+			// The first byte is not used by the marshaling, so store the type
+			// so we know how to decompress and decode this variant.
+			r_buffer.write[p_ofs] = p_variant.get_type();
 	}
 
 	return OK;
@@ -851,10 +848,8 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 
 		// Set argument.
 		int len(0);
-		Error err = _encode_and_compress_variant(*p_arg[0], NULL, len);
+		Error err = _encode_and_compress_variant(*p_arg[0], packet_cache, ofs, len);
 		ERR_FAIL_COND_MSG(err != OK, "Unable to encode RSET value. THIS IS LIKELY A BUG IN THE ENGINE!");
-		MAKE_ROOM(ofs + len);
-		_encode_and_compress_variant(*p_arg[0], &(packet_cache.write[ofs]), len);
 		ofs += len;
 
 	} else {
@@ -895,10 +890,8 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 			ofs += 1;
 			for (int i = 0; i < p_argcount; i++) {
 				int len(0);
-				Error err = _encode_and_compress_variant(*p_arg[i], NULL, len);
+				Error err = _encode_and_compress_variant(*p_arg[i], packet_cache, ofs, len);
 				ERR_FAIL_COND_MSG(err != OK, "Unable to encode RPC argument. THIS IS LIKELY A BUG IN THE ENGINE!");
-				MAKE_ROOM(ofs + len);
-				_encode_and_compress_variant(*p_arg[i], &(packet_cache.write[ofs]), len);
 				ofs += len;
 			}
 		}
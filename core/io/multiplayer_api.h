@@ -106,7 +106,7 @@ protected:
 	void _send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
 	bool _send_confirm_path(Node *p_node, NodePath p_path, PathSentCache *psc, int p_target);
 
-	Error _encode_and_compress_variant(const Variant &p_variant, uint8_t *p_buffer, int &r_len);
+	Error _encode_and_compress_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int p_ofs, int &r_len);
 	Error _decode_and_decompress_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len);
 
 public:
@@ -30,6 +30,7 @@
 
 #include "pck_packer.h"
 
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
 #include "core/os/file_access.h"
 #include "core/version.h"
@@ -57,7 +58,8 @@ static void _pad(FileAccess *p_file, int p_bytes) {
 void PCKPacker::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment"), &PCKPacker::pck_start, DEFVAL(0));
-	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path"), &PCKPacker::add_file);
+	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "compress"), &PCKPacker::add_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("order_by_access_trace", "trace_path"), &PCKPacker::order_by_access_trace);
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 };
 
@@ -89,7 +91,7 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
 	return OK;
 };
 
-Error PCKPacker::add_file(const String &p_file, const String &p_src) {
+Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_compress) {
 
 	FileAccess *f = FileAccess::open(p_src, FileAccess::READ);
 	if (!f) {
@@ -100,7 +102,12 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src) {
 	pf.path = p_file;
 	pf.src_path = p_src;
 	pf.size = f->get_len();
-	pf.offset_offset = 0;
+	pf.compress = p_compress;
+	pf.ofs = 0;
+	pf.stored_size = pf.size;
+	pf.flags = 0;
+	pf.order = 0;
+	pf.path_md5 = p_file.md5_buffer();
 
 	files.push_back(pf);
 
@@ -110,31 +117,58 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src) {
 	return OK;
 };
 
+bool PCKPacker::FileHashComparator::operator()(const File &p_a, const File &p_b) const {
+
+	return memcmp(p_a.path_md5.ptr(), p_b.path_md5.ptr(), 16) < 0;
+}
+
+Error PCKPacker::order_by_access_trace(const String &p_trace) {
+
+	// One path per line, in the order the files were first opened (see --pack-access-trace).
+	FileAccess *f = FileAccess::open(p_trace, FileAccess::READ);
+	if (!f) {
+		return ERR_FILE_CANT_OPEN;
+	};
+
+	access_order.clear();
+	while (!f->eof_reached()) {
+
+		String path = f->get_line().strip_edges();
+		if (path != "" && !access_order.has(path)) {
+			int idx = access_order.size();
+			access_order[path] = idx;
+		}
+	};
+
+	f->close();
+	memdelete(f);
+
+	return OK;
+};
+
 Error PCKPacker::flush(bool p_verbose) {
 
 	ERR_FAIL_COND_V_MSG(!file, ERR_INVALID_PARAMETER, "File must be opened before use.");
 
-	// write the index
-
-	file->store_32(files.size());
+	// store the data first, files in the access trace first so reading them at startup is sequential
 
+	uint32_t path_table_size = 0;
 	for (int i = 0; i < files.size(); i++) {
 
-		file->store_pascal_string(files[i].path);
-		files.write[i].offset_offset = file->get_position();
-		file->store_64(0); // offset
-		file->store_64(files[i].size); // size
-
-		// # empty md5
-		file->store_32(0);
-		file->store_32(0);
-		file->store_32(0);
-		file->store_32(0);
+		const int *order = access_order.getptr(files[i].path);
+		files.write[i].order = order ? *order : access_order.size() + i;
+		path_table_size += files[i].path.utf8().length() + 1;
 	};
 
-	uint64_t ofs = file->get_position();
-	ofs = _align(ofs, alignment);
+	files.sort_custom<FileOrderComparator>();
 
+	// the index is written last, compressed sizes are only known once stored
+	uint64_t index_ofs = file->get_position();
+	file->store_32(files.size());
+	file->store_32(path_table_size);
+	_pad(file, files.size() * PACK_INDEX_ENTRY_SIZE + path_table_size);
+
+	uint64_t ofs = _align(file->get_position(), alignment);
 	_pad(file, ofs - file->get_position());
 
 	const uint32_t buf_max = 65536;
@@ -143,21 +177,40 @@ Error PCKPacker::flush(bool p_verbose) {
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
 
-		FileAccess *src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
-		while (to_write > 0) {
+		File &pf = files.write[i];
+		pf.ofs = ofs;
 
-			int read = src->get_buffer(buf, MIN(to_write, buf_max));
-			file->store_buffer(buf, read);
-			to_write -= read;
-		};
+		FileAccess *src = FileAccess::open(pf.src_path, FileAccess::READ);
 
-		uint64_t pos = file->get_position();
-		file->seek(files[i].offset_offset); // go back to store the file's offset
-		file->store_64(ofs);
-		file->seek(pos);
+		if (pf.compress) {
 
-		ofs = _align(ofs + files[i].size, alignment);
+			Vector<uint8_t> data;
+			data.resize(pf.size);
+			src->get_buffer(data.ptrw(), pf.size);
+
+			// only keep it compressed if that saves space (the file may be compressed already)
+			Vector<uint8_t> compressed = FileAccessCompressed::compress_buffer(data.ptr(), data.size(), PACK_COMPRESSED_MAGIC, Compression::MODE_ZSTD, PACK_COMPRESSED_BLOCK_SIZE);
+			if (compressed.size() > 0 && compressed.size() < data.size() - data.size() / 16) {
+				file->store_buffer(compressed.ptr(), compressed.size());
+				pf.stored_size = compressed.size();
+				pf.flags = PACK_FILE_COMPRESSED;
+			} else {
+				file->store_buffer(data.ptr(), data.size());
+			}
+
+		} else {
+
+			uint64_t to_write = pf.size;
+			while (to_write > 0) {
+
+				int read = src->get_buffer(buf, MIN(to_write, buf_max));
+				file->store_buffer(buf, read);
+				to_write -= read;
+			};
+		}
+
+		uint64_t pos = file->get_position();
+		ofs = _align(pos, alignment);
 		_pad(file, ofs - pos);
 
 		src->close();
@@ -174,9 +227,39 @@ Error PCKPacker::flush(bool p_verbose) {
 	if (p_verbose)
 		printf("\n");
 
-	file->close();
 	memdelete_arr(buf);
 
+	// write the index, sorted by path hash so it doesn't depend on the data order
+
+	Vector<File> index = files;
+	index.sort_custom<FileHashComparator>();
+
+	file->seek(index_ofs + 8);
+
+	for (int i = 0; i < index.size(); i++) {
+
+		file->store_buffer(index[i].path_md5.ptr(), 16);
+		file->store_64(index[i].ofs);
+		file->store_64(index[i].stored_size);
+
+		// # empty md5
+		file->store_32(0);
+		file->store_32(0);
+		file->store_32(0);
+		file->store_32(0);
+
+		file->store_32(index[i].flags);
+		file->store_32(0); // reserved
+	};
+
+	for (int i = 0; i < index.size(); i++) {
+
+		CharString path = index[i].path.utf8();
+		file->store_buffer((const uint8_t *)path.get_data(), path.length() + 1);
+	};
+
+	file->close();
+
 	return OK;
 };
 
@@ -31,6 +31,7 @@
 #ifndef PCK_PACKER_H
 #define PCK_PACKER_H
 
+#include "core/hash_map.h"
 #include "core/reference.h"
 
 class FileAccess;
@@ -49,13 +50,29 @@ class PCKPacker : public Reference {
 		String path;
 		String src_path;
 		int size;
-		uint64_t offset_offset;
+		bool compress;
+		uint64_t ofs;
+		uint64_t stored_size;
+		uint32_t flags;
+		uint64_t order;
+		Vector<uint8_t> path_md5;
 	};
 	Vector<File> files;
 
+	HashMap<String, int> access_order;
+
+	struct FileHashComparator {
+		bool operator()(const File &p_a, const File &p_b) const;
+	};
+
+	struct FileOrderComparator {
+		bool operator()(const File &p_a, const File &p_b) const { return p_a.order < p_b.order; }
+	};
+
 public:
 	Error pck_start(const String &p_file, int p_alignment = 0);
-	Error add_file(const String &p_file, const String &p_src);
+	Error add_file(const String &p_file, const String &p_src, bool p_compress = false);
+	Error order_by_access_trace(const String &p_trace);
 	Error flush(bool p_verbose = false);
 
 	PCKPacker();
@@ -33,6 +33,7 @@
 #include "core/image.h"
 #include "core/io/file_access_compressed.h"
 #include "core/io/marshalls.h"
+#include "core/os/copymem.h"
 #include "core/os/dir_access.h"
 #include "core/project_settings.h"
 #include "core/version.h"
@@ -87,9 +88,12 @@ enum {
 	OBJECT_EXTERNAL_RESOURCE_INDEX = 3,
 	//version 2: added 64 bits support for float and int
 	//version 3: changed nodepath encoding
-	FORMAT_VERSION = 3,
+	//version 4: packed array payloads are preceded by padding, so they are aligned in the file
+	FORMAT_VERSION = 4,
 	FORMAT_VERSION_CAN_RENAME_DEPS = 1,
 	FORMAT_VERSION_NO_NODEPATH_PROPERTY = 3,
+	FORMAT_VERSION_ALIGNED_ARRAYS = 4,
+	ARRAY_PAYLOAD_ALIGNMENT = 16,
 
 };
 
@@ -102,6 +106,29 @@ void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
 	}
 }
 
+void ResourceLoaderBinary::_read_array_payload(uint8_t *p_dst, uint64_t p_size) {
+
+	if (ver_format >= FORMAT_VERSION_ALIGNED_ARRAYS) {
+		uint8_t padding = f->get_8();
+		if (padding) {
+			f->seek(f->get_position() + padding);
+		}
+	}
+
+	if (p_size == 0) {
+		return;
+	}
+
+	// Copy straight out of the mapping when the file is mapped (plain files, or packs),
+	// otherwise this is a single bulk read.
+	const uint8_t *mapped = f->get_buffer_ptr(p_size);
+	if (mapped) {
+		copymem(p_dst, mapped, p_size);
+	} else {
+		f->get_buffer(p_dst, p_size);
+	}
+}
+
 StringName ResourceLoaderBinary::_get_string() {
 
 	uint32_t id = f->get_32();
@@ -379,9 +406,10 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 
 						if (external_resources[erindex].cache.is_null()) {
 							//cache not here yet, wait for it?
-							if (use_sub_threads) {
+							if (external_resources[erindex].pending) {
 								Error err;
 								external_resources.write[erindex].cache = ResourceLoader::load_threaded_get(external_resources[erindex].path, &err);
+								external_resources.write[erindex].pending = false;
 
 								if (err != OK || external_resources[erindex].cache.is_null()) {
 									if (!ResourceLoader::get_abort_on_missing_resources()) {
@@ -454,7 +482,7 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<uint8_t> array;
 			array.resize(len);
 			uint8_t *w = array.ptrw();
-			f->get_buffer(w, len);
+			_read_array_payload(w, len);
 			_advance_padding(len);
 
 			r_v = array;
@@ -467,7 +495,7 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<int32_t> array;
 			array.resize(len);
 			int32_t *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(int32_t));
+			_read_array_payload((uint8_t *)w, len * sizeof(int32_t));
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint32_t *ptr = (uint32_t *)w.ptr();
@@ -488,7 +516,7 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<int64_t> array;
 			array.resize(len);
 			int64_t *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(int64_t));
+			_read_array_payload((uint8_t *)w, len * sizeof(int64_t));
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint64_t *ptr = (uint64_t *)w.ptr();
@@ -509,7 +537,7 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<float> array;
 			array.resize(len);
 			float *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(float));
+			_read_array_payload((uint8_t *)w, len * sizeof(float));
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint32_t *ptr = (uint32_t *)w.ptr();
@@ -530,7 +558,7 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<double> array;
 			array.resize(len);
 			double *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(double));
+			_read_array_payload((uint8_t *)w, len * sizeof(double));
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint64_t *ptr = (uint64_t *)w.ptr();
@@ -564,7 +592,7 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			array.resize(len);
 			Vector2 *w = array.ptrw();
 			if (sizeof(Vector2) == 8) {
-				f->get_buffer((uint8_t *)w, len * sizeof(real_t) * 2);
+				_read_array_payload((uint8_t *)w, len * sizeof(real_t) * 2);
 #ifdef BIG_ENDIAN_ENABLED
 				{
 					uint32_t *ptr = (uint32_t *)w.ptr();
@@ -591,7 +619,7 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			array.resize(len);
 			Vector3 *w = array.ptrw();
 			if (sizeof(Vector3) == 12) {
-				f->get_buffer((uint8_t *)w, len * sizeof(real_t) * 3);
+				_read_array_payload((uint8_t *)w, len * sizeof(real_t) * 3);
 #ifdef BIG_ENDIAN_ENABLED
 				{
 					uint32_t *ptr = (uint32_t *)w.ptr();
@@ -618,7 +646,7 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			array.resize(len);
 			Color *w = array.ptrw();
 			if (sizeof(Color) == 16) {
-				f->get_buffer((uint8_t *)w, len * sizeof(real_t) * 4);
+				_read_array_payload((uint8_t *)w, len * sizeof(real_t) * 4);
 #ifdef BIG_ENDIAN_ENABLED
 				{
 					uint32_t *ptr = (uint32_t *)w.ptr();
@@ -690,8 +718,12 @@ Error ResourceLoaderBinary::load() {
 			}
 
 		} else {
+			// All dependencies are requested up front so they load concurrently,
+			// the first property referencing one waits for it.
 			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, local_path);
-			if (err != OK) {
+			if (err == OK) {
+				external_resources.write[i].pending = true;
+			} else {
 				if (!ResourceLoader::get_abort_on_missing_resources()) {
 
 					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
@@ -1019,6 +1051,13 @@ ResourceLoaderBinary::ResourceLoaderBinary() :
 
 ResourceLoaderBinary::~ResourceLoaderBinary() {
 
+	// Dependencies nothing referenced (or left behind by an error) still hold a request.
+	for (int i = 0; i < external_resources.size(); i++) {
+		if (external_resources[i].pending) {
+			ResourceLoader::load_threaded_get(external_resources[i].path);
+		}
+	}
+
 	if (f)
 		memdelete(f);
 }
@@ -1329,6 +1368,25 @@ void ResourceFormatSaverBinaryInstance::_pad_buffer(FileAccess *f, int p_bytes)
 	}
 }
 
+void ResourceFormatSaverBinaryInstance::_align_array_payload(FileAccess *f) {
+
+	// The padding length is stored first, so payloads stay readable even if
+	// the data is later shifted (as when dependencies are renamed).
+	uint32_t padding = (ARRAY_PAYLOAD_ALIGNMENT - ((f->get_position() + 1) % ARRAY_PAYLOAD_ALIGNMENT)) % ARRAY_PAYLOAD_ALIGNMENT;
+	f->store_8(padding);
+	for (uint32_t i = 0; i < padding; i++)
+		f->store_8(0);
+}
+
+bool ResourceFormatSaverBinaryInstance::_can_store_array_payload(FileAccess *f) {
+
+#ifdef BIG_ENDIAN_ENABLED
+	return false;
+#else
+	return !f->get_endian_swap();
+#endif
+}
+
 void ResourceFormatSaverBinaryInstance::_write_variant(const Variant &p_property, const PropertyInfo &p_hint) {
 
 	write_variant(f, p_property, resource_set, external_resources, string_map, p_hint);
@@ -1637,6 +1695,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Vector<uint8_t> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array_payload(f);
 			const uint8_t *r = arr.ptr();
 			f->store_buffer(r, len);
 			_pad_buffer(f, len);
@@ -1648,9 +1707,14 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Vector<int32_t> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array_payload(f);
 			const int32_t *r = arr.ptr();
-			for (int i = 0; i < len; i++)
-				f->store_32(r[i]);
+			if (_can_store_array_payload(f)) {
+				f->store_buffer((const uint8_t *)r, len * sizeof(int32_t));
+			} else {
+				for (int i = 0; i < len; i++)
+					f->store_32(r[i]);
+			}
 
 		} break;
 		case Variant::PACKED_INT64_ARRAY: {
@@ -1659,9 +1723,14 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Vector<int64_t> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array_payload(f);
 			const int64_t *r = arr.ptr();
-			for (int i = 0; i < len; i++)
-				f->store_64(r[i]);
+			if (_can_store_array_payload(f)) {
+				f->store_buffer((const uint8_t *)r, len * sizeof(int64_t));
+			} else {
+				for (int i = 0; i < len; i++)
+					f->store_64(r[i]);
+			}
 
 		} break;
 		case Variant::PACKED_FLOAT32_ARRAY: {
@@ -1670,9 +1739,14 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Vector<float> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array_payload(f);
 			const float *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i]);
+			if (_can_store_array_payload(f)) {
+				f->store_buffer((const uint8_t *)r, len * sizeof(float));
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_float(r[i]);
+				}
 			}
 
 		} break;
@@ -1682,9 +1756,14 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Vector<double> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array_payload(f);
 			const double *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_double(r[i]);
+			if (_can_store_array_payload(f)) {
+				f->store_buffer((const uint8_t *)r, len * sizeof(double));
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_double(r[i]);
+				}
 			}
 
 		} break;
@@ -1706,11 +1785,16 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Vector<Vector3> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array_payload(f);
 			const Vector3 *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i].x);
-				f->store_real(r[i].y);
-				f->store_real(r[i].z);
+			if (sizeof(Vector3) == 12 && _can_store_array_payload(f)) {
+				f->store_buffer((const uint8_t *)r, len * sizeof(Vector3));
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i].x);
+					f->store_real(r[i].y);
+					f->store_real(r[i].z);
+				}
 			}
 
 		} break;
@@ -1720,10 +1804,15 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Vector<Vector2> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array_payload(f);
 			const Vector2 *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i].x);
-				f->store_real(r[i].y);
+			if (sizeof(Vector2) == 8 && _can_store_array_payload(f)) {
+				f->store_buffer((const uint8_t *)r, len * sizeof(Vector2));
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i].x);
+					f->store_real(r[i].y);
+				}
 			}
 
 		} break;
@@ -1733,12 +1822,17 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Vector<Color> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array_payload(f);
 			const Color *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i].r);
-				f->store_real(r[i].g);
-				f->store_real(r[i].b);
-				f->store_real(r[i].a);
+			if (sizeof(Color) == 16 && _can_store_array_payload(f)) {
+				f->store_buffer((const uint8_t *)r, len * sizeof(Color));
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i].r);
+					f->store_real(r[i].g);
+					f->store_real(r[i].b);
+					f->store_real(r[i].a);
+				}
 			}
 
 		} break;
@@ -59,6 +59,7 @@ class ResourceLoaderBinary {
 		String path;
 		String type;
 		RES cache;
+		bool pending = false; // Requested on a sub-thread, not yet taken.
 	};
 
 	bool use_sub_threads;
@@ -74,6 +75,7 @@ class ResourceLoaderBinary {
 
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
+	void _read_array_payload(uint8_t *p_dst, uint64_t p_size);
 
 	Map<String, String> remaps;
 	Error error;
@@ -150,6 +152,8 @@ class ResourceFormatSaverBinaryInstance {
 	};
 
 	static void _pad_buffer(FileAccess *f, int p_bytes);
+	static void _align_array_payload(FileAccess *f);
+	static bool _can_store_array_payload(FileAccess *f);
 	void _write_variant(const Variant &p_property, const PropertyInfo &p_hint = PropertyInfo());
 	void _find_resources(const Variant &p_variant, bool p_main = false);
 	static void save_unicode_string(FileAccess *f, const String &p_string, bool p_bit_on_len = false);
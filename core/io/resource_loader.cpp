@@ -301,11 +301,8 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Threading loading resource'" + local_path + " failed: Source specified: '" + p_source_resource + "' but was not called by it.");
 		}
 
-		//must not be already added as s sub tasks
-		if (thread_load_tasks[p_source_resource].sub_tasks.has(local_path)) {
-			thread_load_mutex->unlock();
-			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Thread loading source resource '" + p_source_resource + "' already is loading '" + local_path + "'.");
-		}
+		// The same dependency may be requested more than once by a source (for example
+		// when listed twice); every request is counted and must be matched by a get.
 	}
 
 	if (thread_load_tasks.has(local_path)) {
@@ -326,7 +323,7 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 		load_task.remapped_path = _path_remap(local_path, &load_task.xl_remapped);
 		load_task.local_path = local_path;
 		load_task.type_hint = p_type_hint;
-		load_task.use_sub_threads = p_use_sub_threads;
+		load_task.use_sub_threads = p_use_sub_threads || load_dependencies_in_parallel;
 
 		{ //must check if resource is already loaded before attempting to load it in a thread
 
@@ -583,6 +580,7 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 		load_task.remapped_path = _path_remap(local_path, &load_task.xl_remapped);
 		load_task.type_hint = p_type_hint;
 		load_task.loader_id = Thread::get_caller_id();
+		load_task.use_sub_threads = load_dependencies_in_parallel;
 
 		thread_load_tasks[local_path] = load_task;
 
@@ -1147,6 +1145,7 @@ DependencyErrorNotify ResourceLoader::dep_err_notify = NULL;
 void *ResourceLoader::dep_err_notify_ud = NULL;
 
 bool ResourceLoader::abort_on_missing_resource = true;
+bool ResourceLoader::load_dependencies_in_parallel = false;
 bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
@@ -90,6 +90,7 @@ private:
 	static void *dep_err_notify_ud;
 	static DependencyErrorNotify dep_err_notify;
 	static bool abort_on_missing_resource;
+	static bool load_dependencies_in_parallel;
 	static HashMap<String, Vector<String> > translation_remaps;
 	static HashMap<String, String> path_remaps;
 
@@ -178,6 +179,9 @@ public:
 	static void set_abort_on_missing_resources(bool p_abort) { abort_on_missing_resource = p_abort; }
 	static bool get_abort_on_missing_resources() { return abort_on_missing_resource; }
 
+	static void set_load_dependencies_in_parallel(bool p_enable) { load_dependencies_in_parallel = p_enable; }
+	static bool is_loading_dependencies_in_parallel() { return load_dependencies_in_parallel; }
+
 	static String path_remap(const String &p_path);
 	static String import_remap(const String &p_path);
 
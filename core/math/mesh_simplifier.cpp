@@ -0,0 +1,361 @@
+/*************************************************************************/
+/*  mesh_simplifier.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "mesh_simplifier.h"
+
+#include "core/hash_map.h"
+#include "core/os/copymem.h"
+
+void MeshSimplifier::Quadric::add_plane(const Vector3 &p_normal, double p_d, double p_weight) {
+
+	// Plane equation is normal.dot(point) - d = 0.
+	double a = p_normal.x;
+	double b = p_normal.y;
+	double c = p_normal.z;
+	double d = -p_d;
+
+	a00 += p_weight * a * a;
+	a01 += p_weight * a * b;
+	a02 += p_weight * a * c;
+	a03 += p_weight * a * d;
+	a11 += p_weight * b * b;
+	a12 += p_weight * b * c;
+	a13 += p_weight * b * d;
+	a22 += p_weight * c * c;
+	a23 += p_weight * c * d;
+	a33 += p_weight * d * d;
+	weight += p_weight;
+}
+
+void MeshSimplifier::Quadric::operator+=(const Quadric &p_q) {
+
+	a00 += p_q.a00;
+	a01 += p_q.a01;
+	a02 += p_q.a02;
+	a03 += p_q.a03;
+	a11 += p_q.a11;
+	a12 += p_q.a12;
+	a13 += p_q.a13;
+	a22 += p_q.a22;
+	a23 += p_q.a23;
+	a33 += p_q.a33;
+	weight += p_q.weight;
+}
+
+double MeshSimplifier::Quadric::evaluate(const Vector3 &p_point) const {
+
+	if (weight <= 0) {
+		return 0;
+	}
+
+	double x = p_point.x;
+	double y = p_point.y;
+	double z = p_point.z;
+
+	double r = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x;
+	r += a11 * y * y + 2 * a12 * y * z + 2 * a13 * y;
+	r += a22 * z * z + 2 * a23 * z;
+	r += a33;
+
+	// Area weighted, so normalize to get a squared distance.
+	return MAX(r, 0.0) / weight;
+}
+
+bool MeshSimplifier::_collapse_flips_triangle(const Vector3 *p_vertices, const uint32_t *p_indices, const uint32_t *p_adjacency, uint32_t p_adjacency_count, uint32_t p_from, uint32_t p_to) {
+
+	for (uint32_t i = 0; i < p_adjacency_count; i++) {
+
+		const uint32_t *tri = &p_indices[p_adjacency[i] * 3];
+
+		if (tri[0] == p_to || tri[1] == p_to || tri[2] == p_to) {
+			continue; // This triangle is removed by the collapse.
+		}
+
+		Vector3 v[3] = { p_vertices[tri[0]], p_vertices[tri[1]], p_vertices[tri[2]] };
+		Vector3 normal_before = (v[1] - v[0]).cross(v[2] - v[0]);
+
+		for (int j = 0; j < 3; j++) {
+			if (tri[j] == p_from) {
+				v[j] = p_vertices[p_to];
+			}
+		}
+
+		Vector3 normal_after = (v[1] - v[0]).cross(v[2] - v[0]);
+
+		// Reject flipped, degenerate or strongly rotated triangles.
+		if (normal_after.dot(normal_before) <= 0.25 * normal_after.length() * normal_before.length()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+Vector<int> MeshSimplifier::simplify(const Vector<Vector3> &p_vertices, const Vector<int> &p_indices, int p_target_index_count, float p_target_error, float *r_error) {
+
+	ERR_FAIL_COND_V(p_indices.size() % 3 != 0, p_indices);
+
+	if (r_error) {
+		*r_error = 0;
+	}
+
+	uint32_t vertex_count = p_vertices.size();
+	const Vector3 *vertices = p_vertices.ptr();
+
+	Vector<uint32_t> indices;
+	indices.resize(p_indices.size());
+	{
+		uint32_t *w = indices.ptrw();
+		const int *r = p_indices.ptr();
+		for (int i = 0; i < p_indices.size(); i++) {
+			ERR_FAIL_UNSIGNED_INDEX_V((uint32_t)r[i], vertex_count, p_indices);
+			w[i] = r[i];
+		}
+	}
+
+	/* COMPUTE VERTEX QUADRICS */
+
+	Vector<Quadric> quadrics;
+	quadrics.resize(vertex_count);
+	{
+		Quadric *w = quadrics.ptrw();
+		const uint32_t *r = indices.ptr();
+
+		for (int i = 0; i < indices.size(); i += 3) {
+
+			const Vector3 &p0 = vertices[r[i + 0]];
+			Vector3 normal = (vertices[r[i + 1]] - p0).cross(vertices[r[i + 2]] - p0);
+			real_t area2 = normal.length();
+			if (area2 == 0) {
+				continue;
+			}
+			normal /= area2;
+			double d = normal.dot(p0);
+
+			for (int j = 0; j < 3; j++) {
+				w[r[i + j]].add_plane(normal, d, area2 * 0.5);
+			}
+		}
+	}
+
+	/* LOCK BORDER AND NON-MANIFOLD VERTICES */
+
+	// In an indexed mesh, attribute seams (UV, normal splits) show up as borders too, so locking
+	// borders keeps both the silhouette of open meshes and the texture mapping intact.
+
+	Vector<uint8_t> border;
+	border.resize(vertex_count);
+	{
+		HashMap<uint64_t, uint32_t> edge_use;
+		const uint32_t *r = indices.ptr();
+
+		for (int i = 0; i < indices.size(); i += 3) {
+			for (int j = 0; j < 3; j++) {
+				uint64_t a = r[i + j];
+				uint64_t b = r[i + (j + 1) % 3];
+				uint64_t key = a < b ? (a << 32) | b : (b << 32) | a;
+				uint32_t *use = edge_use.getptr(key);
+				if (use) {
+					(*use)++;
+				} else {
+					edge_use.set(key, 1);
+				}
+			}
+		}
+
+		uint8_t *w = border.ptrw();
+		zeromem(w, vertex_count);
+
+		const uint64_t *k = NULL;
+		while ((k = edge_use.next(k))) {
+			if (edge_use[*k] != 2) {
+				w[*k >> 32] = 1;
+				w[*k & 0xFFFFFFFF] = 1;
+			}
+		}
+	}
+
+	/* COLLAPSE EDGES IN PASSES */
+
+	double max_error = double(p_target_error) * double(p_target_error);
+	double result_error = 0;
+	uint32_t target_triangles = MAX(p_target_index_count, 0) / 3;
+
+	Vector<uint32_t> adjacency_offsets;
+	adjacency_offsets.resize(vertex_count + 1);
+	Vector<uint32_t> adjacency;
+	Vector<uint32_t> remap;
+	remap.resize(vertex_count);
+	Vector<uint8_t> pass_locked;
+	pass_locked.resize(vertex_count);
+
+	while (uint32_t(indices.size() / 3) > target_triangles) {
+
+		uint32_t triangle_count = indices.size() / 3;
+		const uint32_t *idx = indices.ptr();
+
+		// Vertex to triangle adjacency, stored contiguously.
+		uint32_t *offsets = adjacency_offsets.ptrw();
+		zeromem(offsets, sizeof(uint32_t) * (vertex_count + 1));
+		for (int i = 0; i < indices.size(); i++) {
+			offsets[idx[i] + 1]++;
+		}
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			offsets[i + 1] += offsets[i];
+		}
+		adjacency.resize(indices.size());
+		{
+			uint32_t *w = adjacency.ptrw();
+			Vector<uint32_t> fill = adjacency_offsets;
+			uint32_t *f = fill.ptrw();
+			for (int i = 0; i < indices.size(); i++) {
+				w[f[idx[i]]++] = i / 3;
+			}
+		}
+
+		// Gather collapse candidates, cheapest first.
+		Vector<Collapse> collapses;
+		{
+			const Quadric *q = quadrics.ptr();
+			const uint8_t *b = border.ptr();
+
+			for (int i = 0; i < indices.size(); i += 3) {
+				for (int j = 0; j < 3; j++) {
+					uint32_t v0 = idx[i + j];
+					uint32_t v1 = idx[i + (j + 1) % 3];
+					Quadric sum = q[v0];
+					sum += q[v1];
+
+					if (!b[v0]) {
+						Collapse c;
+						c.from = v0;
+						c.to = v1;
+						c.error = sum.evaluate(vertices[v1]);
+						collapses.push_back(c);
+					}
+					if (!b[v1]) {
+						Collapse c;
+						c.from = v1;
+						c.to = v0;
+						c.error = sum.evaluate(vertices[v0]);
+						collapses.push_back(c);
+					}
+				}
+			}
+		}
+		collapses.sort();
+
+		uint32_t *rm = remap.ptrw();
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			rm[i] = i;
+		}
+		uint8_t *locked = pass_locked.ptrw();
+		zeromem(locked, vertex_count);
+
+		Quadric *q = quadrics.ptrw();
+		const uint32_t *adj = adjacency.ptr();
+		uint32_t collapsed = 0;
+
+		for (int i = 0; i < collapses.size(); i++) {
+
+			const Collapse &c = collapses[i];
+
+			if (c.error > max_error || triangle_count <= target_triangles) {
+				break;
+			}
+
+			if (locked[c.from] || locked[c.to]) {
+				continue;
+			}
+
+			const uint32_t *from_adj = &adj[offsets[c.from]];
+			uint32_t from_adj_count = offsets[c.from + 1] - offsets[c.from];
+
+			if (_collapse_flips_triangle(vertices, idx, from_adj, from_adj_count, c.from, c.to)) {
+				continue;
+			}
+
+			rm[c.from] = c.to;
+			q[c.to] += q[c.from];
+			result_error = MAX(result_error, c.error);
+
+			// Triangles around the collapsed vertex changed, so keep them untouched until the next pass.
+			for (uint32_t j = 0; j < from_adj_count; j++) {
+				const uint32_t *tri = &idx[from_adj[j] * 3];
+				bool removed = false;
+				for (int k = 0; k < 3; k++) {
+					locked[tri[k]] = 1;
+					removed = removed || tri[k] == c.to;
+				}
+				if (removed) {
+					triangle_count--;
+				}
+			}
+
+			collapsed++;
+		}
+
+		if (collapsed == 0) {
+			break; // Nothing else can be collapsed within the constraints.
+		}
+
+		// Apply collapses and drop degenerate triangles.
+		int write = 0;
+		uint32_t *w = indices.ptrw();
+		for (int i = 0; i < indices.size(); i += 3) {
+			uint32_t a = rm[w[i + 0]];
+			uint32_t b = rm[w[i + 1]];
+			uint32_t c = rm[w[i + 2]];
+			if (a == b || b == c || c == a) {
+				continue;
+			}
+			w[write++] = a;
+			w[write++] = b;
+			w[write++] = c;
+		}
+		indices.resize(write);
+	}
+
+	if (r_error) {
+		*r_error = Math::sqrt(result_error);
+	}
+
+	Vector<int> ret;
+	ret.resize(indices.size());
+	{
+		int *w = ret.ptrw();
+		const uint32_t *r = indices.ptr();
+		for (int i = 0; i < indices.size(); i++) {
+			w[i] = r[i];
+		}
+	}
+
+	return ret;
+}
@@ -0,0 +1,78 @@
+/*************************************************************************/
+/*  mesh_simplifier.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include "core/math/vector3.h"
+#include "core/vector.h"
+
+// Quadric error metric simplifier (Garland & Heckbert) using half-edge collapses.
+// Vertices are only ever collapsed onto existing vertices, so the result is a new
+// index array that can be used against the original vertex buffer (as a mesh LOD).
+// Border edges (which includes attribute seams in an indexed mesh) are kept intact.
+
+class MeshSimplifier {
+
+	struct Quadric {
+		double a00, a01, a02, a03;
+		double a11, a12, a13;
+		double a22, a23;
+		double a33;
+		double weight;
+
+		void add_plane(const Vector3 &p_normal, double p_d, double p_weight);
+		void operator+=(const Quadric &p_q);
+		double evaluate(const Vector3 &p_point) const;
+
+		Quadric() {
+			a00 = a01 = a02 = a03 = a11 = a12 = a13 = a22 = a23 = a33 = weight = 0;
+		}
+	};
+
+	struct Collapse {
+		uint32_t from;
+		uint32_t to;
+		double error;
+
+		bool operator<(const Collapse &p_collapse) const {
+			return error < p_collapse.error;
+		}
+	};
+
+	static bool _collapse_flips_triangle(const Vector3 *p_vertices, const uint32_t *p_indices, const uint32_t *p_adjacency, uint32_t p_adjacency_count, uint32_t p_from, uint32_t p_to);
+
+public:
+	// Simplifies until reaching p_target_index_count or until the next collapse would exceed p_target_error.
+	// r_error receives the object-space distance error of the result.
+	static Vector<int> simplify(const Vector<Vector3> &p_vertices, const Vector<int> &p_indices, int p_target_index_count, float p_target_error = 1e20, float *r_error = NULL);
+};
+
+#endif // MESH_SIMPLIFIER_H
@@ -84,7 +84,6 @@ void MethodBind::set_default_arguments(const Vector<Variant> &p_defargs) {
 	default_argument_count = default_arguments.size();
 }
 
-#ifdef DEBUG_METHODS_ENABLED
 void MethodBind::_generate_argument_types(int p_count) {
 
 	set_argument_count(p_count);
@@ -99,24 +98,20 @@ void MethodBind::_generate_argument_types(int p_count) {
 	argument_types = argt;
 }
 
-#endif
-
 MethodBind::MethodBind() {
 	static int last_id = 0;
 	method_id = last_id++;
 	hint_flags = METHOD_FLAGS_DEFAULT;
 	argument_count = 0;
 	default_argument_count = 0;
-#ifdef DEBUG_METHODS_ENABLED
 	argument_types = NULL;
-#endif
 	_const = false;
 	_returns = false;
+	_returns_enum = false;
+	_enum_arguments = 0;
 }
 
 MethodBind::~MethodBind() {
-#ifdef DEBUG_METHODS_ENABLED
 	if (argument_types)
 		memdelete_arr(argument_types);
-#endif
 }
@@ -42,6 +42,7 @@
 #include "core/variant.h"
 
 #include <stdio.h>
+#include <type_traits>
 
 enum MethodFlags {
 
@@ -214,19 +215,25 @@ class MethodBind {
 
 	bool _const;
 	bool _returns;
+	bool _returns_enum;
+	uint32_t _enum_arguments;
 
 protected:
-#ifdef DEBUG_METHODS_ENABLED
 	Variant::Type *argument_types;
+#ifdef DEBUG_METHODS_ENABLED
 	Vector<StringName> arg_names;
 #endif
 	void _set_const(bool p_const);
 	void _set_returns(bool p_returns);
-#ifdef DEBUG_METHODS_ENABLED
+	void _set_returns_enum(bool p_returns_enum) { _returns_enum = p_returns_enum; }
+	void _set_argument_enum(int p_argument, bool p_enum) {
+		if (p_enum)
+			_enum_arguments |= 1 << p_argument;
+	}
 	virtual Variant::Type _gen_argument_type(int p_arg) const = 0;
-	virtual PropertyInfo _gen_argument_type_info(int p_arg) const = 0;
 	void _generate_argument_types(int p_count);
-
+#ifdef DEBUG_METHODS_ENABLED
+	virtual PropertyInfo _gen_argument_type_info(int p_arg) const = 0;
 #endif
 	void set_argument_count(int p_count) { argument_count = p_count; }
 
@@ -254,14 +261,14 @@ public:
 			return default_arguments[idx];
 	}
 
-#ifdef DEBUG_METHODS_ENABLED
-
 	_FORCE_INLINE_ Variant::Type get_argument_type(int p_argument) const {
 
 		ERR_FAIL_COND_V(p_argument < -1 || p_argument > argument_count, Variant::NIL);
 		return argument_types[p_argument + 1];
 	}
 
+#ifdef DEBUG_METHODS_ENABLED
+
 	PropertyInfo get_argument_info(int p_argument) const;
 	PropertyInfo get_return_info() const;
 
@@ -288,6 +295,10 @@ public:
 	_FORCE_INLINE_ int get_method_id() const { return method_id; }
 	_FORCE_INLINE_ bool is_const() const { return _const; }
 	_FORCE_INLINE_ bool has_return() const { return _returns; }
+	// ptrcall() encodes enum return values as int rather than int64_t.
+	_FORCE_INLINE_ bool has_enum_return() const { return _returns_enum; }
+	// Likewise, ptrcall() decodes enum arguments from int rather than int64_t.
+	_FORCE_INLINE_ bool is_argument_enum(int p_argument) const { return _enum_arguments & (1 << p_argument); }
 	virtual bool is_vararg() const { return false; }
 
 	void set_default_arguments(const Vector<Variant> &p_defargs);
@@ -346,22 +357,23 @@ public:
 	void set_method_info(const MethodInfo &p_info, bool p_return_nil_is_variant) {
 
 		set_argument_count(p_info.arguments.size());
-#ifdef DEBUG_METHODS_ENABLED
 		Variant::Type *at = memnew_arr(Variant::Type, p_info.arguments.size() + 1);
 		at[0] = p_info.return_val.type;
+		for (int i = 0; i < p_info.arguments.size(); i++) {
+			at[i + 1] = p_info.arguments[i].type;
+		}
+		argument_types = at;
+#ifdef DEBUG_METHODS_ENABLED
 		if (p_info.arguments.size()) {
 
 			Vector<StringName> names;
 			names.resize(p_info.arguments.size());
 			for (int i = 0; i < p_info.arguments.size(); i++) {
-
-				at[i + 1] = p_info.arguments[i].type;
 				names.write[i] = p_info.arguments[i].name;
 			}
 
 			set_argument_names(names);
 		}
-		argument_types = at;
 		arguments = p_info;
 		if (p_return_nil_is_variant) {
 			arguments.return_val.usage |= PROPERTY_USAGE_NIL_IS_VARIANT;
@@ -113,6 +113,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_buffer_ptr(uint64_t p_length) const { return NULL; } ///< point at the next bytes without copying them (from a memory mapping, valid until close), NULL if not possible
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -309,8 +309,6 @@ struct PtrToArg<const Ref<T> &> {
 
 #endif // PTRCALL_ENABLED
 
-#ifdef DEBUG_METHODS_ENABLED
-
 template <class T>
 struct GetTypeInfo<Ref<T> > {
 	static const Variant::Type VARIANT_TYPE = Variant::OBJECT;
@@ -331,6 +329,4 @@ struct GetTypeInfo<const Ref<T> &> {
 	}
 };
 
-#endif // DEBUG_METHODS_ENABLED
-
 #endif // REFERENCE_H
@@ -41,6 +41,8 @@
 #include "core/input_map.h"
 #include "core/io/config_file.h"
 #include "core/io/dtls_server.h"
+#include "core/io/file_access_compressed.h"
+#include "core/io/file_read_queue.h"
 #include "core/io/http_client.h"
 #include "core/io/image_loader.h"
 #include "core/io/marshalls.h"
@@ -304,6 +306,8 @@ void unregister_core_types() {
 		memdelete(ip);
 
 	ResourceLoader::finalize();
+	FileReadQueue::finalize();
+	FileAccessCompressed::finalize_read_ahead();
 
 	ClassDB::cleanup_defaults();
 	ObjectDB::cleanup();
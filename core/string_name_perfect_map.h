@@ -0,0 +1,228 @@
+/*************************************************************************/
+/*  string_name_perfect_map.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef STRING_NAME_PERFECT_MAP_H
+#define STRING_NAME_PERFECT_MAP_H
+
+#include "core/hash_map.h"
+#include "core/hashfuncs.h"
+#include "core/string_name.h"
+#include "core/vector.h"
+
+/**
+ * A read-only map from StringName to small values, built once from a HashMap
+ * with a minimal perfect hash over the StringName data pointers.
+ *
+ * Keys are split in buckets, and each bucket gets a seed that sends all of its
+ * keys to free slots (hash and displace). A lookup hashes the pointer to find
+ * the bucket seed, hashes it again with the seed to find the only slot the
+ * key can be in, then compares the pointer. There is no probing, and the slot
+ * array is exactly as large as the number of keys.
+ *
+ * The keys are not referenced, they must be kept alive by their owner (the
+ * map the table was built from, usually).
+ */
+template <class TValue>
+class StringNamePerfectMap {
+
+	enum {
+		KEYS_PER_BUCKET = 2,
+		MAX_SEED = 1 << 16,
+	};
+
+	struct Slot {
+		const void *key;
+		TValue value;
+	};
+
+	Vector<Slot> slots;
+	Vector<uint32_t> seeds;
+
+	static _FORCE_INLINE_ uint32_t _hash(const void *p_key, uint32_t p_seed) {
+		return hash_one_uint64((uint64_t)(uintptr_t)p_key + (uint64_t)p_seed * 0x9E3779B97F4A7C15ULL);
+	}
+
+	// Maps a hash to [0, p_count) without a division.
+	static _FORCE_INLINE_ uint32_t _index(uint32_t p_hash, uint32_t p_count) {
+		return (uint32_t)(((uint64_t)p_hash * p_count) >> 32);
+	}
+
+public:
+	_FORCE_INLINE_ const TValue *getptr(const StringName &p_key) const {
+
+		uint32_t count = slots.size();
+		if (count == 0) {
+			return NULL;
+		}
+
+		const void *key = p_key.data_unique_pointer();
+		uint32_t seed = seeds.ptr()[_index(_hash(key, 0), seeds.size())];
+		const Slot &slot = slots.ptr()[_index(_hash(key, seed), count)];
+		return slot.key == key ? &slot.value : NULL;
+	}
+
+	_FORCE_INLINE_ int size() const { return slots.size(); }
+
+	void clear() {
+		slots.clear();
+		seeds.clear();
+	}
+
+	// Returns false, leaving the map empty, if no seed was found for a bucket.
+	bool build(const HashMap<StringName, TValue> &p_map) {
+
+		clear();
+
+		uint32_t count = p_map.size();
+		if (count == 0) {
+			return true;
+		}
+
+		uint32_t bucket_count = count / KEYS_PER_BUCKET + 1;
+
+		Vector<const void *> keys;
+		Vector<TValue> values;
+		keys.resize(count);
+		values.resize(count);
+		{
+			uint32_t i = 0;
+			const StringName *K = NULL;
+			while ((K = p_map.next(K))) {
+				keys.write[i] = K->data_unique_pointer();
+				values.write[i] = p_map[*K];
+				i++;
+			}
+		}
+
+		// Group the keys by bucket.
+		Vector<uint32_t> bucket_start;
+		bucket_start.resize(bucket_count + 1);
+		uint32_t *start = bucket_start.ptrw();
+		for (uint32_t i = 0; i <= bucket_count; i++) {
+			start[i] = 0;
+		}
+		for (uint32_t i = 0; i < count; i++) {
+			start[_index(_hash(keys[i], 0), bucket_count) + 1]++;
+		}
+		uint32_t max_bucket_size = 0;
+		for (uint32_t i = 0; i < bucket_count; i++) {
+			max_bucket_size = MAX(max_bucket_size, start[i + 1]);
+			start[i + 1] += start[i];
+		}
+
+		Vector<uint32_t> bucket_keys;
+		bucket_keys.resize(count);
+		{
+			Vector<uint32_t> fill = bucket_start;
+			for (uint32_t i = 0; i < count; i++) {
+				uint32_t bucket = _index(_hash(keys[i], 0), bucket_count);
+				bucket_keys.write[fill.write[bucket]++] = i;
+			}
+		}
+
+		// Place the largest buckets first, while most slots are free.
+		Vector<uint32_t> order;
+		order.resize(bucket_count);
+		{
+			uint32_t pos = 0;
+			for (uint32_t size = max_bucket_size; size > 0; size--) {
+				for (uint32_t i = 0; i < bucket_count; i++) {
+					if (start[i + 1] - start[i] == size) {
+						order.write[pos++] = i;
+					}
+				}
+			}
+			order.resize(pos);
+		}
+
+		Vector<uint8_t> used;
+		used.resize(count);
+		for (uint32_t i = 0; i < count; i++) {
+			used.write[i] = 0;
+		}
+
+		Vector<uint32_t> placed;
+		placed.resize(max_bucket_size);
+
+		seeds.resize(bucket_count);
+		for (uint32_t i = 0; i < bucket_count; i++) {
+			seeds.write[i] = 0;
+		}
+		slots.resize(count);
+
+		for (int i = 0; i < order.size(); i++) {
+
+			uint32_t bucket = order[i];
+			uint32_t from = start[bucket];
+			uint32_t size = start[bucket + 1] - from;
+
+			uint32_t seed = 1;
+			for (; seed <= MAX_SEED; seed++) {
+
+				bool fits = true;
+				for (uint32_t j = 0; j < size && fits; j++) {
+					uint32_t slot = _index(_hash(keys[bucket_keys[from + j]], seed), count);
+					if (used[slot]) {
+						fits = false;
+						break;
+					}
+					for (uint32_t k = 0; k < j; k++) {
+						if (placed[k] == slot) {
+							fits = false;
+							break;
+						}
+					}
+					placed.write[j] = slot;
+				}
+
+				if (fits) {
+					break;
+				}
+			}
+
+			if (seed > MAX_SEED) {
+				clear();
+				return false;
+			}
+
+			seeds.write[bucket] = seed;
+			for (uint32_t j = 0; j < size; j++) {
+				uint32_t key = bucket_keys[from + j];
+				used.write[placed[j]] = 1;
+				slots.write[placed[j]].key = keys[key];
+				slots.write[placed[j]].value = values[key];
+			}
+		}
+
+		return true;
+	}
+};
+
+#endif // STRING_NAME_PERFECT_MAP_H
@@ -31,7 +31,8 @@
 #ifndef GET_TYPE_INFO_H
 #define GET_TYPE_INFO_H
 
-#ifdef DEBUG_METHODS_ENABLED
+// Type information is available in all builds, calls from scripts use the
+// argument types to pass values to MethodBind::ptrcall() without Variants.
 
 template <bool C, typename T = void>
 struct EnableIf {
@@ -266,11 +267,4 @@ inline StringName __constant_get_enum_name(T param, const String &p_constant) {
 
 #define CLASS_INFO(m_type) (GetTypeInfo<m_type *>::get_class_info())
 
-#else
-
-#define MAKE_ENUM_TYPE_INFO(m_enum)
-#define CLASS_INFO(m_type)
-
-#endif // DEBUG_METHODS_ENABLED
-
 #endif // GET_TYPE_INFO_H
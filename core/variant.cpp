@@ -2262,6 +2262,49 @@ Object *Variant::get_validated_object() const {
 		return NULL;
 }
 
+const void *Variant::get_ptrcall_arg() const {
+
+	switch (type) {
+		case NIL:
+		case OBJECT:
+			return NULL;
+		case BOOL:
+			return &_data._bool;
+		case INT:
+			return &_data._int;
+		case FLOAT:
+			return &_data._float;
+		case TRANSFORM2D:
+			return _data._transform2d;
+		case AABB:
+			return _data._aabb;
+		case BASIS:
+			return _data._basis;
+		case TRANSFORM:
+			return _data._transform;
+		case PACKED_BYTE_ARRAY:
+			return &PackedArrayRef<uint8_t>::get_array(_data.packed_array);
+		case PACKED_INT32_ARRAY:
+			return &PackedArrayRef<int32_t>::get_array(_data.packed_array);
+		case PACKED_INT64_ARRAY:
+			return &PackedArrayRef<int64_t>::get_array(_data.packed_array);
+		case PACKED_FLOAT32_ARRAY:
+			return &PackedArrayRef<float>::get_array(_data.packed_array);
+		case PACKED_FLOAT64_ARRAY:
+			return &PackedArrayRef<double>::get_array(_data.packed_array);
+		case PACKED_STRING_ARRAY:
+			return &PackedArrayRef<String>::get_array(_data.packed_array);
+		case PACKED_VECTOR2_ARRAY:
+			return &PackedArrayRef<Vector2>::get_array(_data.packed_array);
+		case PACKED_VECTOR3_ARRAY:
+			return &PackedArrayRef<Vector3>::get_array(_data.packed_array);
+		case PACKED_COLOR_ARRAY:
+			return &PackedArrayRef<Color>::get_array(_data.packed_array);
+		default:
+			return _data._mem; // Everything else is stored inline.
+	}
+}
+
 Variant::operator Node *() const {
 
 	if (type == OBJECT)
@@ -310,6 +310,10 @@ public:
 	Object *get_validated_object() const;
 	Object *get_validated_object_with_check(bool &r_previously_freed) const;
 
+	// Stored value as MethodBind::ptrcall() reads arguments of this type,
+	// or NULL for NIL and OBJECT which are passed differently.
+	const void *get_ptrcall_arg() const;
+
 	Variant(bool p_bool);
 	Variant(signed int p_int); // real one
 	Variant(unsigned int p_int);
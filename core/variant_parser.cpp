@@ -33,11 +33,47 @@
 #include "core/io/resource_loader.h"
 #include "core/os/input_event.h"
 #include "core/os/keyboard.h"
-#include "core/string_buffer.h"
-
 CharType VariantParser::StreamFile::get_char() {
 
-	return f->get_8();
+	if (data_pos < data_size && data_f == f) {
+		return data[data_pos++];
+	}
+	return _refill();
+}
+
+CharType VariantParser::StreamFile::_refill() {
+
+	if (data_f != f) {
+		data_f = f;
+		eof = false;
+	}
+	data = NULL;
+	data_pos = 0;
+	data_size = 0;
+
+	if (eof) {
+		return 0;
+	}
+
+	// Tokenize straight from memory when the file is mapped, otherwise read it in chunks.
+	uint64_t pos = f->get_position();
+	uint64_t len = f->get_len();
+	if (len > pos) {
+		data = f->get_buffer_ptr(len - pos);
+		if (data) {
+			data_size = len - pos;
+		} else {
+			data = readahead;
+			data_size = f->get_buffer(readahead, READAHEAD_SIZE);
+		}
+	}
+
+	if (data_size == 0) {
+		eof = true;
+		return 0;
+	}
+
+	return data[data_pos++];
 }
 
 bool VariantParser::StreamFile::is_utf8() const {
@@ -46,7 +82,15 @@ bool VariantParser::StreamFile::is_utf8() const {
 }
 bool VariantParser::StreamFile::is_eof() const {
 
-	return f->eof_reached();
+	return data_f == f && eof;
+}
+
+uint64_t VariantParser::StreamFile::get_position() const {
+
+	if (data_f != f) {
+		return f->get_position();
+	}
+	return f->get_position() - (data_size - data_pos);
 }
 
 CharType VariantParser::StreamString::get_char() {
@@ -92,6 +136,77 @@ const char *VariantParser::tk_name[TK_MAX] = {
 	"ERROR"
 };
 
+void VariantParser::_read_number(Stream *p_stream, CharType p_first, StringBuffer<> &r_num, bool &r_is_float) {
+
+#define READING_SIGN 0
+#define READING_INT 1
+#define READING_DEC 2
+#define READING_EXP 3
+#define READING_DONE 4
+	int reading = READING_INT;
+
+	CharType c = p_first;
+	if (c == '-') {
+		r_num += '-';
+		c = p_stream->get_char();
+	}
+
+	bool exp_sign = false;
+	bool exp_beg = false;
+	r_is_float = false;
+
+	while (true) {
+
+		switch (reading) {
+			case READING_INT: {
+
+				if (c >= '0' && c <= '9') {
+					//pass
+				} else if (c == '.') {
+					reading = READING_DEC;
+					r_is_float = true;
+				} else if (c == 'e') {
+					reading = READING_EXP;
+					r_is_float = true;
+				} else {
+					reading = READING_DONE;
+				}
+
+			} break;
+			case READING_DEC: {
+
+				if (c >= '0' && c <= '9') {
+
+				} else if (c == 'e') {
+					reading = READING_EXP;
+				} else {
+					reading = READING_DONE;
+				}
+
+			} break;
+			case READING_EXP: {
+
+				if (c >= '0' && c <= '9') {
+					exp_beg = true;
+
+				} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
+					exp_sign = true;
+
+				} else {
+					reading = READING_DONE;
+				}
+			} break;
+		}
+
+		if (reading == READING_DONE)
+			break;
+		r_num += c;
+		c = p_stream->get_char();
+	}
+
+	p_stream->saved = c;
+}
+
 Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, String &r_err_str) {
 
 	bool string_name = false;
@@ -220,7 +335,8 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 			}
 			case '"': {
 
-				String str;
+				StringBuffer<> str;
+				bool ascii = true;
 				while (true) {
 
 					CharType ch = p_stream->get_char();
@@ -287,25 +403,28 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 							} break;
 						}
 
+						ascii = ascii && res < 128;
 						str += res;
 
 					} else {
 						if (ch == '\n')
 							line++;
+						ascii = ascii && ch < 128;
 						str += ch;
 					}
 				}
 
-				if (p_stream->is_utf8()) {
-					str.parse_utf8(str.ascii(true).get_data());
+				String s = str.as_string();
+				if (p_stream->is_utf8() && !ascii) {
+					s.parse_utf8(s.ascii(true).get_data());
 				}
 				if (string_name) {
 					r_token.type = TK_STRING_NAME;
-					r_token.value = StringName(str);
+					r_token.value = StringName(s);
 					string_name = false; //reset
 				} else {
 					r_token.type = TK_STRING;
-					r_token.value = str;
+					r_token.value = s;
 				}
 				return OK;
 
@@ -320,73 +439,8 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 					//a number
 
 					StringBuffer<> num;
-#define READING_SIGN 0
-#define READING_INT 1
-#define READING_DEC 2
-#define READING_EXP 3
-#define READING_DONE 4
-					int reading = READING_INT;
-
-					if (cchar == '-') {
-						num += '-';
-						cchar = p_stream->get_char();
-					}
-
-					CharType c = cchar;
-					bool exp_sign = false;
-					bool exp_beg = false;
-					bool is_float = false;
-
-					while (true) {
-
-						switch (reading) {
-							case READING_INT: {
-
-								if (c >= '0' && c <= '9') {
-									//pass
-								} else if (c == '.') {
-									reading = READING_DEC;
-									is_float = true;
-								} else if (c == 'e') {
-									reading = READING_EXP;
-									is_float = true;
-								} else {
-									reading = READING_DONE;
-								}
-
-							} break;
-							case READING_DEC: {
-
-								if (c >= '0' && c <= '9') {
-
-								} else if (c == 'e') {
-									reading = READING_EXP;
-								} else {
-									reading = READING_DONE;
-								}
-
-							} break;
-							case READING_EXP: {
-
-								if (c >= '0' && c <= '9') {
-									exp_beg = true;
-
-								} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
-									exp_sign = true;
-
-								} else {
-									reading = READING_DONE;
-								}
-							} break;
-						}
-
-						if (reading == READING_DONE)
-							break;
-						num += c;
-						c = p_stream->get_char();
-					}
-
-					p_stream->saved = c;
+					bool is_float;
+					_read_number(p_stream, cchar, num, is_float);
 
 					r_token.type = TK_NUMBER;
 
@@ -482,6 +536,32 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 				return ERR_PARSE_ERROR;
 			}
 		}
+
+		// Numbers go straight into the array, without a token and a Variant for each of them.
+		CharType c = p_stream->saved;
+		p_stream->saved = 0;
+		while (true) {
+			if (!c) {
+				c = p_stream->get_char();
+			}
+			if (c == '\n') {
+				line++;
+			} else if (c > 32 || c == 0) {
+				break;
+			}
+			c = 0;
+		}
+
+		if (c == '-' || (c >= '0' && c <= '9')) {
+			StringBuffer<> num;
+			bool is_float;
+			_read_number(p_stream, c, num, is_float);
+			r_construct.push_back(is_float ? (T)num.as_double() : (T)num.as_int());
+			first = false;
+			continue;
+		}
+
+		p_stream->saved = c;
 		get_token(p_stream, token, line, r_err_str);
 
 		if (first && token.type == TK_PARENTHESIS_CLOSE) {
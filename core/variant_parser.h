@@ -33,6 +33,7 @@
 
 #include "core/os/file_access.h"
 #include "core/resource.h"
+#include "core/string_buffer.h"
 #include "core/variant.h"
 
 class VariantParser {
@@ -58,7 +59,32 @@ public:
 		virtual bool is_utf8() const;
 		virtual bool is_eof() const;
 
-		StreamFile() { f = NULL; }
+		// Position in the file of the next character, f is read ahead.
+		uint64_t get_position() const;
+
+		StreamFile() {
+			f = NULL;
+			data_f = NULL;
+			data = NULL;
+			data_pos = 0;
+			data_size = 0;
+			eof = false;
+		}
+
+	private:
+		enum {
+			READAHEAD_SIZE = 4096
+		};
+
+		// The rest of the file when it's mapped in memory, or the last chunk read from it.
+		FileAccess *data_f;
+		const uint8_t *data;
+		uint64_t data_pos;
+		uint64_t data_size;
+		bool eof;
+		uint8_t readahead[READAHEAD_SIZE];
+
+		CharType _refill();
 	};
 
 	struct StreamString : public Stream {
@@ -127,6 +153,7 @@ public:
 private:
 	static const char *tk_name[TK_MAX];
 
+	static void _read_number(Stream *p_stream, CharType p_first, StringBuffer<> &r_num, bool &r_is_float);
 	template <class T>
 	static Error _parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str);
 	static Error _parse_enginecfg(Stream *p_stream, Vector<String> &strings, int &line, String &r_err_str);
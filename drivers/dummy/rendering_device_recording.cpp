@@ -0,0 +1,1530 @@
+/*************************************************************************/
+/*  rendering_device_recording.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "rendering_device_recording.h"
+
+#include "core/os/copymem.h"
+#include "core/os/os.h"
+#include "thirdparty/spirv-reflect/spirv_reflect.h"
+
+void RenderingDeviceRecording::_add_dependency(RID p_id, RID p_depends_on) {
+
+	if (!dependency_map.has(p_depends_on)) {
+		dependency_map[p_depends_on] = Set<RID>();
+	}
+
+	dependency_map[p_depends_on].insert(p_id);
+
+	if (!reverse_dependency_map.has(p_id)) {
+		reverse_dependency_map[p_id] = Set<RID>();
+	}
+
+	reverse_dependency_map[p_id].insert(p_depends_on);
+}
+
+void RenderingDeviceRecording::_free_dependencies(RID p_id) {
+
+	//direct dependencies must be freed
+
+	Map<RID, Set<RID> >::Element *E = dependency_map.find(p_id);
+	if (E) {
+
+		while (E->get().size()) {
+			free(E->get().front()->get());
+		}
+		dependency_map.erase(E);
+	}
+
+	//reverse depenencies must be unreferenced
+	E = reverse_dependency_map.find(p_id);
+
+	if (E) {
+
+		for (Set<RID>::Element *F = E->get().front(); F; F = F->next()) {
+			Map<RID, Set<RID> >::Element *G = dependency_map.find(F->get());
+			ERR_CONTINUE(!G);
+			ERR_CONTINUE(!G->get().has(p_id));
+			G->get().erase(p_id);
+		}
+
+		reverse_dependency_map.erase(E);
+	}
+}
+
+/*****************/
+/**** TEXTURE ****/
+/*****************/
+
+RID RenderingDeviceRecording::texture_create(const TextureFormat &p_format, const TextureView &p_view, const Vector<Vector<uint8_t> > &p_data) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_format.width < 1 || p_format.height < 1 || p_format.depth < 1, RID());
+	ERR_FAIL_COND_V(p_format.array_layers < 1 || p_format.mipmaps < 1, RID());
+	ERR_FAIL_COND_V_MSG(p_data.size() && p_data.size() != (int)p_format.array_layers, RID(),
+			"Default supplied data for image format is of invalid length (" + itos(p_data.size()) + "), should be (" + itos(p_format.array_layers) + ").");
+
+	ERR_FAIL_INDEX_V(p_format.format, DATA_FORMAT_MAX, RID());
+
+	uint32_t required_size = get_image_format_required_size(p_format.format, p_format.width, p_format.height, p_format.depth, p_format.mipmaps);
+	for (int i = 0; i < p_data.size(); i++) {
+		ERR_FAIL_COND_V_MSG((uint32_t)p_data[i].size() != required_size, RID(),
+				"Data for slice index " + itos(i) + " (mapped to layer " + itos(i) + ") differs in size (supplied: " + itos(p_data[i].size()) + ") than what is required by the format (" + itos(required_size) + ").");
+	}
+
+	Texture texture;
+	texture.format = p_format;
+	if (p_view.format_override != DATA_FORMAT_MAX) {
+		texture.format.format = p_view.format_override;
+	}
+	texture.layer_size = required_size;
+	texture.layers = p_data;
+	texture.layers.resize(p_format.array_layers);
+
+	stats.upload_bytes += p_data.size() ? p_data[0].size() * p_data.size() : 0;
+
+	return texture_owner.make_rid(texture);
+}
+
+RID RenderingDeviceRecording::texture_create_shared(const TextureView &p_view, RID p_with_texture) {
+
+	_THREAD_SAFE_METHOD_
+
+	Texture *src_texture = texture_owner.getornull(p_with_texture);
+	ERR_FAIL_COND_V(!src_texture, RID());
+
+	if (src_texture->owner.is_valid()) { //ahh this is a share
+		p_with_texture = src_texture->owner;
+		src_texture = texture_owner.getornull(p_with_texture);
+		ERR_FAIL_COND_V(!src_texture, RID()); //this is a bug
+	}
+
+	Texture texture = *src_texture;
+	if (p_view.format_override != DATA_FORMAT_MAX) {
+		texture.format.format = p_view.format_override;
+	}
+	texture.owner = p_with_texture;
+
+	RID id = texture_owner.make_rid(texture);
+	_add_dependency(id, p_with_texture);
+
+	return id;
+}
+
+RID RenderingDeviceRecording::texture_create_shared_from_slice(const TextureView &p_view, RID p_with_texture, uint32_t p_layer, uint32_t p_mipmap, TextureSliceType p_slice_type) {
+
+	_THREAD_SAFE_METHOD_
+
+	Texture *src_texture = texture_owner.getornull(p_with_texture);
+	ERR_FAIL_COND_V(!src_texture, RID());
+
+	if (src_texture->owner.is_valid()) { //ahh this is a share
+		p_with_texture = src_texture->owner;
+		src_texture = texture_owner.getornull(p_with_texture);
+		ERR_FAIL_COND_V(!src_texture, RID()); //this is a bug
+	}
+
+	ERR_FAIL_COND_V_MSG(p_slice_type == TEXTURE_SLICE_CUBEMAP && (src_texture->format.type != TEXTURE_TYPE_CUBE && src_texture->format.type != TEXTURE_TYPE_CUBE_ARRAY), RID(),
+			"Can only create a cubemap slice from a cubemap or cubemap array mipmap");
+	ERR_FAIL_UNSIGNED_INDEX_V(p_mipmap, src_texture->format.mipmaps, RID());
+	uint32_t slice_layers = p_slice_type == TEXTURE_SLICE_CUBEMAP ? 6 : 1;
+	ERR_FAIL_COND_V(p_layer + slice_layers > src_texture->format.array_layers, RID());
+
+	Texture texture;
+	texture.format = src_texture->format;
+	texture.format.width = MAX(1u, src_texture->format.width >> p_mipmap);
+	texture.format.height = MAX(1u, src_texture->format.height >> p_mipmap);
+	texture.format.array_layers = slice_layers;
+	texture.format.mipmaps = 1;
+	texture.format.type = p_slice_type == TEXTURE_SLICE_CUBEMAP ? TEXTURE_TYPE_CUBE : TEXTURE_TYPE_2D;
+	if (p_view.format_override != DATA_FORMAT_MAX) {
+		texture.format.format = p_view.format_override;
+	}
+	texture.layer_size = get_image_format_required_size(texture.format.format, texture.format.width, texture.format.height, texture.format.depth, 1);
+	texture.layers.resize(slice_layers);
+	texture.owner = p_with_texture;
+
+	RID id = texture_owner.make_rid(texture);
+	_add_dependency(id, p_with_texture);
+
+	return id;
+}
+
+Error RenderingDeviceRecording::texture_update(RID p_texture, uint32_t p_layer, const Vector<uint8_t> &p_data, bool p_sync_with_draw) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(draw_list.active && p_sync_with_draw, ERR_INVALID_PARAMETER,
+			"Updating textures in 'sync to draw' mode is forbidden during creation of a draw list");
+
+	Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!texture, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(texture->owner.is_valid(), ERR_INVALID_PARAMETER,
+			"Updating shared textures is not supported, update the original texture instead.");
+	ERR_FAIL_UNSIGNED_INDEX_V(p_layer, (uint32_t)texture->layers.size(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(texture->layer_size != (uint32_t)p_data.size(), ERR_INVALID_PARAMETER,
+			"Required size for texture update (" + itos(texture->layer_size) + ") does not match data supplied size (" + itos(p_data.size()) + ").");
+
+	texture->layers.write[p_layer] = p_data;
+
+	_record(COMMAND_TEXTURE_UPDATE, p_texture, p_layer, p_data.size());
+	stats.upload_bytes += p_data.size();
+
+	return OK;
+}
+
+Vector<uint8_t> RenderingDeviceRecording::texture_get_data(RID p_texture, uint32_t p_layer) {
+
+	_THREAD_SAFE_METHOD_
+
+	Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!texture, Vector<uint8_t>());
+	if (texture->owner.is_valid()) {
+		texture = texture_owner.getornull(texture->owner);
+		ERR_FAIL_COND_V(!texture, Vector<uint8_t>());
+	}
+	ERR_FAIL_UNSIGNED_INDEX_V(p_layer, (uint32_t)texture->layers.size(), Vector<uint8_t>());
+
+	// Only data that was supplied by the user is known, rendered contents are not.
+	if (texture->layers[p_layer].size() == 0) {
+		Vector<uint8_t> data;
+		data.resize(texture->layer_size);
+		zeromem(data.ptrw(), texture->layer_size);
+		return data;
+	}
+	return texture->layers[p_layer];
+}
+
+bool RenderingDeviceRecording::texture_is_format_supported_for_usage(DataFormat p_format, uint32_t p_usage) const {
+
+	return p_format >= 0 && p_format < DATA_FORMAT_MAX;
+}
+
+bool RenderingDeviceRecording::texture_is_shared(RID p_texture) {
+
+	_THREAD_SAFE_METHOD_
+
+	Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!texture, false);
+	return texture->owner.is_valid();
+}
+
+bool RenderingDeviceRecording::texture_is_valid(RID p_texture) {
+
+	return texture_owner.owns(p_texture);
+}
+
+Error RenderingDeviceRecording::texture_copy(RID p_from_texture, RID p_to_texture, const Vector3 &p_from, const Vector3 &p_to, const Vector3 &p_size, uint32_t p_src_mipmap, uint32_t p_dst_mipmap, uint32_t p_src_layer, uint32_t p_dst_layer, bool p_sync_with_draw) {
+
+	_THREAD_SAFE_METHOD_
+
+	Texture *src_tex = texture_owner.getornull(p_from_texture);
+	ERR_FAIL_COND_V(!src_tex, ERR_INVALID_PARAMETER);
+	Texture *dst_tex = texture_owner.getornull(p_to_texture);
+	ERR_FAIL_COND_V(!dst_tex, ERR_INVALID_PARAMETER);
+
+	ERR_FAIL_COND_V_MSG(p_sync_with_draw && draw_list.active, ERR_INVALID_PARAMETER,
+			"Copying textures is forbidden during creation of a draw list");
+	ERR_FAIL_COND_V_MSG(!(src_tex->format.usage_bits & TEXTURE_USAGE_CAN_COPY_FROM_BIT), ERR_INVALID_PARAMETER,
+			"Source texture requires the TEXTURE_USAGE_CAN_COPY_FROM_BIT in order to be retrieved.");
+	ERR_FAIL_COND_V_MSG(!(dst_tex->format.usage_bits & TEXTURE_USAGE_CAN_COPY_TO_BIT), ERR_INVALID_PARAMETER,
+			"Destination texture requires the TEXTURE_USAGE_CAN_COPY_TO_BIT in order to be retrieved.");
+	ERR_FAIL_UNSIGNED_INDEX_V(p_src_mipmap, src_tex->format.mipmaps, ERR_INVALID_PARAMETER);
+	ERR_FAIL_UNSIGNED_INDEX_V(p_dst_mipmap, dst_tex->format.mipmaps, ERR_INVALID_PARAMETER);
+	ERR_FAIL_UNSIGNED_INDEX_V(p_src_layer, src_tex->format.array_layers, ERR_INVALID_PARAMETER);
+	ERR_FAIL_UNSIGNED_INDEX_V(p_dst_layer, dst_tex->format.array_layers, ERR_INVALID_PARAMETER);
+
+	_record(COMMAND_TEXTURE_COPY, p_to_texture, p_dst_mipmap, p_dst_layer);
+
+	return OK;
+}
+
+Error RenderingDeviceRecording::texture_clear(RID p_texture, const Color &p_color, uint32_t p_base_mipmap, uint32_t p_mipmaps, uint32_t p_base_layer, uint32_t p_layers, bool p_sync_with_draw) {
+
+	_THREAD_SAFE_METHOD_
+
+	Texture *src_tex = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!src_tex, ERR_INVALID_PARAMETER);
+
+	ERR_FAIL_COND_V_MSG(p_sync_with_draw && draw_list.active, ERR_INVALID_PARAMETER,
+			"Clearing textures is forbidden during creation of a draw list");
+	ERR_FAIL_COND_V_MSG(!(src_tex->format.usage_bits & TEXTURE_USAGE_CAN_COPY_TO_BIT), ERR_INVALID_PARAMETER,
+			"Source texture requires the TEXTURE_USAGE_CAN_COPY_TO_BIT in order to be cleared.");
+	ERR_FAIL_COND_V(p_base_mipmap + p_mipmaps > src_tex->format.mipmaps, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_base_layer + p_layers > src_tex->format.array_layers, ERR_INVALID_PARAMETER);
+
+	_record(COMMAND_TEXTURE_CLEAR, p_texture, p_base_mipmap, p_base_layer);
+
+	return OK;
+}
+
+/*********************/
+/**** FRAMEBUFFER ****/
+/*********************/
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecording::framebuffer_format_create(const Vector<AttachmentFormat> &p_format) {
+
+	_THREAD_SAFE_METHOD_
+
+	for (int i = 0; i < framebuffer_formats.size(); i++) {
+		const Vector<AttachmentFormat> &format = framebuffer_formats[i];
+		if (format.size() != p_format.size()) {
+			continue;
+		}
+		bool equal = true;
+		for (int j = 0; j < format.size(); j++) {
+			if (format[j].format != p_format[j].format || format[j].samples != p_format[j].samples || format[j].usage_flags != p_format[j].usage_flags) {
+				equal = false;
+				break;
+			}
+		}
+		if (equal) {
+			return i;
+		}
+	}
+
+	framebuffer_formats.push_back(p_format);
+	return framebuffer_formats.size() - 1;
+}
+
+RenderingDevice::TextureSamples RenderingDeviceRecording::framebuffer_format_get_texture_samples(FramebufferFormatID p_format) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_INDEX_V(p_format, framebuffer_formats.size(), TEXTURE_SAMPLES_1);
+
+	const Vector<AttachmentFormat> &format = framebuffer_formats[p_format];
+	return format.size() ? format[0].samples : TEXTURE_SAMPLES_1;
+}
+
+RID RenderingDeviceRecording::framebuffer_create(const Vector<RID> &p_texture_attachments, FramebufferFormatID p_format_check) {
+
+	_THREAD_SAFE_METHOD_
+
+	Vector<AttachmentFormat> attachments;
+	Size2i size;
+
+	for (int i = 0; i < p_texture_attachments.size(); i++) {
+		Texture *texture = texture_owner.getornull(p_texture_attachments[i]);
+		ERR_FAIL_COND_V_MSG(!texture, RID(), "Texture index supplied for framebuffer (" + itos(i) + ") is not a valid texture.");
+
+		if (i != 0 && (int)texture->format.width != size.width && (int)texture->format.height != size.height) {
+			ERR_FAIL_V_MSG(RID(), "All textures in a framebuffer should be the same size.");
+		}
+		size.width = texture->format.width;
+		size.height = texture->format.height;
+
+		AttachmentFormat af;
+		af.format = texture->format.format;
+		af.samples = texture->format.samples;
+		af.usage_flags = texture->format.usage_bits;
+		attachments.push_back(af);
+	}
+
+	FramebufferFormatID format_id = framebuffer_format_create(attachments);
+	ERR_FAIL_COND_V_MSG(p_format_check != INVALID_ID && format_id != p_format_check, RID(),
+			"The format used to check this framebuffer differs from the intended framebuffer format.");
+
+	Framebuffer framebuffer;
+	framebuffer.format = format_id;
+	framebuffer.size = size;
+
+	RID id = framebuffer_owner.make_rid(framebuffer);
+
+	for (int i = 0; i < p_texture_attachments.size(); i++) {
+		_add_dependency(id, p_texture_attachments[i]);
+	}
+
+	return id;
+}
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecording::framebuffer_get_format(RID p_framebuffer) {
+
+	_THREAD_SAFE_METHOD_
+
+	Framebuffer *framebuffer = framebuffer_owner.getornull(p_framebuffer);
+	ERR_FAIL_COND_V(!framebuffer, INVALID_ID);
+
+	return framebuffer->format;
+}
+
+/*****************/
+/**** SAMPLER ****/
+/*****************/
+
+RID RenderingDeviceRecording::sampler_create(const SamplerState &p_state) {
+
+	_THREAD_SAFE_METHOD_
+
+	return sampler_owner.make_rid(p_state);
+}
+
+/**********************/
+/**** VERTEX ARRAY ****/
+/**********************/
+
+RID RenderingDeviceRecording::_buffer_create(BufferType p_type, uint32_t p_size, const Vector<uint8_t> &p_data) {
+
+	ERR_FAIL_COND_V(p_data.size() && (uint32_t)p_data.size() != p_size, RID());
+
+	Buffer buffer;
+	buffer.type = p_type;
+	buffer.size = p_size;
+	buffer.index_format = INDEX_BUFFER_FORMAT_UINT32;
+	buffer.data = p_data;
+	if (buffer.data.size() == 0) {
+		buffer.data.resize(p_size);
+		if (p_size) {
+			zeromem(buffer.data.ptrw(), p_size);
+		}
+	}
+
+	stats.upload_bytes += p_data.size();
+
+	return buffer_owner.make_rid(buffer);
+}
+
+RID RenderingDeviceRecording::vertex_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data) {
+
+	_THREAD_SAFE_METHOD_
+
+	return _buffer_create(BUFFER_TYPE_VERTEX, p_size_bytes, p_data);
+}
+
+RenderingDevice::VertexFormatID RenderingDeviceRecording::vertex_format_create(const Vector<VertexDescription> &p_vertex_formats) {
+
+	_THREAD_SAFE_METHOD_
+
+	for (int i = 0; i < vertex_formats.size(); i++) {
+		const Vector<VertexDescription> &format = vertex_formats[i];
+		if (format.size() != p_vertex_formats.size()) {
+			continue;
+		}
+		bool equal = true;
+		for (int j = 0; j < format.size(); j++) {
+			const VertexDescription &a = format[j];
+			const VertexDescription &b = p_vertex_formats[j];
+			if (a.location != b.location || a.offset != b.offset || a.format != b.format || a.stride != b.stride || a.frequency != b.frequency) {
+				equal = false;
+				break;
+			}
+		}
+		if (equal) {
+			return i;
+		}
+	}
+
+	for (int i = 0; i < p_vertex_formats.size(); i++) {
+		ERR_FAIL_INDEX_V(p_vertex_formats[i].format, DATA_FORMAT_MAX, INVALID_ID);
+		ERR_FAIL_COND_V_MSG(get_format_vertex_size(p_vertex_formats[i].format) == 0, INVALID_ID,
+				"Data format for attachment (" + itos(i) + ") is not valid for a vertex array.");
+	}
+
+	vertex_formats.push_back(p_vertex_formats);
+	return vertex_formats.size() - 1;
+}
+
+RID RenderingDeviceRecording::vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_vertex_count == 0, RID());
+	ERR_FAIL_INDEX_V(p_vertex_format, vertex_formats.size(), RID());
+	ERR_FAIL_COND_V(vertex_formats[p_vertex_format].size() != p_src_buffers.size(), RID());
+
+	for (int i = 0; i < p_src_buffers.size(); i++) {
+		Buffer *buffer = buffer_owner.getornull(p_src_buffers[i]);
+		ERR_FAIL_COND_V(!buffer || buffer->type != BUFFER_TYPE_VERTEX, RID());
+
+		const VertexDescription &atf = vertex_formats[p_vertex_format][i];
+		if (atf.frequency == VERTEX_FREQUENCY_VERTEX) {
+			//validate size for regular drawing
+			uint64_t total_size = uint64_t(atf.stride) * (p_vertex_count - 1) + atf.offset + get_format_vertex_size(atf.format);
+			ERR_FAIL_COND_V_MSG(total_size > buffer->size, RID(),
+					"Attachment (" + itos(i) + ") will read past the end of the buffer.");
+		}
+	}
+
+	VertexArray vertex_array;
+	vertex_array.vertex_count = p_vertex_count;
+	vertex_array.format = p_vertex_format;
+
+	RID id = vertex_array_owner.make_rid(vertex_array);
+	for (int i = 0; i < p_src_buffers.size(); i++) {
+		_add_dependency(id, p_src_buffers[i]);
+	}
+
+	return id;
+}
+
+RID RenderingDeviceRecording::index_buffer_create(uint32_t p_size_indices, IndexBufferFormat p_format, const Vector<uint8_t> &p_data, bool p_use_restart_indices) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_size_indices == 0, RID());
+
+	uint32_t size_bytes = p_size_indices * (p_format == INDEX_BUFFER_FORMAT_UINT16 ? 2 : 4);
+	RID id = _buffer_create(BUFFER_TYPE_INDEX, size_bytes, p_data);
+	if (id.is_valid()) {
+		buffer_owner.getornull(id)->index_format = p_format;
+	}
+	return id;
+}
+
+RID RenderingDeviceRecording::index_array_create(RID p_index_buffer, uint32_t p_index_offset, uint32_t p_index_count) {
+
+	_THREAD_SAFE_METHOD_
+
+	Buffer *buffer = buffer_owner.getornull(p_index_buffer);
+	ERR_FAIL_COND_V(!buffer || buffer->type != BUFFER_TYPE_INDEX, RID());
+
+	uint32_t index_size = buffer->index_format == INDEX_BUFFER_FORMAT_UINT16 ? 2 : 4;
+	ERR_FAIL_COND_V(p_index_count == 0, RID());
+	ERR_FAIL_COND_V((p_index_offset + p_index_count) * index_size > buffer->size, RID());
+
+	IndexArray index_array;
+	index_array.index_offset = p_index_offset;
+	index_array.index_count = p_index_count;
+
+	RID id = index_array_owner.make_rid(index_array);
+	_add_dependency(id, p_index_buffer);
+	return id;
+}
+
+/****************/
+/**** SHADER ****/
+/****************/
+
+static const char *shader_stage_names[RenderingDevice::SHADER_STAGE_MAX] = {
+	"Vertex",
+	"Fragment",
+	"TesselationControl",
+	"TesselationEvaluation",
+	"Compute"
+};
+
+static const char *shader_uniform_names[RenderingDevice::UNIFORM_TYPE_MAX] = {
+	"Sampler", "CombinedSampler", "Texture", "Image", "TextureBuffer", "SamplerTextureBuffer", "ImageBuffer", "UniformBuffer", "StorageBuffer", "InputAttachment"
+};
+
+RID RenderingDeviceRecording::shader_create(const Vector<ShaderStageData> &p_stages) {
+
+	ERR_FAIL_COND_V(p_stages.size() == 0, RID());
+
+	Shader shader;
+	shader.stage_mask = 0;
+	shader.vertex_input_mask = 0;
+	shader.push_constant_size = 0;
+
+	for (int i = 0; i < p_stages.size(); i++) {
+
+		uint32_t stage = p_stages[i].shader_stage;
+
+		ERR_FAIL_COND_V_MSG(shader.stage_mask & (1 << stage), RID(),
+				"Stage " + String(shader_stage_names[stage]) + " submitted more than once.");
+
+		SpvReflectShaderModule module;
+		SpvReflectResult result = spvReflectCreateShaderModule(p_stages[i].spir_v.size(), p_stages[i].spir_v.ptr(), &module);
+		ERR_FAIL_COND_V_MSG(result != SPV_REFLECT_RESULT_SUCCESS, RID(),
+				"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "' failed parsing shader.");
+
+		uint32_t binding_count = 0;
+		result = spvReflectEnumerateDescriptorBindings(&module, &binding_count, NULL);
+		ERR_FAIL_COND_V_MSG(result != SPV_REFLECT_RESULT_SUCCESS, RID(),
+				"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "' failed enumerating descriptor bindings.");
+
+		if (binding_count > 0) {
+
+			Vector<SpvReflectDescriptorBinding *> bindings;
+			bindings.resize(binding_count);
+			result = spvReflectEnumerateDescriptorBindings(&module, &binding_count, bindings.ptrw());
+			ERR_FAIL_COND_V_MSG(result != SPV_REFLECT_RESULT_SUCCESS, RID(),
+					"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "' failed getting descriptor bindings.");
+
+			for (uint32_t j = 0; j < binding_count; j++) {
+				const SpvReflectDescriptorBinding &binding = *bindings[j];
+
+				UniformInfo info;
+
+				bool need_array_dimensions = false;
+				bool need_block_size = false;
+
+				switch (binding.descriptor_type) {
+					case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLER: {
+						info.type = UNIFORM_TYPE_SAMPLER;
+						need_array_dimensions = true;
+					} break;
+					case SPV_REFLECT_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
+						info.type = UNIFORM_TYPE_SAMPLER_WITH_TEXTURE;
+						need_array_dimensions = true;
+					} break;
+					case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLED_IMAGE: {
+						info.type = UNIFORM_TYPE_TEXTURE;
+						need_array_dimensions = true;
+					} break;
+					case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_IMAGE: {
+						info.type = UNIFORM_TYPE_IMAGE;
+						need_array_dimensions = true;
+					} break;
+					case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER: {
+						info.type = UNIFORM_TYPE_TEXTURE_BUFFER;
+						need_array_dimensions = true;
+					} break;
+					case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: {
+						info.type = UNIFORM_TYPE_IMAGE_BUFFER;
+						need_array_dimensions = true;
+					} break;
+					case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER: {
+						info.type = UNIFORM_TYPE_UNIFORM_BUFFER;
+						need_block_size = true;
+					} break;
+					case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER: {
+						info.type = UNIFORM_TYPE_STORAGE_BUFFER;
+						need_block_size = true;
+					} break;
+					case SPV_REFLECT_DESCRIPTOR_TYPE_INPUT_ATTACHMENT: {
+						info.type = UNIFORM_TYPE_INPUT_ATTACHMENT;
+					} break;
+					default: {
+						ERR_PRINT("Dynamic uniform and storage buffers are not supported.");
+						continue;
+					}
+				}
+
+				if (need_array_dimensions) {
+					info.length = 1;
+					for (uint32_t k = 0; k < binding.array.dims_count; k++) {
+						info.length *= binding.array.dims[k];
+					}
+				} else if (need_block_size) {
+					info.length = binding.block.size;
+				} else {
+					info.length = 0;
+				}
+
+				info.binding = binding.binding;
+				uint32_t set = binding.set;
+
+				ERR_FAIL_COND_V_MSG(set >= MAX_UNIFORM_SETS, RID(),
+						"On shader stage '" + String(shader_stage_names[stage]) + "', uniform '" + binding.name + "' uses a set (" + itos(set) + ") index larger than what is supported (" + itos(MAX_UNIFORM_SETS) + ").");
+
+				if (set >= (uint32_t)shader.sets.size()) {
+					shader.sets.resize(set + 1);
+				}
+
+				//stages may share a binding, as long as they agree on what it is
+				bool exists = false;
+				for (int k = 0; k < shader.sets[set].size(); k++) {
+					const UniformInfo &existing = shader.sets[set][k];
+					if (existing.binding != info.binding) {
+						continue;
+					}
+					ERR_FAIL_COND_V_MSG(existing.type != info.type, RID(),
+							"On shader stage '" + String(shader_stage_names[stage]) + "', uniform '" + binding.name + "' trying to re-use location for set=" + itos(set) + ", binding=" + itos(info.binding) + " with different uniform type.");
+					ERR_FAIL_COND_V_MSG(existing.length != info.length, RID(),
+							"On shader stage '" + String(shader_stage_names[stage]) + "', uniform '" + binding.name + "' trying to re-use location for set=" + itos(set) + ", binding=" + itos(info.binding) + " with different uniform size.");
+					exists = true;
+				}
+
+				if (!exists) {
+					shader.sets.write[set].push_back(info);
+				}
+			}
+		}
+
+		if (stage == SHADER_STAGE_VERTEX) {
+
+			uint32_t iv_count = 0;
+			result = spvReflectEnumerateInputVariables(&module, &iv_count, NULL);
+			ERR_FAIL_COND_V_MSG(result != SPV_REFLECT_RESULT_SUCCESS, RID(),
+					"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "' failed enumerating input variables.");
+
+			if (iv_count) {
+				Vector<SpvReflectInterfaceVariable *> input_vars;
+				input_vars.resize(iv_count);
+
+				result = spvReflectEnumerateInputVariables(&module, &iv_count, input_vars.ptrw());
+				ERR_FAIL_COND_V_MSG(result != SPV_REFLECT_RESULT_SUCCESS, RID(),
+						"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "' failed obtaining input variables.");
+
+				for (uint32_t j = 0; j < iv_count; j++) {
+					if (input_vars[j] && input_vars[j]->decoration_flags == 0) { //regular input
+						shader.vertex_input_mask |= (1 << uint32_t(input_vars[j]->location));
+					}
+				}
+			}
+		}
+
+		uint32_t pc_count = 0;
+		result = spvReflectEnumeratePushConstantBlocks(&module, &pc_count, NULL);
+		ERR_FAIL_COND_V_MSG(result != SPV_REFLECT_RESULT_SUCCESS, RID(),
+				"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "' failed enumerating push constants.");
+
+		if (pc_count) {
+			ERR_FAIL_COND_V_MSG(pc_count > 1, RID(),
+					"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "': Only one push constant is supported, which should be the same across shader stages.");
+
+			Vector<SpvReflectBlockVariable *> pconstants;
+			pconstants.resize(pc_count);
+			result = spvReflectEnumeratePushConstantBlocks(&module, &pc_count, pconstants.ptrw());
+			ERR_FAIL_COND_V_MSG(result != SPV_REFLECT_RESULT_SUCCESS, RID(),
+					"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "' failed obtaining push constants.");
+
+			ERR_FAIL_COND_V_MSG(shader.push_constant_size && shader.push_constant_size != pconstants[0]->size, RID(),
+					"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "': Push constant block must be the same across shader stages.");
+			ERR_FAIL_COND_V_MSG(pconstants[0]->size > MAX_PUSH_CONSTANT_SIZE, RID(),
+					"Reflection of SPIR-V shader stage '" + String(shader_stage_names[stage]) + "': Push constant block is larger than what is supported (" + itos(MAX_PUSH_CONSTANT_SIZE) + ").");
+
+			shader.push_constant_size = pconstants[0]->size;
+		}
+
+		// Destroy the reflection data when no longer required.
+		spvReflectDestroyShaderModule(&module);
+
+		shader.stage_mask |= 1 << stage;
+	}
+
+	ERR_FAIL_COND_V_MSG((shader.stage_mask & (1 << SHADER_STAGE_COMPUTE)) && shader.stage_mask != (1 << SHADER_STAGE_COMPUTE), RID(),
+			"Compute shaders can only receive one stage, dedicated to compute.");
+
+	_THREAD_SAFE_METHOD_
+
+	return shader_owner.make_rid(shader);
+}
+
+uint32_t RenderingDeviceRecording::shader_get_vertex_input_attribute_mask(RID p_shader) {
+
+	_THREAD_SAFE_METHOD_
+
+	const Shader *shader = shader_owner.getornull(p_shader);
+	ERR_FAIL_COND_V(!shader, 0);
+	return shader->vertex_input_mask;
+}
+
+/******************/
+/**** UNIFORMS ****/
+/******************/
+
+RID RenderingDeviceRecording::uniform_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data) {
+
+	_THREAD_SAFE_METHOD_
+
+	return _buffer_create(BUFFER_TYPE_UNIFORM, p_size_bytes, p_data);
+}
+
+RID RenderingDeviceRecording::storage_buffer_create(uint32_t p_size, const Vector<uint8_t> &p_data) {
+
+	_THREAD_SAFE_METHOD_
+
+	return _buffer_create(BUFFER_TYPE_STORAGE, p_size, p_data);
+}
+
+RID RenderingDeviceRecording::texture_buffer_create(uint32_t p_size_elements, DataFormat p_format, const Vector<uint8_t> &p_data) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_INDEX_V(p_format, DATA_FORMAT_MAX, RID());
+	ERR_FAIL_COND_V(p_size_elements == 0, RID());
+
+	uint32_t element_size = get_format_vertex_size(p_format);
+	ERR_FAIL_COND_V_MSG(element_size == 0, RID(), "Format requested is not supported for texture buffers");
+	uint64_t size_bytes = uint64_t(element_size) * p_size_elements;
+
+	ERR_FAIL_COND_V(p_data.size() && (uint32_t)p_data.size() != size_bytes, RID());
+
+	return _buffer_create(BUFFER_TYPE_TEXTURE, size_bytes, p_data);
+}
+
+RID RenderingDeviceRecording::uniform_set_create(const Vector<Uniform> &p_uniforms, RID p_shader, uint32_t p_shader_set) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_uniforms.size() == 0, RID());
+
+	const Shader *shader = shader_owner.getornull(p_shader);
+	ERR_FAIL_COND_V(!shader, RID());
+
+	ERR_FAIL_COND_V_MSG(p_shader_set >= (uint32_t)shader->sets.size() || shader->sets[p_shader_set].size() == 0, RID(),
+			"Desired set (" + itos(p_shader_set) + ") not used by shader.");
+
+	//see that all sets in shader are satisfied
+	const Vector<UniformInfo> &set_uniforms = shader->sets[p_shader_set];
+
+	for (int i = 0; i < set_uniforms.size(); i++) {
+		const UniformInfo &set_uniform = set_uniforms[i];
+		int uniform_idx = -1;
+		for (int j = 0; j < p_uniforms.size(); j++) {
+			if (p_uniforms[j].binding == set_uniform.binding) {
+				uniform_idx = j;
+			}
+		}
+		ERR_FAIL_COND_V_MSG(uniform_idx == -1, RID(),
+				"All the shader bindings for the given set must be covered by the uniforms provided.");
+
+		const Uniform &uniform = p_uniforms[uniform_idx];
+
+		ERR_FAIL_COND_V_MSG(uniform.type != set_uniform.type, RID(),
+				"Mismatch uniform type for binding (" + itos(set_uniform.binding) + "). Expected '" + shader_uniform_names[set_uniform.type] + "', supplied: '" + shader_uniform_names[uniform.type] + "'.");
+
+		switch (uniform.type) {
+			case UNIFORM_TYPE_SAMPLER_WITH_TEXTURE:
+			case UNIFORM_TYPE_SAMPLER_WITH_TEXTURE_BUFFER: {
+				ERR_FAIL_COND_V_MSG(uniform.ids.size() != set_uniform.length * 2, RID(),
+						"Uniform (binding: " + itos(uniform.binding) + ") expects (" + itos(set_uniform.length) + ") sampler and texture pairs (IDs provided: " + itos(uniform.ids.size()) + ").");
+			} break;
+			case UNIFORM_TYPE_UNIFORM_BUFFER:
+			case UNIFORM_TYPE_STORAGE_BUFFER: {
+				ERR_FAIL_COND_V_MSG(uniform.ids.size() != 1, RID(),
+						"Buffer supplied (binding: " + itos(uniform.binding) + ") must provide one ID (" + itos(uniform.ids.size()) + " provided).");
+
+				const Buffer *buffer = buffer_owner.getornull(uniform.ids[0]);
+				BufferType buffer_type = uniform.type == UNIFORM_TYPE_UNIFORM_BUFFER ? BUFFER_TYPE_UNIFORM : BUFFER_TYPE_STORAGE;
+				ERR_FAIL_COND_V_MSG(!buffer || buffer->type != buffer_type, RID(),
+						"Buffer supplied (binding: " + itos(uniform.binding) + ") is invalid.");
+				//storage buffers with a length of 0 are sized on link time
+				ERR_FAIL_COND_V_MSG((uniform.type == UNIFORM_TYPE_UNIFORM_BUFFER || set_uniform.length > 0) && buffer->size != (uint32_t)set_uniform.length, RID(),
+						"Buffer supplied (binding: " + itos(uniform.binding) + ") size (" + itos(buffer->size) + ") does not match size of shader uniform: (" + itos(set_uniform.length) + ").");
+			} break;
+			case UNIFORM_TYPE_INPUT_ATTACHMENT: {
+			} break;
+			default: {
+				ERR_FAIL_COND_V_MSG(uniform.ids.size() != set_uniform.length, RID(),
+						"Uniform (binding: " + itos(uniform.binding) + ") expects (" + itos(set_uniform.length) + ") IDs (IDs provided: " + itos(uniform.ids.size()) + ").");
+			}
+		}
+	}
+
+	for (int i = 0; i < p_uniforms.size(); i++) {
+		const Uniform &uniform = p_uniforms[i];
+		for (int j = 0; j < uniform.ids.size(); j++) {
+			RID rid = uniform.ids[j];
+			ERR_FAIL_COND_V_MSG(!texture_owner.owns(rid) && !buffer_owner.owns(rid) && !sampler_owner.owns(rid), RID(),
+					"Uniform (binding: " + itos(uniform.binding) + ") references an invalid or freed resource.");
+		}
+	}
+
+	UniformSet uniform_set;
+	uniform_set.shader = p_shader;
+	uniform_set.set = p_shader_set;
+
+	RID id = uniform_set_owner.make_rid(uniform_set);
+	//add dependencies, so the set is invalidated when any of its resources is freed
+	_add_dependency(id, p_shader);
+	for (int i = 0; i < p_uniforms.size(); i++) {
+		const Uniform &uniform = p_uniforms[i];
+		for (int j = 0; j < uniform.ids.size(); j++) {
+			if (!sampler_owner.owns(uniform.ids[j])) {
+				_add_dependency(id, uniform.ids[j]);
+			}
+		}
+	}
+
+	return id;
+}
+
+bool RenderingDeviceRecording::uniform_set_is_valid(RID p_uniform_set) {
+
+	return uniform_set_owner.owns(p_uniform_set);
+}
+
+Error RenderingDeviceRecording::buffer_update(RID p_buffer, uint32_t p_offset, uint32_t p_size, const void *p_data, bool p_sync_with_draw) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(draw_list.active && p_sync_with_draw, ERR_INVALID_PARAMETER,
+			"Updating buffers in 'sync to draw' mode is forbidden during creation of a draw list");
+
+	Buffer *buffer = buffer_owner.getornull(p_buffer);
+	ERR_FAIL_COND_V_MSG(!buffer, ERR_INVALID_PARAMETER, "Buffer argument is not a valid buffer of any type.");
+	ERR_FAIL_COND_V_MSG(p_offset + p_size > buffer->size, ERR_INVALID_PARAMETER,
+			"Attempted to write buffer (" + itos((p_offset + p_size) - buffer->size) + " bytes) past the end.");
+
+	if (p_size) {
+		copymem(buffer->data.ptrw() + p_offset, p_data, p_size);
+	}
+
+	_record(COMMAND_BUFFER_UPDATE, p_buffer, p_offset, p_size);
+	stats.upload_bytes += p_size;
+
+	return OK;
+}
+
+Vector<uint8_t> RenderingDeviceRecording::buffer_get_data(RID p_buffer) {
+
+	_THREAD_SAFE_METHOD_
+
+	Buffer *buffer = buffer_owner.getornull(p_buffer);
+	ERR_FAIL_COND_V_MSG(!buffer, Vector<uint8_t>(), "Buffer is either invalid or this type of buffer can't be retrieved. Only Index and Vertex buffers allow retrieving.");
+
+	return buffer->data;
+}
+
+/*************************/
+/**** RENDER PIPELINE ****/
+/*************************/
+
+RID RenderingDeviceRecording::render_pipeline_create(RID p_shader, FramebufferFormatID p_framebuffer_format, VertexFormatID p_vertex_format, RenderPrimitive p_render_primitive, const PipelineRasterizationState &p_rasterization_state, const PipelineMultisampleState &p_multisample_state, const PipelineDepthStencilState &p_depth_stencil_state, const PipelineColorBlendState &p_blend_state, int p_dynamic_state_flags) {
+
+	_THREAD_SAFE_METHOD_
+
+	Shader *shader = shader_owner.getornull(p_shader);
+	ERR_FAIL_COND_V(!shader, RID());
+	ERR_FAIL_COND_V_MSG(shader->stage_mask & (1 << SHADER_STAGE_COMPUTE), RID(),
+			"Compute shaders can't be used in render pipelines");
+	ERR_FAIL_INDEX_V(p_framebuffer_format, framebuffer_formats.size(), RID());
+	ERR_FAIL_COND_V(p_vertex_format != INVALID_ID && (p_vertex_format < 0 || p_vertex_format >= vertex_formats.size()), RID());
+	ERR_FAIL_INDEX_V(p_render_primitive, RENDER_PRIMITIVE_MAX, RID());
+	ERR_FAIL_COND_V_MSG(p_blend_state.attachments.size() > framebuffer_formats[p_framebuffer_format].size(), RID(),
+			"Blend state supplies more attachments than the framebuffer format has.");
+
+	if (p_vertex_format != INVALID_ID) {
+		//uses vertices, make sure the vertex format provides every attribute the shader reads
+		uint32_t provided_mask = 0;
+		const Vector<VertexDescription> &vd = vertex_formats[p_vertex_format];
+		for (int i = 0; i < vd.size(); i++) {
+			provided_mask |= 1 << vd[i].location;
+		}
+		ERR_FAIL_COND_V_MSG((shader->vertex_input_mask & provided_mask) != shader->vertex_input_mask, RID(),
+				"Vertex format does not provide all the attributes the shader requires (shader mask: " + itos(shader->vertex_input_mask) + ", vertex format mask: " + itos(provided_mask) + ").");
+	} else {
+		ERR_FAIL_COND_V_MSG(shader->vertex_input_mask != 0, RID(),
+				"Shader contains vertex inputs, but no vertex input description was provided for pipeline creation.");
+	}
+
+	RenderPipeline pipeline;
+	pipeline.shader = p_shader;
+	pipeline.framebuffer_format = p_framebuffer_format;
+	pipeline.vertex_format = p_vertex_format;
+	pipeline.push_constant_size = shader->push_constant_size;
+
+	RID id = render_pipeline_owner.make_rid(pipeline);
+	_add_dependency(id, p_shader);
+	return id;
+}
+
+bool RenderingDeviceRecording::render_pipeline_is_valid(RID p_pipeline) {
+
+	_THREAD_SAFE_METHOD_
+
+	return render_pipeline_owner.owns(p_pipeline);
+}
+
+/**************************/
+/**** COMPUTE PIPELINE ****/
+/**************************/
+
+RID RenderingDeviceRecording::compute_pipeline_create(RID p_shader) {
+
+	_THREAD_SAFE_METHOD_
+
+	Shader *shader = shader_owner.getornull(p_shader);
+	ERR_FAIL_COND_V(!shader, RID());
+	ERR_FAIL_COND_V_MSG(!(shader->stage_mask & (1 << SHADER_STAGE_COMPUTE)), RID(),
+			"Non-compute shaders can't be used in compute pipelines");
+
+	ComputePipeline pipeline;
+	pipeline.shader = p_shader;
+	pipeline.push_constant_size = shader->push_constant_size;
+
+	RID id = compute_pipeline_owner.make_rid(pipeline);
+	_add_dependency(id, p_shader);
+	return id;
+}
+
+bool RenderingDeviceRecording::compute_pipeline_is_valid(RID p_pipeline) {
+
+	return compute_pipeline_owner.owns(p_pipeline);
+}
+
+/****************/
+/**** SCREEN ****/
+/****************/
+
+int RenderingDeviceRecording::screen_get_width(int p_screen) const {
+
+	return OS::get_singleton()->get_video_mode(p_screen).width;
+}
+
+int RenderingDeviceRecording::screen_get_height(int p_screen) const {
+
+	return OS::get_singleton()->get_video_mode(p_screen).height;
+}
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecording::screen_get_framebuffer_format() const {
+
+	return screen_framebuffer_format;
+}
+
+/*******************/
+/**** DRAW LIST ****/
+/*******************/
+
+RenderingDevice::DrawListID RenderingDeviceRecording::draw_list_begin_for_screen(int p_screen, const Color &p_clear_color) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(draw_list.active, INVALID_ID, "Only one draw list can be active at the same time.");
+	ERR_FAIL_COND_V_MSG(compute_list.active, INVALID_ID, "Only one draw/compute list can be active at the same time.");
+
+	draw_list = DrawListState();
+	draw_list.active = true;
+	draw_list.framebuffer_format = screen_framebuffer_format;
+
+	_record(COMMAND_DRAW_LIST_BEGIN, RID(), p_screen);
+
+	return DRAW_LIST_ID;
+}
+
+RenderingDevice::DrawListID RenderingDeviceRecording::draw_list_begin(RID p_framebuffer, InitialAction p_initial_color_action, FinalAction p_final_color_action, InitialAction p_initial_depth_action, FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values, float p_clear_depth, uint32_t p_clear_stencil, const Rect2 &p_region) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(draw_list.active, INVALID_ID, "Only one draw list can be active at the same time.");
+	ERR_FAIL_COND_V_MSG(compute_list.active, INVALID_ID, "Only one draw/compute list can be active at the same time.");
+
+	Framebuffer *framebuffer = framebuffer_owner.getornull(p_framebuffer);
+	ERR_FAIL_COND_V(!framebuffer, INVALID_ID);
+
+	if (p_region != Rect2() && p_region != Rect2(Point2(), framebuffer->size)) {
+		ERR_FAIL_COND_V(p_region.position.x < 0 || p_region.position.y < 0, INVALID_ID);
+		ERR_FAIL_COND_V(p_region.position.x + p_region.size.x > framebuffer->size.width, INVALID_ID);
+		ERR_FAIL_COND_V(p_region.position.y + p_region.size.y > framebuffer->size.height, INVALID_ID);
+	}
+
+	if (p_initial_color_action == INITIAL_ACTION_CLEAR) {
+		int color_count = 0;
+		const Vector<AttachmentFormat> &format = framebuffer_formats[framebuffer->format];
+		for (int i = 0; i < format.size(); i++) {
+			if (format[i].usage_flags & TEXTURE_USAGE_COLOR_ATTACHMENT_BIT) {
+				color_count++;
+			}
+		}
+		ERR_FAIL_COND_V_MSG(p_clear_color_values.size() != color_count, INVALID_ID,
+				"Clear color values supplied (" + itos(p_clear_color_values.size()) + ") differ from the amount required for framebuffer color attachments (" + itos(color_count) + ").");
+	}
+
+	draw_list = DrawListState();
+	draw_list.active = true;
+	draw_list.framebuffer_format = framebuffer->format;
+
+	_record(COMMAND_DRAW_LIST_BEGIN, p_framebuffer, p_initial_color_action, p_initial_depth_action);
+
+	return DRAW_LIST_ID;
+}
+
+Error RenderingDeviceRecording::draw_list_begin_split(RID p_framebuffer, uint32_t p_splits, DrawListID *r_split_ids, InitialAction p_initial_color_action, FinalAction p_final_color_action, InitialAction p_initial_depth_action, FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values, float p_clear_depth, uint32_t p_clear_stencil, const Rect2 &p_region) {
+
+	ERR_FAIL_COND_V(p_splits < 1, ERR_INVALID_DECLARATION);
+
+	DrawListID id = draw_list_begin(p_framebuffer, p_initial_color_action, p_final_color_action, p_initial_depth_action, p_final_depth_action, p_clear_color_values, p_clear_depth, p_clear_stencil, p_region);
+	ERR_FAIL_COND_V(id == INVALID_ID, ERR_INVALID_PARAMETER);
+
+	// Splits are recorded sequentially into the same list, they all share the validation state.
+	draw_list.split_count = p_splits;
+	for (uint32_t i = 0; i < p_splits; i++) {
+		r_split_ids[i] = DRAW_LIST_ID + i;
+	}
+
+	return OK;
+}
+
+bool RenderingDeviceRecording::_validate_draw_list(DrawListID p_list) const {
+
+	ERR_FAIL_COND_V_MSG(!draw_list.active, false, "Submitted Draw Lists can no longer be modified.");
+	uint32_t splits = MAX(1u, draw_list.split_count);
+	ERR_FAIL_COND_V_MSG(p_list < DRAW_LIST_ID || p_list >= DRAW_LIST_ID + splits, false, "Draw list ID is not valid.");
+	return true;
+}
+
+void RenderingDeviceRecording::draw_list_bind_render_pipeline(DrawListID p_list, RID p_render_pipeline) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	const RenderPipeline *pipeline = render_pipeline_owner.getornull(p_render_pipeline);
+	ERR_FAIL_COND(!pipeline);
+	ERR_FAIL_COND_MSG(pipeline->framebuffer_format != draw_list.framebuffer_format,
+			"The framebuffer format of the pipeline (" + itos(pipeline->framebuffer_format) + ") does not match the one of the draw list (" + itos(draw_list.framebuffer_format) + ").");
+
+	draw_list.pipeline = p_render_pipeline;
+	draw_list.pipeline_vertex_format = pipeline->vertex_format;
+	draw_list.pipeline_push_constant_size = pipeline->push_constant_size;
+
+	_record(COMMAND_DRAW_LIST_BIND_RENDER_PIPELINE, p_render_pipeline);
+}
+
+void RenderingDeviceRecording::draw_list_bind_uniform_set(DrawListID p_list, RID p_uniform_set, uint32_t p_index) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	ERR_FAIL_COND_MSG(p_index >= (uint32_t)limit_get(LIMIT_MAX_BOUND_UNIFORM_SETS),
+			"Attempting to bind a descriptor set (" + itos(p_index) + ") greater than what the hardware supports (" + itos(limit_get(LIMIT_MAX_BOUND_UNIFORM_SETS)) + ").");
+	ERR_FAIL_COND_MSG(!uniform_set_owner.owns(p_uniform_set), "Uniform set is invalid or was freed.");
+
+	_record(COMMAND_DRAW_LIST_BIND_UNIFORM_SET, p_uniform_set, p_index);
+}
+
+void RenderingDeviceRecording::draw_list_bind_vertex_array(DrawListID p_list, RID p_vertex_array) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	const VertexArray *vertex_array = vertex_array_owner.getornull(p_vertex_array);
+	ERR_FAIL_COND(!vertex_array);
+
+	draw_list.vertex_array = p_vertex_array;
+	draw_list.vertex_count = vertex_array->vertex_count;
+	draw_list.vertex_format = vertex_array->format;
+
+	_record(COMMAND_DRAW_LIST_BIND_VERTEX_ARRAY, p_vertex_array);
+}
+
+void RenderingDeviceRecording::draw_list_bind_index_array(DrawListID p_list, RID p_index_array) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	const IndexArray *index_array = index_array_owner.getornull(p_index_array);
+	ERR_FAIL_COND(!index_array);
+
+	draw_list.index_array = p_index_array;
+	draw_list.index_count = index_array->index_count;
+
+	_record(COMMAND_DRAW_LIST_BIND_INDEX_ARRAY, p_index_array);
+}
+
+void RenderingDeviceRecording::draw_list_set_line_width(DrawListID p_list, float p_width) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	_record(COMMAND_DRAW_LIST_SET_LINE_WIDTH);
+}
+
+void RenderingDeviceRecording::draw_list_set_push_constant(DrawListID p_list, void *p_data, uint32_t p_data_size) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	ERR_FAIL_COND_MSG(p_data_size != draw_list.pipeline_push_constant_size,
+			"This render pipeline requires (" + itos(draw_list.pipeline_push_constant_size) + ") bytes of push constant data, supplied: (" + itos(p_data_size) + ")");
+
+	_record(COMMAND_DRAW_LIST_SET_PUSH_CONSTANT, RID(), p_data_size);
+}
+
+void RenderingDeviceRecording::draw_list_draw(DrawListID p_list, bool p_use_indices, uint32_t p_instances, uint32_t p_procedural_vertices) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	ERR_FAIL_COND_MSG(draw_list.pipeline.is_null(),
+			"No render pipeline was set before attempting to draw.");
+	ERR_FAIL_COND_MSG(!render_pipeline_owner.owns(draw_list.pipeline),
+			"The render pipeline bound for drawing was freed.");
+
+	if (draw_list.pipeline_vertex_format != INVALID_ID) {
+		ERR_FAIL_COND_MSG(draw_list.vertex_array.is_null(),
+				"No vertex array was bound, and render pipeline expects vertices.");
+		ERR_FAIL_COND_MSG(draw_list.pipeline_vertex_format != draw_list.vertex_format,
+				"The vertex format used to create the pipeline does not match the vertex format bound.");
+	}
+
+	uint32_t elements = 0;
+	if (p_use_indices) {
+		ERR_FAIL_COND_MSG(p_procedural_vertices > 0,
+				"Procedural vertices can't be used together with indices.");
+		ERR_FAIL_COND_MSG(draw_list.index_array.is_null(),
+				"Draw command requested indices, but no index buffer was set.");
+		elements = draw_list.index_count;
+	} else if (p_procedural_vertices > 0) {
+		ERR_FAIL_COND_MSG(draw_list.pipeline_vertex_format != INVALID_ID,
+				"Procedural vertices requested, but pipeline expects a vertex array.");
+		elements = p_procedural_vertices;
+	} else {
+		ERR_FAIL_COND_MSG(draw_list.pipeline_vertex_format == INVALID_ID,
+				"Draw command lacks indices, but pipeline format does not use vertices.");
+		elements = draw_list.vertex_count;
+	}
+
+	_record(COMMAND_DRAW_LIST_DRAW, draw_list.pipeline, elements, p_instances, p_use_indices ? 1 : 0);
+	stats.draw_instances += p_instances;
+	stats.draw_elements += uint64_t(elements) * p_instances;
+}
+
+void RenderingDeviceRecording::draw_list_enable_scissor(DrawListID p_list, const Rect2 &p_rect) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	_record(COMMAND_DRAW_LIST_ENABLE_SCISSOR);
+}
+
+void RenderingDeviceRecording::draw_list_disable_scissor(DrawListID p_list) {
+
+	if (!_validate_draw_list(p_list)) {
+		return;
+	}
+
+	_record(COMMAND_DRAW_LIST_DISABLE_SCISSOR);
+}
+
+void RenderingDeviceRecording::draw_list_end() {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_MSG(!draw_list.active, "Immediate draw list is already inactive.");
+
+	draw_list = DrawListState();
+
+	_record(COMMAND_DRAW_LIST_END);
+}
+
+/**********************/
+/**** COMPUTE LISTS ***/
+/**********************/
+
+RenderingDevice::ComputeListID RenderingDeviceRecording::compute_list_begin() {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(draw_list.active, INVALID_ID, "Only one draw/compute list can be active at the same time.");
+	ERR_FAIL_COND_V_MSG(compute_list.active, INVALID_ID, "Only one draw/compute list can be active at the same time.");
+
+	compute_list = ComputeListState();
+	compute_list.active = true;
+
+	_record(COMMAND_COMPUTE_LIST_BEGIN);
+
+	return COMPUTE_LIST_ID;
+}
+
+void RenderingDeviceRecording::compute_list_bind_compute_pipeline(ComputeListID p_list, RID p_compute_pipeline) {
+
+	ERR_FAIL_COND(p_list != COMPUTE_LIST_ID);
+	ERR_FAIL_COND_MSG(!compute_list.active, "Submitted Compute Lists can no longer be modified.");
+	const ComputePipeline *pipeline = compute_pipeline_owner.getornull(p_compute_pipeline);
+	ERR_FAIL_COND(!pipeline);
+
+	compute_list.pipeline = p_compute_pipeline;
+	compute_list.pipeline_push_constant_size = pipeline->push_constant_size;
+
+	_record(COMMAND_COMPUTE_LIST_BIND_COMPUTE_PIPELINE, p_compute_pipeline);
+}
+
+void RenderingDeviceRecording::compute_list_bind_uniform_set(ComputeListID p_list, RID p_uniform_set, uint32_t p_index) {
+
+	ERR_FAIL_COND(p_list != COMPUTE_LIST_ID);
+	ERR_FAIL_COND_MSG(!compute_list.active, "Submitted Compute Lists can no longer be modified.");
+	ERR_FAIL_COND_MSG(p_index >= (uint32_t)limit_get(LIMIT_MAX_BOUND_UNIFORM_SETS),
+			"Attempting to bind a descriptor set (" + itos(p_index) + ") greater than what the hardware supports (" + itos(limit_get(LIMIT_MAX_BOUND_UNIFORM_SETS)) + ").");
+	ERR_FAIL_COND_MSG(!uniform_set_owner.owns(p_uniform_set), "Uniform set is invalid or was freed.");
+
+	_record(COMMAND_COMPUTE_LIST_BIND_UNIFORM_SET, p_uniform_set, p_index);
+}
+
+void RenderingDeviceRecording::compute_list_set_push_constant(ComputeListID p_list, void *p_data, uint32_t p_data_size) {
+
+	ERR_FAIL_COND(p_list != COMPUTE_LIST_ID);
+	ERR_FAIL_COND_MSG(!compute_list.active, "Submitted Compute Lists can no longer be modified.");
+	ERR_FAIL_COND_MSG(p_data_size != compute_list.pipeline_push_constant_size,
+			"This compute pipeline requires (" + itos(compute_list.pipeline_push_constant_size) + ") bytes of push constant data, supplied: (" + itos(p_data_size) + ")");
+
+	_record(COMMAND_COMPUTE_LIST_SET_PUSH_CONSTANT, RID(), p_data_size);
+}
+
+void RenderingDeviceRecording::compute_list_dispatch(ComputeListID p_list, uint32_t p_x_groups, uint32_t p_y_groups, uint32_t p_z_groups) {
+
+	ERR_FAIL_COND(p_list != COMPUTE_LIST_ID);
+	ERR_FAIL_COND_MSG(!compute_list.active, "Submitted Compute Lists can no longer be modified.");
+	ERR_FAIL_COND_MSG(compute_list.pipeline.is_null(), "No compute pipeline was set before attempting to dispatch.");
+	ERR_FAIL_COND_MSG(p_x_groups == 0 || p_y_groups == 0 || p_z_groups == 0, "Dispatch amount of groups can't be zero.");
+
+	_record(COMMAND_COMPUTE_LIST_DISPATCH, compute_list.pipeline, p_x_groups, p_y_groups, p_z_groups);
+}
+
+void RenderingDeviceRecording::compute_list_add_barrier(ComputeListID p_list) {
+
+	ERR_FAIL_COND(p_list != COMPUTE_LIST_ID);
+	ERR_FAIL_COND_MSG(!compute_list.active, "Submitted Compute Lists can no longer be modified.");
+
+	_record(COMMAND_COMPUTE_LIST_ADD_BARRIER);
+}
+
+void RenderingDeviceRecording::compute_list_end() {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_MSG(!compute_list.active, "Immediate compute list is already inactive.");
+
+	compute_list = ComputeListState();
+
+	_record(COMMAND_COMPUTE_LIST_END);
+}
+
+/***********************/
+/**** COMMAND LISTS ****/
+/***********************/
+
+void RenderingDeviceRecording::free(RID p_id) {
+
+	_THREAD_SAFE_METHOD_
+
+	_free_dependencies(p_id); //recursively erase dependencies first, to avoid potential API problems
+
+	if (texture_owner.owns(p_id)) {
+		texture_owner.free(p_id);
+	} else if (framebuffer_owner.owns(p_id)) {
+		framebuffer_owner.free(p_id);
+	} else if (sampler_owner.owns(p_id)) {
+		sampler_owner.free(p_id);
+	} else if (buffer_owner.owns(p_id)) {
+		buffer_owner.free(p_id);
+	} else if (vertex_array_owner.owns(p_id)) {
+		vertex_array_owner.free(p_id);
+	} else if (index_array_owner.owns(p_id)) {
+		index_array_owner.free(p_id);
+	} else if (shader_owner.owns(p_id)) {
+		shader_owner.free(p_id);
+	} else if (uniform_set_owner.owns(p_id)) {
+		uniform_set_owner.free(p_id);
+	} else if (render_pipeline_owner.owns(p_id)) {
+		render_pipeline_owner.free(p_id);
+	} else if (compute_pipeline_owner.owns(p_id)) {
+		compute_pipeline_owner.free(p_id);
+	} else {
+		ERR_PRINT("Attempted to free invalid ID: " + itos(p_id.get_id()));
+	}
+}
+
+void RenderingDeviceRecording::capture_timestamp(const String &p_name, bool p_sync_to_draw) {
+
+	ERR_FAIL_COND(timestamp_count == MAX_TIMESTAMPS);
+
+	timestamp_names[timestamp_count] = p_name;
+	timestamp_cpu_values[timestamp_count] = OS::get_singleton()->get_ticks_usec();
+	timestamp_count++;
+}
+
+uint32_t RenderingDeviceRecording::get_captured_timestamps_count() const {
+
+	return timestamp_result_count;
+}
+
+uint64_t RenderingDeviceRecording::get_captured_timestamps_frame() const {
+
+	return frames_drawn;
+}
+
+uint64_t RenderingDeviceRecording::get_captured_timestamp_gpu_time(uint32_t p_index) const {
+
+	// There is no GPU, report the CPU time at which the command was recorded (in nanoseconds).
+	ERR_FAIL_UNSIGNED_INDEX_V(p_index, timestamp_result_count, 0);
+	return timestamp_cpu_result_values[p_index] * 1000;
+}
+
+uint64_t RenderingDeviceRecording::get_captured_timestamp_cpu_time(uint32_t p_index) const {
+
+	ERR_FAIL_UNSIGNED_INDEX_V(p_index, timestamp_result_count, 0);
+	return timestamp_cpu_result_values[p_index];
+}
+
+String RenderingDeviceRecording::get_captured_timestamp_name(uint32_t p_index) const {
+
+	ERR_FAIL_UNSIGNED_INDEX_V(p_index, timestamp_result_count, String());
+	return timestamp_result_names[p_index];
+}
+
+int RenderingDeviceRecording::limit_get(Limit p_limit) {
+
+	switch (p_limit) {
+		case LIMIT_MAX_BOUND_UNIFORM_SETS: return MAX_UNIFORM_SETS;
+		case LIMIT_MAX_FRAMEBUFFER_COLOR_ATTACHMENTS: return 8;
+		case LIMIT_MAX_PUSH_CONSTANT_SIZE: return MAX_PUSH_CONSTANT_SIZE;
+		case LIMIT_MAX_UNIFORM_BUFFER_SIZE: return 65536;
+		case LIMIT_MAX_VERTEX_INPUT_ATTRIBUTES: return 16;
+		case LIMIT_MAX_VERTEX_INPUT_BINDINGS: return 16;
+		case LIMIT_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT: return 256;
+		case LIMIT_MAX_COMPUTE_WORKGROUP_INVOCATIONS: return 1024;
+		case LIMIT_MAX_COMPUTE_WORKGROUP_SIZE_X: return 1024;
+		case LIMIT_MAX_COMPUTE_WORKGROUP_SIZE_Y: return 1024;
+		case LIMIT_MAX_COMPUTE_WORKGROUP_SIZE_Z: return 64;
+		default: return 0x7FFFFFFF;
+	}
+}
+
+void RenderingDeviceRecording::prepare_screen_for_drawing() {
+}
+
+void RenderingDeviceRecording::swap_buffers() {
+
+	_THREAD_SAFE_METHOD_
+
+	if (draw_list.active) {
+		ERR_PRINT("Found open draw list at the end of the frame, this should never happen (further drawing will likely not work).");
+	}
+
+	if (compute_list.active) {
+		ERR_PRINT("Found open compute list at the end of the frame, this should never happen (further compute will likely not work).");
+	}
+
+	for (uint32_t i = 0; i < timestamp_count; i++) {
+		timestamp_result_names[i] = timestamp_names[i];
+		timestamp_cpu_result_values[i] = timestamp_cpu_values[i];
+	}
+	timestamp_result_count = timestamp_count;
+	timestamp_count = 0;
+
+	last_frame_stats = stats;
+	stats = FrameStats();
+
+	last_frame_commands = commands;
+	commands.clear();
+
+	frames_drawn++;
+}
+
+uint32_t RenderingDeviceRecording::get_frame_delay() const {
+
+	return 1;
+}
+
+void RenderingDeviceRecording::set_command_log_enabled(bool p_enabled) {
+
+	command_log_enabled = p_enabled;
+}
+
+bool RenderingDeviceRecording::is_command_log_enabled() const {
+
+	return command_log_enabled;
+}
+
+const Vector<RenderingDeviceRecording::Command> &RenderingDeviceRecording::get_last_frame_commands() const {
+
+	return last_frame_commands;
+}
+
+const RenderingDeviceRecording::FrameStats &RenderingDeviceRecording::get_last_frame_stats() const {
+
+	return last_frame_stats;
+}
+
+const char *RenderingDeviceRecording::get_command_name(CommandType p_type) {
+
+	static const char *names[COMMAND_MAX] = {
+		"DrawListBegin",
+		"DrawListBindRenderPipeline",
+		"DrawListBindUniformSet",
+		"DrawListBindVertexArray",
+		"DrawListBindIndexArray",
+		"DrawListSetLineWidth",
+		"DrawListSetPushConstant",
+		"DrawListDraw",
+		"DrawListEnableScissor",
+		"DrawListDisableScissor",
+		"DrawListEnd",
+		"ComputeListBegin",
+		"ComputeListBindComputePipeline",
+		"ComputeListBindUniformSet",
+		"ComputeListSetPushConstant",
+		"ComputeListDispatch",
+		"ComputeListAddBarrier",
+		"ComputeListEnd",
+		"BufferUpdate",
+		"TextureUpdate",
+		"TextureCopy",
+		"TextureClear",
+	};
+
+	ERR_FAIL_INDEX_V(p_type, COMMAND_MAX, "");
+	return names[p_type];
+}
+
+template <class T>
+static void _free_rids(T &p_owner, RenderingDeviceRecording *p_device, const char *p_type) {
+
+	List<RID> owned;
+	p_owner.get_owned_list(&owned);
+	if (owned.size()) {
+		WARN_PRINT(itos(owned.size()) + " RIDs of type '" + p_type + "' were leaked.");
+		for (List<RID>::Element *E = owned.front(); E; E = E->next()) {
+			if (p_owner.owns(E->get())) { //may have been freed as a dependency
+				p_device->free(E->get());
+			}
+		}
+	}
+}
+
+void RenderingDeviceRecording::initialize() {
+
+	Vector<AttachmentFormat> screen_format;
+	AttachmentFormat af;
+	af.format = DATA_FORMAT_B8G8R8A8_UNORM;
+	af.usage_flags = TEXTURE_USAGE_COLOR_ATTACHMENT_BIT;
+	screen_format.push_back(af);
+	screen_framebuffer_format = framebuffer_format_create(screen_format);
+
+	frames_drawn = 0;
+}
+
+void RenderingDeviceRecording::finalize() {
+
+	_free_rids(render_pipeline_owner, this, "Pipeline");
+	_free_rids(compute_pipeline_owner, this, "Compute");
+	_free_rids(uniform_set_owner, this, "UniformSet");
+	_free_rids(shader_owner, this, "Shader");
+	_free_rids(index_array_owner, this, "IndexArray");
+	_free_rids(vertex_array_owner, this, "VertexArray");
+	_free_rids(framebuffer_owner, this, "Framebuffer");
+	_free_rids(sampler_owner, this, "Sampler");
+	_free_rids(texture_owner, this, "Texture");
+	_free_rids(buffer_owner, this, "Buffer");
+
+	framebuffer_formats.clear();
+	vertex_formats.clear();
+	commands.clear();
+	last_frame_commands.clear();
+}
+
+RenderingDeviceRecording::RenderingDeviceRecording() {
+
+	screen_framebuffer_format = INVALID_ID;
+}
+
+RenderingDeviceRecording::~RenderingDeviceRecording() {
+}
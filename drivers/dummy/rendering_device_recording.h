@@ -0,0 +1,376 @@
+/*************************************************************************/
+/*  rendering_device_recording.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RENDERING_DEVICE_RECORDING_H
+#define RENDERING_DEVICE_RECORDING_H
+
+#include "core/map.h"
+#include "core/os/thread_safe.h"
+#include "core/rid_owner.h"
+#include "core/set.h"
+#include "servers/visual/rendering_device.h"
+
+// Headless RenderingDevice. Resources are kept in CPU memory and commands are
+// validated and recorded, but nothing is ever executed. This allows running
+// (and profiling) the CPU side of the RD renderer without a GPU.
+
+class RenderingDeviceRecording : public RenderingDevice {
+	GDCLASS(RenderingDeviceRecording, RenderingDevice)
+
+	_THREAD_SAFE_CLASS_
+
+public:
+	enum CommandType {
+		COMMAND_DRAW_LIST_BEGIN,
+		COMMAND_DRAW_LIST_BIND_RENDER_PIPELINE,
+		COMMAND_DRAW_LIST_BIND_UNIFORM_SET,
+		COMMAND_DRAW_LIST_BIND_VERTEX_ARRAY,
+		COMMAND_DRAW_LIST_BIND_INDEX_ARRAY,
+		COMMAND_DRAW_LIST_SET_LINE_WIDTH,
+		COMMAND_DRAW_LIST_SET_PUSH_CONSTANT,
+		COMMAND_DRAW_LIST_DRAW,
+		COMMAND_DRAW_LIST_ENABLE_SCISSOR,
+		COMMAND_DRAW_LIST_DISABLE_SCISSOR,
+		COMMAND_DRAW_LIST_END,
+		COMMAND_COMPUTE_LIST_BEGIN,
+		COMMAND_COMPUTE_LIST_BIND_COMPUTE_PIPELINE,
+		COMMAND_COMPUTE_LIST_BIND_UNIFORM_SET,
+		COMMAND_COMPUTE_LIST_SET_PUSH_CONSTANT,
+		COMMAND_COMPUTE_LIST_DISPATCH,
+		COMMAND_COMPUTE_LIST_ADD_BARRIER,
+		COMMAND_COMPUTE_LIST_END,
+		COMMAND_BUFFER_UPDATE,
+		COMMAND_TEXTURE_UPDATE,
+		COMMAND_TEXTURE_COPY,
+		COMMAND_TEXTURE_CLEAR,
+		COMMAND_MAX
+	};
+
+	struct Command {
+		CommandType type;
+		RID resource;
+		uint32_t params[3];
+	};
+
+	struct FrameStats {
+		uint32_t command_count[COMMAND_MAX];
+		uint64_t draw_instances;
+		uint64_t draw_elements; //indices or vertices submitted
+		uint64_t upload_bytes;
+
+		FrameStats() {
+			for (int i = 0; i < COMMAND_MAX; i++) {
+				command_count[i] = 0;
+			}
+			draw_instances = 0;
+			draw_elements = 0;
+			upload_bytes = 0;
+		}
+	};
+
+private:
+	enum {
+		DRAW_LIST_ID = 1,
+		COMPUTE_LIST_ID = 1 << 16,
+		MAX_TIMESTAMPS = 256,
+		MAX_PUSH_CONSTANT_SIZE = 128,
+		MAX_UNIFORM_SETS = 8,
+	};
+
+	/* RESOURCES */
+
+	struct Texture {
+		TextureFormat format;
+		uint32_t layer_size; //bytes per layer, all mipmaps included
+		Vector<Vector<uint8_t> > layers; //only what was supplied, GPU writes are not simulated
+		RID owner; //valid if shared
+	};
+
+	RID_Owner<Texture> texture_owner;
+
+	enum BufferType {
+		BUFFER_TYPE_VERTEX,
+		BUFFER_TYPE_INDEX,
+		BUFFER_TYPE_UNIFORM,
+		BUFFER_TYPE_STORAGE,
+		BUFFER_TYPE_TEXTURE,
+	};
+
+	struct Buffer {
+		BufferType type;
+		uint32_t size;
+		IndexBufferFormat index_format;
+		Vector<uint8_t> data;
+	};
+
+	RID_Owner<Buffer> buffer_owner;
+
+	struct VertexArray {
+		uint32_t vertex_count;
+		VertexFormatID format;
+	};
+
+	RID_Owner<VertexArray> vertex_array_owner;
+
+	struct IndexArray {
+		uint32_t index_offset;
+		uint32_t index_count;
+	};
+
+	RID_Owner<IndexArray> index_array_owner;
+
+	struct UniformInfo {
+		UniformType type;
+		int binding;
+		int length; //size of arrays (in total elements), or ubos (in bytes * total elements)
+	};
+
+	// Filled from SPIR-V reflection, the same way real devices do, so
+	// uniform sets, vertex streams and push constants are validated
+	// against what the shader actually declares.
+	struct Shader {
+		uint32_t stage_mask;
+		uint32_t vertex_input_mask;
+		uint32_t push_constant_size;
+		Vector<Vector<UniformInfo> > sets;
+	};
+
+	RID_Owner<Shader> shader_owner;
+
+	struct UniformSet {
+		RID shader;
+		uint32_t set;
+	};
+
+	RID_Owner<UniformSet> uniform_set_owner;
+
+	struct Framebuffer {
+		FramebufferFormatID format;
+		Size2i size;
+	};
+
+	RID_Owner<Framebuffer> framebuffer_owner;
+
+	struct RenderPipeline {
+		RID shader;
+		FramebufferFormatID framebuffer_format;
+		VertexFormatID vertex_format;
+		uint32_t push_constant_size;
+	};
+
+	RID_Owner<RenderPipeline> render_pipeline_owner;
+
+	struct ComputePipeline {
+		RID shader;
+		uint32_t push_constant_size;
+	};
+
+	RID_Owner<ComputePipeline> compute_pipeline_owner;
+
+	RID_Owner<SamplerState> sampler_owner;
+
+	Vector<Vector<AttachmentFormat> > framebuffer_formats;
+	Vector<Vector<VertexDescription> > vertex_formats;
+	FramebufferFormatID screen_framebuffer_format;
+
+	// Freeing a resource frees what depends on it (uniform sets, framebuffers, shared textures), same as real devices.
+	Map<RID, Set<RID> > dependency_map;
+	Map<RID, Set<RID> > reverse_dependency_map;
+
+	void _add_dependency(RID p_id, RID p_depends_on);
+	void _free_dependencies(RID p_id);
+
+	RID _buffer_create(BufferType p_type, uint32_t p_size, const Vector<uint8_t> &p_data);
+
+	/* COMMAND STATE */
+
+	struct DrawListState {
+		bool active = false;
+		uint32_t split_count = 0;
+		FramebufferFormatID framebuffer_format = INVALID_ID;
+		RID pipeline;
+		VertexFormatID pipeline_vertex_format = INVALID_ID;
+		uint32_t pipeline_push_constant_size = 0;
+		RID vertex_array;
+		uint32_t vertex_count = 0;
+		VertexFormatID vertex_format = INVALID_ID;
+		RID index_array;
+		uint32_t index_count = 0;
+	} draw_list;
+
+	struct ComputeListState {
+		bool active = false;
+		RID pipeline;
+		uint32_t pipeline_push_constant_size = 0;
+	} compute_list;
+
+	bool _validate_draw_list(DrawListID p_list) const;
+
+	/* RECORDING */
+
+	bool command_log_enabled = false;
+	Vector<Command> commands;
+	Vector<Command> last_frame_commands;
+	FrameStats stats;
+	FrameStats last_frame_stats;
+	uint64_t frames_drawn = 0;
+
+	_FORCE_INLINE_ void _record(CommandType p_type, RID p_resource = RID(), uint32_t p_param0 = 0, uint32_t p_param1 = 0, uint32_t p_param2 = 0) {
+		stats.command_count[p_type]++;
+		if (command_log_enabled) {
+			Command c;
+			c.type = p_type;
+			c.resource = p_resource;
+			c.params[0] = p_param0;
+			c.params[1] = p_param1;
+			c.params[2] = p_param2;
+			commands.push_back(c);
+		}
+	}
+
+	String timestamp_names[MAX_TIMESTAMPS];
+	uint64_t timestamp_cpu_values[MAX_TIMESTAMPS];
+	uint32_t timestamp_count = 0;
+	String timestamp_result_names[MAX_TIMESTAMPS];
+	uint64_t timestamp_cpu_result_values[MAX_TIMESTAMPS];
+	uint32_t timestamp_result_count = 0;
+
+public:
+	virtual RID texture_create(const TextureFormat &p_format, const TextureView &p_view, const Vector<Vector<uint8_t> > &p_data = Vector<Vector<uint8_t> >());
+	virtual RID texture_create_shared(const TextureView &p_view, RID p_with_texture);
+	virtual RID texture_create_shared_from_slice(const TextureView &p_view, RID p_with_texture, uint32_t p_layer, uint32_t p_mipmap, TextureSliceType p_slice_type = TEXTURE_SLICE_2D);
+	virtual Error texture_update(RID p_texture, uint32_t p_layer, const Vector<uint8_t> &p_data, bool p_sync_with_draw = false);
+	virtual Vector<uint8_t> texture_get_data(RID p_texture, uint32_t p_layer);
+
+	virtual bool texture_is_format_supported_for_usage(DataFormat p_format, uint32_t p_usage) const;
+	virtual bool texture_is_shared(RID p_texture);
+	virtual bool texture_is_valid(RID p_texture);
+
+	virtual Error texture_copy(RID p_from_texture, RID p_to_texture, const Vector3 &p_from, const Vector3 &p_to, const Vector3 &p_size, uint32_t p_src_mipmap, uint32_t p_dst_mipmap, uint32_t p_src_layer, uint32_t p_dst_layer, bool p_sync_with_draw = false);
+	virtual Error texture_clear(RID p_texture, const Color &p_color, uint32_t p_base_mipmap, uint32_t p_mipmaps, uint32_t p_base_layer, uint32_t p_layers, bool p_sync_with_draw = false);
+
+	virtual FramebufferFormatID framebuffer_format_create(const Vector<AttachmentFormat> &p_format);
+	virtual TextureSamples framebuffer_format_get_texture_samples(FramebufferFormatID p_format);
+	virtual RID framebuffer_create(const Vector<RID> &p_texture_attachments, FramebufferFormatID p_format_check = INVALID_ID);
+	virtual FramebufferFormatID framebuffer_get_format(RID p_framebuffer);
+
+	virtual RID sampler_create(const SamplerState &p_state);
+
+	virtual RID vertex_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data = Vector<uint8_t>());
+	virtual VertexFormatID vertex_format_create(const Vector<VertexDescription> &p_vertex_formats);
+	virtual RID vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers);
+
+	virtual RID index_buffer_create(uint32_t p_size_indices, IndexBufferFormat p_format, const Vector<uint8_t> &p_data = Vector<uint8_t>(), bool p_use_restart_indices = false);
+	virtual RID index_array_create(RID p_index_buffer, uint32_t p_index_offset, uint32_t p_index_count);
+
+	virtual RID shader_create(const Vector<ShaderStageData> &p_stages);
+	virtual uint32_t shader_get_vertex_input_attribute_mask(RID p_shader);
+
+	virtual RID uniform_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data = Vector<uint8_t>());
+	virtual RID storage_buffer_create(uint32_t p_size, const Vector<uint8_t> &p_data = Vector<uint8_t>());
+	virtual RID texture_buffer_create(uint32_t p_size_elements, DataFormat p_format, const Vector<uint8_t> &p_data = Vector<uint8_t>());
+
+	virtual RID uniform_set_create(const Vector<Uniform> &p_uniforms, RID p_shader, uint32_t p_shader_set);
+	virtual bool uniform_set_is_valid(RID p_uniform_set);
+
+	virtual Error buffer_update(RID p_buffer, uint32_t p_offset, uint32_t p_size, const void *p_data, bool p_sync_with_draw = false);
+	virtual Vector<uint8_t> buffer_get_data(RID p_buffer);
+
+	virtual RID render_pipeline_create(RID p_shader, FramebufferFormatID p_framebuffer_format, VertexFormatID p_vertex_format, RenderPrimitive p_render_primitive, const PipelineRasterizationState &p_rasterization_state, const PipelineMultisampleState &p_multisample_state, const PipelineDepthStencilState &p_depth_stencil_state, const PipelineColorBlendState &p_blend_state, int p_dynamic_state_flags = 0);
+	virtual bool render_pipeline_is_valid(RID p_pipeline);
+
+	virtual RID compute_pipeline_create(RID p_shader);
+	virtual bool compute_pipeline_is_valid(RID p_pipeline);
+
+	virtual int screen_get_width(int p_screen = 0) const;
+	virtual int screen_get_height(int p_screen = 0) const;
+	virtual FramebufferFormatID screen_get_framebuffer_format() const;
+
+	virtual DrawListID draw_list_begin_for_screen(int p_screen = 0, const Color &p_clear_color = Color());
+	virtual DrawListID draw_list_begin(RID p_framebuffer, InitialAction p_initial_color_action, FinalAction p_final_color_action, InitialAction p_initial_depth_action, FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values = Vector<Color>(), float p_clear_depth = 1.0, uint32_t p_clear_stencil = 0, const Rect2 &p_region = Rect2());
+	virtual Error draw_list_begin_split(RID p_framebuffer, uint32_t p_splits, DrawListID *r_split_ids, InitialAction p_initial_color_action, FinalAction p_final_color_action, InitialAction p_initial_depth_action, FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values = Vector<Color>(), float p_clear_depth = 1.0, uint32_t p_clear_stencil = 0, const Rect2 &p_region = Rect2());
+
+	virtual void draw_list_bind_render_pipeline(DrawListID p_list, RID p_render_pipeline);
+	virtual void draw_list_bind_uniform_set(DrawListID p_list, RID p_uniform_set, uint32_t p_index);
+	virtual void draw_list_bind_vertex_array(DrawListID p_list, RID p_vertex_array);
+	virtual void draw_list_bind_index_array(DrawListID p_list, RID p_index_array);
+	virtual void draw_list_set_line_width(DrawListID p_list, float p_width);
+	virtual void draw_list_set_push_constant(DrawListID p_list, void *p_data, uint32_t p_data_size);
+
+	virtual void draw_list_draw(DrawListID p_list, bool p_use_indices, uint32_t p_instances = 1, uint32_t p_procedural_vertices = 0);
+
+	virtual void draw_list_enable_scissor(DrawListID p_list, const Rect2 &p_rect);
+	virtual void draw_list_disable_scissor(DrawListID p_list);
+
+	virtual void draw_list_end();
+
+	virtual ComputeListID compute_list_begin();
+	virtual void compute_list_bind_compute_pipeline(ComputeListID p_list, RID p_compute_pipeline);
+	virtual void compute_list_bind_uniform_set(ComputeListID p_list, RID p_uniform_set, uint32_t p_index);
+	virtual void compute_list_set_push_constant(ComputeListID p_list, void *p_data, uint32_t p_data_size);
+	virtual void compute_list_dispatch(ComputeListID p_list, uint32_t p_x_groups, uint32_t p_y_groups, uint32_t p_z_groups);
+	virtual void compute_list_add_barrier(ComputeListID p_list);
+	virtual void compute_list_end();
+
+	virtual void free(RID p_id);
+
+	virtual void capture_timestamp(const String &p_name, bool p_sync_to_draw);
+	virtual uint32_t get_captured_timestamps_count() const;
+	virtual uint64_t get_captured_timestamps_frame() const;
+	virtual uint64_t get_captured_timestamp_gpu_time(uint32_t p_index) const;
+	virtual uint64_t get_captured_timestamp_cpu_time(uint32_t p_index) const;
+	virtual String get_captured_timestamp_name(uint32_t p_index) const;
+
+	virtual int limit_get(Limit p_limit);
+
+	virtual void prepare_screen_for_drawing();
+	virtual void swap_buffers();
+
+	virtual uint32_t get_frame_delay() const;
+
+	/* RECORDING API */
+
+	void set_command_log_enabled(bool p_enabled);
+	bool is_command_log_enabled() const;
+
+	// Results of the last finished frame (after swap_buffers).
+	const Vector<Command> &get_last_frame_commands() const;
+	const FrameStats &get_last_frame_stats() const;
+
+	static const char *get_command_name(CommandType p_type);
+
+	void initialize();
+	void finalize();
+
+	RenderingDeviceRecording();
+	~RenderingDeviceRecording();
+};
+
+#endif // RENDERING_DEVICE_RECORDING_H
@@ -41,6 +41,7 @@
 #include <errno.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -72,11 +73,24 @@ void FileAccessUnix::check_errors() const {
 	}
 }
 
+void FileAccessUnix::_unmap() {
+
+#if defined(UNIX_ENABLED)
+	if (mapping) {
+		munmap((void *)mapping, mapping_size);
+	}
+#endif
+	mapping = NULL;
+	mapping_size = 0;
+	mapping_failed = false;
+}
+
 Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 
 	if (f)
 		fclose(f);
 	f = NULL;
+	_unmap();
 
 	path_src = p_path;
 	path = fix_path(p_path);
@@ -156,6 +170,7 @@ void FileAccessUnix::close() {
 
 	fclose(f);
 	f = NULL;
+	_unmap();
 
 	if (close_notification_func) {
 		close_notification_func(path, flags);
@@ -255,6 +270,53 @@ int FileAccessUnix::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 };
 
+const uint8_t *FileAccessUnix::get_buffer_ptr(uint64_t p_length) const {
+
+	ERR_FAIL_COND_V_MSG(!f, NULL, "File must be opened before use.");
+
+#if defined(UNIX_ENABLED)
+	if (flags != READ) {
+		return NULL; // Writes through the stream would not be seen.
+	}
+
+	// The whole file is mapped the first time, read-only.
+	if (!mapping) {
+		if (mapping_failed) {
+			return NULL;
+		}
+
+		struct stat st;
+		int fd = fileno(f);
+		if (fd == -1 || fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > SIZE_MAX) {
+			mapping_failed = true;
+			return NULL;
+		}
+
+		void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr == MAP_FAILED) {
+			mapping_failed = true;
+			return NULL;
+		}
+
+		mapping = (const uint8_t *)addr;
+		mapping_size = st.st_size;
+	}
+
+	size_t pos = get_position();
+	if (pos > mapping_size || p_length > mapping_size - pos) {
+		return NULL;
+	}
+
+	if (fseek(f, pos + p_length, SEEK_SET)) {
+		check_errors();
+		return NULL;
+	}
+	return mapping + pos;
+#else
+	return NULL;
+#endif
+}
+
 Error FileAccessUnix::get_error() const {
 
 	return last_error;
@@ -357,6 +419,9 @@ CloseNotificationFunc FileAccessUnix::close_notification_func = NULL;
 FileAccessUnix::FileAccessUnix() :
 		f(NULL),
 		flags(0),
+		mapping(NULL),
+		mapping_size(0),
+		mapping_failed(false),
 		last_error(OK) {
 }
 
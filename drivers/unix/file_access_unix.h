@@ -44,7 +44,11 @@ class FileAccessUnix : public FileAccess {
 
 	FILE *f;
 	int flags;
+	mutable const uint8_t *mapping;
+	mutable size_t mapping_size;
+	mutable bool mapping_failed;
 	void check_errors() const;
+	void _unmap();
 	mutable Error last_error;
 	String save_path;
 	String path;
@@ -71,6 +75,7 @@ public:
 
 	virtual uint8_t get_8() const; ///< get a byte
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_buffer_ptr(uint64_t p_length) const;
 
 	virtual Error get_error() const; ///< get last error
 
@@ -0,0 +1,351 @@
+/*************************************************************************/
+/*  file_read_queue_io_uring.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_read_queue_io_uring.h"
+
+#if defined(UNIX_ENABLED) && defined(HAVE_IO_URING)
+
+#include "core/os/memory.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define RING_ENTRIES 64
+// Files kept open once none of their reads are in flight.
+#define MAX_IDLE_FILES 16
+
+bool FileReadQueueIOUring::_setup_ring() {
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	ring_fd = syscall(__NR_io_uring_setup, RING_ENTRIES, &params);
+	if (ring_fd < 0)
+		return false;
+
+	sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+	single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+#endif
+	if (single_mmap) {
+		sq_ring_size = MAX(sq_ring_size, cq_ring_size);
+		cq_ring_size = sq_ring_size;
+	}
+
+	sq_ring = mmap(NULL, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+	if (sq_ring == MAP_FAILED) {
+		sq_ring = NULL;
+		return false;
+	}
+
+	if (single_mmap) {
+		cq_ring = sq_ring;
+	} else {
+		cq_ring = mmap(NULL, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+		if (cq_ring == MAP_FAILED) {
+			cq_ring = NULL;
+			return false;
+		}
+	}
+
+	void *sqes_mapping = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+	if (sqes_mapping == MAP_FAILED)
+		return false;
+	sqes = (struct io_uring_sqe *)sqes_mapping;
+
+	uint8_t *sq = (uint8_t *)sq_ring;
+	sq_head = (uint32_t *)(sq + params.sq_off.head);
+	sq_tail = (uint32_t *)(sq + params.sq_off.tail);
+	sq_mask = *(uint32_t *)(sq + params.sq_off.ring_mask);
+	sq_entries = *(uint32_t *)(sq + params.sq_off.ring_entries);
+	sq_array = (uint32_t *)(sq + params.sq_off.array);
+
+	uint8_t *cq = (uint8_t *)cq_ring;
+	cq_head = (uint32_t *)(cq + params.cq_off.head);
+	cq_tail = (uint32_t *)(cq + params.cq_off.tail);
+	cq_mask = *(uint32_t *)(cq + params.cq_off.ring_mask);
+	cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+void FileReadQueueIOUring::_close_ring() {
+
+	if (sqes)
+		munmap(sqes, sqes_size);
+	if (cq_ring && cq_ring != sq_ring)
+		munmap(cq_ring, cq_ring_size);
+	if (sq_ring)
+		munmap(sq_ring, sq_ring_size);
+	if (ring_fd >= 0)
+		close(ring_fd);
+
+	sqes = NULL;
+	cq_ring = NULL;
+	sq_ring = NULL;
+	ring_fd = -1;
+}
+
+void FileReadQueueIOUring::_push(NativeRead *p_native_read) {
+
+	// Only this thread produces submissions, the kernel advances the head as it consumes them.
+	uint32_t tail = *sq_tail;
+	uint32_t index = tail & sq_mask;
+
+	p_native_read->iov.iov_base = p_native_read->read->dst + p_native_read->read_bytes;
+	p_native_read->iov.iov_len = p_native_read->length - p_native_read->read_bytes;
+
+	struct io_uring_sqe *sqe = &sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_READV;
+	sqe->fd = p_native_read->fd;
+	sqe->off = p_native_read->offset + p_native_read->read_bytes;
+	sqe->addr = (uint64_t)(uintptr_t)&p_native_read->iov;
+	sqe->len = 1;
+	sqe->user_data = (uint64_t)(uintptr_t)p_native_read;
+
+	sq_array[index] = index;
+	__atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	p_native_read->in_flight_element = in_flight.push_back(p_native_read);
+	to_submit++;
+}
+
+FileReadQueue::Read *FileReadQueueIOUring::_release(NativeRead *p_native_read) {
+
+	Map<String, OpenFile>::Element *E = open_files.find(p_native_read->os_path);
+	if (E) {
+		E->get().reads--;
+		if (E->get().reads == 0 && open_files.size() > MAX_IDLE_FILES) {
+			close(E->get().fd);
+			open_files.erase(E);
+		}
+	}
+
+	Read *read = p_native_read->read;
+	memdelete(p_native_read);
+	return read;
+}
+
+void FileReadQueueIOUring::_finish(NativeRead *p_native_read, int p_result, Error p_error) {
+
+	_complete(_release(p_native_read), p_result, p_error);
+}
+
+int FileReadQueueIOUring::_reap() {
+
+	int completed = 0;
+	uint32_t head = *cq_head;
+
+	while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+
+		struct io_uring_cqe *cqe = &cqes[head & cq_mask];
+		NativeRead *native_read = (NativeRead *)(uintptr_t)cqe->user_data;
+		int res = cqe->res;
+		head++;
+		in_flight.erase(native_read->in_flight_element);
+		native_read->in_flight_element = NULL;
+
+		if (res == -EINTR || res == -EAGAIN) {
+			pending.push_front(native_read);
+		} else if (res < 0) {
+			_finish(native_read, -1, ERR_FILE_CANT_READ);
+			completed++;
+		} else {
+			native_read->read_bytes += res;
+			if (res > 0 && native_read->read_bytes < native_read->length) {
+				// Short read, continue where it stopped.
+				pending.push_front(native_read);
+			} else {
+				_finish(native_read, native_read->read_bytes, OK);
+				completed++;
+			}
+		}
+	}
+
+	__atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+	return completed;
+}
+
+void FileReadQueueIOUring::_abandon_ring() {
+
+	// Whatever the kernel accepted is cancelled when the ring is closed, the thread pool
+	// reads it all again (partial reads included) into the same place.
+	Vector<Read *> reads;
+	for (List<NativeRead *>::Element *E = in_flight.front(); E; E = E->next())
+		reads.push_back(_release(E->get()));
+	for (List<NativeRead *>::Element *E = pending.front(); E; E = E->next())
+		reads.push_back(_release(E->get()));
+	in_flight.clear();
+	pending.clear();
+	to_submit = 0;
+
+	_close_ring();
+	_submit_to_pool(reads);
+}
+
+bool FileReadQueueIOUring::_submit_native(Read *p_read) {
+
+	if (ring_fd < 0)
+		return false;
+
+	String os_path;
+	uint64_t offset;
+	int length;
+	if (!_get_os_location(p_read->path, p_read->offset, p_read->length, os_path, offset, length))
+		return false;
+
+	Map<String, OpenFile>::Element *E = open_files.find(os_path);
+	if (!E) {
+		OpenFile open_file;
+		open_file.fd = open(os_path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+		if (open_file.fd < 0)
+			return false; // Let the thread pool report the error.
+		open_file.reads = 0;
+		E = open_files.insert(os_path, open_file);
+	}
+
+	E->get().reads++;
+
+	NativeRead *native_read = memnew(NativeRead);
+	native_read->read = p_read;
+	native_read->fd = E->get().fd;
+	native_read->os_path = os_path;
+	native_read->offset = offset;
+	native_read->length = length;
+	native_read->read_bytes = 0;
+	native_read->in_flight_element = NULL;
+
+	if (length == 0) {
+		_finish(native_read, 0, OK);
+		return true;
+	}
+
+	pending.push_back(native_read);
+	return true;
+}
+
+void FileReadQueueIOUring::_flush_native() {
+
+	if (ring_fd < 0)
+		return;
+
+	while (pending.size() && (uint32_t)in_flight.size() < sq_entries) {
+		_push(pending.front()->get());
+		pending.pop_front();
+	}
+
+	while (to_submit) {
+		int ret = syscall(__NR_io_uring_enter, ring_fd, to_submit, 0, 0, NULL, 0);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EBUSY)
+				break; // Retried by _poll_native() once completions are reaped.
+			_abandon_ring();
+			ERR_FAIL_MSG("io_uring_enter() failed to submit reads, running them on the thread pool.");
+		}
+		if (ret == 0)
+			break;
+		to_submit -= ret;
+	}
+}
+
+void FileReadQueueIOUring::_poll_native(bool p_block) {
+
+	if (ring_fd < 0)
+		return;
+
+	while (true) {
+		int completed = _reap();
+		_flush_native();
+
+		if (ring_fd < 0 || completed || !p_block || in_flight.empty())
+			break;
+
+		// Also submits what _flush_native() couldn't.
+		int ret = syscall(__NR_io_uring_enter, ring_fd, to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (ret >= 0) {
+			to_submit -= ret;
+		} else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+			_abandon_ring();
+			ERR_FAIL_MSG("io_uring_enter() failed to wait for reads, running them on the thread pool.");
+		}
+	}
+}
+
+FileReadQueue *FileReadQueueIOUring::_create_func() {
+
+	return memnew(FileReadQueueIOUring);
+}
+
+void FileReadQueueIOUring::make_default() {
+
+	_create = _create_func;
+}
+
+FileReadQueueIOUring::FileReadQueueIOUring() {
+
+	ring_fd = -1;
+	sq_ring = NULL;
+	sq_ring_size = 0;
+	cq_ring = NULL;
+	cq_ring_size = 0;
+	sqes = NULL;
+	sqes_size = 0;
+	to_submit = 0;
+
+	if (!_setup_ring())
+		_close_ring();
+}
+
+FileReadQueueIOUring::~FileReadQueueIOUring() {
+
+	wait_all();
+
+	for (Map<String, OpenFile>::Element *E = open_files.front(); E; E = E->next())
+		close(E->get().fd);
+
+	_close_ring();
+}
+
+#endif // UNIX_ENABLED && HAVE_IO_URING
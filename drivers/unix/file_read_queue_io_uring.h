@@ -0,0 +1,112 @@
+/*************************************************************************/
+/*  file_read_queue_io_uring.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_READ_QUEUE_IO_URING_H
+#define FILE_READ_QUEUE_IO_URING_H
+
+#include "core/io/file_read_queue.h"
+
+#if defined(UNIX_ENABLED) && defined(HAVE_IO_URING)
+
+#include "core/map.h"
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+// Runs the reads of the queue with the io_uring interface of Linux, falling back
+// to the thread pool when it's not available (older kernels, seccomp filters...).
+class FileReadQueueIOUring : public FileReadQueue {
+
+	struct NativeRead {
+		Read *read;
+		int fd;
+		String os_path;
+		uint64_t offset;
+		int length;
+		int read_bytes;
+		struct iovec iov;
+		List<NativeRead *>::Element *in_flight_element; // Valid while the kernel has it.
+	};
+
+	struct OpenFile {
+		int fd;
+		int reads;
+	};
+
+	int ring_fd;
+
+	void *sq_ring;
+	size_t sq_ring_size;
+	void *cq_ring;
+	size_t cq_ring_size;
+	struct io_uring_sqe *sqes;
+	size_t sqes_size;
+
+	uint32_t *sq_head;
+	uint32_t *sq_tail;
+	uint32_t sq_mask;
+	uint32_t sq_entries;
+	uint32_t *sq_array;
+
+	uint32_t *cq_head;
+	uint32_t *cq_tail;
+	uint32_t cq_mask;
+	struct io_uring_cqe *cqes;
+
+	Map<String, OpenFile> open_files;
+	List<NativeRead *> pending;
+	List<NativeRead *> in_flight;
+	uint32_t to_submit;
+
+	bool _setup_ring();
+	void _close_ring();
+	void _push(NativeRead *p_native_read);
+	Read *_release(NativeRead *p_native_read);
+	void _finish(NativeRead *p_native_read, int p_result, Error p_error);
+	int _reap();
+	void _abandon_ring();
+
+	static FileReadQueue *_create_func();
+
+protected:
+	virtual bool _submit_native(Read *p_read);
+	virtual void _flush_native();
+	virtual void _poll_native(bool p_block);
+
+public:
+	static void make_default();
+
+	FileReadQueueIOUring();
+	~FileReadQueueIOUring();
+};
+
+#endif // UNIX_ENABLED && HAVE_IO_URING
+
+#endif // FILE_READ_QUEUE_IO_URING_H
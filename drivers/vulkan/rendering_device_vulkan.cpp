@@ -540,584 +540,6 @@ const char *RenderingDeviceVulkan::named_formats[RenderingDevice::DATA_FORMAT_MA
 	"Pvrtc2_4Bpp_Srgb_Block_Img"
 };
 
-int RenderingDeviceVulkan::get_format_vertex_size(DataFormat p_format) {
-	switch (p_format) {
-		case DATA_FORMAT_R8_UNORM:
-		case DATA_FORMAT_R8_SNORM:
-		case DATA_FORMAT_R8_UINT:
-		case DATA_FORMAT_R8_SINT:
-		case DATA_FORMAT_R8G8_UNORM:
-		case DATA_FORMAT_R8G8_SNORM:
-		case DATA_FORMAT_R8G8_UINT:
-		case DATA_FORMAT_R8G8_SINT:
-		case DATA_FORMAT_R8G8B8_UNORM:
-		case DATA_FORMAT_R8G8B8_SNORM:
-		case DATA_FORMAT_R8G8B8_UINT:
-		case DATA_FORMAT_R8G8B8_SINT:
-		case DATA_FORMAT_B8G8R8_UNORM:
-		case DATA_FORMAT_B8G8R8_SNORM:
-		case DATA_FORMAT_B8G8R8_UINT:
-		case DATA_FORMAT_B8G8R8_SINT:
-		case DATA_FORMAT_R8G8B8A8_UNORM:
-		case DATA_FORMAT_R8G8B8A8_SNORM:
-		case DATA_FORMAT_R8G8B8A8_UINT:
-		case DATA_FORMAT_R8G8B8A8_SINT:
-		case DATA_FORMAT_B8G8R8A8_UNORM:
-		case DATA_FORMAT_B8G8R8A8_SNORM:
-		case DATA_FORMAT_B8G8R8A8_UINT:
-		case DATA_FORMAT_B8G8R8A8_SINT: return 4;
-		case DATA_FORMAT_R16_UNORM:
-		case DATA_FORMAT_R16_SNORM:
-		case DATA_FORMAT_R16_UINT:
-		case DATA_FORMAT_R16_SINT:
-		case DATA_FORMAT_R16_SFLOAT: return 4;
-		case DATA_FORMAT_R16G16_UNORM:
-		case DATA_FORMAT_R16G16_SNORM:
-		case DATA_FORMAT_R16G16_UINT:
-		case DATA_FORMAT_R16G16_SINT:
-		case DATA_FORMAT_R16G16_SFLOAT: return 4;
-		case DATA_FORMAT_R16G16B16_UNORM:
-		case DATA_FORMAT_R16G16B16_SNORM:
-		case DATA_FORMAT_R16G16B16_UINT:
-		case DATA_FORMAT_R16G16B16_SINT:
-		case DATA_FORMAT_R16G16B16_SFLOAT: return 8;
-		case DATA_FORMAT_R16G16B16A16_UNORM:
-		case DATA_FORMAT_R16G16B16A16_SNORM:
-		case DATA_FORMAT_R16G16B16A16_UINT:
-		case DATA_FORMAT_R16G16B16A16_SINT:
-		case DATA_FORMAT_R16G16B16A16_SFLOAT: return 8;
-		case DATA_FORMAT_R32_UINT:
-		case DATA_FORMAT_R32_SINT:
-		case DATA_FORMAT_R32_SFLOAT: return 4;
-		case DATA_FORMAT_R32G32_UINT:
-		case DATA_FORMAT_R32G32_SINT:
-		case DATA_FORMAT_R32G32_SFLOAT: return 8;
-		case DATA_FORMAT_R32G32B32_UINT:
-		case DATA_FORMAT_R32G32B32_SINT:
-		case DATA_FORMAT_R32G32B32_SFLOAT: return 12;
-		case DATA_FORMAT_R32G32B32A32_UINT:
-		case DATA_FORMAT_R32G32B32A32_SINT:
-		case DATA_FORMAT_R32G32B32A32_SFLOAT: return 16;
-		case DATA_FORMAT_R64_UINT:
-		case DATA_FORMAT_R64_SINT:
-		case DATA_FORMAT_R64_SFLOAT: return 8;
-		case DATA_FORMAT_R64G64_UINT:
-		case DATA_FORMAT_R64G64_SINT:
-		case DATA_FORMAT_R64G64_SFLOAT: return 16;
-		case DATA_FORMAT_R64G64B64_UINT:
-		case DATA_FORMAT_R64G64B64_SINT:
-		case DATA_FORMAT_R64G64B64_SFLOAT: return 24;
-		case DATA_FORMAT_R64G64B64A64_UINT:
-		case DATA_FORMAT_R64G64B64A64_SINT:
-		case DATA_FORMAT_R64G64B64A64_SFLOAT: return 32;
-		default: return 0;
-	}
-}
-
-uint32_t RenderingDeviceVulkan::get_image_format_pixel_size(DataFormat p_format) {
-
-	switch (p_format) {
-
-		case DATA_FORMAT_R4G4_UNORM_PACK8: return 1;
-		case DATA_FORMAT_R4G4B4A4_UNORM_PACK16:
-		case DATA_FORMAT_B4G4R4A4_UNORM_PACK16:
-		case DATA_FORMAT_R5G6B5_UNORM_PACK16:
-		case DATA_FORMAT_B5G6R5_UNORM_PACK16:
-		case DATA_FORMAT_R5G5B5A1_UNORM_PACK16:
-		case DATA_FORMAT_B5G5R5A1_UNORM_PACK16:
-		case DATA_FORMAT_A1R5G5B5_UNORM_PACK16: return 2;
-		case DATA_FORMAT_R8_UNORM:
-		case DATA_FORMAT_R8_SNORM:
-		case DATA_FORMAT_R8_USCALED:
-		case DATA_FORMAT_R8_SSCALED:
-		case DATA_FORMAT_R8_UINT:
-		case DATA_FORMAT_R8_SINT:
-		case DATA_FORMAT_R8_SRGB: return 1;
-		case DATA_FORMAT_R8G8_UNORM:
-		case DATA_FORMAT_R8G8_SNORM:
-		case DATA_FORMAT_R8G8_USCALED:
-		case DATA_FORMAT_R8G8_SSCALED:
-		case DATA_FORMAT_R8G8_UINT:
-		case DATA_FORMAT_R8G8_SINT:
-		case DATA_FORMAT_R8G8_SRGB: return 2;
-		case DATA_FORMAT_R8G8B8_UNORM:
-		case DATA_FORMAT_R8G8B8_SNORM:
-		case DATA_FORMAT_R8G8B8_USCALED:
-		case DATA_FORMAT_R8G8B8_SSCALED:
-		case DATA_FORMAT_R8G8B8_UINT:
-		case DATA_FORMAT_R8G8B8_SINT:
-		case DATA_FORMAT_R8G8B8_SRGB:
-		case DATA_FORMAT_B8G8R8_UNORM:
-		case DATA_FORMAT_B8G8R8_SNORM:
-		case DATA_FORMAT_B8G8R8_USCALED:
-		case DATA_FORMAT_B8G8R8_SSCALED:
-		case DATA_FORMAT_B8G8R8_UINT:
-		case DATA_FORMAT_B8G8R8_SINT:
-		case DATA_FORMAT_B8G8R8_SRGB: return 3;
-		case DATA_FORMAT_R8G8B8A8_UNORM:
-		case DATA_FORMAT_R8G8B8A8_SNORM:
-		case DATA_FORMAT_R8G8B8A8_USCALED:
-		case DATA_FORMAT_R8G8B8A8_SSCALED:
-		case DATA_FORMAT_R8G8B8A8_UINT:
-		case DATA_FORMAT_R8G8B8A8_SINT:
-		case DATA_FORMAT_R8G8B8A8_SRGB:
-		case DATA_FORMAT_B8G8R8A8_UNORM:
-		case DATA_FORMAT_B8G8R8A8_SNORM:
-		case DATA_FORMAT_B8G8R8A8_USCALED:
-		case DATA_FORMAT_B8G8R8A8_SSCALED:
-		case DATA_FORMAT_B8G8R8A8_UINT:
-		case DATA_FORMAT_B8G8R8A8_SINT:
-		case DATA_FORMAT_B8G8R8A8_SRGB: return 4;
-		case DATA_FORMAT_A8B8G8R8_UNORM_PACK32:
-		case DATA_FORMAT_A8B8G8R8_SNORM_PACK32:
-		case DATA_FORMAT_A8B8G8R8_USCALED_PACK32:
-		case DATA_FORMAT_A8B8G8R8_SSCALED_PACK32:
-		case DATA_FORMAT_A8B8G8R8_UINT_PACK32:
-		case DATA_FORMAT_A8B8G8R8_SINT_PACK32:
-		case DATA_FORMAT_A8B8G8R8_SRGB_PACK32:
-		case DATA_FORMAT_A2R10G10B10_UNORM_PACK32:
-		case DATA_FORMAT_A2R10G10B10_SNORM_PACK32:
-		case DATA_FORMAT_A2R10G10B10_USCALED_PACK32:
-		case DATA_FORMAT_A2R10G10B10_SSCALED_PACK32:
-		case DATA_FORMAT_A2R10G10B10_UINT_PACK32:
-		case DATA_FORMAT_A2R10G10B10_SINT_PACK32:
-		case DATA_FORMAT_A2B10G10R10_UNORM_PACK32:
-		case DATA_FORMAT_A2B10G10R10_SNORM_PACK32:
-		case DATA_FORMAT_A2B10G10R10_USCALED_PACK32:
-		case DATA_FORMAT_A2B10G10R10_SSCALED_PACK32:
-		case DATA_FORMAT_A2B10G10R10_UINT_PACK32:
-		case DATA_FORMAT_A2B10G10R10_SINT_PACK32: return 4;
-		case DATA_FORMAT_R16_UNORM:
-		case DATA_FORMAT_R16_SNORM:
-		case DATA_FORMAT_R16_USCALED:
-		case DATA_FORMAT_R16_SSCALED:
-		case DATA_FORMAT_R16_UINT:
-		case DATA_FORMAT_R16_SINT:
-		case DATA_FORMAT_R16_SFLOAT: return 2;
-		case DATA_FORMAT_R16G16_UNORM:
-		case DATA_FORMAT_R16G16_SNORM:
-		case DATA_FORMAT_R16G16_USCALED:
-		case DATA_FORMAT_R16G16_SSCALED:
-		case DATA_FORMAT_R16G16_UINT:
-		case DATA_FORMAT_R16G16_SINT:
-		case DATA_FORMAT_R16G16_SFLOAT: return 4;
-		case DATA_FORMAT_R16G16B16_UNORM:
-		case DATA_FORMAT_R16G16B16_SNORM:
-		case DATA_FORMAT_R16G16B16_USCALED:
-		case DATA_FORMAT_R16G16B16_SSCALED:
-		case DATA_FORMAT_R16G16B16_UINT:
-		case DATA_FORMAT_R16G16B16_SINT:
-		case DATA_FORMAT_R16G16B16_SFLOAT: return 6;
-		case DATA_FORMAT_R16G16B16A16_UNORM:
-		case DATA_FORMAT_R16G16B16A16_SNORM:
-		case DATA_FORMAT_R16G16B16A16_USCALED:
-		case DATA_FORMAT_R16G16B16A16_SSCALED:
-		case DATA_FORMAT_R16G16B16A16_UINT:
-		case DATA_FORMAT_R16G16B16A16_SINT:
-		case DATA_FORMAT_R16G16B16A16_SFLOAT: return 8;
-		case DATA_FORMAT_R32_UINT:
-		case DATA_FORMAT_R32_SINT:
-		case DATA_FORMAT_R32_SFLOAT: return 4;
-		case DATA_FORMAT_R32G32_UINT:
-		case DATA_FORMAT_R32G32_SINT:
-		case DATA_FORMAT_R32G32_SFLOAT: return 8;
-		case DATA_FORMAT_R32G32B32_UINT:
-		case DATA_FORMAT_R32G32B32_SINT:
-		case DATA_FORMAT_R32G32B32_SFLOAT: return 12;
-		case DATA_FORMAT_R32G32B32A32_UINT:
-		case DATA_FORMAT_R32G32B32A32_SINT:
-		case DATA_FORMAT_R32G32B32A32_SFLOAT: return 16;
-		case DATA_FORMAT_R64_UINT:
-		case DATA_FORMAT_R64_SINT:
-		case DATA_FORMAT_R64_SFLOAT: return 8;
-		case DATA_FORMAT_R64G64_UINT:
-		case DATA_FORMAT_R64G64_SINT:
-		case DATA_FORMAT_R64G64_SFLOAT: return 16;
-		case DATA_FORMAT_R64G64B64_UINT:
-		case DATA_FORMAT_R64G64B64_SINT:
-		case DATA_FORMAT_R64G64B64_SFLOAT: return 24;
-		case DATA_FORMAT_R64G64B64A64_UINT:
-		case DATA_FORMAT_R64G64B64A64_SINT:
-		case DATA_FORMAT_R64G64B64A64_SFLOAT: return 32;
-		case DATA_FORMAT_B10G11R11_UFLOAT_PACK32:
-		case DATA_FORMAT_E5B9G9R9_UFLOAT_PACK32: return 4;
-		case DATA_FORMAT_D16_UNORM: return 2;
-		case DATA_FORMAT_X8_D24_UNORM_PACK32: return 4;
-		case DATA_FORMAT_D32_SFLOAT: return 4;
-		case DATA_FORMAT_S8_UINT: return 1;
-		case DATA_FORMAT_D16_UNORM_S8_UINT: return 4;
-		case DATA_FORMAT_D24_UNORM_S8_UINT: return 4;
-		case DATA_FORMAT_D32_SFLOAT_S8_UINT:
-			return 5; //?
-		case DATA_FORMAT_BC1_RGB_UNORM_BLOCK:
-		case DATA_FORMAT_BC1_RGB_SRGB_BLOCK:
-		case DATA_FORMAT_BC1_RGBA_UNORM_BLOCK:
-		case DATA_FORMAT_BC1_RGBA_SRGB_BLOCK:
-		case DATA_FORMAT_BC2_UNORM_BLOCK:
-		case DATA_FORMAT_BC2_SRGB_BLOCK:
-		case DATA_FORMAT_BC3_UNORM_BLOCK:
-		case DATA_FORMAT_BC3_SRGB_BLOCK:
-		case DATA_FORMAT_BC4_UNORM_BLOCK:
-		case DATA_FORMAT_BC4_SNORM_BLOCK:
-		case DATA_FORMAT_BC5_UNORM_BLOCK:
-		case DATA_FORMAT_BC5_SNORM_BLOCK:
-		case DATA_FORMAT_BC6H_UFLOAT_BLOCK:
-		case DATA_FORMAT_BC6H_SFLOAT_BLOCK:
-		case DATA_FORMAT_BC7_UNORM_BLOCK:
-		case DATA_FORMAT_BC7_SRGB_BLOCK: return 1;
-		case DATA_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK: return 1;
-		case DATA_FORMAT_EAC_R11_UNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11_SNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11G11_UNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11G11_SNORM_BLOCK: return 1;
-		case DATA_FORMAT_ASTC_4x4_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_4x4_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_5x4_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_5x4_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_5x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_5x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_6x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_6x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_6x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_6x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x8_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x8_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x8_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x8_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x10_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x10_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_12x10_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_12x10_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_12x12_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_12x12_SRGB_BLOCK: return 1;
-		case DATA_FORMAT_G8B8G8R8_422_UNORM:
-		case DATA_FORMAT_B8G8R8G8_422_UNORM: return 4;
-		case DATA_FORMAT_G8_B8_R8_3PLANE_420_UNORM:
-		case DATA_FORMAT_G8_B8R8_2PLANE_420_UNORM:
-		case DATA_FORMAT_G8_B8_R8_3PLANE_422_UNORM:
-		case DATA_FORMAT_G8_B8R8_2PLANE_422_UNORM:
-		case DATA_FORMAT_G8_B8_R8_3PLANE_444_UNORM: return 4;
-		case DATA_FORMAT_R10X6_UNORM_PACK16:
-		case DATA_FORMAT_R10X6G10X6_UNORM_2PACK16:
-		case DATA_FORMAT_R10X6G10X6B10X6A10X6_UNORM_4PACK16:
-		case DATA_FORMAT_G10X6B10X6G10X6R10X6_422_UNORM_4PACK16:
-		case DATA_FORMAT_B10X6G10X6R10X6G10X6_422_UNORM_4PACK16:
-		case DATA_FORMAT_G10X6_B10X6_R10X6_3PLANE_420_UNORM_3PACK16:
-		case DATA_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16:
-		case DATA_FORMAT_G10X6_B10X6_R10X6_3PLANE_422_UNORM_3PACK16:
-		case DATA_FORMAT_G10X6_B10X6R10X6_2PLANE_422_UNORM_3PACK16:
-		case DATA_FORMAT_G10X6_B10X6_R10X6_3PLANE_444_UNORM_3PACK16:
-		case DATA_FORMAT_R12X4_UNORM_PACK16:
-		case DATA_FORMAT_R12X4G12X4_UNORM_2PACK16:
-		case DATA_FORMAT_R12X4G12X4B12X4A12X4_UNORM_4PACK16:
-		case DATA_FORMAT_G12X4B12X4G12X4R12X4_422_UNORM_4PACK16:
-		case DATA_FORMAT_B12X4G12X4R12X4G12X4_422_UNORM_4PACK16:
-		case DATA_FORMAT_G12X4_B12X4_R12X4_3PLANE_420_UNORM_3PACK16:
-		case DATA_FORMAT_G12X4_B12X4R12X4_2PLANE_420_UNORM_3PACK16:
-		case DATA_FORMAT_G12X4_B12X4_R12X4_3PLANE_422_UNORM_3PACK16:
-		case DATA_FORMAT_G12X4_B12X4R12X4_2PLANE_422_UNORM_3PACK16:
-		case DATA_FORMAT_G12X4_B12X4_R12X4_3PLANE_444_UNORM_3PACK16: return 2;
-		case DATA_FORMAT_G16B16G16R16_422_UNORM:
-		case DATA_FORMAT_B16G16R16G16_422_UNORM:
-		case DATA_FORMAT_G16_B16_R16_3PLANE_420_UNORM:
-		case DATA_FORMAT_G16_B16R16_2PLANE_420_UNORM:
-		case DATA_FORMAT_G16_B16_R16_3PLANE_422_UNORM:
-		case DATA_FORMAT_G16_B16R16_2PLANE_422_UNORM:
-		case DATA_FORMAT_G16_B16_R16_3PLANE_444_UNORM: return 8;
-		case DATA_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG: return 1;
-		default: {
-			ERR_PRINT("Format not handled, bug");
-		}
-	}
-
-	return 1;
-}
-
-// https://www.khronos.org/registry/DataFormat/specs/1.1/dataformat.1.1.pdf
-
-void RenderingDeviceVulkan::get_compressed_image_format_block_dimensions(DataFormat p_format, uint32_t &r_w, uint32_t &r_h) {
-
-	switch (p_format) {
-		case DATA_FORMAT_BC1_RGB_UNORM_BLOCK:
-		case DATA_FORMAT_BC1_RGB_SRGB_BLOCK:
-		case DATA_FORMAT_BC1_RGBA_UNORM_BLOCK:
-		case DATA_FORMAT_BC1_RGBA_SRGB_BLOCK:
-		case DATA_FORMAT_BC2_UNORM_BLOCK:
-		case DATA_FORMAT_BC2_SRGB_BLOCK:
-		case DATA_FORMAT_BC3_UNORM_BLOCK:
-		case DATA_FORMAT_BC3_SRGB_BLOCK:
-		case DATA_FORMAT_BC4_UNORM_BLOCK:
-		case DATA_FORMAT_BC4_SNORM_BLOCK:
-		case DATA_FORMAT_BC5_UNORM_BLOCK:
-		case DATA_FORMAT_BC5_SNORM_BLOCK:
-		case DATA_FORMAT_BC6H_UFLOAT_BLOCK:
-		case DATA_FORMAT_BC6H_SFLOAT_BLOCK:
-		case DATA_FORMAT_BC7_UNORM_BLOCK:
-		case DATA_FORMAT_BC7_SRGB_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
-		case DATA_FORMAT_EAC_R11_UNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11_SNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11G11_UNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11G11_SNORM_BLOCK:
-		case DATA_FORMAT_ASTC_4x4_UNORM_BLOCK: //again, not sure about astc
-		case DATA_FORMAT_ASTC_4x4_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_5x4_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_5x4_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_5x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_5x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_6x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_6x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_6x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_6x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x8_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x8_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x8_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x8_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x10_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x10_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_12x10_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_12x10_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_12x12_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_12x12_SRGB_BLOCK:
-			r_w = 4;
-			r_h = 4;
-			return;
-		case DATA_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG:
-			r_w = 4;
-			r_h = 4;
-			return;
-		case DATA_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG:
-			r_w = 8;
-			r_h = 4;
-			return;
-		default: {
-			r_w = 1;
-			r_h = 1;
-		}
-	}
-}
-
-uint32_t RenderingDeviceVulkan::get_compressed_image_format_block_byte_size(DataFormat p_format) {
-
-	switch (p_format) {
-		case DATA_FORMAT_BC1_RGB_UNORM_BLOCK:
-		case DATA_FORMAT_BC1_RGB_SRGB_BLOCK:
-		case DATA_FORMAT_BC1_RGBA_UNORM_BLOCK:
-		case DATA_FORMAT_BC1_RGBA_SRGB_BLOCK: return 8;
-		case DATA_FORMAT_BC2_UNORM_BLOCK:
-		case DATA_FORMAT_BC2_SRGB_BLOCK: return 16;
-		case DATA_FORMAT_BC3_UNORM_BLOCK:
-		case DATA_FORMAT_BC3_SRGB_BLOCK: return 16;
-		case DATA_FORMAT_BC4_UNORM_BLOCK:
-		case DATA_FORMAT_BC4_SNORM_BLOCK: return 8;
-		case DATA_FORMAT_BC5_UNORM_BLOCK:
-		case DATA_FORMAT_BC5_SNORM_BLOCK: return 16;
-		case DATA_FORMAT_BC6H_UFLOAT_BLOCK:
-		case DATA_FORMAT_BC6H_SFLOAT_BLOCK: return 16;
-		case DATA_FORMAT_BC7_UNORM_BLOCK:
-		case DATA_FORMAT_BC7_SRGB_BLOCK: return 16;
-		case DATA_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8_SRGB_BLOCK: return 8;
-		case DATA_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK: return 8;
-		case DATA_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK: return 16;
-		case DATA_FORMAT_EAC_R11_UNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11_SNORM_BLOCK: return 8;
-		case DATA_FORMAT_EAC_R11G11_UNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11G11_SNORM_BLOCK: return 16;
-		case DATA_FORMAT_ASTC_4x4_UNORM_BLOCK: //again, not sure about astc
-		case DATA_FORMAT_ASTC_4x4_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_5x4_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_5x4_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_5x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_5x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_6x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_6x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_6x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_6x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_8x8_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_8x8_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x5_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x5_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x6_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x6_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x8_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x8_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_10x10_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_10x10_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_12x10_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_12x10_SRGB_BLOCK:
-		case DATA_FORMAT_ASTC_12x12_UNORM_BLOCK:
-		case DATA_FORMAT_ASTC_12x12_SRGB_BLOCK:
-			return 8; //wrong
-		case DATA_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG:
-			return 8; //what varies is resolution
-		default: {
-		}
-	}
-	return 1;
-}
-
-uint32_t RenderingDeviceVulkan::get_compressed_image_format_pixel_rshift(DataFormat p_format) {
-
-	switch (p_format) {
-		case DATA_FORMAT_BC1_RGB_UNORM_BLOCK: //these formats are half byte size, so rshift is 1
-		case DATA_FORMAT_BC1_RGB_SRGB_BLOCK:
-		case DATA_FORMAT_BC1_RGBA_UNORM_BLOCK:
-		case DATA_FORMAT_BC1_RGBA_SRGB_BLOCK:
-		case DATA_FORMAT_BC4_UNORM_BLOCK:
-		case DATA_FORMAT_BC4_SNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
-		case DATA_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
-		case DATA_FORMAT_EAC_R11_UNORM_BLOCK:
-		case DATA_FORMAT_EAC_R11_SNORM_BLOCK:
-		case DATA_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG: return 1;
-		case DATA_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG: //these formats are quarter byte size, so rshift is 1
-		case DATA_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG:
-		case DATA_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG: return 2;
-		default: {
-		}
-	}
-
-	return 0;
-}
-
-bool RenderingDeviceVulkan::format_has_stencil(DataFormat p_format) {
-	switch (p_format) {
-		case DATA_FORMAT_S8_UINT:
-		case DATA_FORMAT_D16_UNORM_S8_UINT:
-		case DATA_FORMAT_D24_UNORM_S8_UINT:
-		case DATA_FORMAT_D32_SFLOAT_S8_UINT: {
-			return true;
-		}
-		default: {
-		}
-	}
-	return false;
-}
-
-uint32_t RenderingDeviceVulkan::get_image_format_required_size(DataFormat p_format, uint32_t p_width, uint32_t p_height, uint32_t p_depth, uint32_t p_mipmaps, uint32_t *r_blockw, uint32_t *r_blockh, uint32_t *r_depth) {
-
-	ERR_FAIL_COND_V(p_mipmaps == 0, 0);
-	uint32_t w = p_width;
-	uint32_t h = p_height;
-	uint32_t d = p_depth;
-
-	uint32_t size = 0;
-
-	uint32_t pixel_size = get_image_format_pixel_size(p_format);
-	uint32_t pixel_rshift = get_compressed_image_format_pixel_rshift(p_format);
-	uint32_t blockw, blockh;
-	get_compressed_image_format_block_dimensions(p_format, blockw, blockh);
-
-	for (uint32_t i = 0; i < p_mipmaps; i++) {
-		uint32_t bw = w % blockw != 0 ? w + (blockw - w % blockw) : w;
-		uint32_t bh = h % blockh != 0 ? h + (blockh - h % blockh) : h;
-
-		uint32_t s = bw * bh;
-
-		s *= pixel_size;
-		s >>= pixel_rshift;
-		size += s * d;
-		if (r_blockw) {
-			*r_blockw = bw;
-		}
-		if (r_blockh) {
-			*r_blockh = bh;
-		}
-		if (r_depth) {
-			*r_depth = d;
-		}
-		w = MAX(blockw, w >> 1);
-		h = MAX(blockh, h >> 1);
-		d = MAX(1, d >> 1);
-	}
-
-	return size;
-}
-
-uint32_t RenderingDeviceVulkan::get_image_required_mipmaps(uint32_t p_width, uint32_t p_height, uint32_t p_depth) {
-
-	//formats and block size don't really matter here since they can all go down to 1px (even if block is larger)
-	int w = p_width;
-	int h = p_height;
-	int d = p_depth;
-
-	int mipmaps = 1;
-
-	while (true) {
-
-		if (w == 1 && h == 1 && d == 1) {
-			break;
-		}
-
-		w = MAX(1, w >> 1);
-		h = MAX(1, h >> 1);
-		d = MAX(1, d >> 1);
-
-		mipmaps++;
-	};
-
-	return mipmaps;
-}
-
 ///////////////////////
 
 const VkCompareOp RenderingDeviceVulkan::compare_operators[RenderingDevice::COMPARE_OP_MAX] = {
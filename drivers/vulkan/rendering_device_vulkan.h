@@ -69,19 +69,6 @@ class RenderingDeviceVulkan : public RenderingDevice {
 	static const VkBorderColor sampler_border_colors[SAMPLER_BORDER_COLOR_MAX];
 	static const VkImageType vulkan_image_type[TEXTURE_TYPE_MAX];
 
-	// Functions used for format
-	// validation, and ensures the
-	// user passes valid data.
-
-	static int get_format_vertex_size(DataFormat p_format);
-	static uint32_t get_image_format_pixel_size(DataFormat p_format);
-	static void get_compressed_image_format_block_dimensions(DataFormat p_format, uint32_t &r_w, uint32_t &r_h);
-	uint32_t get_compressed_image_format_block_byte_size(DataFormat p_format);
-	static uint32_t get_compressed_image_format_pixel_rshift(DataFormat p_format);
-	static uint32_t get_image_format_required_size(DataFormat p_format, uint32_t p_width, uint32_t p_height, uint32_t p_depth, uint32_t p_mipmaps, uint32_t *r_blockw = NULL, uint32_t *r_blockh = NULL, uint32_t *r_depth = NULL);
-	static uint32_t get_image_required_mipmaps(uint32_t p_width, uint32_t p_height, uint32_t p_depth);
-	static bool format_has_stencil(DataFormat p_format);
-
 	/***************************/
 	/**** ID INFRASTRUCTURE ****/
 	/***************************/
@@ -32,6 +32,7 @@
 
 #include "core/crypto/crypto_core.h"
 #include "core/io/config_file.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
@@ -321,10 +322,26 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 
 	SavedData sd;
 	sd.path_utf8 = p_path.utf8();
+	sd.path_md5 = p_path.md5_buffer();
 	sd.ofs = pd->f->get_position();
 	sd.size = p_data.size();
+	sd.flags = 0;
+
+	Vector<uint8_t> compressed;
+	if (pd->compress) {
+		// Only keep it compressed if that saves space (the file may be compressed already).
+		compressed = FileAccessCompressed::compress_buffer(p_data.ptr(), p_data.size(), PACK_COMPRESSED_MAGIC, Compression::MODE_ZSTD, PACK_COMPRESSED_BLOCK_SIZE);
+		if (compressed.size() > 0 && compressed.size() < p_data.size() - p_data.size() / 16) {
+			sd.size = compressed.size();
+			sd.flags = PACK_FILE_COMPRESSED;
+		}
+	}
 
-	pd->f->store_buffer(p_data.ptr(), p_data.size());
+	if (sd.flags & PACK_FILE_COMPRESSED) {
+		pd->f->store_buffer(compressed.ptr(), compressed.size());
+	} else {
+		pd->f->store_buffer(p_data.ptr(), p_data.size());
+	}
 	int pad = _get_pad(PCK_PADDING, sd.size);
 	for (int i = 0; i < pad; i++) {
 		pd->f->store_8(0);
@@ -926,6 +943,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 	pd.ep = &ep;
 	pd.f = ftmp;
 	pd.so_files = p_so_files;
+	pd.compress = GLOBAL_GET("editor/compress_pck_files_on_export");
 
 	Error err = export_project_files(p_preset, _save_pack_file, &pd, _add_shared_object);
 
@@ -936,7 +954,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 		return err;
 	}
 
-	pd.file_ofs.sort(); //do sort, so we can do binary search later
+	pd.file_ofs.sort(); // The index is sorted by path hash, whatever the export order.
 
 	FileAccess *f;
 	int64_t embed_pos = 0;
@@ -984,35 +1002,33 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 
 	f->store_32(pd.file_ofs.size()); //amount of files
 
-	int64_t header_size = f->get_position();
+	uint32_t path_table_size = 0;
+	for (int i = 0; i < pd.file_ofs.size(); i++) {
+		path_table_size += pd.file_ofs[i].path_utf8.length() + 1; // NUL terminated
+	}
+	f->store_32(path_table_size);
 
 	//precalculate header size
 
-	for (int i = 0; i < pd.file_ofs.size(); i++) {
-		header_size += 4; // size of path string (32 bits is enough)
-		int string_len = pd.file_ofs[i].path_utf8.length();
-		header_size += string_len + _get_pad(4, string_len); ///size of path string
-		header_size += 8; // offset to file _with_ header size included
-		header_size += 8; // size of file
-		header_size += 16; // md5
-	}
+	int64_t header_size = f->get_position();
+	header_size += pd.file_ofs.size() * PACK_INDEX_ENTRY_SIZE; // path md5, offset, size, md5 and flags
+	header_size += path_table_size;
 
 	int header_padding = _get_pad(PCK_PADDING, header_size);
 
 	for (int i = 0; i < pd.file_ofs.size(); i++) {
 
-		int string_len = pd.file_ofs[i].path_utf8.length();
-		int pad = _get_pad(4, string_len);
-
-		f->store_32(string_len + pad);
-		f->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), string_len);
-		for (int j = 0; j < pad; j++) {
-			f->store_8(0);
-		}
-
+		f->store_buffer(pd.file_ofs[i].path_md5.ptr(), 16);
 		f->store_64(pd.file_ofs[i].ofs + header_padding + header_size);
 		f->store_64(pd.file_ofs[i].size); // pay attention here, this is where file is
 		f->store_buffer(pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
+		f->store_32(pd.file_ofs[i].flags);
+		f->store_32(0); // reserved
+	}
+
+	for (int i = 0; i < pd.file_ofs.size(); i++) {
+
+		f->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), pd.file_ofs[i].path_utf8.length() + 1);
 	}
 
 	for (int i = 0; i < header_padding; i++) {
@@ -1417,6 +1433,8 @@ EditorExport::EditorExport() {
 	save_timer->connect("timeout", callable_mp(this, &EditorExport::_save));
 	block_save = false;
 
+	GLOBAL_DEF("editor/compress_pck_files_on_export", false);
+
 	singleton = this;
 }
 
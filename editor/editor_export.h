@@ -165,10 +165,12 @@ private:
 		uint64_t ofs;
 		uint64_t size;
 		Vector<uint8_t> md5;
+		Vector<uint8_t> path_md5;
 		CharString path_utf8;
+		uint32_t flags;
 
 		bool operator<(const SavedData &p_data) const {
-			return path_utf8 < p_data.path_utf8;
+			return memcmp(path_md5.ptr(), p_data.path_md5.ptr(), 16) < 0;
 		}
 	};
 
@@ -176,6 +178,7 @@ private:
 
 		FileAccess *f;
 		Vector<SavedData> file_ofs;
+		bool compress;
 		EditorProgress *ep;
 		Vector<SharedObject> *so_files;
 	};
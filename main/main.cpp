@@ -147,6 +147,7 @@ static bool debug_collisions = false;
 static bool debug_navigation = false;
 #endif
 static int frame_delay = 0;
+static Vector<RES> preloaded_script_classes;
 static bool disable_render_loop = false;
 static int fixed_fps = -1;
 static bool print_fps = false;
@@ -250,6 +251,7 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  --path <directory>               Path to a project (<directory> must contain a 'project.godot' file).\n");
 	OS::get_singleton()->print("  -u, --upwards                    Scan folders upwards for project.godot file.\n");
 	OS::get_singleton()->print("  --main-pack <file>               Path to a pack (.pck) file to load.\n");
+	OS::get_singleton()->print("  --pack-access-trace <file>       Write the paths of the files opened from packs to <file>, in order (see PCKPacker.order_by_access_trace()).\n");
 	OS::get_singleton()->print("  --render-thread <mode>           Render thread mode ('unsafe', 'safe', 'separate').\n");
 	OS::get_singleton()->print("  --remote-fs <address>            Remote filesystem (<host/IP>[:<port>] address).\n");
 	OS::get_singleton()->print("  --remote-fs-password <password>  Password for remote filesystem.\n");
@@ -783,6 +785,17 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 				goto error;
 			};
 
+		} else if (I->get() == "--pack-access-trace") {
+
+			if (I->next()) {
+
+				packed_data->set_access_trace(I->next()->get());
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing path to pack access trace file, aborting.\n");
+				goto error;
+			};
+
 		} else if (I->get() == "-d" || I->get() == "--debug") {
 			debug_mode = "local";
 #if defined(DEBUG_ENABLED) && !defined(SERVER_ENABLED)
@@ -1152,6 +1165,9 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 		ProjectSettings::get_singleton()->set_custom_property_info("application/run/frame_delay_msec", PropertyInfo(Variant::INT, "application/run/frame_delay_msec", PROPERTY_HINT_RANGE, "0,100,1,or_greater")); // No negative numbers
 	}
 
+	ResourceLoader::set_load_dependencies_in_parallel(GLOBAL_DEF("application/run/load_dependencies_in_parallel", false));
+	GLOBAL_DEF("application/run/load_script_classes_in_parallel", false);
+
 	OS::get_singleton()->set_low_processor_usage_mode(GLOBAL_DEF("application/run/low_processor_mode", false));
 	OS::get_singleton()->set_low_processor_usage_mode_sleep_usec(GLOBAL_DEF("application/run/low_processor_mode_sleep_usec", 6900)); // Roughly 144 FPS
 	ProjectSettings::get_singleton()->set_custom_property_info("application/run/low_processor_mode_sleep_usec", PropertyInfo(Variant::INT, "application/run/low_processor_mode_sleep_usec", PROPERTY_HINT_RANGE, "0,33200,1,or_greater")); // No negative numbers
@@ -1408,6 +1424,7 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 	locale = String();
 
 	ClassDB::set_current_api(ClassDB::API_NONE); //no more api is registered at this point
+	ClassDB::build_lookup_tables();
 
 	print_verbose("CORE API HASH: " + uitos(ClassDB::get_api_hash(ClassDB::API_CORE)));
 	print_verbose("EDITOR API HASH: " + uitos(ClassDB::get_api_hash(ClassDB::API_EDITOR)));
@@ -1419,6 +1436,43 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 // everything the main loop needs to know about frame timings
 static MainTimerSync main_timer_sync;
 
+// Load the named script classes on the resource loader threads, so they are
+// parsed and compiled on all cores instead of one by one when first used.
+// Only a few are requested ahead, each request starts a thread.
+static void _preload_script_classes() {
+
+	List<StringName> classes;
+	ScriptServer::get_global_class_list(&classes);
+
+	Vector<String> paths;
+	for (List<StringName>::Element *E = classes.front(); E; E = E->next()) {
+		paths.push_back(ScriptServer::get_global_class_path(E->get()));
+	}
+
+	int ahead = MAX(OS::get_singleton()->get_processor_count(), 1) * 2;
+	int requested = 0;
+
+	for (int i = 0; i < paths.size(); i++) {
+
+		for (; requested < paths.size() && requested - i < ahead; requested++) {
+			if (ResourceLoader::load_threaded_request(paths[requested]) != OK) {
+				paths.write[requested] = String();
+			}
+		}
+
+		if (paths[i] == String()) {
+			continue;
+		}
+
+		RES res = ResourceLoader::load_threaded_get(paths[i]);
+		if (res.is_valid()) {
+			preloaded_script_classes.push_back(res);
+		}
+	}
+
+	print_verbose("Preloaded " + itos(preloaded_script_classes.size()) + " script classes.");
+}
+
 bool Main::start() {
 
 	ERR_FAIL_COND_V(!_start_success, false);
@@ -1683,6 +1737,10 @@ bool Main::start() {
 					}
 				}
 
+				if (GLOBAL_GET("application/run/load_script_classes_in_parallel")) {
+					_preload_script_classes();
+				}
+
 				//second pass, load into global constants
 				List<Node *> to_add;
 				for (List<PropertyInfo>::Element *E = props.front(); E; E = E->next()) {
@@ -2181,6 +2239,8 @@ void Main::cleanup() {
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
 
+	preloaded_script_classes.clear();
+
 	message_queue->flush();
 	memdelete(message_queue);
 
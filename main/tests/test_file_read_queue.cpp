@@ -0,0 +1,347 @@
+/*************************************************************************/
+/*  test_file_read_queue.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_file_read_queue.h"
+
+#include "core/io/file_access_pack.h"
+#include "core/io/file_read_queue.h"
+#include "core/io/pck_packer.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+#if defined(UNIX_ENABLED) && defined(HAVE_IO_URING)
+#include "drivers/unix/file_read_queue_io_uring.h"
+#endif
+
+namespace TestFileReadQueue {
+
+// Not a multiple of the read sizes, so reads run into the end of the files.
+#define FILE_SIZE (3 * 65536 + 123)
+#define PACK_DIR "res://file_read_queue_test/"
+
+enum {
+	SEED_PLAIN = 1,
+	SEED_STORED = 2,
+	SEED_COMPRESSED = 3,
+	SEED_NEXT = 4, // Stored right after SEED_STORED in the pack.
+};
+
+typedef FileReadQueue *(*CreateFunc)();
+
+String temp_dir;
+bool pack_mounted = false;
+
+uint8_t expected_byte(int p_seed, uint64_t p_pos) {
+	return (uint8_t)((p_pos * 131 + (p_pos >> 9) + p_seed * 17) & 0xFF);
+}
+
+String temp_path(const String &p_name) {
+	return temp_dir.plus_file("file_read_queue_test_" + p_name);
+}
+
+bool write_file(const String &p_path, int p_seed) {
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	if (!f) {
+		return false;
+	}
+
+	for (int i = 0; i < FILE_SIZE; i++) {
+		f->store_8(expected_byte(p_seed, i));
+	}
+	memdelete(f);
+	return true;
+}
+
+bool check_data(const Vector<uint8_t> &p_data, int p_seed, uint64_t p_offset, int p_length) {
+	if (p_data.size() < p_length) {
+		return false;
+	}
+
+	for (int i = 0; i < p_length; i++) {
+		if (p_data[i] != expected_byte(p_seed, p_offset + i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Reads p_length bytes at p_offset and checks that p_expected bytes of the file came back.
+bool check_read(CreateFunc p_create, const String &p_path, int p_seed, uint64_t p_offset, int p_length, int p_expected) {
+	Vector<uint8_t> data;
+	data.resize(p_length);
+
+	FileReadQueue *queue = p_create();
+	FileReadQueue::ReadID id = queue->queue_read(p_path, p_offset, data.ptrw(), p_length);
+	Error err;
+	int read = queue->wait(id, &err);
+	memdelete(queue);
+
+	return id != 0 && err == OK && read == p_expected && check_data(data, p_seed, p_offset, read);
+}
+
+FileReadQueue *create_pool() {
+	return memnew(FileReadQueue);
+}
+
+#if defined(UNIX_ENABLED) && defined(HAVE_IO_URING)
+FileReadQueue *create_io_uring() {
+	return memnew(FileReadQueueIOUring);
+}
+#endif
+
+bool test_wait_out_of_order(CreateFunc p_create) {
+	const int count = 8;
+	Vector<uint8_t> data[count];
+	FileReadQueue::ReadID ids[count];
+
+	FileReadQueue *queue = p_create();
+	for (int i = 0; i < count; i++) {
+		data[i].resize(1000 + i * 3000);
+		ids[i] = queue->queue_read(temp_path("plain"), i * 20000 + i, data[i].ptrw(), data[i].size());
+	}
+	queue->submit();
+
+	bool pass = true;
+	for (int i = count - 1; i >= 0; i--) {
+		Error err;
+		int read = queue->wait(ids[i], &err);
+		pass = pass && err == OK && read == data[i].size() && check_data(data[i], SEED_PLAIN, i * 20000 + i, read);
+	}
+	memdelete(queue);
+
+	return pass;
+}
+
+bool test_end_of_file(CreateFunc p_create) {
+	String path = temp_path("plain");
+
+	// The whole file at once, large reads may come back from the OS in several parts.
+	return check_read(p_create, path, SEED_PLAIN, 0, FILE_SIZE + 1, FILE_SIZE) &&
+		   check_read(p_create, path, SEED_PLAIN, FILE_SIZE - 100, 1000, 100) &&
+		   check_read(p_create, path, SEED_PLAIN, FILE_SIZE, 10, 0) &&
+		   check_read(p_create, path, SEED_PLAIN, FILE_SIZE + 5000, 10, 0) &&
+		   check_read(p_create, path, SEED_PLAIN, 100, 0, 0);
+}
+
+bool test_missing_file(CreateFunc p_create) {
+	uint8_t data[16];
+
+	// Native backends can't open it either and hand it to the thread pool, which reports the error.
+	FileReadQueue *queue = p_create();
+	FileReadQueue::ReadID id = queue->queue_read(temp_path("missing"), 0, data, sizeof(data));
+	Error err;
+	int read = queue->wait(id, &err);
+	memdelete(queue);
+
+	return read == -1 && err != OK;
+}
+
+bool test_completion_accounting(CreateFunc p_create) {
+	// More reads than native queues usually take at once, completed before anything waits for them.
+	const int count = 300;
+	Vector<uint8_t> data[count];
+	FileReadQueue::ReadID ids[count];
+
+	FileReadQueue *queue = p_create();
+	for (int i = 0; i < count; i++) {
+		data[i].resize(700);
+		ids[i] = queue->queue_read(temp_path("plain"), i * 650, data[i].ptrw(), 700);
+	}
+	queue->submit();
+
+	uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 10000;
+	bool all_done = false;
+	while (!all_done && OS::get_singleton()->get_ticks_msec() < timeout) {
+		all_done = true;
+		for (int i = 0; i < count && all_done; i++) {
+			all_done = queue->is_done(ids[i]);
+		}
+		if (!all_done) {
+			OS::get_singleton()->delay_usec(1000);
+		}
+	}
+
+	bool pass = all_done;
+	for (int i = 0; i < count; i++) {
+		int read = queue->wait(ids[i]);
+		pass = pass && read == 700 && check_data(data[i], SEED_PLAIN, i * 650, read);
+	}
+
+	// The completions posted above were never waited for, a new read must still be waited for
+	// until it's actually done.
+	Vector<uint8_t> last;
+	last.resize(FILE_SIZE);
+	FileReadQueue::ReadID last_id = queue->queue_read(temp_path("plain"), 0, last.ptrw(), FILE_SIZE);
+	pass = pass && queue->wait(last_id) == FILE_SIZE && check_data(last, SEED_PLAIN, 0, FILE_SIZE);
+
+	// Reads left when the queue is freed are waited for by it.
+	for (int i = 0; i < count; i++) {
+		queue->queue_read(temp_path("plain"), i, data[i].ptrw(), 700);
+	}
+	queue->submit();
+	memdelete(queue);
+
+	for (int i = 0; i < count; i++) {
+		pass = pass && check_data(data[i], SEED_PLAIN, i, 700);
+	}
+
+	return pass;
+}
+
+bool test_pack_offsets(CreateFunc p_create) {
+	if (!pack_mounted) {
+		return false;
+	}
+
+	// Reads are relative to the file, and stop at its end rather than run into the next one.
+	String path = PACK_DIR "stored.bin";
+	return check_read(p_create, path, SEED_STORED, 0, 4096, 4096) &&
+		   check_read(p_create, path, SEED_STORED, 70000, 5000, 5000) &&
+		   check_read(p_create, path, SEED_STORED, FILE_SIZE - 10, 100, 10) &&
+		   check_read(p_create, path, SEED_STORED, FILE_SIZE + 1, 100, 0) &&
+		   check_read(p_create, PACK_DIR "next.bin", SEED_NEXT, 0, 100, 100);
+}
+
+bool test_pack_compressed(CreateFunc p_create) {
+	if (!pack_mounted) {
+		return false;
+	}
+
+	// Compressed files can't be read from the pack directly, native backends leave them to the thread pool.
+	String path = PACK_DIR "compressed.bin";
+	return check_read(p_create, path, SEED_COMPRESSED, 0, 4096, 4096) &&
+		   check_read(p_create, path, SEED_COMPRESSED, 70000, 70000, 70000) &&
+		   check_read(p_create, path, SEED_COMPRESSED, FILE_SIZE - 10, 100, 10);
+}
+
+bool setup() {
+	temp_dir = OS::get_singleton()->get_cache_path();
+	if (temp_dir == String() || !write_file(temp_path("plain"), SEED_PLAIN) || !write_file(temp_path("stored"), SEED_STORED) ||
+			!write_file(temp_path("next"), SEED_NEXT) || !write_file(temp_path("compressed"), SEED_COMPRESSED)) {
+		return false;
+	}
+
+	Ref<PCKPacker> packer;
+	packer.instance();
+	if (packer->pck_start(temp_path("pack.pck")) != OK ||
+			packer->add_file(PACK_DIR "stored.bin", temp_path("stored")) != OK ||
+			packer->add_file(PACK_DIR "next.bin", temp_path("next")) != OK ||
+			packer->add_file(PACK_DIR "compressed.bin", temp_path("compressed"), true) != OK ||
+			packer->flush() != OK) {
+		return false;
+	}
+
+	PackedData *packed_data = PackedData::get_singleton();
+	pack_mounted = packed_data && !packed_data->is_disabled() && packed_data->add_pack(temp_path("pack.pck"), true) == OK;
+	return true;
+}
+
+void cleanup() {
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(temp_path("plain"));
+	da->remove(temp_path("stored"));
+	da->remove(temp_path("next"));
+	da->remove(temp_path("compressed"));
+	da->remove(temp_path("pack.pck"));
+	memdelete(da);
+}
+
+typedef bool (*TestFunc)(CreateFunc);
+
+struct Test {
+	const char *name;
+	TestFunc func;
+};
+
+Test tests[] = {
+
+	{ "wait_out_of_order", test_wait_out_of_order },
+	{ "end_of_file", test_end_of_file },
+	{ "missing_file", test_missing_file },
+	{ "completion_accounting", test_completion_accounting },
+	{ "pack_offsets", test_pack_offsets },
+	{ "pack_compressed", test_pack_compressed },
+	{ NULL, NULL }
+
+};
+
+struct Backend {
+	const char *name;
+	CreateFunc create;
+};
+
+Backend backends[] = {
+
+	{ "thread pool", create_pool },
+#if defined(UNIX_ENABLED) && defined(HAVE_IO_URING)
+	{ "io_uring", create_io_uring },
+#endif
+	{ NULL, NULL }
+
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	if (!setup()) {
+		OS::get_singleton()->print("Can't write the test files to '%s'.\n", temp_dir.utf8().get_data());
+		cleanup();
+		return NULL;
+	}
+
+	for (int i = 0; backends[i].name; i++) {
+
+		OS::get_singleton()->print("%s:\n", backends[i].name);
+
+		for (int j = 0; tests[j].name; j++) {
+			bool pass = tests[j].func(backends[i].create);
+			if (pass)
+				passed++;
+			OS::get_singleton()->print("\t%s: %s\n", tests[j].name, pass ? "PASS" : "FAILED");
+
+			count++;
+		}
+	}
+
+	cleanup();
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestFileReadQueue
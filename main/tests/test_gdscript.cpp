@@ -30,15 +30,20 @@
 
 #include "test_gdscript.h"
 
+#include "core/compressed_translation.h"
+#include "core/image.h"
 #include "core/os/file_access.h"
+#include "core/os/input_event.h"
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
+#include "core/translation.h"
 
 #include "modules/modules_enabled.gen.h"
 #ifdef MODULE_GDSCRIPT_ENABLED
 
 #include "modules/gdscript/gdscript.h"
 #include "modules/gdscript/gdscript_compiler.h"
+#include "modules/gdscript/gdscript_optimizer.h"
 #include "modules/gdscript/gdscript_parser.h"
 #include "modules/gdscript/gdscript_tokenizer.h"
 
@@ -565,10 +570,15 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 			switch (code[ip]) {
 
-				case GDScriptFunction::OPCODE_OPERATOR: {
+				case GDScriptFunction::OPCODE_OPERATOR:
+				case GDScriptFunction::OPCODE_OPERATOR_INT:
+				case GDScriptFunction::OPCODE_OPERATOR_FLOAT:
+				case GDScriptFunction::OPCODE_OPERATOR_VECTOR2:
+				case GDScriptFunction::OPCODE_OPERATOR_VECTOR3: {
 
+					static const char *typed_names[] = { "", "(int)", "(float)", "(Vector2)", "(Vector3)" };
 					int op = code[ip + 1];
-					txt += " op ";
+					txt += " op" + String(typed_names[code[ip] - GDScriptFunction::OPCODE_OPERATOR]) + " ";
 
 					String opname = Variant::get_operator_name(Variant::Operator(op));
 
@@ -610,20 +620,22 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += "[\"";
 					txt += func.get_global_name(code[ip + 2]);
 					txt += "\"]=";
-					txt += DADDR(3);
-					incr += 4;
+					txt += DADDR(4);
+					txt += " cache " + itos(code[ip + 3]);
+					incr += 5;
 
 				} break;
 				case GDScriptFunction::OPCODE_GET_NAMED: {
 
 					txt += " get_named ";
-					txt += DADDR(3);
+					txt += DADDR(4);
 					txt += "=";
 					txt += DADDR(1);
 					txt += "[\"";
 					txt += func.get_global_name(code[ip + 2]);
 					txt += "\"]";
-					incr += 4;
+					txt += " cache " + itos(code[ip + 3]);
+					incr += 5;
 
 				} break;
 				case GDScriptFunction::OPCODE_SET_MEMBER: {
@@ -768,18 +780,23 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 				} break;
 
 				case GDScriptFunction::OPCODE_CALL:
-				case GDScriptFunction::OPCODE_CALL_RETURN: {
+				case GDScriptFunction::OPCODE_CALL_RETURN:
+				case GDScriptFunction::OPCODE_CALL_PTRCALL:
+				case GDScriptFunction::OPCODE_CALL_PTRCALL_RETURN: {
 
-					bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN;
+					bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN || code[ip] == GDScriptFunction::OPCODE_CALL_PTRCALL_RETURN;
+					bool ptr = code[ip] == GDScriptFunction::OPCODE_CALL_PTRCALL || code[ip] == GDScriptFunction::OPCODE_CALL_PTRCALL_RETURN;
 
-					if (ret)
+					if (ptr)
+						txt += ret ? " call-ptr-ret " : " call-ptr ";
+					else if (ret)
 						txt += " call-ret ";
 					else
 						txt += " call ";
 
 					int argc = code[ip + 1];
 					if (ret) {
-						txt += DADDR(4 + argc) + "=";
+						txt += DADDR(5 + argc) + "=";
 					}
 
 					txt += DADDR(2) + ".";
@@ -789,11 +806,12 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					for (int i = 0; i < argc; i++) {
 						if (i > 0)
 							txt += ", ";
-						txt += DADDR(4 + i);
+						txt += DADDR(5 + i);
 					}
 					txt += ")";
+					txt += " cache " + itos(code[ip + 4]);
 
-					incr = 5 + argc;
+					incr = 6 + argc;
 
 				} break;
 				case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
@@ -895,13 +913,15 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					incr = 2;
 
 				} break;
-				case GDScriptFunction::OPCODE_ITERATE_BEGIN: {
+				case GDScriptFunction::OPCODE_ITERATE_BEGIN:
+				case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT: {
 
 					txt += " for-init " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
 					incr += 5;
 
 				} break;
-				case GDScriptFunction::OPCODE_ITERATE: {
+				case GDScriptFunction::OPCODE_ITERATE:
+				case GDScriptFunction::OPCODE_ITERATE_INT: {
 
 					txt += " for-loop " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
 					incr += 5;
@@ -942,8 +962,302 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 	}
 }
 
+static Ref<GDScript> _compile_benchmark(const String &p_code, bool p_optimize) {
+
+	GDScriptParser parser;
+	Error err = parser.parse(p_code);
+	ERR_FAIL_COND_V_MSG(err, Ref<GDScript>(), "Parse Error: " + itos(parser.get_error_line()) + ": " + parser.get_error());
+
+	if (p_optimize) {
+		GDScriptOptimizer().optimize(&parser);
+	}
+
+	Ref<GDScript> gds;
+	gds.instance();
+
+	GDScriptCompiler gdc;
+	err = gdc.compile(&parser, gds.ptr());
+	ERR_FAIL_COND_V_MSG(err, Ref<GDScript>(), "Compile Error: " + itos(gdc.get_error_line()) + ": " + gdc.get_error());
+
+	return gds;
+}
+
+// Many coroutines suspended at once, each resumed once per round.
+static void _run_yield_benchmark() {
+
+	const int coroutines = 10000;
+	const int rounds = 100;
+
+	Ref<GDScript> gds = _compile_benchmark(
+			"static func worker(rounds):\n"
+			"\tvar total = 0\n"
+			"\tfor i in range(rounds):\n"
+			"\t\ttotal += i\n"
+			"\t\tyield()\n"
+			"\treturn total\n",
+			true);
+	ERR_FAIL_COND(gds.is_null());
+
+	Object *obj = gds.ptr(); // GDScript::call() runs static functions.
+	Variant arg = rounds;
+	const Variant *args[1] = { &arg };
+	Callable::CallError ce;
+
+	Vector<Variant> states;
+	states.resize(coroutines);
+
+	uint64_t start = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < coroutines; i++) {
+		states.write[i] = obj->call("worker", args, 1, ce);
+		ERR_FAIL_COND(ce.error != Callable::CallError::CALL_OK);
+	}
+
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < coroutines; i++) {
+			Ref<GDScriptFunctionState> state = states[i];
+			ERR_FAIL_COND(state.is_null());
+			states.write[i] = state->resume();
+		}
+	}
+
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - start;
+
+	for (int i = 0; i < coroutines; i++) {
+		if (states[i] != Variant(rounds * (rounds - 1) / 2)) {
+			ERR_PRINT("yield: coroutine " + itos(i) + " returned " + String(states[i]) + ", expected " + itos(rounds * (rounds - 1) / 2) + ".");
+			return;
+		}
+	}
+
+	print_line("yield: " + itos(coroutines) + " coroutines resumed " + itos(rounds) + " times: " + itos(elapsed) + " usec, " + itos(elapsed * 1000 / (coroutines * rounds)) + " ns per resume");
+}
+
+#ifdef DEBUG_ENABLED
+
+struct Benchmark {
+	const char *name;
+	const char *code;
+};
+
+// Each benchmark is run with and without the optimizer, both must return the same value.
+static const Benchmark benchmarks[] = {
+	{ "constant_locals",
+			"static func run():\n"
+			"\tvar width = 16\n"
+			"\tvar height = 9\n"
+			"\tvar area = width * height\n"
+			"\tvar total = 0\n"
+			"\tfor i in range(1000):\n"
+			"\t\ttotal += area * 2 + i\n"
+			"\treturn total\n" },
+	{ "constant_branches",
+			"const VERBOSE = false\n"
+			"static func run():\n"
+			"\tvar total = 0\n"
+			"\tfor i in range(1000):\n"
+			"\t\tif VERBOSE:\n"
+			"\t\t\tprint(i)\n"
+			"\t\telse:\n"
+			"\t\t\ttotal += i\n"
+			"\treturn total\n" },
+	{ "dead_stores",
+			"static func run():\n"
+			"\tvar total = 0\n"
+			"\tfor i in range(1000):\n"
+			"\t\tvar unused = 4\n"
+			"\t\tvar scale = 3\n"
+			"\t\ttotal = total + i * scale\n"
+			"\treturn total\n" },
+	{ "unreachable_code",
+			"static func run():\n"
+			"\tvar total = 0\n"
+			"\tfor i in range(1000):\n"
+			"\t\ttotal += i\n"
+			"\t\tcontinue\n"
+			"\t\ttotal -= i\n"
+			"\treturn total\n" },
+	{ "temporaries",
+			"static func run():\n"
+			"\tvar a = 0\n"
+			"\tvar b = 1\n"
+			"\tfor i in range(1000):\n"
+			"\t\ta = a + i\n"
+			"\t\tb = (b * 3) % 7\n"
+			"\treturn a + b\n" },
+	{ NULL, NULL }
+};
+
+static uint64_t _run_benchmark(const String &p_code, bool p_optimize, Variant &r_result) {
+
+	Ref<GDScript> gds = _compile_benchmark(p_code, p_optimize);
+	ERR_FAIL_COND_V(gds.is_null(), 0);
+
+	Object *obj = gds.ptr(); // GDScript::call() runs static functions.
+	Callable::CallError ce;
+	GDScriptLanguage::get_singleton()->profiling_start();
+	r_result = obj->call("run", NULL, 0, ce);
+	GDScriptLanguage::get_singleton()->profiling_stop();
+	ERR_FAIL_COND_V(ce.error != Callable::CallError::CALL_OK, 0);
+
+	uint64_t count = 0;
+	for (const Map<StringName, GDScriptFunction *>::Element *E = gds->debug_get_member_functions().front(); E; E = E->next()) {
+		count += E->get()->get_profile_opcode_count();
+	}
+	return count;
+}
+
+static void _run_benchmarks() {
+
+	for (int i = 0; benchmarks[i].name; i++) {
+
+		Variant result;
+		Variant optimized_result;
+		uint64_t count = _run_benchmark(benchmarks[i].code, false, result);
+		uint64_t optimized_count = _run_benchmark(benchmarks[i].code, true, optimized_result);
+
+		String txt = String(benchmarks[i].name) + ": " + itos(count) + " opcodes, optimized " + itos(optimized_count);
+		if (count > 0) {
+			txt += " (" + rtos(Math::stepify(100.0 * optimized_count / count, 0.1)) + "%)";
+		}
+		print_line(txt);
+
+		if (result != optimized_result) {
+			ERR_PRINT(String(benchmarks[i].name) + ": optimized code returned " + String(optimized_result) + ", expected " + String(result) + ".");
+		}
+	}
+}
+
+#endif
+
+static bool _check_inline_cache(const String &p_name, const Variant &p_result, const Variant &p_expected) {
+
+	if (p_result.get_type() != p_expected.get_type() || p_result != p_expected) {
+		ERR_PRINT("inline cache: " + p_name + " returned " + String(p_result) + ", expected " + String(p_expected) + ".");
+		return false;
+	}
+	print_line("inline cache: " + p_name + ": OK");
+	return true;
+}
+
+// Runs every call site more than once, so both the lookup that fills the
+// inline cache and the cached path are compared against the expected results.
+static void _run_inline_cache_tests() {
+
+	Ref<GDScript> gds = _compile_benchmark(
+			"var value = 0\n"
+			"var typed_value : int = 0\n"
+			"func get_value():\n"
+			"\treturn value\n"
+			"static func rename(objects, name):\n"
+			"\tfor o in objects:\n"
+			"\t\to.resource_name = name\n"
+			"\tvar names = []\n"
+			"\tfor o in objects:\n"
+			"\t\tnames.push_back(o.resource_name)\n"
+			"\treturn names\n"
+			"static func bump(o, times):\n"
+			"\tfor i in range(times):\n"
+			"\t\to.value = o.value + 1\n"
+			"\treturn o.value\n"
+			"static func set_typed(o, v):\n"
+			"\to.typed_value = v\n"
+			"\treturn o.typed_value\n"
+			"static func call_get_value(o):\n"
+			"\treturn o.get_value()\n",
+			false);
+	ERR_FAIL_COND(gds.is_null());
+
+	Object *obj = gds.ptr(); // GDScript::call() runs static functions.
+	Callable::CallError ce;
+
+	// Native properties, on more receiver classes than a call site caches.
+	Array objects;
+	objects.push_back(Ref<Resource>(memnew(Resource)));
+	objects.push_back(Ref<Image>(memnew(Image)));
+	objects.push_back(Ref<Translation>(memnew(Translation)));
+	objects.push_back(Ref<PHashTranslation>(memnew(PHashTranslation)));
+	objects.push_back(Ref<InputEventKey>(memnew(InputEventKey)));
+	objects.push_back(Ref<InputEventAction>(memnew(InputEventAction)));
+
+	for (int i = 0; i < 3; i++) {
+		String name = "name" + itos(i);
+		Variant names_arg = name;
+		Variant objects_arg = objects;
+		const Variant *args[2] = { &objects_arg, &names_arg };
+		Array names = obj->call("rename", args, 2, ce);
+		ERR_FAIL_COND(ce.error != Callable::CallError::CALL_OK);
+
+		Array expected;
+		for (int j = 0; j < objects.size(); j++) {
+			expected.push_back(name);
+		}
+		if (!_check_inline_cache("rename #" + itos(i), names, expected)) {
+			return;
+		}
+	}
+
+#ifdef TOOLS_ENABLED
+	for (int i = 0; i < objects.size(); i++) {
+		Object *o = objects[i];
+		if (!o->is_edited()) {
+			ERR_PRINT("inline cache: setting a property through the cache did not flag " + o->get_class() + " as edited.");
+			return;
+		}
+	}
+#endif
+
+	// Script members and functions, including across a cache invalidation.
+	Variant instance = obj->call("new", NULL, 0, ce);
+	ERR_FAIL_COND(ce.error != Callable::CallError::CALL_OK);
+
+	Variant times = 10;
+	const Variant *bump_args[2] = { &instance, &times };
+	if (!_check_inline_cache("bump #0", obj->call("bump", bump_args, 2, ce), 10) ||
+			!_check_inline_cache("bump #1", obj->call("bump", bump_args, 2, ce), 20)) {
+		return;
+	}
+
+	GDScriptLanguage::get_singleton()->invalidate_inline_caches();
+	if (!_check_inline_cache("bump after invalidation", obj->call("bump", bump_args, 2, ce), 30)) {
+		return;
+	}
+
+	// A typed member needs a conversion, which the cache leaves to the regular path.
+	Variant real_value = 2.5;
+	Variant int_value = 3;
+	const Variant *real_args[2] = { &instance, &real_value };
+	const Variant *int_args[2] = { &instance, &int_value };
+	if (!_check_inline_cache("set_typed #0", obj->call("set_typed", int_args, 2, ce), 3) ||
+			!_check_inline_cache("set_typed #1", obj->call("set_typed", real_args, 2, ce), 2) ||
+			!_check_inline_cache("set_typed #2", obj->call("set_typed", int_args, 2, ce), 3)) {
+		return;
+	}
+
+	const Variant *call_args[1] = { &instance };
+	if (!_check_inline_cache("call_get_value #0", obj->call("call_get_value", call_args, 1, ce), 30) ||
+			!_check_inline_cache("call_get_value #1", obj->call("call_get_value", call_args, 1, ce), 30)) {
+		return;
+	}
+}
+
 MainLoop *test(TestType p_type) {
 
+	if (p_type == TEST_INLINE_CACHE) {
+		_run_inline_cache_tests();
+		return NULL;
+	}
+
+	if (p_type == TEST_BENCHMARK) {
+#ifdef DEBUG_ENABLED
+		_run_benchmarks();
+#else
+		print_line("Opcodes are only counted in debug builds.");
+#endif
+		_run_yield_benchmark();
+		return NULL;
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
@@ -40,6 +40,8 @@ enum TestType {
 	TEST_PARSER,
 	TEST_COMPILER,
 	TEST_BYTECODE,
+	TEST_BENCHMARK,
+	TEST_INLINE_CACHE,
 };
 
 MainLoop *test(TestType p_type);
@@ -34,16 +34,22 @@
 #ifdef DEBUG_ENABLED
 
 #include "test_astar.h"
+#include "test_file_read_queue.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
+#include "test_marshalls.h"
 #include "test_math.h"
+#include "test_mesh_simplifier.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
+#include "test_packed_scene.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
 #include "test_render.h"
+#include "test_render_benchmark.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_string_name_perfect_map.h"
 
 const char **tests_get_names() {
 
@@ -53,6 +59,9 @@ const char **tests_get_names() {
 		"physics",
 		"physics_2d",
 		"render",
+#ifdef SERVER_ENABLED
+		"render_benchmark",
+#endif
 		"oa_hash_map",
 		"gui",
 		"shaderlang",
@@ -60,8 +69,15 @@ const char **tests_get_names() {
 		"gd_parser",
 		"gd_compiler",
 		"gd_bytecode",
+		"gd_bench",
+		"gd_inline_cache",
 		"ordered_hash_map",
 		"astar",
+		"string_name_perfect_map",
+		"file_read_queue",
+		"marshalls",
+		"packed_scene",
+		"mesh_simplifier",
 		NULL
 	};
 
@@ -95,6 +111,13 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestRender::test();
 	}
 
+#ifdef SERVER_ENABLED
+	if (p_test == "render_benchmark") {
+
+		return TestRenderBenchmark::test();
+	}
+#endif
+
 	if (p_test == "oa_hash_map") {
 
 		return TestOAHashMap::test();
@@ -132,6 +155,16 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_bench") {
+
+		return TestGDScript::test(TestGDScript::TEST_BENCHMARK);
+	}
+
+	if (p_test == "gd_inline_cache") {
+
+		return TestGDScript::test(TestGDScript::TEST_INLINE_CACHE);
+	}
+
 	if (p_test == "ordered_hash_map") {
 
 		return TestOrderedHashMap::test();
@@ -142,6 +175,31 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestAStar::test();
 	}
 
+	if (p_test == "string_name_perfect_map") {
+
+		return TestStringNamePerfectMap::test();
+	}
+
+	if (p_test == "file_read_queue") {
+
+		return TestFileReadQueue::test();
+	}
+
+	if (p_test == "marshalls") {
+
+		return TestMarshalls::test();
+	}
+
+	if (p_test == "packed_scene") {
+
+		return TestPackedScene::test();
+	}
+
+	if (p_test == "mesh_simplifier") {
+
+		return TestMeshSimplifier::test();
+	}
+
 	print_line("Unknown test: " + p_test);
 	return NULL;
 }
@@ -0,0 +1,272 @@
+/*************************************************************************/
+/*  test_marshalls.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_marshalls.h"
+
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+
+namespace TestMarshalls {
+
+// One of each packed array, with odd sizes so padding is exercised, and negative or large first
+// elements so a misread element count shows up.
+Array make_packed_arrays() {
+
+	Array arrays;
+
+	Vector<uint8_t> bytes;
+	for (int i = 0; i < 13; i++) {
+		bytes.push_back(i * 17);
+	}
+	arrays.push_back(bytes);
+
+	Vector<int32_t> ints;
+	for (int i = 0; i < 7; i++) {
+		ints.push_back(-123456 + i * 1000);
+	}
+	arrays.push_back(ints);
+
+	Vector<int64_t> longs;
+	for (int i = 0; i < 7; i++) {
+		longs.push_back((int64_t(1) << 40) * (i + 1) - 3);
+	}
+	arrays.push_back(longs);
+
+	Vector<float> floats;
+	for (int i = 0; i < 5; i++) {
+		floats.push_back(i * 0.25f - 1.0f);
+	}
+	arrays.push_back(floats);
+
+	Vector<double> doubles;
+	for (int i = 0; i < 5; i++) {
+		doubles.push_back(i / 3.0 - 100.0);
+	}
+	arrays.push_back(doubles);
+
+	Vector<String> strings;
+	strings.push_back("");
+	strings.push_back("abc");
+	strings.push_back(String::utf8("\xC3\xA9t\xC3\xA9"));
+	arrays.push_back(strings);
+
+	Vector<Vector2> vector2s;
+	for (int i = 0; i < 3; i++) {
+		vector2s.push_back(Vector2(i, -i * 0.5));
+	}
+	arrays.push_back(vector2s);
+
+	Vector<Vector3> vector3s;
+	for (int i = 0; i < 3; i++) {
+		vector3s.push_back(Vector3(i, -i * 0.5, i * 2));
+	}
+	arrays.push_back(vector3s);
+
+	Vector<Color> colors;
+	for (int i = 0; i < 3; i++) {
+		colors.push_back(Color(i * 0.25, 0.5, 1.0 - i * 0.25, 0.75));
+	}
+	arrays.push_back(colors);
+
+	return arrays;
+}
+
+bool round_trip(const Variant &p_variant) {
+
+	int len;
+	if (encode_variant(p_variant, NULL, len) != OK) {
+		return false;
+	}
+
+	Vector<uint8_t> buffer;
+	buffer.resize(len);
+	int written;
+	if (encode_variant(p_variant, buffer.ptrw(), written) != OK || written != len) {
+		return false;
+	}
+
+	Variant decoded;
+	int read;
+	if (decode_variant(decoded, buffer.ptr(), len, &read) != OK || read != len) {
+		return false;
+	}
+
+	return decoded.get_type() == p_variant.get_type() && decoded == p_variant;
+}
+
+bool test_packed_arrays() {
+
+	Array arrays = make_packed_arrays();
+
+	bool pass = true;
+	for (int i = 0; i < arrays.size(); i++) {
+		if (!round_trip(arrays[i])) {
+			OS::get_singleton()->print("\t%s round trip failed.\n", Variant::get_type_name(arrays[i].get_type()).utf8().get_data());
+			pass = false;
+		}
+	}
+	return pass;
+}
+
+bool test_empty_packed_arrays() {
+
+	Array arrays = make_packed_arrays();
+
+	bool pass = true;
+	for (int i = 0; i < arrays.size(); i++) {
+		Callable::CallError ce;
+		Variant empty = Variant::construct(arrays[i].get_type(), NULL, 0, ce);
+		if (!round_trip(empty)) {
+			OS::get_singleton()->print("\tEmpty %s round trip failed.\n", Variant::get_type_name(arrays[i].get_type()).utf8().get_data());
+			pass = false;
+		}
+	}
+	return pass;
+}
+
+Variant make_message() {
+
+	Dictionary dict;
+	dict["name"] = "player";
+	dict[StringName("id")] = 42;
+	dict["path"] = NodePath("/root/Main/Player:position");
+
+	Array message = make_packed_arrays();
+	message.push_back(dict);
+	message.push_back(StringName("state"));
+	message.push_back(int64_t(1) << 50);
+	message.push_back(1.5);
+	return message;
+}
+
+bool test_growable_matches_fixed() {
+
+	Variant message = make_message();
+
+	int len;
+	encode_variant(message, NULL, len);
+	Vector<uint8_t> fixed;
+	fixed.resize(len);
+	encode_variant(message, fixed.ptrw(), len);
+
+	Vector<uint8_t> growable;
+	int growable_len;
+	if (encode_variant(message, growable, 0, growable_len) != OK || growable_len != len || growable.size() < len) {
+		return false;
+	}
+
+	return memcmp(fixed.ptr(), growable.ptr(), len) == 0;
+}
+
+bool test_growable_offset() {
+
+	Variant message = make_message();
+
+	Vector<uint8_t> buffer;
+	buffer.push_back(0xAB);
+	buffer.push_back(0xCD);
+	buffer.push_back(0xEF);
+
+	int len;
+	if (encode_variant(message, buffer, 3, len) != OK || buffer.size() < 3 + len) {
+		return false;
+	}
+	if (buffer[0] != 0xAB || buffer[1] != 0xCD || buffer[2] != 0xEF) {
+		return false;
+	}
+
+	Variant decoded;
+	int read;
+	if (decode_variant(decoded, buffer.ptr() + 3, len, &read) != OK || read != len) {
+		return false;
+	}
+
+	// Dictionaries compare by reference, so check the decoded message encodes the same instead.
+	Vector<uint8_t> encoded;
+	int encoded_len;
+	encode_variant(decoded, encoded, 0, encoded_len);
+	return encoded_len == len && memcmp(encoded.ptr(), buffer.ptr() + 3, len) == 0;
+}
+
+bool test_growable_reuse() {
+
+	Vector<uint8_t> buffer;
+	int len;
+	encode_variant(make_message(), buffer, 0, len);
+	int capacity = buffer.size();
+
+	// A smaller message reuses the buffer as it is.
+	if (encode_variant("small", buffer, 0, len) != OK || buffer.size() != capacity) {
+		return false;
+	}
+
+	Variant decoded;
+	return decode_variant(decoded, buffer.ptr(), len) == OK && decoded == Variant("small");
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_packed_arrays,
+	test_empty_packed_arrays,
+	test_growable_matches_fixed,
+	test_growable_offset,
+	test_growable_reuse,
+	0
+
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestMarshalls
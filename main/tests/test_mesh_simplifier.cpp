@@ -0,0 +1,297 @@
+/*************************************************************************/
+/*  test_mesh_simplifier.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_mesh_simplifier.h"
+
+#include "core/math/mesh_simplifier.h"
+#include "core/os/os.h"
+
+namespace TestMeshSimplifier {
+
+// A flat n x n grid of unit quads on the XZ plane, facing +Y. Vertex (x, z) has index z * (n + 1) + x.
+void make_grid(int p_size, Vector<Vector3> &r_vertices, Vector<int> &r_indices) {
+
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			r_vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			int a = z * (p_size + 1) + x;
+			int b = a + 1;
+			int c = a + p_size + 1;
+			int d = c + 1;
+
+			r_indices.push_back(a);
+			r_indices.push_back(c);
+			r_indices.push_back(b);
+
+			r_indices.push_back(b);
+			r_indices.push_back(c);
+			r_indices.push_back(d);
+		}
+	}
+}
+
+bool is_border(int p_size, int p_index) {
+
+	int x = p_index % (p_size + 1);
+	int z = p_index / (p_size + 1);
+	return x == 0 || z == 0 || x == p_size || z == p_size;
+}
+
+bool same_indices(const Vector<int> &p_a, const Vector<int> &p_b) {
+
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+
+	for (int i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Checks the indices are in range and every triangle still faces +Y, returning the covered area (projected on XZ).
+bool check_triangles(const Vector<Vector3> &p_vertices, const Vector<int> &p_indices, real_t &r_area) {
+
+	r_area = 0;
+
+	if (p_indices.size() % 3 != 0) {
+		OS::get_singleton()->print("\tIndex count %i is not a multiple of 3.\n", p_indices.size());
+		return false;
+	}
+
+	for (int i = 0; i < p_indices.size(); i += 3) {
+
+		for (int j = 0; j < 3; j++) {
+			if (p_indices[i + j] < 0 || p_indices[i + j] >= p_vertices.size()) {
+				OS::get_singleton()->print("\tIndex %i out of range.\n", p_indices[i + j]);
+				return false;
+			}
+		}
+
+		const Vector3 &a = p_vertices[p_indices[i + 0]];
+		const Vector3 &b = p_vertices[p_indices[i + 1]];
+		const Vector3 &c = p_vertices[p_indices[i + 2]];
+		Vector3 normal = (b - a).cross(c - a);
+
+		if (normal.y <= CMP_EPSILON) {
+			OS::get_singleton()->print("\tTriangle %i is degenerate or flipped.\n", i / 3);
+			return false;
+		}
+
+		r_area += normal.y * 0.5;
+	}
+
+	return true;
+}
+
+bool test_flat_grid() {
+
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_grid(4, vertices, indices);
+
+	float error = -1;
+	Vector<int> result = MeshSimplifier::simplify(vertices, indices, 0, 0.001, &error);
+
+	real_t area;
+	if (!check_triangles(vertices, result, area)) {
+		return false;
+	}
+
+	// Every interior vertex collapses at no cost, leaving the 16 border vertices fanned into 14 triangles.
+	if (result.size() != 14 * 3) {
+		OS::get_singleton()->print("\tExpected 14 triangles, got %i.\n", result.size() / 3);
+		return false;
+	}
+
+	for (int i = 0; i < result.size(); i++) {
+		if (!is_border(4, result[i])) {
+			OS::get_singleton()->print("\tInterior vertex %i was kept.\n", result[i]);
+			return false;
+		}
+	}
+
+	if (!Math::is_equal_approx(area, 16)) {
+		OS::get_singleton()->print("\tCovered area changed to %f.\n", area);
+		return false;
+	}
+
+	if (error != 0) {
+		OS::get_singleton()->print("\tExpected no error, got %f.\n", error);
+		return false;
+	}
+
+	return true;
+}
+
+bool test_target_index_count() {
+
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_grid(8, vertices, indices);
+
+	Vector<int> unchanged = MeshSimplifier::simplify(vertices, indices, indices.size());
+	if (!same_indices(unchanged, indices)) {
+		OS::get_singleton()->print("\tIndices changed although the target was already met.\n");
+		return false;
+	}
+
+	float error = -1;
+	Vector<int> result = MeshSimplifier::simplify(vertices, indices, 60 * 3, 1e20, &error);
+
+	real_t area;
+	if (!check_triangles(vertices, result, area)) {
+		return false;
+	}
+
+	if (result.size() != 60 * 3) {
+		OS::get_singleton()->print("\tExpected 60 triangles, got %i.\n", result.size() / 3);
+		return false;
+	}
+
+	if (!Math::is_equal_approx(area, 64) || error != 0) {
+		OS::get_singleton()->print("\tExpected area 64 and no error, got %f and %f.\n", area, error);
+		return false;
+	}
+
+	return true;
+}
+
+// A 2 x 2 grid with the center vertex raised by one unit, which is the only vertex that can collapse.
+void make_tent(Vector<Vector3> &r_vertices, Vector<int> &r_indices) {
+
+	make_grid(2, r_vertices, r_indices);
+	r_vertices.write[4].y = 1;
+}
+
+bool test_error_limit() {
+
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_tent(vertices, indices);
+
+	float error = -1;
+	Vector<int> result = MeshSimplifier::simplify(vertices, indices, 0, 0.5, &error);
+
+	if (!same_indices(result, indices)) {
+		OS::get_singleton()->print("\tThe apex collapsed past the error limit.\n");
+		return false;
+	}
+
+	if (error != 0) {
+		OS::get_singleton()->print("\tExpected no error, got %f.\n", error);
+		return false;
+	}
+
+	return true;
+}
+
+bool test_known_error() {
+
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_tent(vertices, indices);
+
+	float error = -1;
+	Vector<int> result = MeshSimplifier::simplify(vertices, indices, 0, 1e20, &error);
+
+	real_t area;
+	if (!check_triangles(vertices, result, area)) {
+		return false;
+	}
+
+	// The apex collapses onto one of the edge midpoints (all four cost the same), removing the two triangles on that edge.
+	if (result.size() != 6 * 3 || result.find(4) != -1) {
+		OS::get_singleton()->print("\tExpected 6 triangles without the apex, got %i.\n", result.size() / 3);
+		return false;
+	}
+
+	if (!Math::is_equal_approx(area, 4)) {
+		OS::get_singleton()->print("\tCovered area changed to %f.\n", area);
+		return false;
+	}
+
+	// Area weighted RMS distance from the midpoint to the planes of the triangles around both
+	// collapsed vertices (the two shared triangles count twice), worked out by hand.
+	const float expected_error = 0.702746;
+	if (Math::abs(error - expected_error) > 0.0001) {
+		OS::get_singleton()->print("\tExpected error %f, got %f.\n", expected_error, error);
+		return false;
+	}
+
+	return true;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+
+	test_flat_grid,
+	test_target_index_count,
+	test_error_limit,
+	test_known_error,
+	0
+
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestMeshSimplifier
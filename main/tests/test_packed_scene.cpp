@@ -0,0 +1,234 @@
+/*************************************************************************/
+/*  test_packed_scene.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_packed_scene.h"
+
+#include "core/os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/gui/label.h"
+#include "scene/resources/packed_scene.h"
+
+namespace TestPackedScene {
+
+#define INSTANCE_COUNT 1000
+
+// Properties set through ptrcall() (bool, int, float, Vector2, Color, String, enum) and
+// through the Variant call of a setter with an optional argument (Control position).
+Ref<PackedScene> make_scene(float p_rotation) {
+
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+	root->set_position(Vector2(10, 20));
+
+	Node2D *sprite = memnew(Node2D);
+	sprite->set_name("Sprite");
+	sprite->set_rotation(p_rotation);
+	sprite->set_z_index(3);
+	sprite->set_z_as_relative(false);
+	sprite->set_modulate(Color(0.25, 0.5, 0.75, 1.0));
+	root->add_child(sprite);
+	sprite->set_owner(root);
+
+	Label *label = memnew(Label);
+	label->set_name("Label");
+	label->set_text("Hello");
+	label->set_mouse_filter(Control::MOUSE_FILTER_IGNORE);
+	label->set_position(Vector2(-5, 7));
+	label->set_visible(false);
+	root->add_child(label);
+	label->set_owner(root);
+
+	Node *child = memnew(Node);
+	child->set_name("Child");
+	sprite->add_child(child);
+	child->set_owner(root);
+
+	Ref<PackedScene> scene;
+	scene.instance();
+	Error err = scene->pack(root);
+	memdelete(root);
+
+	return err == OK ? scene : Ref<PackedScene>();
+}
+
+bool check_instance(Node *p_node, float p_rotation) {
+
+	Node2D *root = Object::cast_to<Node2D>(p_node);
+	if (!root || root->get_name() != StringName("Root") || root->get_position() != Vector2(10, 20) || root->get_child_count() != 2) {
+		OS::get_singleton()->print("\tbad root\n");
+		return false;
+	}
+
+	Node2D *sprite = Object::cast_to<Node2D>(root->get_child(0));
+	if (!sprite || sprite->get_name() != StringName("Sprite") || !Math::is_equal_approx(sprite->get_rotation(), p_rotation) || sprite->get_z_index() != 3 || sprite->is_z_relative() || sprite->get_modulate() != Color(0.25, 0.5, 0.75, 1.0)) {
+		OS::get_singleton()->print("\tbad sprite\n");
+		return false;
+	}
+
+	Label *label = Object::cast_to<Label>(root->get_child(1));
+	if (!label || label->get_name() != StringName("Label") || label->get_text() != "Hello" || label->get_mouse_filter() != Control::MOUSE_FILTER_IGNORE || label->get_position() != Vector2(-5, 7) || label->is_visible()) {
+		OS::get_singleton()->print("\tbad label\n");
+		return false;
+	}
+
+	if (sprite->get_child_count() != 1 || sprite->get_child(0)->get_name() != StringName("Child") || sprite->get_child(0)->get_owner() != root) {
+		OS::get_singleton()->print("\tbad child\n");
+		return false;
+	}
+
+	return true;
+}
+
+bool test_instance_properties() {
+
+	OS::get_singleton()->print("\n\nTest 1: Instanced properties and children\n");
+
+	Ref<PackedScene> scene = make_scene(0.5);
+	if (scene.is_null()) {
+		return false;
+	}
+
+	// The first instance builds the plan, the second one uses it.
+	for (int i = 0; i < 2; i++) {
+		Node *node = scene->instance();
+		bool ok = check_instance(node, 0.5);
+		if (node) {
+			memdelete(node);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool test_plan_dropped_on_change() {
+
+	OS::get_singleton()->print("\n\nTest 2: Changed scene is instanced with its new properties\n");
+
+	Ref<PackedScene> scene = make_scene(0.5);
+	if (scene.is_null()) {
+		return false;
+	}
+
+	Node *node = scene->instance();
+	if (!node) {
+		return false;
+	}
+	memdelete(node);
+
+	Ref<PackedScene> changed = make_scene(1.25);
+	if (changed.is_null()) {
+		return false;
+	}
+	scene->get_state()->set_bundled_scene(changed->get_state()->get_bundled_scene());
+
+	node = scene->instance();
+	bool ok = check_instance(node, 1.25);
+	if (node) {
+		memdelete(node);
+	}
+
+	return ok;
+}
+
+bool test_instancing_time() {
+
+	OS::get_singleton()->print("\n\nTest 3: Instancing time\n");
+
+	Ref<PackedScene> scene = make_scene(0.5);
+	if (scene.is_null()) {
+		return false;
+	}
+
+	Vector<Node *> nodes;
+	nodes.resize(INSTANCE_COUNT);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+		nodes.write[i] = scene->instance();
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	bool ok = true;
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+		if (!nodes[i]) {
+			ok = false;
+			continue;
+		}
+		if (i == INSTANCE_COUNT - 1) {
+			ok = ok && check_instance(nodes[i], 0.5);
+		}
+		memdelete(nodes[i]);
+	}
+
+	OS::get_singleton()->print("\tInstanced %i scenes in %i usec\n", INSTANCE_COUNT, (int)elapsed);
+
+	return ok;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_instance_properties,
+	test_plan_dropped_on_change,
+	test_instancing_time,
+	0
+
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestPackedScene
@@ -0,0 +1,357 @@
+/*************************************************************************/
+/*  test_render_benchmark.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+// The recording device is only built for the server platform.
+#ifdef SERVER_ENABLED
+
+#include "test_render_benchmark.h"
+
+#include "core/math/math_funcs.h"
+#include "core/os/main_loop.h"
+#include "core/os/os.h"
+#include "core/print_string.h"
+#include "drivers/dummy/rendering_device_recording.h"
+#include "servers/visual_server.h"
+
+// Renders synthetic 3D and 2D scenes for a fixed amount of frames and reports the CPU
+// time spent in every renderer stage. Meant to be run without a GPU:
+//
+//   godot_server --video-driver Recording --test render_benchmark [object_count]
+
+#define OBJECT_COUNT 2000
+#define CANVAS_ITEM_COUNT 2000
+#define WARMUP_FRAMES 30
+#define MEASURED_FRAMES 300
+
+namespace TestRenderBenchmark {
+
+class TestMainLoop : public MainLoop {
+
+	RID scenario;
+	RID camera;
+	RID viewport;
+	RID canvas;
+	Vector<RID> lights;
+
+	struct InstanceInfo {
+		RID instance;
+		Transform base;
+		Vector3 rot_axis;
+	};
+
+	Vector<InstanceInfo> instances;
+
+	struct CanvasItemInfo {
+		RID item;
+		Vector2 origin;
+		float speed;
+	};
+
+	Vector<CanvasItemInfo> canvas_items;
+
+	struct StageTime {
+		String name;
+		double total_msec;
+	};
+
+	Vector<StageTime> stages;
+	double total_frame_msec;
+	uint64_t last_profile_frame;
+
+	uint64_t command_totals[RenderingDeviceRecording::COMMAND_MAX];
+	uint64_t draw_instances;
+	uint64_t draw_elements;
+	uint64_t upload_bytes;
+
+	int frame;
+	int measured_frames;
+	uint64_t begin_usec;
+	float ofs;
+
+	void _accumulate_profile() {
+
+		VisualServer *vs = VisualServer::get_singleton();
+
+		if (vs->get_frame_profile_frame() == last_profile_frame) {
+			return;
+		}
+		last_profile_frame = vs->get_frame_profile_frame();
+
+		Vector<VisualServer::FrameProfileArea> profile = vs->get_frame_profile();
+		if (profile.size() == 0) {
+			return;
+		}
+
+		// Areas store the time elapsed since the first timestamp, so a stage lasts until the next one begins.
+		for (int i = 0; i < profile.size() - 1; i++) {
+			double msec = profile[i + 1].cpu_msec - profile[i].cpu_msec;
+			int idx = -1;
+			for (int j = 0; j < stages.size(); j++) {
+				if (stages[j].name == profile[i].name) {
+					idx = j;
+					break;
+				}
+			}
+			if (idx == -1) {
+				StageTime st;
+				st.name = profile[i].name;
+				st.total_msec = 0;
+				stages.push_back(st);
+				idx = stages.size() - 1;
+			}
+			stages.write[idx].total_msec += msec;
+		}
+		total_frame_msec += profile[profile.size() - 1].cpu_msec;
+
+		RenderingDeviceRecording *rd = Object::cast_to<RenderingDeviceRecording>(RenderingDevice::get_singleton());
+		if (rd) {
+			const RenderingDeviceRecording::FrameStats &stats = rd->get_last_frame_stats();
+			for (int i = 0; i < RenderingDeviceRecording::COMMAND_MAX; i++) {
+				command_totals[i] += stats.command_count[i];
+			}
+			draw_instances += stats.draw_instances;
+			draw_elements += stats.draw_elements;
+			upload_bytes += stats.upload_bytes;
+		}
+
+		measured_frames++;
+	}
+
+	void _print_results() {
+
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		print_line("RENDER BENCHMARK: " + itos(instances.size()) + " instances, " + itos(canvas_items.size()) + " canvas items, " + itos(measured_frames) + " profiled frames");
+		print_line("Wall time per frame: " + rtos(double(elapsed) / 1000.0 / MEASURED_FRAMES) + " msec");
+
+		if (measured_frames == 0) {
+			print_line("No frame profile was captured, make sure a rendering driver is in use (--video-driver Recording).");
+			return;
+		}
+
+		print_line("CPU time per frame: " + rtos(total_frame_msec / measured_frames) + " msec");
+		for (int i = 0; i < stages.size(); i++) {
+			print_line("\t" + stages[i].name + ": " + rtos(stages[i].total_msec / measured_frames) + " msec");
+		}
+
+		if (!Object::cast_to<RenderingDeviceRecording>(RenderingDevice::get_singleton())) {
+			return;
+		}
+
+		print_line("Recorded commands per frame:");
+		for (int i = 0; i < RenderingDeviceRecording::COMMAND_MAX; i++) {
+			if (command_totals[i] == 0) {
+				continue;
+			}
+			print_line("\t" + String(RenderingDeviceRecording::get_command_name(RenderingDeviceRecording::CommandType(i))) + ": " + rtos(double(command_totals[i]) / measured_frames));
+		}
+		print_line("Instances drawn per frame: " + rtos(double(draw_instances) / measured_frames));
+		print_line("Elements drawn per frame: " + rtos(double(draw_elements) / measured_frames));
+		print_line("Bytes uploaded per frame: " + rtos(double(upload_bytes) / measured_frames));
+	}
+
+public:
+	virtual void init() {
+
+		VisualServer *vs = VisualServer::get_singleton();
+
+		int object_count = OBJECT_COUNT;
+		List<String> cmdline = OS::get_singleton()->get_cmdline_args();
+		if (cmdline.size() > 0 && cmdline[cmdline.size() - 1].to_int()) {
+			object_count = cmdline[cmdline.size() - 1].to_int();
+		}
+
+		Math::seed(0x42);
+
+		/* 3D */
+
+		RID test_cube = vs->get_test_cube();
+		scenario = vs->scenario_create();
+
+		for (int i = 0; i < object_count; i++) {
+
+			InstanceInfo ii;
+			ii.instance = vs->instance_create2(test_cube, scenario);
+			ii.base.translate(Math::random(-40, 40), Math::random(-40, 40), Math::random(-40, 18));
+			ii.base.rotate(Vector3(0, 1, 0), Math::randf() * Math_PI);
+			ii.base.rotate(Vector3(1, 0, 0), Math::randf() * Math_PI);
+			ii.rot_axis = Vector3(Math::random(-1, 1), Math::random(-1, 1), Math::random(-1, 1)).normalized();
+			vs->instance_set_transform(ii.instance, ii.base);
+
+			instances.push_back(ii);
+		}
+
+		RID directional = vs->directional_light_create();
+		vs->light_set_color(directional, Color(1.0, 1.0, 1.0));
+		RID light_instance = vs->instance_create2(directional, scenario);
+		Transform lla;
+		lla.set_look_at(Vector3(), Vector3(-0.2, -0.8, -0.5), Vector3(0, 1, 0));
+		vs->instance_set_transform(light_instance, lla);
+		lights.push_back(directional);
+		lights.push_back(light_instance);
+
+		for (int i = 0; i < 16; i++) {
+			RID omni = vs->omni_light_create();
+			vs->light_set_color(omni, Color(Math::randf(), Math::randf(), Math::randf()));
+			vs->light_set_param(omni, VisualServer::LIGHT_PARAM_RANGE, 8);
+			RID omni_instance = vs->instance_create2(omni, scenario);
+			vs->instance_set_transform(omni_instance, Transform(Basis(), Vector3(Math::random(-30, 30), Math::random(-30, 30), Math::random(-30, 10))));
+			lights.push_back(omni);
+			lights.push_back(omni_instance);
+		}
+
+		camera = vs->camera_create();
+		vs->camera_set_transform(camera, Transform(Basis(), Vector3(0, 3, 30)));
+		vs->camera_set_perspective(camera, 60, 0.1, 1000);
+
+		viewport = vs->viewport_create();
+		Size2i screen_size = OS::get_singleton()->get_window_size();
+		vs->viewport_set_size(viewport, screen_size.x, screen_size.y);
+		vs->viewport_attach_to_screen(viewport, Rect2(Vector2(), screen_size));
+		vs->viewport_set_active(viewport, true);
+		vs->viewport_attach_camera(viewport, camera);
+		vs->viewport_set_scenario(viewport, scenario);
+
+		/* 2D */
+
+		canvas = vs->canvas_create();
+		vs->viewport_attach_canvas(viewport, canvas);
+
+		for (int i = 0; i < CANVAS_ITEM_COUNT; i++) {
+
+			CanvasItemInfo ci;
+			ci.item = vs->canvas_item_create();
+			ci.origin = Vector2(Math::random(0, screen_size.x), Math::random(0, screen_size.y));
+			ci.speed = Math::random(-2, 2);
+			vs->canvas_item_set_parent(ci.item, canvas);
+
+			Color color(Math::randf(), Math::randf(), Math::randf(), 0.5);
+			if (i % 2 == 0) {
+				vs->canvas_item_add_rect(ci.item, Rect2(-8, -8, 16, 16), color);
+			} else {
+				Vector<Point2> points;
+				Vector<Color> colors;
+				for (int j = 0; j < 6; j++) {
+					float a = j * Math_PI * 2.0 / 6.0;
+					points.push_back(Point2(Math::cos(a), Math::sin(a)) * 10.0);
+				}
+				colors.push_back(color);
+				vs->canvas_item_add_polygon(ci.item, points, colors);
+			}
+			vs->canvas_item_set_transform(ci.item, Transform2D(0, ci.origin));
+
+			canvas_items.push_back(ci);
+		}
+
+		vs->set_frame_profiling_enabled(true);
+
+		stages.clear();
+		total_frame_msec = 0;
+		last_profile_frame = 0;
+		for (int i = 0; i < RenderingDeviceRecording::COMMAND_MAX; i++) {
+			command_totals[i] = 0;
+		}
+		draw_instances = 0;
+		draw_elements = 0;
+		upload_bytes = 0;
+		frame = 0;
+		measured_frames = 0;
+		begin_usec = 0;
+		ofs = 0;
+	}
+
+	virtual bool iteration(float p_time) {
+
+		VisualServer *vs = VisualServer::get_singleton();
+
+		// Use a fixed step, so every run renders exactly the same frames.
+		ofs += 1.0 / 60.0;
+
+		for (int i = 0; i < instances.size(); i++) {
+			const InstanceInfo &ii = instances[i];
+			Transform pre(Basis(ii.rot_axis, ofs), Vector3());
+			vs->instance_set_transform(ii.instance, pre * ii.base);
+		}
+
+		for (int i = 0; i < canvas_items.size(); i++) {
+			const CanvasItemInfo &ci = canvas_items[i];
+			vs->canvas_item_set_transform(ci.item, Transform2D(ofs * ci.speed, ci.origin));
+		}
+
+		if (frame == WARMUP_FRAMES) {
+			begin_usec = OS::get_singleton()->get_ticks_usec();
+			last_profile_frame = vs->get_frame_profile_frame();
+		} else if (frame > WARMUP_FRAMES) {
+			_accumulate_profile();
+		}
+
+		frame++;
+
+		if (frame > WARMUP_FRAMES + MEASURED_FRAMES) {
+			_print_results();
+			return true;
+		}
+
+		return false;
+	}
+
+	virtual bool idle(float p_time) {
+		return false;
+	}
+
+	virtual void finish() {
+
+		VisualServer *vs = VisualServer::get_singleton();
+
+		vs->set_frame_profiling_enabled(false);
+
+		for (int i = 0; i < canvas_items.size(); i++) {
+			vs->free(canvas_items[i].item);
+		}
+		for (int i = 0; i < instances.size(); i++) {
+			vs->free(instances[i].instance);
+		}
+		for (int i = lights.size() - 1; i >= 0; i--) {
+			vs->free(lights[i]);
+		}
+		vs->free(canvas);
+		vs->free(viewport);
+		vs->free(camera);
+		vs->free(scenario);
+	}
+};
+
+MainLoop *test() {
+
+	return memnew(TestMainLoop);
+}
+} // namespace TestRenderBenchmark
+
+#endif
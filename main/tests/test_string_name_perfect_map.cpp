@@ -0,0 +1,143 @@
+/*************************************************************************/
+/*  test_string_name_perfect_map.cpp                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_string_name_perfect_map.h"
+
+#include "core/class_db.h"
+#include "core/os/os.h"
+#include "core/string_name_perfect_map.h"
+
+namespace TestStringNamePerfectMap {
+
+bool test_empty() {
+	HashMap<StringName, int> source;
+	StringNamePerfectMap<int> map;
+
+	return map.build(source) && map.size() == 0 && !map.getptr("missing");
+}
+
+bool test_lookup() {
+	HashMap<StringName, int> source;
+	for (int i = 0; i < 2000; i++) {
+		source[StringName("key_" + itos(i))] = i;
+	}
+
+	StringNamePerfectMap<int> map;
+	if (!map.build(source) || map.size() != 2000) {
+		return false;
+	}
+
+	for (int i = 0; i < 2000; i++) {
+		const int *value = map.getptr(StringName("key_" + itos(i)));
+		if (!value || *value != i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_missing_keys() {
+	HashMap<StringName, int> source;
+	for (int i = 0; i < 100; i++) {
+		source[StringName("key_" + itos(i))] = i;
+	}
+
+	StringNamePerfectMap<int> map;
+	map.build(source);
+
+	for (int i = 100; i < 1000; i++) {
+		if (map.getptr(StringName("key_" + itos(i)))) {
+			return false;
+		}
+	}
+	return !map.getptr(StringName());
+}
+
+bool test_rebuild() {
+	HashMap<StringName, int> source;
+	source["a"] = 1;
+	source["b"] = 2;
+
+	StringNamePerfectMap<int> map;
+	map.build(source);
+	source.erase("a");
+	source["c"] = 3;
+	map.build(source);
+
+	return !map.getptr("a") && *map.getptr("b") == 2 && *map.getptr("c") == 3 && map.size() == 2;
+}
+
+bool test_class_db_inherited() {
+	// Inherited methods resolve to the parent's bind.
+	MethodBind *node = ClassDB::get_method("Node", "get_instance_id");
+	MethodBind *object = ClassDB::get_method("Object", "get_instance_id");
+
+	return node && node == object && !ClassDB::get_method("Node", "not_a_method");
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_empty,
+	test_lookup,
+	test_missing_keys,
+	test_rebuild,
+	test_class_db_inherited,
+	0
+
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestStringNamePerfectMap
@@ -39,7 +39,9 @@
 #include "core/os/file_access.h"
 #include "core/os/os.h"
 #include "core/project_settings.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_compiler.h"
+#include "gdscript_optimizer.h"
 
 ///////////////////////////
 
@@ -408,6 +410,7 @@ bool GDScript::_update_exports() {
 			const GDScriptParser::ClassNode *c = static_cast<const GDScriptParser::ClassNode *>(root);
 
 			if (base_cache.is_valid()) {
+				MutexLock lock(GDScriptLanguage::singleton->lock);
 				base_cache->inheriters_cache.erase(get_instance_id());
 				base_cache = Ref<GDScript>();
 			}
@@ -440,6 +443,7 @@ bool GDScript::_update_exports() {
 
 						if (bf.is_valid()) {
 
+							MutexLock lock(GDScriptLanguage::singleton->lock);
 							base_cache = bf;
 							bf->inheriters_cache.insert(get_instance_id());
 						}
@@ -530,6 +534,11 @@ void GDScript::_set_subclass_path(Ref<GDScript> &p_sc, const String &p_path) {
 
 Error GDScript::reload(bool p_keep_state) {
 
+	return _reload(p_keep_state, true);
+}
+
+Error GDScript::_reload(bool p_keep_state, bool p_debug_opcodes) {
+
 	bool has_instances;
 	{
 		MutexLock lock(GDScriptLanguage::singleton->lock);
@@ -565,7 +574,13 @@ Error GDScript::reload(bool p_keep_state) {
 
 	bool can_run = ScriptServer::is_scripting_enabled() || parser.is_tool_script();
 
+	if (!ScriptDebugger::get_singleton()) {
+		// Stepping and inspecting locals in the debugger expect the code as written.
+		GDScriptOptimizer().optimize(&parser);
+	}
+
 	GDScriptCompiler compiler;
+	compiler.set_debug_opcodes(p_debug_opcodes);
 	err = compiler.compile(&parser, this, p_keep_state);
 
 	if (err) {
@@ -850,6 +865,26 @@ Error GDScript::load_byte_code(const String &p_path) {
 	ERR_FAIL_COND_V(bytecode.size() == 0, ERR_PARSE_ERROR);
 	path = p_path;
 
+	if (GDScriptBytecodeCache::is_cache(bytecode)) {
+
+		// Stepping and inspecting locals in the debugger expect the code as
+		// written, so the tokens stored with the compiled code are used then.
+		if (!ScriptDebugger::get_singleton() && GDScriptBytecodeCache::load(bytecode, this) == OK) {
+
+			valid = true;
+
+			for (Map<StringName, Ref<GDScript> >::Element *E = subclasses.front(); E; E = E->next()) {
+
+				_set_subclass_path(E->get(), path);
+			}
+
+			return OK;
+		}
+
+		bytecode = GDScriptBytecodeCache::get_tokens(bytecode);
+		ERR_FAIL_COND_V(bytecode.size() == 0, ERR_PARSE_ERROR);
+	}
+
 	String basedir = path;
 
 	if (basedir == "")
@@ -866,6 +901,10 @@ Error GDScript::load_byte_code(const String &p_path) {
 		ERR_FAIL_V(ERR_PARSE_ERROR);
 	}
 
+	if (!ScriptDebugger::get_singleton()) {
+		GDScriptOptimizer().optimize(&parser);
+	}
+
 	GDScriptCompiler compiler;
 	err = compiler.compile(&parser, this);
 
@@ -1031,6 +1070,10 @@ void GDScript::_save_orphaned_subclasses() {
 }
 
 GDScript::~GDScript() {
+	if (GDScriptLanguage::get_singleton()) {
+		GDScriptLanguage::get_singleton()->invalidate_inline_caches();
+	}
+
 	for (Map<StringName, GDScriptFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
@@ -1532,6 +1575,10 @@ void GDScriptLanguage::init() {
 
 		_add_global(E->get().name, E->get().ptr);
 	}
+
+	if (GLOBAL_GET("debug/gdscript/sampling_profiler/enabled") && !Engine::get_singleton()->is_editor_hint()) {
+		sampling_profiler.start(GLOBAL_GET("debug/gdscript/sampling_profiler/interval_usec"));
+	}
 }
 
 String GDScriptLanguage::get_type() const {
@@ -1548,6 +1595,11 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 	return OK;
 }
 void GDScriptLanguage::finish() {
+
+	if (sampling_profiler.is_running()) {
+		sampling_profiler.stop();
+		sampling_profiler.save(GLOBAL_GET("debug/gdscript/sampling_profiler/output_path"));
+	}
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -1566,6 +1618,7 @@ void GDScriptLanguage::profiling_start() {
 		elem->self()->profile.last_frame_call_count = 0;
 		elem->self()->profile.last_frame_self_time = 0;
 		elem->self()->profile.last_frame_total_time = 0;
+		elem->self()->profile.opcode_count = 0;
 		elem = elem->next();
 	}
 
@@ -1815,6 +1868,10 @@ void GDScriptLanguage::frame() {
 
 	calls = 0;
 
+	if (sampling_profiler.is_running()) {
+		sampling_profiler.flush();
+	}
+
 #ifdef DEBUG_ENABLED
 	if (profiling) {
 		MutexLock lock(this->lock);
@@ -2183,6 +2240,7 @@ GDScriptWarning::Code GDScriptWarning::get_code_from_name(const String &p_name)
 GDScriptLanguage::GDScriptLanguage() {
 
 	calls = 0;
+	inline_cache_generation.store(0);
 	ERR_FAIL_COND(singleton);
 	singleton = this;
 	strings._init = StaticCString::create("_init");
@@ -2201,6 +2259,11 @@ GDScriptLanguage::GDScriptLanguage() {
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/gdscript/max_call_stack", PropertyInfo(Variant::INT, "debug/settings/gdscript/max_call_stack", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater")); //minimum is 1024
 
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/enabled", false);
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/interval_usec", 1000);
+	ProjectSettings::get_singleton()->set_custom_property_info("debug/gdscript/sampling_profiler/interval_usec", PropertyInfo(Variant::INT, "debug/gdscript/sampling_profiler/interval_usec", PROPERTY_HINT_RANGE, "100,100000,1,or_greater"));
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/output_path", "user://gdscript_samples.txt");
+
 	if (ScriptDebugger::get_singleton()) {
 		//debugging enabled!
 
@@ -2234,10 +2297,12 @@ GDScriptLanguage::~GDScriptLanguage() {
 }
 
 void GDScriptLanguage::add_orphan_subclass(const String &p_qualified_name, const ObjectID &p_subclass) {
+	MutexLock lock(this->lock);
 	orphan_subclasses[p_qualified_name] = p_subclass;
 }
 
 Ref<GDScript> GDScriptLanguage::get_orphan_subclass(const String &p_qualified_name) {
+	MutexLock lock(this->lock);
 	Map<String, ObjectID>::Element *orphan_subclass_element = orphan_subclasses.find(p_qualified_name);
 	if (!orphan_subclass_element)
 		return Ref<GDScript>();
@@ -2264,7 +2329,9 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 
 		script->set_script_path(p_original_path); // script needs this.
 		script->set_path(p_original_path);
+		GDScriptCache::load_started(p_original_path);
 		Error err = script->load_byte_code(p_path);
+		GDScriptCache::load_finished(p_original_path);
 		ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot load byte code from file '" + p_path + "'.");
 
 	} else {
@@ -2274,7 +2341,9 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 		script->set_script_path(p_original_path); // script needs this.
 		script->set_path(p_original_path);
 
+		GDScriptCache::load_started(p_original_path);
 		script->reload();
+		GDScriptCache::load_finished(p_original_path);
 	}
 	if (r_error)
 		*r_error = OK;
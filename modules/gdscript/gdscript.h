@@ -34,7 +34,9 @@
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/script_language.h"
+#include "gdscript_cache.h"
 #include "gdscript_function.h"
+#include "gdscript_sampling_profiler.h"
 
 class GDScriptNativeClass : public Reference {
 
@@ -70,6 +72,7 @@ class GDScript : public Script {
 	friend class GDScriptInstance;
 	friend class GDScriptFunction;
 	friend class GDScriptCompiler;
+	friend class GDScriptBytecodeCache;
 	friend class GDScriptFunctions;
 	friend class GDScriptLanguage;
 
@@ -118,6 +121,7 @@ class GDScript : public Script {
 	GDScriptInstance *_create_instance(const Variant **p_args, int p_argcount, Object *p_owner, bool p_isref, Callable::CallError &r_error);
 
 	void _set_subclass_path(Ref<GDScript> &p_sc, const String &p_path);
+	Error _reload(bool p_keep_state, bool p_debug_opcodes);
 
 #ifdef TOOLS_ENABLED
 	Set<PlaceHolderScriptInstance *> placeholders;
@@ -380,11 +384,21 @@ class GDScriptLanguage : public ScriptLanguage {
 	bool profiling;
 	uint64_t script_frame_time;
 
+	GDScriptSamplingProfiler sampling_profiler;
+	GDScriptCache cache;
+
 	Map<String, ObjectID> orphan_subclasses;
 
+	std::atomic<uint32_t> inline_cache_generation;
+
 public:
 	int calls;
 
+	// Bytecode inline caches hold raw function and member pointers, so they are
+	// flushed whenever a script is recompiled or freed.
+	_FORCE_INLINE_ uint32_t get_inline_cache_generation() const { return inline_cache_generation.load(std::memory_order_acquire); }
+	_FORCE_INLINE_ void invalidate_inline_caches() { inline_cache_generation.fetch_add(1, std::memory_order_acq_rel); }
+
 	bool debug_break(const String &p_error, bool p_allow_continue = true);
 	bool debug_break_parse(const String &p_file, int p_line, const String &p_error);
 
@@ -524,6 +538,8 @@ public:
 	virtual int profiling_get_accumulated_data(ProfilingInfo *p_info_arr, int p_info_max);
 	virtual int profiling_get_frame_data(ProfilingInfo *p_info_arr, int p_info_max);
 
+	GDScriptSamplingProfiler *get_sampling_profiler() { return &sampling_profiler; }
+
 	/* LOADER FUNCTIONS */
 
 	virtual void get_recognized_extensions(List<String> *p_extensions) const;
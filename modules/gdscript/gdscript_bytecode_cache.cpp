@@ -0,0 +1,1093 @@
+/*************************************************************************/
+/*  gdscript_bytecode_cache.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_bytecode_cache.h"
+
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/version.h"
+#include "gdscript_functions.h"
+
+static const uint8_t cache_magic[4] = { 'G', 'D', 'S', 'O' };
+
+uint32_t GDScriptBytecodeCache::_get_build_signature(bool p_debug) {
+
+	// Opcodes, builtin functions, operators and types are stored as plain
+	// integers in the code, a cache is only valid for the build that wrote it.
+	// Debug and release templates compile different code from the same source.
+	uint32_t hash = String(VERSION_FULL_BUILD).hash();
+	hash = hash_djb2_one_32(GDScriptFunction::OPCODE_END, hash);
+	hash = hash_djb2_one_32(GDScriptFunction::ADDR_BITS, hash);
+	hash = hash_djb2_one_32(GDScriptFunctions::FUNC_MAX, hash);
+	hash = hash_djb2_one_32(Variant::OP_MAX, hash);
+	hash = hash_djb2_one_32(Variant::VARIANT_MAX, hash);
+	hash = hash_djb2_one_32(p_debug, hash);
+	return hash;
+}
+
+bool GDScriptBytecodeCache::_get_address_operands(const Vector<int> &p_code, Vector<int> &r_addresses) {
+
+	// Follows the instruction layouts GDScriptFunction::call() decodes, only
+	// these operands are addresses, the others are names, types, counts,
+	// jump targets and cache slots.
+#define OPERAND(m_pos) (1 << (m_pos))
+
+	const int *code = p_code.ptr();
+	int size = p_code.size();
+	int ip = 0;
+
+	while (ip < size) {
+
+		int length = 0;
+		int operands = 0;
+		// Argument lists are contiguous addresses, followed by the result.
+		int list_start = 0;
+		int list_size = 0;
+
+		switch (code[ip]) {
+			case GDScriptFunction::OPCODE_OPERATOR:
+			case GDScriptFunction::OPCODE_OPERATOR_INT:
+			case GDScriptFunction::OPCODE_OPERATOR_FLOAT:
+			case GDScriptFunction::OPCODE_OPERATOR_VECTOR2:
+			case GDScriptFunction::OPCODE_OPERATOR_VECTOR3: {
+				length = 5;
+				operands = OPERAND(2) | OPERAND(3) | OPERAND(4);
+			} break;
+			case GDScriptFunction::OPCODE_EXTENDS_TEST:
+			case GDScriptFunction::OPCODE_SET:
+			case GDScriptFunction::OPCODE_GET:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT:
+			case GDScriptFunction::OPCODE_CAST_TO_NATIVE:
+			case GDScriptFunction::OPCODE_CAST_TO_SCRIPT: {
+				length = 4;
+				operands = OPERAND(1) | OPERAND(2) | OPERAND(3);
+			} break;
+			case GDScriptFunction::OPCODE_IS_BUILTIN: {
+				length = 4;
+				operands = OPERAND(1) | OPERAND(3);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+			case GDScriptFunction::OPCODE_CAST_TO_BUILTIN: {
+				length = 4;
+				operands = OPERAND(2) | OPERAND(3);
+			} break;
+			case GDScriptFunction::OPCODE_SET_NAMED:
+			case GDScriptFunction::OPCODE_GET_NAMED: {
+				length = 5;
+				operands = OPERAND(1) | OPERAND(4);
+			} break;
+			case GDScriptFunction::OPCODE_SET_MEMBER:
+			case GDScriptFunction::OPCODE_GET_MEMBER: {
+				length = 3;
+				operands = OPERAND(2);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN:
+			case GDScriptFunction::OPCODE_YIELD_SIGNAL:
+			case GDScriptFunction::OPCODE_ASSERT: {
+				length = 3;
+				operands = OPERAND(1) | OPERAND(2);
+			} break;
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+				length = 3;
+				operands = OPERAND(1);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+			case GDScriptFunction::OPCODE_YIELD_RESUME:
+			case GDScriptFunction::OPCODE_RETURN: {
+				length = 2;
+				operands = OPERAND(1);
+			} break;
+			case GDScriptFunction::OPCODE_JUMP:
+			case GDScriptFunction::OPCODE_LINE: {
+				length = 2;
+			} break;
+			case GDScriptFunction::OPCODE_YIELD:
+			case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+			case GDScriptFunction::OPCODE_BREAKPOINT:
+			case GDScriptFunction::OPCODE_END: {
+				length = 1;
+			} break;
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN:
+			case GDScriptFunction::OPCODE_ITERATE:
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+			case GDScriptFunction::OPCODE_ITERATE_INT: {
+				length = 5;
+				operands = OPERAND(1) | OPERAND(2) | OPERAND(4);
+			} break;
+			case GDScriptFunction::OPCODE_CONSTRUCT:
+			case GDScriptFunction::OPCODE_CALL_BUILT_IN:
+			case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
+				// Type, function or name, then the argument count.
+				int argc = ip + 2 < size ? code[ip + 2] : -1;
+				if (argc < 0 || argc >= size) {
+					return false;
+				}
+				length = 4 + argc;
+				list_start = 3;
+				list_size = argc + 1;
+			} break;
+			case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+			case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY: {
+				// Element count, dictionaries store key and value pairs.
+				int argc = ip + 1 < size ? code[ip + 1] : -1;
+				if (argc < 0 || argc >= size) {
+					return false;
+				}
+				int elements = code[ip] == GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY ? argc * 2 : argc;
+				length = 3 + elements;
+				list_start = 2;
+				list_size = elements + 1;
+			} break;
+			case GDScriptFunction::OPCODE_CALL:
+			case GDScriptFunction::OPCODE_CALL_RETURN:
+			case GDScriptFunction::OPCODE_CALL_PTRCALL:
+			case GDScriptFunction::OPCODE_CALL_PTRCALL_RETURN: {
+				// Argument count, base, name and cache slot.
+				int argc = ip + 1 < size ? code[ip + 1] : -1;
+				if (argc < 0 || argc >= size) {
+					return false;
+				}
+				length = 6 + argc;
+				operands = OPERAND(2);
+				list_start = 5;
+				list_size = argc + 1;
+			} break;
+			default: {
+				return false;
+			}
+		}
+
+		if (length > size - ip) {
+			return false;
+		}
+
+		for (int i = 1; i < 5; i++) {
+			if (operands & OPERAND(i)) {
+				r_addresses.push_back(ip + i);
+			}
+		}
+		for (int i = 0; i < list_size; i++) {
+			r_addresses.push_back(ip + list_start + i);
+		}
+
+		ip += length;
+	}
+
+#undef OPERAND
+
+	return true;
+}
+
+/* Saving */
+
+void GDScriptBytecodeCache::_put_8(uint8_t p_value) {
+
+	data.push_back(p_value);
+}
+
+void GDScriptBytecodeCache::_put_32(uint32_t p_value) {
+
+	int size = data.size();
+	data.resize(size + 4);
+	encode_uint32(p_value, &data.write[size]);
+}
+
+void GDScriptBytecodeCache::_put_string(const String &p_string) {
+
+	CharString utf8 = p_string.utf8();
+	_put_32(utf8.length());
+	_put_buffer((const uint8_t *)utf8.get_data(), utf8.length());
+}
+
+void GDScriptBytecodeCache::_put_buffer(const uint8_t *p_buffer, int p_size) {
+
+	if (p_size == 0) {
+		return;
+	}
+
+	int size = data.size();
+	data.resize(size + p_size);
+	copymem(&data.write[size], p_buffer, p_size);
+}
+
+void GDScriptBytecodeCache::_put_variant(const Variant &p_value) {
+
+	switch (p_value.get_type()) {
+		case Variant::OBJECT: {
+			Object *obj = p_value.get_validated_object();
+			if (!obj) {
+				_put_8(VARIANT_NULL_OBJECT);
+				break;
+			}
+
+			GDScriptNativeClass *native = Object::cast_to<GDScriptNativeClass>(obj);
+			if (native) {
+				_put_8(VARIANT_NATIVE_CLASS);
+				_put_string(native->get_name());
+				break;
+			}
+
+			Script *script = Object::cast_to<Script>(obj);
+			if (script) {
+				_put_8(VARIANT_SCRIPT);
+				_put_script(Ref<Script>(script));
+				break;
+			}
+
+			// Preloaded resources are loaded again by path, anything else
+			// (autoload instances, built-in resources) can't be stored.
+			Resource *res = Object::cast_to<Resource>(obj);
+			if (!res || !res->get_path().is_resource_file()) {
+				failed = true;
+				break;
+			}
+
+			_put_8(VARIANT_RESOURCE);
+			_put_string(res->get_path());
+		} break;
+		case Variant::ARRAY: {
+			Array array = p_value;
+			_put_8(VARIANT_ARRAY);
+			_put_32(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				_put_variant(array[i]);
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary dict = p_value;
+			List<Variant> keys;
+			dict.get_key_list(&keys);
+
+			_put_8(VARIANT_DICTIONARY);
+			_put_32(keys.size());
+			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+				_put_variant(E->get());
+				_put_variant(dict[E->get()]);
+			}
+		} break;
+		case Variant::_RID:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL: {
+			failed = true;
+		} break;
+		default: {
+			int len;
+			Error err = encode_variant(p_value, NULL, len);
+			if (err != OK) {
+				failed = true;
+				break;
+			}
+
+			_put_8(VARIANT_VALUE);
+			int size = data.size();
+			data.resize(size + len);
+			encode_variant(p_value, &data.write[size], len);
+		} break;
+	}
+}
+
+void GDScriptBytecodeCache::_put_script(const Ref<Script> &p_script) {
+
+	if (p_script.is_null()) {
+		_put_8(SCRIPT_NONE);
+		return;
+	}
+
+	// Inner classes are stored as the file they belong to and the path of
+	// class names leading to them.
+	Vector<StringName> names;
+	const Script *top = p_script.ptr();
+	const GDScript *gdscript = Object::cast_to<GDScript>(top);
+	while (gdscript && gdscript->_owner) {
+
+		const GDScript *owner = gdscript->_owner;
+		const Map<StringName, Ref<GDScript> >::Element *E = owner->subclasses.front();
+		while (E && E->get().ptr() != gdscript) {
+			E = E->next();
+		}
+
+		if (!E) {
+			failed = true;
+			return;
+		}
+
+		names.push_back(E->key());
+		gdscript = gdscript->_owner;
+		top = gdscript;
+	}
+
+	// References to the script itself (preloads, its class name) resolve to
+	// the copy loaded in the editor, not the one being saved.
+	if (top == root || top->get_path() == root->path) {
+		_put_8(SCRIPT_LOCAL);
+	} else {
+		if (!top->get_path().is_resource_file()) {
+			failed = true;
+			return;
+		}
+
+		_put_8(SCRIPT_EXTERNAL);
+		_put_string(top->get_path());
+	}
+
+	names.invert();
+	_put_32(names.size());
+	for (int i = 0; i < names.size(); i++) {
+		_put_string(names[i]);
+	}
+}
+
+void GDScriptBytecodeCache::_put_data_type(const GDScriptDataType &p_type) {
+
+	_put_8(p_type.has_type);
+	if (!p_type.has_type) {
+		return;
+	}
+
+	_put_8(p_type.kind);
+	_put_32(p_type.builtin_type);
+	_put_string(p_type.native_type);
+	_put_script(p_type.script_type);
+}
+
+void GDScriptBytecodeCache::_put_property(const PropertyInfo &p_property) {
+
+	_put_32(p_property.type);
+	_put_string(p_property.name);
+	_put_string(p_property.class_name);
+	_put_32(p_property.hint);
+	_put_string(p_property.hint_string);
+	_put_32(p_property.usage);
+}
+
+void GDScriptBytecodeCache::_put_function(const GDScriptFunction *p_function) {
+
+	_put_string(p_function->name);
+	_put_8(p_function->_static);
+	_put_32(p_function->rpc_mode);
+	_put_32(p_function->_argument_count);
+	_put_32(p_function->_initial_line);
+	_put_32(p_function->_stack_size);
+	_put_32(p_function->_call_size);
+	_put_32(p_function->_inline_cache_count);
+
+	_put_32(p_function->argument_types.size());
+	for (int i = 0; i < p_function->argument_types.size(); i++) {
+		_put_data_type(p_function->argument_types[i]);
+	}
+	_put_data_type(p_function->return_type);
+
+#ifdef TOOLS_ENABLED
+	_put_32(p_function->arg_names.size());
+	for (int i = 0; i < p_function->arg_names.size(); i++) {
+		_put_string(p_function->arg_names[i]);
+	}
+#else
+	_put_32(0);
+#endif
+
+	_put_32(p_function->constants.size());
+	for (int i = 0; i < p_function->constants.size(); i++) {
+		_put_variant(p_function->constants[i]);
+	}
+
+	_put_32(p_function->global_names.size());
+	for (int i = 0; i < p_function->global_names.size(); i++) {
+		_put_string(p_function->global_names[i]);
+	}
+
+	_put_32(p_function->default_arguments.size());
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		_put_32(p_function->default_arguments[i]);
+	}
+
+	// Global array indices depend on what the build registers (the editor
+	// has more classes than an export template), so globals are saved by
+	// name. Autoloads are named globals in the editor and regular globals
+	// at runtime, they are saved the same way.
+	Vector<int> addresses;
+	if (!_get_address_operands(p_function->code, addresses)) {
+		failed = true;
+		return;
+	}
+
+	Vector<StringName> globals;
+	Vector<int> code = p_function->code;
+	for (int i = 0; i < addresses.size(); i++) {
+
+		int address = code[addresses[i]];
+		int address_type = (address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS;
+		int index = address & GDScriptFunction::ADDR_MASK;
+		StringName global;
+
+		if (address_type == GDScriptFunction::ADDR_TYPE_GLOBAL && index < global_names.size()) {
+			global = global_names[index];
+#ifdef TOOLS_ENABLED
+		} else if (address_type == GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL && index < p_function->named_globals.size()) {
+			global = p_function->named_globals[index];
+#endif
+		} else if (address_type == GDScriptFunction::ADDR_TYPE_GLOBAL || address_type == GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL) {
+			failed = true;
+			return;
+		} else {
+			continue;
+		}
+
+		int global_index = globals.find(global);
+		if (global_index == -1) {
+			global_index = globals.size();
+			globals.push_back(global);
+		}
+		code.write[addresses[i]] = global_index | (GDScriptFunction::ADDR_TYPE_GLOBAL << GDScriptFunction::ADDR_BITS);
+	}
+
+	_put_32(globals.size());
+	for (int i = 0; i < globals.size(); i++) {
+		_put_string(globals[i]);
+	}
+
+	_put_32(code.size());
+	for (int i = 0; i < code.size(); i++) {
+		_put_32(code[i]);
+	}
+}
+
+void GDScriptBytecodeCache::_put_class_tree(const GDScript *p_class) {
+
+	_put_32(p_class->subclasses.size());
+	for (const Map<StringName, Ref<GDScript> >::Element *E = p_class->subclasses.front(); E; E = E->next()) {
+		_put_string(E->key());
+		_put_class_tree(E->get().ptr());
+	}
+}
+
+void GDScriptBytecodeCache::_put_class(const GDScript *p_class) {
+
+	_put_8(p_class->tool);
+	_put_string(p_class->name);
+	_put_script(p_class->base);
+	_put_string(p_class->native.is_valid() ? String(p_class->native->get_name()) : String());
+
+	_put_32(p_class->members.size());
+	for (const Set<StringName>::Element *E = p_class->members.front(); E; E = E->next()) {
+		_put_string(E->get());
+	}
+
+	_put_32(p_class->member_indices.size());
+	for (const Map<StringName, GDScript::MemberInfo>::Element *E = p_class->member_indices.front(); E; E = E->next()) {
+		_put_string(E->key());
+		_put_32(E->get().index);
+		_put_string(E->get().setter);
+		_put_string(E->get().getter);
+		_put_32(E->get().rpc_mode);
+		_put_data_type(E->get().data_type);
+	}
+
+	_put_32(p_class->member_info.size());
+	for (const Map<StringName, PropertyInfo>::Element *E = p_class->member_info.front(); E; E = E->next()) {
+		_put_string(E->key());
+		_put_property(E->get());
+	}
+
+	_put_32(p_class->constants.size());
+	for (const Map<StringName, Variant>::Element *E = p_class->constants.front(); E; E = E->next()) {
+		_put_string(E->key());
+		_put_variant(E->get());
+	}
+
+	_put_32(p_class->_signals.size());
+	for (const Map<StringName, Vector<StringName> >::Element *E = p_class->_signals.front(); E; E = E->next()) {
+		_put_string(E->key());
+		_put_32(E->get().size());
+		for (int i = 0; i < E->get().size(); i++) {
+			_put_string(E->get()[i]);
+		}
+	}
+
+	_put_32(p_class->member_functions.size());
+	for (const Map<StringName, GDScriptFunction *>::Element *E = p_class->member_functions.front(); E; E = E->next()) {
+		_put_function(E->get());
+	}
+	_put_string(p_class->initializer ? String(p_class->initializer->get_name()) : String());
+
+	for (const Map<StringName, Ref<GDScript> >::Element *E = p_class->subclasses.front(); E; E = E->next()) {
+		_put_class(E->get().ptr());
+	}
+}
+
+/* Loading */
+
+uint8_t GDScriptBytecodeCache::_get_8() {
+
+	if (pos + 1 > data.size()) {
+		failed = true;
+		return 0;
+	}
+
+	return data.ptr()[pos++];
+}
+
+uint32_t GDScriptBytecodeCache::_get_32() {
+
+	if (pos + 4 > data.size()) {
+		failed = true;
+		return 0;
+	}
+
+	uint32_t value = decode_uint32(data.ptr() + pos);
+	pos += 4;
+	return value;
+}
+
+String GDScriptBytecodeCache::_get_string() {
+
+	uint32_t len = _get_32();
+	if (len > uint32_t(data.size() - pos)) {
+		failed = true;
+		return String();
+	}
+
+	String string;
+	string.parse_utf8((const char *)data.ptr() + pos, len);
+	pos += len;
+	return string;
+}
+
+Variant GDScriptBytecodeCache::_get_variant() {
+
+	switch (_get_8()) {
+		case VARIANT_VALUE: {
+			Variant value;
+			int len;
+			if (pos >= data.size() || decode_variant(value, data.ptr() + pos, data.size() - pos, &len) != OK) {
+				failed = true;
+				return Variant();
+			}
+
+			pos += len;
+			return value;
+		} break;
+		case VARIANT_NULL_OBJECT: {
+			return Variant((Object *)NULL);
+		} break;
+		case VARIANT_SCRIPT: {
+			return _get_script();
+		} break;
+		case VARIANT_NATIVE_CLASS: {
+			const Map<StringName, int>::Element *E = GDScriptLanguage::get_singleton()->get_global_map().find(_get_string());
+			if (!E) {
+				failed = true;
+				return Variant();
+			}
+
+			return GDScriptLanguage::get_singleton()->get_global_array()[E->get()];
+		} break;
+		case VARIANT_RESOURCE: {
+			RES res = GDScriptCache::load_dependency(_get_string());
+			if (res.is_null()) {
+				failed = true;
+			}
+
+			return res;
+		} break;
+		case VARIANT_ARRAY: {
+			uint32_t size = _get_32();
+			Array array;
+			for (uint32_t i = 0; i < size && !failed; i++) {
+				array.push_back(_get_variant());
+			}
+
+			return array;
+		} break;
+		case VARIANT_DICTIONARY: {
+			uint32_t size = _get_32();
+			Dictionary dict;
+			for (uint32_t i = 0; i < size && !failed; i++) {
+				Variant key = _get_variant();
+				dict[key] = _get_variant();
+			}
+
+			return dict;
+		} break;
+		default: {
+			failed = true;
+		} break;
+	}
+
+	return Variant();
+}
+
+Ref<Script> GDScriptBytecodeCache::_get_script() {
+
+	Ref<Script> script;
+
+	switch (_get_8()) {
+		case SCRIPT_NONE: {
+			return script;
+		} break;
+		case SCRIPT_LOCAL: {
+			script = Ref<Script>(root);
+		} break;
+		case SCRIPT_EXTERNAL: {
+			script = GDScriptCache::load_dependency(_get_string());
+		} break;
+		default: {
+			failed = true;
+			return script;
+		} break;
+	}
+
+	uint32_t name_count = _get_32();
+	for (uint32_t i = 0; i < name_count && !failed; i++) {
+
+		StringName name = _get_string();
+		Ref<GDScript> owner = script;
+		if (owner.is_null() || !owner->subclasses.has(name)) {
+			failed = true;
+			return Ref<Script>();
+		}
+
+		script = owner->subclasses[name];
+	}
+
+	if (script.is_null()) {
+		failed = true;
+	}
+
+	return script;
+}
+
+GDScriptDataType GDScriptBytecodeCache::_get_data_type() {
+
+	GDScriptDataType type;
+	type.has_type = _get_8();
+	if (!type.has_type) {
+		return type;
+	}
+
+	uint8_t kind = _get_8();
+	if (kind > GDScriptDataType::GDSCRIPT) {
+		failed = true;
+		return GDScriptDataType();
+	}
+
+	type.kind = (decltype(type.kind))kind;
+	type.builtin_type = Variant::Type(_get_32());
+	type.native_type = _get_string();
+	type.script_type = _get_script();
+	return type;
+}
+
+PropertyInfo GDScriptBytecodeCache::_get_property() {
+
+	PropertyInfo property;
+	property.type = Variant::Type(_get_32());
+	property.name = _get_string();
+	property.class_name = _get_string();
+	property.hint = PropertyHint(_get_32());
+	property.hint_string = _get_string();
+	property.usage = _get_32();
+	return property;
+}
+
+GDScriptFunction *GDScriptBytecodeCache::_get_function(GDScript *p_class) {
+
+	// Fills the same fields as GDScriptCompiler::_parse_function().
+	GDScriptFunction *func = memnew(GDScriptFunction);
+	func->name = _get_string();
+	func->_static = _get_8();
+	func->rpc_mode = MultiplayerAPI::RPCMode(_get_32());
+	func->_argument_count = _get_32();
+	func->_initial_line = _get_32();
+	func->_stack_size = _get_32();
+	func->_call_size = _get_32();
+	func->_script = p_class;
+	func->source = root->get_path();
+
+	uint32_t inline_cache_count = _get_32();
+	if (!failed && inline_cache_count) {
+		func->_inline_cache_count = inline_cache_count;
+		func->_inline_caches = memnew_arr(GDScriptFunction::InlineCache, inline_cache_count);
+	}
+
+	uint32_t argument_type_count = _get_32();
+	for (uint32_t i = 0; i < argument_type_count && !failed; i++) {
+		func->argument_types.push_back(_get_data_type());
+	}
+	func->return_type = _get_data_type();
+
+	uint32_t arg_name_count = _get_32();
+	for (uint32_t i = 0; i < arg_name_count && !failed; i++) {
+		StringName arg_name = _get_string();
+#ifdef TOOLS_ENABLED
+		func->arg_names.push_back(arg_name);
+#endif
+	}
+
+	uint32_t constant_count = _get_32();
+	for (uint32_t i = 0; i < constant_count && !failed; i++) {
+		func->constants.push_back(_get_variant());
+	}
+	func->_constant_count = func->constants.size();
+	func->_constants_ptr = func->constants.size() ? func->constants.ptrw() : NULL;
+
+	uint32_t global_name_count = _get_32();
+	for (uint32_t i = 0; i < global_name_count && !failed; i++) {
+		func->global_names.push_back(_get_string());
+	}
+	func->_global_names_count = func->global_names.size();
+	func->_global_names_ptr = func->global_names.size() ? func->global_names.ptr() : NULL;
+
+#ifdef TOOLS_ENABLED
+	func->_named_globals_ptr = NULL;
+	func->_named_globals_count = 0;
+#endif
+
+	uint32_t default_argument_count = _get_32();
+	for (uint32_t i = 0; i < default_argument_count && !failed; i++) {
+		func->default_arguments.push_back(_get_32());
+	}
+	func->_default_arg_count = func->default_arguments.size() ? func->default_arguments.size() - 1 : 0;
+	func->_default_arg_ptr = func->default_arguments.size() ? func->default_arguments.ptr() : NULL;
+
+	// Bind global names to this build's global array.
+	const Map<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+	Vector<int> globals;
+	uint32_t global_count = _get_32();
+	for (uint32_t i = 0; i < global_count && !failed; i++) {
+		const Map<StringName, int>::Element *E = global_map.find(_get_string());
+		if (!E) {
+			failed = true;
+			break;
+		}
+		globals.push_back(E->get());
+	}
+
+	uint32_t code_size = _get_32();
+	if (code_size > uint32_t(data.size() - pos) / 4) {
+		failed = true;
+	}
+
+	if (!failed) {
+		func->code.resize(code_size);
+		for (uint32_t i = 0; i < code_size; i++) {
+			func->code.write[i] = _get_32();
+		}
+
+		Vector<int> addresses;
+		if (!_get_address_operands(func->code, addresses)) {
+			failed = true;
+		}
+
+		for (int i = 0; i < addresses.size() && !failed; i++) {
+
+			int address = func->code[addresses[i]];
+			int address_type = (address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS;
+			if (address_type == GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL) {
+				failed = true; // Saved as globals, and never valid outside the editor.
+			} else if (address_type == GDScriptFunction::ADDR_TYPE_GLOBAL) {
+				int index = address & GDScriptFunction::ADDR_MASK;
+				if (index >= globals.size()) {
+					failed = true;
+					break;
+				}
+				func->code.write[addresses[i]] = globals[index] | (GDScriptFunction::ADDR_TYPE_GLOBAL << GDScriptFunction::ADDR_BITS);
+			}
+		}
+	}
+	func->_code_size = func->code.size();
+	func->_code_ptr = func->code.size() ? func->code.ptr() : NULL;
+
+#ifdef DEBUG_ENABLED
+	func->func_cname = (String(func->source) + " - " + String(func->name)).utf8();
+	func->_func_cname = func->func_cname.get_data();
+#endif
+
+	return func;
+}
+
+void GDScriptBytecodeCache::_get_class_tree(GDScript *p_class) {
+
+	uint32_t subclass_count = _get_32();
+	for (uint32_t i = 0; i < subclass_count && !failed; i++) {
+
+		StringName name = _get_string();
+
+		Ref<GDScript> subclass;
+		subclass.instance();
+		subclass->_owner = p_class;
+		subclass->fully_qualified_name = p_class->fully_qualified_name + "::" + name;
+		p_class->subclasses.insert(name, subclass);
+
+		_get_class_tree(subclass.ptr());
+	}
+}
+
+void GDScriptBytecodeCache::_get_class(GDScript *p_class) {
+
+	p_class->tool = _get_8();
+	p_class->name = _get_string();
+
+	p_class->base = _get_script();
+	p_class->_base = p_class->base.ptr();
+
+	String native = _get_string();
+	if (native != String()) {
+		const Map<StringName, int>::Element *E = GDScriptLanguage::get_singleton()->get_global_map().find(native);
+		if (E) {
+			p_class->native = GDScriptLanguage::get_singleton()->get_global_array()[E->get()];
+		}
+		if (p_class->native.is_null()) {
+			failed = true;
+			return;
+		}
+	}
+
+	uint32_t member_count = _get_32();
+	for (uint32_t i = 0; i < member_count && !failed; i++) {
+		p_class->members.insert(_get_string());
+	}
+
+	uint32_t member_index_count = _get_32();
+	for (uint32_t i = 0; i < member_index_count && !failed; i++) {
+
+		StringName name = _get_string();
+		GDScript::MemberInfo minfo;
+		minfo.index = _get_32();
+		minfo.setter = _get_string();
+		minfo.getter = _get_string();
+		minfo.rpc_mode = MultiplayerAPI::RPCMode(_get_32());
+		minfo.data_type = _get_data_type();
+		p_class->member_indices[name] = minfo;
+	}
+
+	uint32_t member_info_count = _get_32();
+	for (uint32_t i = 0; i < member_info_count && !failed; i++) {
+		StringName name = _get_string();
+		p_class->member_info[name] = _get_property();
+	}
+
+	uint32_t constant_count = _get_32();
+	for (uint32_t i = 0; i < constant_count && !failed; i++) {
+		StringName name = _get_string();
+		p_class->constants[name] = _get_variant();
+	}
+
+	uint32_t signal_count = _get_32();
+	for (uint32_t i = 0; i < signal_count && !failed; i++) {
+
+		StringName name = _get_string();
+		Vector<StringName> arguments;
+		uint32_t argument_count = _get_32();
+		for (uint32_t j = 0; j < argument_count && !failed; j++) {
+			arguments.push_back(_get_string());
+		}
+		p_class->_signals[name] = arguments;
+	}
+
+	uint32_t function_count = _get_32();
+	for (uint32_t i = 0; i < function_count && !failed; i++) {
+
+		GDScriptFunction *func = _get_function(p_class);
+		if (p_class->member_functions.has(func->name)) {
+			memdelete(p_class->member_functions[func->name]);
+		}
+		p_class->member_functions[func->name] = func;
+	}
+
+	StringName initializer = _get_string();
+	if (initializer != StringName()) {
+		if (!p_class->member_functions.has(initializer)) {
+			failed = true;
+			return;
+		}
+		p_class->initializer = p_class->member_functions[initializer];
+	}
+
+	for (Map<StringName, Ref<GDScript> >::Element *E = p_class->subclasses.front(); E && !failed; E = E->next()) {
+		_get_class(E->get().ptr());
+	}
+
+	p_class->valid = !failed;
+}
+
+/* Interface */
+
+bool GDScriptBytecodeCache::is_cache(const Vector<uint8_t> &p_buffer) {
+
+	return p_buffer.size() >= 4 && memcmp(p_buffer.ptr(), cache_magic, 4) == 0;
+}
+
+Vector<uint8_t> GDScriptBytecodeCache::get_tokens(const Vector<uint8_t> &p_buffer) {
+
+	ERR_FAIL_COND_V(!is_cache(p_buffer), Vector<uint8_t>());
+
+	GDScriptBytecodeCache cache;
+	cache.data = p_buffer;
+	cache.pos = 4;
+	cache._get_32(); // Format version.
+	cache._get_32(); // Build signature.
+
+	uint32_t size = cache._get_32();
+	ERR_FAIL_COND_V(cache.failed || size > uint32_t(p_buffer.size() - cache.pos), Vector<uint8_t>());
+	return p_buffer.subarray(cache.pos, cache.pos + size - 1);
+}
+
+Vector<uint8_t> GDScriptBytecodeCache::save(const String &p_path, const String &p_source, const Vector<uint8_t> &p_tokens, bool p_debug) {
+
+	ERR_FAIL_COND_V(p_tokens.empty(), Vector<uint8_t>());
+
+	// A separate copy, the one loaded in the editor is compiled for the
+	// editor's own build.
+	Ref<GDScript> script;
+	script.instance();
+	script->set_script_path(p_path);
+	script->set_source_code(p_source);
+	if (script->_reload(false, p_debug) != OK) {
+		return Vector<uint8_t>();
+	}
+
+	GDScriptBytecodeCache cache;
+	cache.root = script.ptr();
+
+	const Map<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+	cache.global_names.resize(GDScriptLanguage::get_singleton()->get_global_array_size());
+	for (const Map<StringName, int>::Element *E = global_map.front(); E; E = E->next()) {
+		cache.global_names.write[E->get()] = E->key();
+	}
+
+	cache._put_buffer(cache_magic, 4);
+	cache._put_32(FORMAT_VERSION);
+	cache._put_32(_get_build_signature(p_debug));
+	cache._put_32(p_tokens.size());
+	cache._put_buffer(p_tokens.ptr(), p_tokens.size());
+
+	cache._put_class_tree(cache.root);
+	cache._put_class(cache.root);
+
+	cache._put_32(cache.root->rpc_functions.size());
+	for (int i = 0; i < cache.root->rpc_functions.size(); i++) {
+		cache._put_string(cache.root->rpc_functions[i].name);
+		cache._put_32(cache.root->rpc_functions[i].mode);
+	}
+
+	cache._put_32(cache.root->rpc_variables.size());
+	for (int i = 0; i < cache.root->rpc_variables.size(); i++) {
+		cache._put_string(cache.root->rpc_variables[i].name);
+		cache._put_32(cache.root->rpc_variables[i].mode);
+	}
+
+	if (cache.failed) {
+		return Vector<uint8_t>();
+	}
+
+	return cache.data;
+}
+
+Error GDScriptBytecodeCache::load(const Vector<uint8_t> &p_buffer, GDScript *p_script) {
+
+	ERR_FAIL_COND_V(!is_cache(p_buffer), ERR_FILE_UNRECOGNIZED);
+
+	GDScriptBytecodeCache cache;
+	cache.root = p_script;
+	cache.data = p_buffer;
+	cache.pos = 4;
+
+#ifdef DEBUG_ENABLED
+	const bool debug = true;
+#else
+	const bool debug = false;
+#endif
+	if (cache._get_32() != FORMAT_VERSION || cache._get_32() != _get_build_signature(debug)) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	uint32_t token_size = cache._get_32();
+	ERR_FAIL_COND_V(cache.failed || token_size > uint32_t(p_buffer.size() - cache.pos), ERR_FILE_CORRUPT);
+	cache.pos += token_size;
+
+	// Same naming as GDScriptCompiler::compile().
+	p_script->fully_qualified_name = p_script->path;
+	p_script->_owner = NULL;
+
+	cache._get_class_tree(p_script);
+	if (!cache.failed) {
+		cache._get_class(p_script);
+	}
+
+	uint32_t rpc_function_count = cache._get_32();
+	for (uint32_t i = 0; i < rpc_function_count && !cache.failed; i++) {
+		ScriptNetData nd;
+		nd.name = cache._get_string();
+		nd.mode = MultiplayerAPI::RPCMode(cache._get_32());
+		p_script->rpc_functions.push_back(nd);
+	}
+
+	uint32_t rpc_variable_count = cache._get_32();
+	for (uint32_t i = 0; i < rpc_variable_count && !cache.failed; i++) {
+		ScriptNetData nd;
+		nd.name = cache._get_string();
+		nd.mode = MultiplayerAPI::RPCMode(cache._get_32());
+		p_script->rpc_variables.push_back(nd);
+	}
+
+	if (cache.failed) {
+		// Leave the script as it was, it is compiled from the tokens next.
+		for (Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+			memdelete(E->get());
+		}
+		p_script->member_functions.clear();
+		p_script->initializer = NULL;
+		p_script->subclasses.clear();
+		p_script->native = Ref<GDScriptNativeClass>();
+		p_script->base = Ref<GDScript>();
+		p_script->_base = NULL;
+		p_script->members.clear();
+		p_script->member_indices.clear();
+		p_script->member_info.clear();
+		p_script->constants.clear();
+		p_script->_signals.clear();
+		p_script->rpc_functions.clear();
+		p_script->rpc_variables.clear();
+		p_script->valid = false;
+		return ERR_FILE_CORRUPT;
+	}
+
+	return OK;
+}
+
+GDScriptBytecodeCache::GDScriptBytecodeCache() :
+		root(NULL),
+		pos(0),
+		failed(false) {
+}
@@ -0,0 +1,108 @@
+/*************************************************************************/
+/*  gdscript_bytecode_cache.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_BYTECODE_CACHE_H
+#define GDSCRIPT_BYTECODE_CACHE_H
+
+#include "gdscript.h"
+
+// Serialized form of a compiled script: its functions, constants and member
+// tables, so exported scripts can skip the parser and compiler at load time.
+// The tokens are stored too and are used instead when the cache was written
+// by a different build, or when anything it references can't be resolved.
+class GDScriptBytecodeCache {
+
+	enum {
+		FORMAT_VERSION = 1,
+	};
+
+	enum VariantTag {
+		VARIANT_VALUE,
+		VARIANT_NULL_OBJECT,
+		VARIANT_SCRIPT,
+		VARIANT_NATIVE_CLASS,
+		VARIANT_RESOURCE,
+		VARIANT_ARRAY,
+		VARIANT_DICTIONARY,
+	};
+
+	enum ScriptTag {
+		SCRIPT_NONE,
+		SCRIPT_LOCAL, // A class of the script being loaded.
+		SCRIPT_EXTERNAL,
+	};
+
+	GDScript *root;
+	Vector<uint8_t> data;
+	int pos;
+	bool failed;
+
+	Vector<StringName> global_names; // Global array index to name, when saving.
+
+	static uint32_t _get_build_signature(bool p_debug);
+	static bool _get_address_operands(const Vector<int> &p_code, Vector<int> &r_addresses);
+
+	void _put_8(uint8_t p_value);
+	void _put_32(uint32_t p_value);
+	void _put_string(const String &p_string);
+	void _put_buffer(const uint8_t *p_buffer, int p_size);
+	void _put_variant(const Variant &p_value);
+	void _put_script(const Ref<Script> &p_script);
+	void _put_data_type(const GDScriptDataType &p_type);
+	void _put_property(const PropertyInfo &p_property);
+	void _put_function(const GDScriptFunction *p_function);
+	void _put_class_tree(const GDScript *p_class);
+	void _put_class(const GDScript *p_class);
+
+	uint8_t _get_8();
+	uint32_t _get_32();
+	String _get_string();
+	Variant _get_variant();
+	Ref<Script> _get_script();
+	GDScriptDataType _get_data_type();
+	PropertyInfo _get_property();
+	GDScriptFunction *_get_function(GDScript *p_class);
+	void _get_class_tree(GDScript *p_class);
+	void _get_class(GDScript *p_class);
+
+	GDScriptBytecodeCache();
+
+public:
+	static bool is_cache(const Vector<uint8_t> &p_buffer);
+	static Vector<uint8_t> get_tokens(const Vector<uint8_t> &p_buffer);
+
+	// Compiles the script as a debug or release build runs it (with or without
+	// line, assert and breakpoint opcodes). Returns an empty buffer if it
+	// doesn't compile or holds values that can't be saved.
+	static Vector<uint8_t> save(const String &p_path, const String &p_source, const Vector<uint8_t> &p_tokens, bool p_debug);
+	static Error load(const Vector<uint8_t> &p_buffer, GDScript *p_script);
+};
+
+#endif // GDSCRIPT_BYTECODE_CACHE_H
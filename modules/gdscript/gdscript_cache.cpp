@@ -0,0 +1,139 @@
+/*************************************************************************/
+/*  gdscript_cache.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_cache.h"
+
+#include "core/io/resource_loader.h"
+#include "core/project_settings.h"
+
+GDScriptCache *GDScriptCache::singleton = NULL;
+
+bool GDScriptCache::_is_cyclic(const String &p_path, Thread::ID p_thread) const {
+
+	// Follow the path to the thread compiling it, then to the path that
+	// thread waits for, and so on. Each thread waits for one path at most:
+	// the chain passes through every waiting thread at most once, and one
+	// more step reaches either p_thread or a thread that isn't waiting.
+	String path = p_path;
+	for (uint32_t i = 0; i <= waiting.size(); i++) {
+		const Thread::ID *owner = loading.getptr(path);
+		if (!owner) {
+			return false; // Not being compiled, or not a script.
+		}
+		if (*owner == p_thread) {
+			return true;
+		}
+		const String *next = waiting.getptr(*owner);
+		if (!next || *next == path) {
+			return false; // Not blocked, or compiling the dependency itself.
+		}
+		path = *next;
+	}
+
+	return false;
+}
+
+void GDScriptCache::load_started(const String &p_path) {
+
+	if (!singleton) {
+		return;
+	}
+
+	MutexLock lock(singleton->mutex);
+	singleton->loading[p_path] = Thread::get_caller_id();
+}
+
+void GDScriptCache::load_finished(const String &p_path) {
+
+	if (!singleton) {
+		return;
+	}
+
+	MutexLock lock(singleton->mutex);
+	const Thread::ID *owner = singleton->loading.getptr(p_path);
+	if (owner && *owner == Thread::get_caller_id()) {
+		singleton->loading.erase(p_path);
+	}
+}
+
+RES GDScriptCache::load_dependency(const String &p_path, Error *r_error) {
+
+	if (!singleton) {
+		return ResourceLoader::load(p_path, "", false, r_error);
+	}
+
+	String path = ProjectSettings::get_singleton()->localize_path(p_path);
+	Thread::ID thread = Thread::get_caller_id();
+	String previous;
+	bool nested = false;
+
+	{
+		MutexLock lock(singleton->mutex);
+
+		if (singleton->_is_cyclic(path, thread)) {
+			if (r_error) {
+				*r_error = ERR_CYCLIC_LINK;
+			}
+			return RES();
+		}
+
+		// A dependency loaded while compiling a dependency.
+		const String *current = singleton->waiting.getptr(thread);
+		if (current) {
+			previous = *current;
+			nested = true;
+		}
+		singleton->waiting[thread] = path;
+	}
+
+	RES res = ResourceLoader::load(path, "", false, r_error);
+
+	{
+		MutexLock lock(singleton->mutex);
+
+		if (nested) {
+			singleton->waiting[thread] = previous;
+		} else {
+			singleton->waiting.erase(thread);
+		}
+	}
+
+	return res;
+}
+
+GDScriptCache::GDScriptCache() {
+
+	singleton = this;
+}
+
+GDScriptCache::~GDScriptCache() {
+
+	singleton = NULL;
+}
@@ -0,0 +1,66 @@
+/*************************************************************************/
+/*  gdscript_cache.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_CACHE_H
+#define GDSCRIPT_CACHE_H
+
+#include "core/hash_map.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/resource.h"
+
+// Keeps track of the scripts being compiled on each thread, so scripts can be
+// loaded from several threads at once (ResourceLoader::load_threaded_request,
+// or sub-resources loaded in parallel) without deadlocking on each other.
+// A script waiting for a dependency that is, directly or through other
+// threads, waiting for it gets an error, like a cyclic preload on a single
+// thread does, instead of blocking forever.
+class GDScriptCache {
+
+	static GDScriptCache *singleton;
+
+	Mutex mutex;
+	HashMap<String, Thread::ID> loading; // Script path, thread compiling it.
+	HashMap<Thread::ID, String> waiting; // Thread, path of the dependency it is loading.
+
+	bool _is_cyclic(const String &p_path, Thread::ID p_thread) const;
+
+public:
+	static void load_started(const String &p_path);
+	static void load_finished(const String &p_path);
+
+	// Same as ResourceLoader::load(), for resources a script depends on.
+	static RES load_dependency(const String &p_path, Error *r_error = NULL);
+
+	GDScriptCache();
+	~GDScriptCache();
+};
+
+#endif // GDSCRIPT_CACHE_H
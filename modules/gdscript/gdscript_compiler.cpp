@@ -74,6 +74,170 @@ void GDScriptCompiler::_set_error(const String &p_error, const GDScriptParser::N
 	}
 }
 
+GDScriptFunction::Opcode GDScriptCompiler::_get_operator_opcode(Variant::Operator p_op, const GDScriptParser::DataType &p_a, const GDScriptParser::DataType &p_b) const {
+
+	// Typed opcodes only cover operands of the same builtin type. They check
+	// the types again at runtime, so a wrong guess only costs the fast path.
+	if (!p_a.has_type || !p_b.has_type || p_a.kind != GDScriptParser::DataType::BUILTIN || p_b.kind != GDScriptParser::DataType::BUILTIN || p_a.builtin_type != p_b.builtin_type) {
+		return GDScriptFunction::OPCODE_OPERATOR;
+	}
+
+	switch (p_op) {
+		case Variant::OP_EQUAL:
+		case Variant::OP_NOT_EQUAL:
+		case Variant::OP_ADD:
+		case Variant::OP_SUBTRACT:
+		case Variant::OP_MULTIPLY:
+		case Variant::OP_NEGATE:
+		case Variant::OP_POSITIVE: {
+			switch (p_a.builtin_type) {
+				case Variant::INT: return GDScriptFunction::OPCODE_OPERATOR_INT;
+				case Variant::FLOAT: return GDScriptFunction::OPCODE_OPERATOR_FLOAT;
+				case Variant::VECTOR2: return GDScriptFunction::OPCODE_OPERATOR_VECTOR2;
+				case Variant::VECTOR3: return GDScriptFunction::OPCODE_OPERATOR_VECTOR3;
+				default: break;
+			}
+		} break;
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL:
+		case Variant::OP_DIVIDE: {
+			switch (p_a.builtin_type) {
+				case Variant::INT: return GDScriptFunction::OPCODE_OPERATOR_INT;
+				case Variant::FLOAT: return GDScriptFunction::OPCODE_OPERATOR_FLOAT;
+				default: break;
+			}
+		} break;
+		case Variant::OP_MODULE:
+		case Variant::OP_BIT_AND:
+		case Variant::OP_BIT_OR:
+		case Variant::OP_BIT_XOR:
+		case Variant::OP_BIT_NEGATE: {
+			if (p_a.builtin_type == Variant::INT) {
+				return GDScriptFunction::OPCODE_OPERATOR_INT;
+			}
+		} break;
+		default: break;
+	}
+
+	return GDScriptFunction::OPCODE_OPERATOR;
+}
+
+GDScriptFunction::Opcode GDScriptCompiler::_get_call_opcode(CodeGen &codegen, const GDScriptParser::OperatorNode *p_call, bool p_root) const {
+
+	GDScriptFunction::Opcode generic = p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN;
+
+#ifdef PTRCALL_ENABLED
+	// Ptrcall is only emitted when the native method and the argument types
+	// are known here. The call site checks the receiver and the argument
+	// types again, and falls back to a regular call when they differ.
+	StringName native;
+	const GDScriptParser::Node *base = p_call->arguments[0];
+
+	if (base->type == GDScriptParser::Node::TYPE_SELF) {
+		for (GDScript *scr = codegen.script; scr; scr = scr->_base) {
+			if (scr->native.is_valid()) {
+				native = scr->native->get_name();
+			}
+		}
+	} else {
+		GDScriptParser::DataType base_type = base->get_datatype();
+		while (base_type.has_type && base_type.kind == GDScriptParser::DataType::CLASS && base_type.class_type) {
+			base_type = base_type.class_type->base_type;
+		}
+		if (!base_type.has_type || base_type.is_meta_type) {
+			return generic;
+		}
+		switch (base_type.kind) {
+			case GDScriptParser::DataType::NATIVE: {
+				native = base_type.native_type;
+			} break;
+			case GDScriptParser::DataType::GDSCRIPT:
+			case GDScriptParser::DataType::SCRIPT: {
+				if (base_type.script_type.is_valid()) {
+					native = base_type.script_type->get_instance_base_type();
+				}
+			} break;
+			default: break;
+		}
+	}
+
+	if (native == StringName()) {
+		return generic;
+	}
+
+	const StringName &name = static_cast<const GDScriptParser::IdentifierNode *>(p_call->arguments[1])->name;
+	MethodBind *method = ClassDB::get_method(native, name);
+	int argc = p_call->arguments.size() - 2;
+
+	if (!method || method->is_vararg() || method->get_argument_count() != argc) {
+		return generic;
+	}
+	if (method->has_return() && method->get_argument_type(-1) == Variant::OBJECT) {
+		return generic;
+	}
+
+	for (int i = 0; i < argc; i++) {
+		Variant::Type type = method->get_argument_type(i);
+		if (type == Variant::NIL) {
+			continue; // Takes a Variant.
+		}
+		GDScriptParser::DataType arg_type = p_call->arguments[i + 2]->get_datatype();
+		if (type == Variant::OBJECT || !arg_type.has_type || arg_type.kind != GDScriptParser::DataType::BUILTIN || arg_type.builtin_type != type) {
+			return generic;
+		}
+	}
+
+	return p_root ? GDScriptFunction::OPCODE_CALL_PTRCALL : GDScriptFunction::OPCODE_CALL_PTRCALL_RETURN;
+#else
+	return generic;
+#endif
+}
+
+bool GDScriptCompiler::_is_operator_result(const GDScriptParser::OperatorNode *p_assign, int p_address, int p_stack_level) const {
+
+	// True when the right side of the assignment was just compiled to an
+	// operator opcode, whose destination is the last word emitted.
+	if (p_address != (p_stack_level | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS))) {
+		return false;
+	}
+
+	if (p_assign->op != GDScriptParser::OperatorNode::OP_ASSIGN && p_assign->op != GDScriptParser::OperatorNode::OP_INIT_ASSIGN) {
+		return true; // Compound assignments always use an operator.
+	}
+	if (p_assign->arguments[1]->type != GDScriptParser::Node::TYPE_OPERATOR) {
+		return false;
+	}
+
+	switch (static_cast<const GDScriptParser::OperatorNode *>(p_assign->arguments[1])->op) {
+		case GDScriptParser::OperatorNode::OP_NEG:
+		case GDScriptParser::OperatorNode::OP_POS:
+		case GDScriptParser::OperatorNode::OP_NOT:
+		case GDScriptParser::OperatorNode::OP_BIT_INVERT:
+		case GDScriptParser::OperatorNode::OP_IN:
+		case GDScriptParser::OperatorNode::OP_EQUAL:
+		case GDScriptParser::OperatorNode::OP_NOT_EQUAL:
+		case GDScriptParser::OperatorNode::OP_LESS:
+		case GDScriptParser::OperatorNode::OP_LESS_EQUAL:
+		case GDScriptParser::OperatorNode::OP_GREATER:
+		case GDScriptParser::OperatorNode::OP_GREATER_EQUAL:
+		case GDScriptParser::OperatorNode::OP_ADD:
+		case GDScriptParser::OperatorNode::OP_SUB:
+		case GDScriptParser::OperatorNode::OP_MUL:
+		case GDScriptParser::OperatorNode::OP_DIV:
+		case GDScriptParser::OperatorNode::OP_MOD:
+		case GDScriptParser::OperatorNode::OP_SHIFT_LEFT:
+		case GDScriptParser::OperatorNode::OP_SHIFT_RIGHT:
+		case GDScriptParser::OperatorNode::OP_BIT_AND:
+		case GDScriptParser::OperatorNode::OP_BIT_OR:
+		case GDScriptParser::OperatorNode::OP_BIT_XOR:
+			return true;
+		default:
+			return false;
+	}
+}
+
 bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level) {
 
 	ERR_FAIL_COND_V(on->arguments.size() != 1, false);
@@ -82,7 +246,8 @@ bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptPa
 	if (src_address_a < 0)
 		return false;
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	GDScriptParser::DataType type = on->arguments[0]->get_datatype();
+	codegen.opcodes.push_back(_get_operator_opcode(op, type, type)); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_a); // argument 2 (repeated)
@@ -104,7 +269,7 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 	if (src_address_b < 0)
 		return false;
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	codegen.opcodes.push_back(_get_operator_opcode(op, on->arguments[0]->get_datatype(), on->arguments[1]->get_datatype())); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
@@ -325,7 +490,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 					return -1;
 				}
 
-				RES res = ResourceLoader::load(ScriptServer::get_global_class_path(identifier));
+				RES res = GDScriptCache::load_dependency(ScriptServer::get_global_class_path(identifier));
 				if (res.is_null()) {
 					_set_error("Can't load global class " + String(identifier) + ", cyclic reference?", p_expression);
 					return -1;
@@ -656,11 +821,15 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							arguments.push_back(ret);
 						}
 
-						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+						codegen.opcodes.push_back(_get_call_opcode(codegen, on, p_root)); // perform operator
 						codegen.opcodes.push_back(on->arguments.size() - 2);
 						codegen.alloc_call(on->arguments.size() - 2);
-						for (int i = 0; i < arguments.size(); i++)
+						for (int i = 0; i < arguments.size(); i++) {
 							codegen.opcodes.push_back(arguments[i]);
+							if (i == 1) {
+								codegen.opcodes.push_back(codegen.alloc_inline_cache()); // inline cache, after the method name
+							}
+						}
 					}
 				} break;
 				case GDScriptParser::OperatorNode::OP_YIELD: {
@@ -752,6 +921,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 					codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
 					codegen.opcodes.push_back(from); // argument 1
 					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
+					if (named) {
+						codegen.opcodes.push_back(codegen.alloc_inline_cache());
+					}
 
 				} break;
 				case GDScriptParser::OperatorNode::OP_AND: {
@@ -1054,6 +1226,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET);
 							codegen.opcodes.push_back(prev_pos);
 							codegen.opcodes.push_back(key_idx);
+							if (named) {
+								codegen.opcodes.push_back(codegen.alloc_inline_cache());
+							}
 							slevel++;
 							codegen.alloc_stack(slevel);
 							int dst_pos = (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) | slevel;
@@ -1063,6 +1238,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							//add in reverse order, since it will be reverted
 
 							setchain.push_back(dst_pos);
+							if (named) {
+								setchain.push_back(codegen.alloc_inline_cache());
+							}
 							setchain.push_back(key_idx);
 							setchain.push_back(prev_pos);
 							setchain.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
@@ -1100,6 +1278,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
 						codegen.opcodes.push_back(prev_pos);
 						codegen.opcodes.push_back(set_index);
+						if (named) {
+							codegen.opcodes.push_back(codegen.alloc_inline_cache());
+						}
 						codegen.opcodes.push_back(set_value);
 
 						for (int i = 0; i < setchain.size(); i++) {
@@ -1191,6 +1372,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 									codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
 								}
 							}
+						} else if (_is_operator_result(on, src_address_b, slevel) && (dst_address_a >> GDScriptFunction::ADDR_BITS) == GDScriptFunction::ADDR_TYPE_STACK_VARIABLE) {
+							// Have the operator write to the local instead of going through a temporary.
+							codegen.opcodes.write[codegen.opcodes.size() - 1] = dst_address_a;
 						} else {
 							// Either untyped assignment or already type-checked by the parser
 							codegen.opcodes.push_back(GDScriptFunction::OPCODE_ASSIGN); // perform operator
@@ -1275,8 +1459,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 			case GDScriptParser::Node::TYPE_NEWLINE: {
 #ifdef DEBUG_ENABLED
 				const GDScriptParser::NewLineNode *nl = static_cast<const GDScriptParser::NewLineNode *>(s);
-				codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
-				codegen.opcodes.push_back(nl->line);
+				if (debug_opcodes) {
+					codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
+					codegen.opcodes.push_back(nl->line);
+				}
 				codegen.current_line = nl->line;
 #endif
 			} break;
@@ -1408,13 +1594,25 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						if (ret2 < 0)
 							return ERR_COMPILATION_FAILED;
 
+						// range(n) is turned into int(n) by the parser, iterate it without going through Variant.
+						bool int_container = false;
+						GDScriptParser::DataType container_type = cf->arguments[1]->get_datatype();
+						if (container_type.has_type && container_type.kind == GDScriptParser::DataType::BUILTIN && container_type.builtin_type == Variant::INT) {
+							int_container = true;
+						} else if (cf->arguments[1]->type == GDScriptParser::Node::TYPE_OPERATOR) {
+							const GDScriptParser::OperatorNode *con = static_cast<const GDScriptParser::OperatorNode *>(cf->arguments[1]);
+							if (con->op == GDScriptParser::OperatorNode::OP_CALL && con->arguments[0]->type == GDScriptParser::Node::TYPE_TYPE) {
+								int_container = static_cast<const GDScriptParser::TypeNode *>(con->arguments[0])->vtype == Variant::INT;
+							}
+						}
+
 						//assign container
 						codegen.opcodes.push_back(GDScriptFunction::OPCODE_ASSIGN);
 						codegen.opcodes.push_back(container_pos);
 						codegen.opcodes.push_back(ret2);
 
 						//begin loop
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_ITERATE_BEGIN);
+						codegen.opcodes.push_back(int_container ? GDScriptFunction::OPCODE_ITERATE_BEGIN_INT : GDScriptFunction::OPCODE_ITERATE_BEGIN);
 						codegen.opcodes.push_back(counter_pos);
 						codegen.opcodes.push_back(container_pos);
 						codegen.opcodes.push_back(codegen.opcodes.size() + 4);
@@ -1427,7 +1625,7 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						codegen.opcodes.push_back(0); //skip code for next
 						//next loop
 						int continue_pos = codegen.opcodes.size();
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_ITERATE);
+						codegen.opcodes.push_back(int_container ? GDScriptFunction::OPCODE_ITERATE_INT : GDScriptFunction::OPCODE_ITERATE);
 						codegen.opcodes.push_back(counter_pos);
 						codegen.opcodes.push_back(container_pos);
 						codegen.opcodes.push_back(break_pos);
@@ -1512,8 +1710,18 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 					} break;
 				}
 			} break;
+			case GDScriptParser::Node::TYPE_BLOCK: {
+				// Left by the optimizer in place of a branch with a constant condition.
+				Error err = _parse_block(codegen, static_cast<const GDScriptParser::BlockNode *>(s), p_stack_level, p_break_addr, p_continue_addr);
+				if (err)
+					return err;
+			} break;
 			case GDScriptParser::Node::TYPE_ASSERT: {
 #ifdef DEBUG_ENABLED
+				if (!debug_opcodes) {
+					break;
+				}
+
 				// try subblocks
 
 				const GDScriptParser::AssertNode *as = static_cast<const GDScriptParser::AssertNode *>(s);
@@ -1537,7 +1745,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 			case GDScriptParser::Node::TYPE_BREAKPOINT: {
 #ifdef DEBUG_ENABLED
 				// try subblocks
-				codegen.opcodes.push_back(GDScriptFunction::OPCODE_BREAKPOINT);
+				if (debug_opcodes) {
+					codegen.opcodes.push_back(GDScriptFunction::OPCODE_BREAKPOINT);
+				}
 #endif
 			} break;
 			case GDScriptParser::Node::TYPE_LOCAL_VAR: {
@@ -1579,6 +1789,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.inline_cache_count = 0;
 	codegen.debug_stack = ScriptDebugger::get_singleton() != NULL;
 	Vector<StringName> argnames;
 
@@ -1763,6 +1974,10 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	gdfunc->_argument_count = p_func ? p_func->arguments.size() : 0;
 	gdfunc->_stack_size = codegen.stack_max;
 	gdfunc->_call_size = codegen.call_max;
+	if (codegen.inline_cache_count) {
+		gdfunc->_inline_cache_count = codegen.inline_cache_count;
+		gdfunc->_inline_caches = memnew_arr(GDScriptFunction::InlineCache, codegen.inline_cache_count);
+	}
 	gdfunc->name = func_name;
 #ifdef DEBUG_ENABLED
 	if (ScriptDebugger::get_singleton()) {
@@ -1836,6 +2051,9 @@ Error GDScriptCompiler::_parse_class_level(GDScript *p_script, const GDScriptPar
 		}
 	}
 
+	// Functions and member indices are about to be replaced, cached call sites must not see them.
+	GDScriptLanguage::get_singleton()->invalidate_inline_caches();
+
 	p_script->native = Ref<GDScriptNativeClass>();
 	p_script->base = Ref<GDScript>();
 	p_script->_base = NULL;
@@ -2190,4 +2408,6 @@ int GDScriptCompiler::get_error_column() const {
 }
 
 GDScriptCompiler::GDScriptCompiler() {
+
+	debug_opcodes = true;
 }
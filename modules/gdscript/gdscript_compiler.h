@@ -128,10 +128,14 @@ class GDScriptCompiler {
 		void alloc_call(int p_params) {
 			if (p_params >= call_max) call_max = p_params;
 		}
+		int alloc_inline_cache() {
+			return inline_cache_count++;
+		}
 
 		int current_line;
 		int stack_max;
 		int call_max;
+		int inline_cache_count;
 	};
 
 	bool _is_class_member_property(CodeGen &codegen, const StringName &p_name);
@@ -139,6 +143,9 @@ class GDScriptCompiler {
 
 	void _set_error(const String &p_error, const GDScriptParser::Node *p_node);
 
+	GDScriptFunction::Opcode _get_operator_opcode(Variant::Operator p_op, const GDScriptParser::DataType &p_a, const GDScriptParser::DataType &p_b) const;
+	GDScriptFunction::Opcode _get_call_opcode(CodeGen &codegen, const GDScriptParser::OperatorNode *p_call, bool p_root) const;
+	bool _is_operator_result(const GDScriptParser::OperatorNode *p_assign, int p_address, int p_stack_level) const;
 	bool _create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level);
 	bool _create_binary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false, int p_index_addr = 0);
 
@@ -155,8 +162,10 @@ class GDScriptCompiler {
 	int err_column;
 	StringName source;
 	String error;
+	bool debug_opcodes; // Line, assert and breakpoint opcodes, only emitted in debug builds.
 
 public:
+	void set_debug_opcodes(bool p_enabled) { debug_opcodes = p_enabled; }
 	Error compile(const GDScriptParser *p_parser, GDScript *p_script, bool p_keep_state = false);
 
 	String get_error() const;
@@ -30,6 +30,7 @@
 
 #include "gdscript_function.h"
 
+#include "core/core_string_names.h"
 #include "core/os/os.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
@@ -131,6 +132,101 @@ Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_insta
 	return NULL;
 }
 
+// Memory for the stacks of the calls running on a thread. Frames are pushed
+// and popped in call order into blocks kept for the next calls, instead of
+// being allocated on the native stack every time. Free memory is kept zeroed,
+// a zeroed Variant is a NIL one, so calls only construct their arguments and
+// leave the other slots as they find them.
+class GDScriptCallStack {
+
+	enum {
+		BLOCK_SIZE = 64 * 1024,
+	};
+
+	struct Block {
+		uint8_t *memory;
+		uint32_t size;
+		uint32_t used;
+		Block *prev;
+		Block *next;
+	};
+
+	Block *current;
+
+	void _next_block(uint32_t p_size) {
+
+		Block *next = current ? current->next : NULL;
+		if (next && next->size < p_size) {
+			// Blocks past the current one are empty, drop the small one.
+			current->next = next->next;
+			if (next->next) {
+				next->next->prev = current;
+			}
+			memfree(next->memory);
+			memdelete(next);
+			next = NULL;
+		}
+
+		if (!next) {
+			next = memnew(Block);
+			next->size = MAX((uint32_t)BLOCK_SIZE, p_size);
+			next->memory = (uint8_t *)memalloc(next->size);
+			zeromem(next->memory, next->size);
+			next->used = 0;
+			next->prev = current;
+			next->next = current ? current->next : NULL;
+			if (next->next) {
+				next->next->prev = next;
+			}
+			if (current) {
+				current->next = next;
+			}
+		}
+
+		current = next;
+	}
+
+public:
+	_FORCE_INLINE_ uint8_t *push(uint32_t p_size) {
+
+		if (unlikely(!current || current->used + p_size > current->size)) {
+			_next_block(p_size);
+		}
+		uint8_t *frame = current->memory + current->used;
+		current->used += p_size;
+		return frame;
+	}
+
+	// The frame must be zeroed again, or hold only NIL variants.
+	_FORCE_INLINE_ void pop(uint32_t p_size) {
+
+		current->used -= p_size;
+		if (current->used == 0 && current->prev) {
+			current = current->prev;
+		}
+	}
+
+	GDScriptCallStack() {
+		current = NULL;
+	}
+
+	~GDScriptCallStack() {
+
+		Block *block = current;
+		while (block && block->prev) {
+			block = block->prev;
+		}
+		while (block) {
+			Block *next = block->next;
+			memfree(block->memory);
+			memdelete(block);
+			block = next;
+		}
+	}
+};
+
+static thread_local GDScriptCallStack thread_call_stack;
+
 #ifdef DEBUG_ENABLED
 static String _get_var_type(const Variant *p_var) {
 
@@ -190,10 +286,402 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	return err_text;
 }
 
+void GDScriptFunction::InlineCache::insert(const Entry &p_entry, uint32_t p_generation) {
+
+	uint32_t v = version.load(std::memory_order_relaxed);
+	if ((v & 1) || !version.compare_exchange_strong(v, v + 1, std::memory_order_acquire)) {
+		return; // Another thread is filling this call site, it can be cached next time.
+	}
+	// Readers that see any of the stores below must also see the odd version.
+	std::atomic_thread_fence(std::memory_order_release);
+
+	int count = entry_count.load(std::memory_order_relaxed);
+	if (generation.load(std::memory_order_relaxed) != p_generation) {
+		count = 0;
+		generation.store(p_generation, std::memory_order_relaxed);
+	}
+
+	bool exists = false;
+	for (int i = 0; i < count; i++) {
+		if (slots[i].class_key.load(std::memory_order_relaxed) == p_entry.class_key && slots[i].script.load(std::memory_order_relaxed) == p_entry.script) {
+			exists = true;
+			break;
+		}
+	}
+
+	// Once full, the call site is megamorphic and further receivers use the regular lookup.
+	if (!exists && count < MAX_ENTRIES) {
+		Slot &slot = slots[count++];
+		slot.class_key.store(p_entry.class_key, std::memory_order_relaxed);
+		slot.script.store(p_entry.script, std::memory_order_relaxed);
+		slot.kind.store(p_entry.kind, std::memory_order_relaxed);
+		slot.function.store(p_entry.function, std::memory_order_relaxed);
+		slot.method.store(p_entry.method, std::memory_order_relaxed);
+		slot.member_type.store(p_entry.member_type, std::memory_order_relaxed);
+		slot.index.store(p_entry.index, std::memory_order_relaxed);
+	}
+	entry_count.store(count, std::memory_order_relaxed);
+
+	version.store(v + 2, std::memory_order_release);
+}
+
+GDScriptFunction::InlineCache *GDScriptFunction::_get_inline_cache(int p_index) const {
+
+#ifdef DEBUG_ENABLED
+	ERR_FAIL_INDEX_V(p_index, _inline_cache_count, NULL);
+#endif
+	return &_inline_caches[p_index];
+}
+
+// Resolves the object behind a receiver, only when the regular lookup for it can be cached:
+// no script, or a (non placeholder) GDScript instance.
+static _FORCE_INLINE_ bool _get_inline_cache_receiver(const Variant *p_base, Object *&r_object, GDScriptInstance *&r_instance) {
+
+	if (p_base->get_type() != Variant::OBJECT) {
+		return false;
+	}
+
+#ifdef DEBUG_ENABLED
+	Object *obj = p_base->get_validated_object();
+#else
+	Object *obj = p_base->operator Object *();
+#endif
+	if (!obj) {
+		return false; // Let the regular path report it.
+	}
+
+	ScriptInstance *si = obj->get_script_instance();
+	if (si && (si->get_language() != GDScriptLanguage::get_singleton() || si->is_placeholder())) {
+		return false;
+	}
+
+	r_object = obj;
+	r_instance = static_cast<GDScriptInstance *>(si);
+	return true;
+}
+
+MethodBind *GDScriptFunction::_get_cached_native_method(InlineCache *p_cache, const Variant *p_base, Object *&r_object) const {
+
+	GDScriptInstance *instance;
+	if (!p_cache || !_get_inline_cache_receiver(p_base, r_object, instance)) {
+		return NULL;
+	}
+
+	InlineCache::Entry entry;
+	if (!p_cache->lookup(r_object->get_class_name().data_unique_pointer(), instance ? instance->script.ptr() : NULL, GDScriptLanguage::get_singleton()->get_inline_cache_generation(), entry)) {
+		return NULL;
+	}
+
+	return entry.kind == InlineCache::KIND_NATIVE_METHOD ? entry.method : NULL;
+}
+
+#ifdef PTRCALL_ENABLED
+
+// Calls p_method with unboxed arguments and stores the return value in r_ret (if not NULL).
+// Returns false without calling when the return value can't be read back from a ptrcall.
+static _FORCE_INLINE_ bool _ptrcall_method(MethodBind *p_method, Object *p_object, const void **p_args, Variant *r_ret) {
+
+	if (!p_method->has_return()) {
+		p_method->ptrcall(p_object, p_args, NULL);
+		if (r_ret) {
+			*r_ret = Variant();
+		}
+		return true;
+	}
+
+#define PTRCALL_RETURN(m_type)                           \
+	{                                                    \
+		m_type ret;                                      \
+		p_method->ptrcall(p_object, p_args, &ret);       \
+		if (r_ret) {                                     \
+			*r_ret = ret;                                \
+		}                                                \
+		return true;                                     \
+	}
+
+	if (p_method->has_enum_return()) {
+		PTRCALL_RETURN(int);
+	}
+
+	switch (p_method->get_argument_type(-1)) {
+		case Variant::NIL: PTRCALL_RETURN(Variant); // Returns a Variant.
+		case Variant::BOOL: PTRCALL_RETURN(bool);
+		case Variant::INT: PTRCALL_RETURN(int64_t);
+		case Variant::FLOAT: PTRCALL_RETURN(double);
+		case Variant::STRING: PTRCALL_RETURN(String);
+		case Variant::VECTOR2: PTRCALL_RETURN(Vector2);
+		case Variant::VECTOR2I: PTRCALL_RETURN(Vector2i);
+		case Variant::RECT2: PTRCALL_RETURN(Rect2);
+		case Variant::RECT2I: PTRCALL_RETURN(Rect2i);
+		case Variant::VECTOR3: PTRCALL_RETURN(Vector3);
+		case Variant::VECTOR3I: PTRCALL_RETURN(Vector3i);
+		case Variant::TRANSFORM2D: PTRCALL_RETURN(Transform2D);
+		case Variant::PLANE: PTRCALL_RETURN(Plane);
+		case Variant::QUAT: PTRCALL_RETURN(Quat);
+		case Variant::AABB: PTRCALL_RETURN(AABB);
+		case Variant::BASIS: PTRCALL_RETURN(Basis);
+		case Variant::TRANSFORM: PTRCALL_RETURN(Transform);
+		case Variant::COLOR: PTRCALL_RETURN(Color);
+		case Variant::STRING_NAME: PTRCALL_RETURN(StringName);
+		case Variant::NODE_PATH: PTRCALL_RETURN(NodePath);
+		case Variant::_RID: PTRCALL_RETURN(RID);
+		case Variant::CALLABLE: PTRCALL_RETURN(Callable);
+		case Variant::SIGNAL: PTRCALL_RETURN(Signal);
+		case Variant::DICTIONARY: PTRCALL_RETURN(Dictionary);
+		case Variant::ARRAY: PTRCALL_RETURN(Array);
+		case Variant::PACKED_BYTE_ARRAY: PTRCALL_RETURN(PackedByteArray);
+		case Variant::PACKED_INT32_ARRAY: PTRCALL_RETURN(PackedInt32Array);
+		case Variant::PACKED_INT64_ARRAY: PTRCALL_RETURN(PackedInt64Array);
+		case Variant::PACKED_FLOAT32_ARRAY: PTRCALL_RETURN(PackedFloat32Array);
+		case Variant::PACKED_FLOAT64_ARRAY: PTRCALL_RETURN(PackedFloat64Array);
+		case Variant::PACKED_STRING_ARRAY: PTRCALL_RETURN(PackedStringArray);
+		case Variant::PACKED_VECTOR2_ARRAY: PTRCALL_RETURN(PackedVector2Array);
+		case Variant::PACKED_VECTOR3_ARRAY: PTRCALL_RETURN(PackedVector3Array);
+		case Variant::PACKED_COLOR_ARRAY: PTRCALL_RETURN(PackedColorArray);
+		default: {
+			// Objects are returned either as a raw pointer or as a Ref, which can't be told apart here.
+			return false;
+		}
+	}
+
+#undef PTRCALL_RETURN
+}
+
+#endif // PTRCALL_ENABLED
+
+bool GDScriptFunction::_cached_call(InlineCache *p_cache, const Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Callable::CallError &r_error) const {
+
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!p_cache || !_get_inline_cache_receiver(p_base, obj, instance)) {
+		return false;
+	}
+
+	const void *class_key = obj->get_class_name().data_unique_pointer();
+	const GDScript *script = instance ? instance->script.ptr() : NULL;
+	uint32_t generation = GDScriptLanguage::get_singleton()->get_inline_cache_generation();
+
+	InlineCache::Entry entry;
+	if (p_cache->lookup(class_key, script, generation, entry)) {
+
+		// Same as Object::call() once "free" and script overrides of call() are ruled out.
+#ifdef DEBUG_ENABLED
+		_ObjectDebugLock debug_lock(obj);
+#endif
+		r_error.error = Callable::CallError::CALL_OK;
+		Variant ret;
+		if (entry.kind == InlineCache::KIND_SCRIPT_FUNCTION) {
+			ret = entry.function->call(instance, p_args, p_argcount, r_error);
+		} else {
+			ret = entry.method->call(obj, p_args, p_argcount, r_error);
+		}
+		if (r_ret) {
+			*r_ret = ret;
+		}
+		return true;
+	}
+
+	// Miss, resolve the method the way Object::call() would and remember it.
+	if (p_method == CoreStringNames::get_singleton()->_free) {
+		return false;
+	}
+	if (Object::cast_to<Script>(obj) || Object::cast_to<GDScriptNativeClass>(obj)) {
+		return false; // These override call() to reach static functions first.
+	}
+
+	entry.class_key = class_key;
+	entry.script = script;
+	entry.function = NULL;
+	entry.method = NULL;
+	entry.member_type = NULL;
+	entry.index = -1;
+
+	for (const GDScript *sptr = script; sptr; sptr = sptr->_base) {
+		const Map<StringName, GDScriptFunction *>::Element *E = sptr->member_functions.find(p_method);
+		if (E) {
+			entry.kind = InlineCache::KIND_SCRIPT_FUNCTION;
+			entry.function = E->get();
+			break;
+		}
+	}
+
+	if (!entry.function) {
+		entry.method = ClassDB::get_method(obj->get_class_name(), p_method);
+		if (!entry.method) {
+			return false;
+		}
+		entry.kind = InlineCache::KIND_NATIVE_METHOD;
+	}
+
+	p_cache->insert(entry, generation);
+	return false;
+}
+
+bool GDScriptFunction::_cached_get_named(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret, bool &r_valid) const {
+
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!p_cache || !_get_inline_cache_receiver(p_base, obj, instance)) {
+		return false;
+	}
+
+	const void *class_key = obj->get_class_name().data_unique_pointer();
+	const GDScript *script = instance ? instance->script.ptr() : NULL;
+	uint32_t generation = GDScriptLanguage::get_singleton()->get_inline_cache_generation();
+
+	InlineCache::Entry entry;
+	if (p_cache->lookup(class_key, script, generation, entry)) {
+
+		if (entry.kind == InlineCache::KIND_MEMBER) {
+			r_ret = instance->members[entry.index];
+			r_valid = true;
+		} else {
+			Callable::CallError ce;
+			r_ret = entry.method->call(obj, NULL, 0, ce);
+			r_valid = ce.error == Callable::CallError::CALL_OK;
+		}
+		return true;
+	}
+
+	// Miss, follow Object::get(): script members first, then the ClassDB getter.
+	entry.class_key = class_key;
+	entry.script = script;
+	entry.function = NULL;
+	entry.method = NULL;
+	entry.member_type = NULL;
+	entry.index = -1;
+
+	if (script) {
+		const Map<StringName, GDScript::MemberInfo>::Element *E = script->member_indices.find(p_name);
+		if (E) {
+			if (E->get().getter) {
+				return false;
+			}
+			entry.kind = InlineCache::KIND_MEMBER;
+			entry.index = E->get().index;
+			p_cache->insert(entry, generation);
+			return false;
+		}
+
+		for (const GDScript *sptr = script; sptr; sptr = sptr->_base) {
+			if (sptr->constants.has(p_name) || sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._get)) {
+				return false;
+			}
+		}
+	}
+
+	const StringName &class_name = obj->get_class_name();
+	StringName getter = ClassDB::get_property_getter(class_name, p_name);
+	if (getter == StringName() || ClassDB::get_property_index(class_name, p_name) >= 0) {
+		return false;
+	}
+
+	entry.method = ClassDB::get_method(class_name, getter);
+	if (!entry.method) {
+		return false;
+	}
+	entry.kind = InlineCache::KIND_PROPERTY;
+
+	p_cache->insert(entry, generation);
+	return false;
+}
+
+bool GDScriptFunction::_cached_set_named(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid) const {
+
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!p_cache || !_get_inline_cache_receiver(p_base, obj, instance)) {
+		return false;
+	}
+
+#ifdef TOOLS_ENABLED
+	// Object::set() also flags the object as edited, let it do so the first time.
+	if (!obj->is_edited()) {
+		return false;
+	}
+#endif
+
+	const void *class_key = obj->get_class_name().data_unique_pointer();
+	const GDScript *script = instance ? instance->script.ptr() : NULL;
+	uint32_t generation = GDScriptLanguage::get_singleton()->get_inline_cache_generation();
+
+	InlineCache::Entry entry;
+	if (p_cache->lookup(class_key, script, generation, entry)) {
+
+		if (entry.kind == InlineCache::KIND_MEMBER) {
+			if (!entry.member_type->is_type(p_value)) {
+				return false; // Needs a conversion.
+			}
+			instance->members.write[entry.index] = p_value;
+			r_valid = true;
+		} else {
+			Callable::CallError ce;
+			if (entry.index >= 0) {
+				Variant index = entry.index;
+				const Variant *args[2] = { &index, &p_value };
+				entry.method->call(obj, args, 2, ce);
+			} else {
+				const Variant *args[1] = { &p_value };
+				entry.method->call(obj, args, 1, ce);
+			}
+			r_valid = ce.error == Callable::CallError::CALL_OK;
+		}
+		return true;
+	}
+
+	// Miss, follow Object::set(): script members first, then the ClassDB setter.
+	entry.class_key = class_key;
+	entry.script = script;
+	entry.function = NULL;
+	entry.method = NULL;
+	entry.member_type = NULL;
+	entry.index = -1;
+
+	if (script) {
+		const Map<StringName, GDScript::MemberInfo>::Element *E = script->member_indices.find(p_name);
+		if (E) {
+			if (E->get().setter) {
+				return false;
+			}
+			entry.kind = InlineCache::KIND_MEMBER;
+			entry.index = E->get().index;
+			entry.member_type = &E->get().data_type;
+			p_cache->insert(entry, generation);
+			return false;
+		}
+
+		for (const GDScript *sptr = script; sptr; sptr = sptr->_base) {
+			if (sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._set)) {
+				return false;
+			}
+		}
+	}
+
+	const StringName &class_name = obj->get_class_name();
+	StringName setter = ClassDB::get_property_setter(class_name, p_name);
+	if (setter == StringName()) {
+		return false;
+	}
+
+	entry.method = ClassDB::get_method(class_name, setter);
+	if (!entry.method) {
+		return false;
+	}
+	entry.kind = InlineCache::KIND_PROPERTY;
+	entry.index = ClassDB::get_property_index(class_name, p_name);
+
+	p_cache->insert(entry, generation);
+	return false;
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_INT,                \
+		&&OPCODE_OPERATOR_FLOAT,              \
+		&&OPCODE_OPERATOR_VECTOR2,            \
+		&&OPCODE_OPERATOR_VECTOR3,            \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_IS_BUILTIN,                  \
 		&&OPCODE_SET,                         \
@@ -216,6 +704,8 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 		&&OPCODE_CONSTRUCT_DICTIONARY,        \
 		&&OPCODE_CALL,                        \
 		&&OPCODE_CALL_RETURN,                 \
+		&&OPCODE_CALL_PTRCALL,                \
+		&&OPCODE_CALL_PTRCALL_RETURN,         \
 		&&OPCODE_CALL_BUILT_IN,               \
 		&&OPCODE_CALL_SELF,                   \
 		&&OPCODE_CALL_SELF_BASE,              \
@@ -229,6 +719,8 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 		&&OPCODE_RETURN,                      \
 		&&OPCODE_ITERATE_BEGIN,               \
 		&&OPCODE_ITERATE,                     \
+		&&OPCODE_ITERATE_BEGIN_INT,           \
+		&&OPCODE_ITERATE_INT,                 \
 		&&OPCODE_ASSERT,                      \
 		&&OPCODE_BREAKPOINT,                  \
 		&&OPCODE_LINE,                        \
@@ -242,7 +734,17 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	OPSEXIT:
 #define OPCODES_OUT \
 	OPSOUT:
+#ifdef DEBUG_ENABLED
+#define DISPATCH_OPCODE                        \
+	{                                          \
+		if (profiling_opcodes) {               \
+			opcode_count++;                    \
+		}                                      \
+		goto *switch_table_ops[_code_ptr[ip]]; \
+	}
+#else
 #define DISPATCH_OPCODE goto *switch_table_ops[_code_ptr[ip]]
+#endif
 #define OPCODE_SWITCH(m_test) DISPATCH_OPCODE;
 #define OPCODE_BREAK goto OPSEXIT
 #define OPCODE_OUT goto OPSOUT
@@ -253,7 +755,15 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 #define OPCODES_END
 #define OPCODES_OUT
 #define DISPATCH_OPCODE continue
+#ifdef DEBUG_ENABLED
+#define OPCODE_SWITCH(m_test) \
+	if (profiling_opcodes) {  \
+		opcode_count++;       \
+	}                         \
+	switch (m_test)
+#else
 #define OPCODE_SWITCH(m_test) switch (m_test)
+#endif
 #define OPCODE_BREAK break
 #define OPCODE_OUT break
 #endif
@@ -283,6 +793,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 	uint32_t alloca_size = 0;
+	bool stack_moved = false; // Handed over to a GDScriptFunctionState on yield.
+	GDScriptCallStack *call_stack = NULL; // Set when the frame is on the thread call stack.
 	GDScript *script;
 	int ip = 0;
 	int line = _initial_line;
@@ -325,7 +837,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 		if (alloca_size) {
 
-			uint8_t *aptr = (uint8_t *)alloca(alloca_size);
+			call_stack = &thread_call_stack;
+			uint8_t *aptr = call_stack->push(alloca_size);
 
 			if (_stack_size) {
 
@@ -338,9 +851,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 					if (!argument_types[i].is_type(*p_args[i], true)) {
 						if (argument_types[i].is_type(Variant(), true)) {
-							memnew_placement(&stack[i], Variant);
 							continue;
 						} else {
+							for (int j = 0; j < i; j++) {
+								stack[j].~Variant();
+								memnew_placement(&stack[j], Variant);
+							}
+							call_stack->pop(alloca_size);
+
 							r_err.error = Callable::CallError::CALL_ERROR_INVALID_ARGUMENT;
 							r_err.argument = i;
 							r_err.expected = argument_types[i].kind == GDScriptDataType::BUILTIN ? argument_types[i].builtin_type : Variant::OBJECT;
@@ -354,9 +872,6 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						memnew_placement(&stack[i], Variant(*p_args[i]));
 					}
 				}
-				for (int i = p_argcount; i < _stack_size; i++) {
-					memnew_placement(&stack[i], Variant);
-				}
 			} else {
 				stack = NULL;
 			}
@@ -389,6 +904,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
+	// Resuming from yield pushes the function again, each call pops once.
+	bool sampled = GDScriptSamplingProfiler::is_active();
+	if (unlikely(sampled)) {
+		GDScriptSamplingProfiler::push(this);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	if (ScriptDebugger::get_singleton())
@@ -433,6 +954,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	}
 	bool exit_ok = false;
 	bool yielded = false;
+	// Opcodes are only counted while profiling, so regular debug runs skip the increment.
+	const bool profiling_opcodes = GDScriptLanguage::get_singleton()->profiling;
+	uint64_t opcode_count = 0;
 #endif
 
 #ifdef DEBUG_ENABLED
@@ -444,6 +968,176 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 		OPCODE_SWITCH(_code_ptr[ip]) {
 
+			// Typed operators are emitted when the compiler knows both operand
+			// types. They share the layout of OPCODE_OPERATOR and fall through
+			// to it when the types don't match at runtime or the operation
+			// needs its error handling (e.g. division by zero).
+
+			OPCODE(OPCODE_OPERATOR_INT) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				if (likely(a->get_type() == Variant::INT && b->get_type() == Variant::INT)) {
+
+					GET_VARIANT_PTR(dst, 4);
+
+					int64_t va = *a;
+					int64_t vb = *b;
+					bool handled = true;
+
+					switch (_code_ptr[ip + 1]) {
+						case Variant::OP_EQUAL: *dst = va == vb; break;
+						case Variant::OP_NOT_EQUAL: *dst = va != vb; break;
+						case Variant::OP_LESS: *dst = va < vb; break;
+						case Variant::OP_LESS_EQUAL: *dst = va <= vb; break;
+						case Variant::OP_GREATER: *dst = va > vb; break;
+						case Variant::OP_GREATER_EQUAL: *dst = va >= vb; break;
+						case Variant::OP_ADD: *dst = va + vb; break;
+						case Variant::OP_SUBTRACT: *dst = va - vb; break;
+						case Variant::OP_MULTIPLY: *dst = va * vb; break;
+						case Variant::OP_DIVIDE: {
+							if (vb == 0) {
+								handled = false;
+							} else {
+								*dst = va / vb;
+							}
+						} break;
+						case Variant::OP_MODULE: {
+							if (vb == 0) {
+								handled = false;
+							} else {
+								*dst = va % vb;
+							}
+						} break;
+						case Variant::OP_NEGATE: *dst = -va; break;
+						case Variant::OP_POSITIVE: *dst = va; break;
+						case Variant::OP_BIT_AND: *dst = va & vb; break;
+						case Variant::OP_BIT_OR: *dst = va | vb; break;
+						case Variant::OP_BIT_XOR: *dst = va ^ vb; break;
+						case Variant::OP_BIT_NEGATE: *dst = ~va; break;
+						default: handled = false;
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+
+			OPCODE(OPCODE_OPERATOR_FLOAT) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				if (likely(a->get_type() == Variant::FLOAT && b->get_type() == Variant::FLOAT)) {
+
+					GET_VARIANT_PTR(dst, 4);
+
+					double va = *a;
+					double vb = *b;
+					bool handled = true;
+
+					switch (_code_ptr[ip + 1]) {
+						case Variant::OP_EQUAL: *dst = va == vb; break;
+						case Variant::OP_NOT_EQUAL: *dst = va != vb; break;
+						case Variant::OP_LESS: *dst = va < vb; break;
+						case Variant::OP_LESS_EQUAL: *dst = va <= vb; break;
+						case Variant::OP_GREATER: *dst = va > vb; break;
+						case Variant::OP_GREATER_EQUAL: *dst = va >= vb; break;
+						case Variant::OP_ADD: *dst = va + vb; break;
+						case Variant::OP_SUBTRACT: *dst = va - vb; break;
+						case Variant::OP_MULTIPLY: *dst = va * vb; break;
+						case Variant::OP_DIVIDE: {
+							if (vb == 0) {
+								handled = false;
+							} else {
+								*dst = va / vb;
+							}
+						} break;
+						case Variant::OP_NEGATE: *dst = -va; break;
+						case Variant::OP_POSITIVE: *dst = va; break;
+						default: handled = false;
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+
+			OPCODE(OPCODE_OPERATOR_VECTOR2) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				if (likely(a->get_type() == Variant::VECTOR2 && b->get_type() == Variant::VECTOR2)) {
+
+					GET_VARIANT_PTR(dst, 4);
+
+					Vector2 va = *a;
+					Vector2 vb = *b;
+					bool handled = true;
+
+					switch (_code_ptr[ip + 1]) {
+						case Variant::OP_EQUAL: *dst = va == vb; break;
+						case Variant::OP_NOT_EQUAL: *dst = va != vb; break;
+						case Variant::OP_ADD: *dst = va + vb; break;
+						case Variant::OP_SUBTRACT: *dst = va - vb; break;
+						case Variant::OP_MULTIPLY: *dst = va * vb; break;
+						case Variant::OP_NEGATE: *dst = -va; break;
+						case Variant::OP_POSITIVE: *dst = va; break;
+						default: handled = false;
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+
+			OPCODE(OPCODE_OPERATOR_VECTOR3) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				if (likely(a->get_type() == Variant::VECTOR3 && b->get_type() == Variant::VECTOR3)) {
+
+					GET_VARIANT_PTR(dst, 4);
+
+					Vector3 va = *a;
+					Vector3 vb = *b;
+					bool handled = true;
+
+					switch (_code_ptr[ip + 1]) {
+						case Variant::OP_EQUAL: *dst = va == vb; break;
+						case Variant::OP_NOT_EQUAL: *dst = va != vb; break;
+						case Variant::OP_ADD: *dst = va + vb; break;
+						case Variant::OP_SUBTRACT: *dst = va - vb; break;
+						case Variant::OP_MULTIPLY: *dst = va * vb; break;
+						case Variant::OP_NEGATE: *dst = -va; break;
+						case Variant::OP_POSITIVE: *dst = va; break;
+						default: handled = false;
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+
 			OPCODE(OPCODE_OPERATOR) {
 
 				CHECK_SPACE(5);
@@ -640,10 +1334,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_SET_NAMED) {
 
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(dst, 1);
-				GET_VARIANT_PTR(value, 3);
+				GET_VARIANT_PTR(value, 4);
 
 				int indexname = _code_ptr[ip + 2];
 
@@ -651,7 +1345,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				const StringName *index = &_global_names_ptr[indexname];
 
 				bool valid;
-				dst->set_named(*index, *value, &valid);
+				if (!_cached_set_named(_get_inline_cache(_code_ptr[ip + 3]), dst, *index, *value, valid)) {
+					dst->set_named(*index, *value, &valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -660,16 +1356,16 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
 
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 1);
-				GET_VARIANT_PTR(dst, 3);
+				GET_VARIANT_PTR(dst, 4);
 
 				int indexname = _code_ptr[ip + 2];
 
@@ -677,13 +1373,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				const StringName *index = &_global_names_ptr[indexname];
 
 				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, &valid);
-
-#else
-				*dst = src->get_named(*index, &valid);
-#endif
+				// Read into a temporary, src and dst may be the same stack position.
+				Variant ret;
+				if (!_cached_get_named(_get_inline_cache(_code_ptr[ip + 3]), src, *index, ret, valid)) {
+					ret = src->get_named(*index, &valid);
+				}
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					if (src->has_method(*index)) {
@@ -693,9 +1387,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					}
 					OPCODE_BREAK;
 				}
-				*dst = ret;
 #endif
-				ip += 4;
+				*dst = ret;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1061,21 +1755,82 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_PTRCALL_RETURN)
+			OPCODE(OPCODE_CALL_PTRCALL) {
+
+#ifdef PTRCALL_ENABLED
+				CHECK_SPACE(5);
+
+				int argc = _code_ptr[ip + 1];
+				GD_ERR_BREAK(argc < 0);
+				CHECK_SPACE(5 + argc + 1);
+				GET_VARIANT_PTR(base, 2);
+
+				// Only taken for the native method the call site already resolved to, with
+				// arguments of exactly the types it expects. Anything else is a regular call.
+				Object *obj;
+				MethodBind *method = _get_cached_native_method(_get_inline_cache(_code_ptr[ip + 4]), base, obj);
+#ifdef DEBUG_ENABLED
+				if (GDScriptLanguage::get_singleton()->profiling) {
+					method = NULL;
+				}
+#endif
+				if (method && method->get_argument_count() == argc) {
+
+					const void **argptrs = (const void **)call_args;
+					bool unboxed = true;
+					for (int i = 0; i < argc; i++) {
+						GET_VARIANT_PTR(v, 5 + i);
+						Variant::Type type = method->get_argument_type(i);
+						if (type == Variant::NIL) {
+							argptrs[i] = v; // Takes a Variant.
+						} else if (type == Variant::OBJECT || v->get_type() != type) {
+							unboxed = false;
+							break;
+						} else {
+							argptrs[i] = v->get_ptrcall_arg();
+						}
+					}
+
+					if (unboxed) {
+						Variant *ret = NULL;
+						if (_code_ptr[ip] == OPCODE_CALL_PTRCALL_RETURN) {
+							ret = _get_variant(_code_ptr[ip + 5 + argc], p_instance, script, self, static_ref, stack, err_text);
+							GD_ERR_BREAK(!ret);
+						}
+
+						bool called;
+						{
+#ifdef DEBUG_ENABLED
+							_ObjectDebugLock debug_lock(obj);
+#endif
+							called = _ptrcall_method(method, obj, argptrs, ret);
+						}
+						if (called) {
+							ip += 5 + argc + 1;
+							DISPATCH_OPCODE;
+						}
+					}
+				}
+#endif
+			}
+
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
 
-				CHECK_SPACE(4);
-				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
+				CHECK_SPACE(5);
+				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN || _code_ptr[ip] == OPCODE_CALL_PTRCALL_RETURN;
 
 				int argc = _code_ptr[ip + 1];
 				GET_VARIANT_PTR(base, 2);
 				int nameg = _code_ptr[ip + 3];
+				InlineCache *cache = _get_inline_cache(_code_ptr[ip + 4]);
 
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -1096,10 +1851,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				if (call_ret) {
 
 					GET_VARIANT_PTR(ret, argc);
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+					if (!_cached_call(cache, base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+						base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+					}
 				} else {
 
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
+					if (!_cached_call(cache, base, *methodname, (const Variant **)argptrs, argc, NULL, err)) {
+						base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1277,11 +2036,22 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 				gdfs->function = this;
 
-				gdfs->state.stack.resize(alloca_size);
-				//copy variant stack
-				for (int i = 0; i < _stack_size; i++) {
-					memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+				if (p_state) {
+					// Yielding again after a resume, the stack already lives in
+					// the state's buffer and is handed over as is.
+					gdfs->state.stack = p_state->stack;
+					p_state->stack = Vector<uint8_t>();
+				} else {
+					// Variants are moved rather than copied, they can be relocated
+					// bitwise (CowData does the same when it reallocates). The
+					// stack is left to the state and not destructed on exit.
+					gdfs->state.stack = _alloc_yield_stack(alloca_size);
+					if (_stack_size) {
+						copymem(gdfs->state.stack.ptrw(), stack, sizeof(Variant) * _stack_size);
+						zeromem((void *)stack, sizeof(Variant) * _stack_size);
+					}
 				}
+				stack_moved = true;
 				gdfs->state.stack_size = _stack_size;
 				gdfs->state.self = self;
 				gdfs->state.alloca_size = alloca_size;
@@ -1431,6 +2201,34 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				OPCODE_BREAK;
 			}
 
+			// Iterating an int (what `for i in range(n)` compiles to). Falls
+			// through to the generic version if the container isn't an int.
+			OPCODE(OPCODE_ITERATE_BEGIN_INT) {
+
+				CHECK_SPACE(8);
+
+				GET_VARIANT_PTR(container, 2);
+
+				if (likely(container->get_type() == Variant::INT)) {
+
+					GET_VARIANT_PTR(counter, 1);
+
+					int64_t size = *container;
+					*counter = (int64_t)0;
+
+					if (size <= 0) {
+						int jumpto = _code_ptr[ip + 3];
+						GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+						ip = jumpto;
+					} else {
+						GET_VARIANT_PTR(iterator, 4);
+						*iterator = (int64_t)0;
+						ip += 5; //skip regular iterate which is always next
+					}
+					DISPATCH_OPCODE;
+				}
+			}
+
 			OPCODE(OPCODE_ITERATE_BEGIN) {
 
 				CHECK_SPACE(8); //space for this a regular iterate
@@ -1464,6 +2262,32 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_ITERATE_INT) {
+
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(container, 2);
+
+				if (likely(container->get_type() == Variant::INT && counter->get_type() == Variant::INT)) {
+
+					int64_t idx = *counter;
+					idx++;
+
+					if (idx >= int64_t(*container)) {
+						int jumpto = _code_ptr[ip + 3];
+						GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+						ip = jumpto;
+					} else {
+						GET_VARIANT_PTR(iterator, 4);
+						*counter = idx;
+						*iterator = idx;
+						ip += 5; //loop again
+					}
+					DISPATCH_OPCODE;
+				}
+			}
+
 			OPCODE(OPCODE_ITERATE) {
 
 				CHECK_SPACE(4);
@@ -1614,6 +2438,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		profile.self_time += time_taken - function_call_time;
 		profile.frame_total_time += time_taken;
 		profile.frame_self_time += time_taken - function_call_time;
+		profile.opcode_count += opcode_count;
 		GDScriptLanguage::get_singleton()->script_frame_time += time_taken - function_call_time;
 	}
 
@@ -1626,19 +2451,73 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			GDScriptLanguage::get_singleton()->exit_function();
 #endif
 
-		if (_stack_size) {
+		if (_stack_size && !stack_moved) {
 			//free stack
-			for (int i = 0; i < _stack_size; i++)
-				stack[i].~Variant();
+			if (call_stack) {
+				// Left as NIL for the next call using this memory.
+				for (int i = 0; i < _stack_size; i++) {
+					if (stack[i].get_type() != Variant::NIL) {
+						stack[i].~Variant();
+						memnew_placement(&stack[i], Variant);
+					}
+				}
+			} else {
+				for (int i = 0; i < _stack_size; i++)
+					stack[i].~Variant();
+			}
 		}
 
 #ifdef DEBUG_ENABLED
 	}
 #endif
 
+	if (call_stack) {
+		if (_call_size) {
+			zeromem(call_args, sizeof(Variant *) * _call_size);
+		}
+		call_stack->pop(alloca_size);
+	}
+
+	if (unlikely(sampled)) {
+		GDScriptSamplingProfiler::pop();
+	}
+
 	return retvalue;
 }
 
+Vector<uint8_t> GDScriptFunction::_alloc_yield_stack(uint32_t p_size) {
+
+	{
+		MutexLock lock(yield_stack_lock);
+
+		int count = yield_stack_pool.size();
+		if (count) {
+			Vector<uint8_t> stack = yield_stack_pool[count - 1];
+			yield_stack_pool.resize(count - 1);
+			return stack;
+		}
+	}
+
+	Vector<uint8_t> stack;
+	stack.resize(p_size);
+	return stack;
+}
+
+void GDScriptFunction::_free_yield_stack(Vector<uint8_t> &p_stack) {
+
+	// Only holds raw memory, the variants in it are already destructed.
+	uint32_t size = sizeof(Variant *) * _call_size + sizeof(Variant) * _stack_size;
+	if (size > 0 && (uint32_t)p_stack.size() == size) {
+		MutexLock lock(yield_stack_lock);
+
+		if (yield_stack_pool.size() < YIELD_STACK_POOL_MAX) {
+			yield_stack_pool.push_back(p_stack);
+		}
+	}
+
+	p_stack = Vector<uint8_t>();
+}
+
 const int *GDScriptFunction::get_code() const {
 
 	return _code_ptr;
@@ -1764,6 +2643,8 @@ GDScriptFunction::GDScriptFunction() :
 
 	_stack_size = 0;
 	_call_size = 0;
+	_inline_caches = NULL;
+	_inline_cache_count = 0;
 	rpc_mode = MultiplayerAPI::RPC_MODE_DISABLED;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -1784,11 +2665,19 @@ GDScriptFunction::GDScriptFunction() :
 	profile.last_frame_call_count = 0;
 	profile.last_frame_self_time = 0;
 	profile.last_frame_total_time = 0;
+	profile.opcode_count = 0;
 
 #endif
 }
 
 GDScriptFunction::~GDScriptFunction() {
+
+	if (_inline_caches) {
+		memdelete_arr(_inline_caches);
+	}
+
+	GDScriptSamplingProfiler::function_freed();
+
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
@@ -1873,6 +2762,7 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 		}
 	}
 
+	GDScriptFunction *finished_function = function;
 	function = NULL; //cleaned up;
 	state.result = Variant();
 
@@ -1893,6 +2783,7 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 				stack[i].~Variant();
 		}
 #endif
+		finished_function->_free_yield_stack(state.stack);
 	}
 
 	return ret;
@@ -31,6 +31,7 @@
 #ifndef GDSCRIPT_FUNCTION_H
 #define GDSCRIPT_FUNCTION_H
 
+#include "core/os/mutex.h"
 #include "core/os/thread.h"
 #include "core/pair.h"
 #include "core/reference.h"
@@ -39,6 +40,8 @@
 #include "core/string_name.h"
 #include "core/variant.h"
 
+#include <atomic>
+
 class GDScriptInstance;
 class GDScript;
 
@@ -156,6 +159,10 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_INT,
+		OPCODE_OPERATOR_FLOAT,
+		OPCODE_OPERATOR_VECTOR2,
+		OPCODE_OPERATOR_VECTOR3,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET,
@@ -178,6 +185,8 @@ public:
 		OPCODE_CONSTRUCT_DICTIONARY,
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
+		OPCODE_CALL_PTRCALL,
+		OPCODE_CALL_PTRCALL_RETURN,
 		OPCODE_CALL_BUILT_IN,
 		OPCODE_CALL_SELF,
 		OPCODE_CALL_SELF_BASE,
@@ -191,6 +200,8 @@ public:
 		OPCODE_RETURN,
 		OPCODE_ITERATE_BEGIN,
 		OPCODE_ITERATE,
+		OPCODE_ITERATE_BEGIN_INT,
+		OPCODE_ITERATE_INT,
 		OPCODE_ASSERT,
 		OPCODE_BREAKPOINT,
 		OPCODE_LINE,
@@ -223,6 +234,90 @@ public:
 
 private:
 	friend class GDScriptCompiler;
+	friend class GDScriptBytecodeCache;
+	friend class GDScriptFunctionState;
+
+	// Per call site cache for OPCODE_CALL, OPCODE_GET_NAMED and OPCODE_SET_NAMED.
+	// Remembers what a name resolved to for the last few receiver classes/scripts,
+	// so repeated accesses skip the script and ClassDB lookups. Entries are
+	// published with a sequence counter so functions can run on several threads,
+	// and are dropped whenever GDScriptLanguage bumps the cache generation.
+	// Every stored field is a relaxed atomic, so a reader racing with a writer
+	// never reads a torn value, and the counter tells it to discard what it read.
+	struct InlineCache {
+
+		enum {
+			MAX_ENTRIES = 4
+		};
+
+		enum Kind {
+			KIND_SCRIPT_FUNCTION,
+			KIND_NATIVE_METHOD,
+			KIND_MEMBER,
+			KIND_PROPERTY,
+		};
+
+		struct Entry {
+			const void *class_key;
+			const GDScript *script;
+			Kind kind;
+			GDScriptFunction *function;
+			MethodBind *method;
+			const GDScriptDataType *member_type;
+			int index;
+		};
+
+		struct Slot {
+			std::atomic<const void *> class_key;
+			std::atomic<const GDScript *> script;
+			std::atomic<int> kind;
+			std::atomic<GDScriptFunction *> function;
+			std::atomic<MethodBind *> method;
+			std::atomic<const GDScriptDataType *> member_type;
+			std::atomic<int> index;
+		};
+
+		std::atomic<uint32_t> version;
+		std::atomic<uint32_t> generation;
+		std::atomic<int> entry_count;
+		Slot slots[MAX_ENTRIES];
+
+		_FORCE_INLINE_ bool lookup(const void *p_class_key, const GDScript *p_script, uint32_t p_generation, Entry &r_entry) const {
+
+			uint32_t v = version.load(std::memory_order_acquire);
+			if ((v & 1) || generation.load(std::memory_order_relaxed) != p_generation) {
+				return false;
+			}
+
+			bool found = false;
+			int count = entry_count.load(std::memory_order_relaxed);
+			for (int i = 0; i < count; i++) {
+				const Slot &slot = slots[i];
+				if (slot.class_key.load(std::memory_order_relaxed) == p_class_key && slot.script.load(std::memory_order_relaxed) == p_script) {
+					r_entry.class_key = p_class_key;
+					r_entry.script = p_script;
+					r_entry.kind = Kind(slot.kind.load(std::memory_order_relaxed));
+					r_entry.function = slot.function.load(std::memory_order_relaxed);
+					r_entry.method = slot.method.load(std::memory_order_relaxed);
+					r_entry.member_type = slot.member_type.load(std::memory_order_relaxed);
+					r_entry.index = slot.index.load(std::memory_order_relaxed);
+					found = true;
+					break;
+				}
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return found && version.load(std::memory_order_relaxed) == v;
+		}
+
+		void insert(const Entry &p_entry, uint32_t p_generation);
+
+		InlineCache() {
+			version.store(0);
+			generation.store(0);
+			entry_count.store(0);
+		}
+	};
 
 	StringName source;
 
@@ -242,6 +337,8 @@ private:
 	int _argument_count;
 	int _stack_size;
 	int _call_size;
+	InlineCache *_inline_caches;
+	int _inline_cache_count;
 	int _initial_line;
 	bool _static;
 	MultiplayerAPI::RPCMode rpc_mode;
@@ -265,9 +362,27 @@ private:
 
 	List<StackDebug> stack_debug;
 
+	// Stack buffers of finished coroutines, reused by the next yield instead
+	// of allocating a new one.
+	enum {
+		YIELD_STACK_POOL_MAX = 64,
+	};
+
+	Mutex yield_stack_lock;
+	Vector<Vector<uint8_t> > yield_stack_pool;
+
+	Vector<uint8_t> _alloc_yield_stack(uint32_t p_size);
+	void _free_yield_stack(Vector<uint8_t> &p_stack);
+
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
+	_FORCE_INLINE_ InlineCache *_get_inline_cache(int p_index) const;
+	MethodBind *_get_cached_native_method(InlineCache *p_cache, const Variant *p_base, Object *&r_object) const;
+	bool _cached_call(InlineCache *p_cache, const Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Callable::CallError &r_error) const;
+	bool _cached_get_named(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret, bool &r_valid) const;
+	bool _cached_set_named(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid) const;
+
 	friend class GDScriptLanguage;
 
 	SelfList<GDScriptFunction> function_list;
@@ -286,6 +401,7 @@ private:
 		uint64_t last_frame_call_count;
 		uint64_t last_frame_self_time;
 		uint64_t last_frame_total_time;
+		uint64_t opcode_count;
 	} profile;
 
 #endif
@@ -322,6 +438,9 @@ public:
 	StringName get_source() const { return source; }
 
 	void debug_get_stack_member_state(int p_line, List<Pair<StringName, int> > *r_stackvars) const;
+#ifdef DEBUG_ENABLED
+	uint64_t get_profile_opcode_count() const { return profile.opcode_count; } // Opcodes run while profiling.
+#endif
 
 	_FORCE_INLINE_ bool is_empty() const { return _code_size == 0; }
 
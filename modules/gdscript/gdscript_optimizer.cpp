@@ -0,0 +1,617 @@
+/*************************************************************************/
+/*  gdscript_optimizer.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_optimizer.h"
+
+#include "core/class_db.h"
+
+static bool _is_assignment(GDScriptParser::OperatorNode::Operator p_op) {
+
+	return p_op >= GDScriptParser::OperatorNode::OP_INIT_ASSIGN && p_op <= GDScriptParser::OperatorNode::OP_ASSIGN_BIT_XOR;
+}
+
+static bool _is_value_type(Variant::Type p_type) {
+
+	// Only values that are copied on assignment, so a constant can't be
+	// modified through the local it was propagated from.
+	return p_type < Variant::_RID;
+}
+
+static bool _get_variant_operator(GDScriptParser::OperatorNode::Operator p_op, Variant::Operator &r_op) {
+
+	switch (p_op) {
+		case GDScriptParser::OperatorNode::OP_NEG: r_op = Variant::OP_NEGATE; break;
+		case GDScriptParser::OperatorNode::OP_POS: r_op = Variant::OP_POSITIVE; break;
+		case GDScriptParser::OperatorNode::OP_NOT: r_op = Variant::OP_NOT; break;
+		case GDScriptParser::OperatorNode::OP_BIT_INVERT: r_op = Variant::OP_BIT_NEGATE; break;
+		case GDScriptParser::OperatorNode::OP_IN: r_op = Variant::OP_IN; break;
+		case GDScriptParser::OperatorNode::OP_EQUAL: r_op = Variant::OP_EQUAL; break;
+		case GDScriptParser::OperatorNode::OP_NOT_EQUAL: r_op = Variant::OP_NOT_EQUAL; break;
+		case GDScriptParser::OperatorNode::OP_LESS: r_op = Variant::OP_LESS; break;
+		case GDScriptParser::OperatorNode::OP_LESS_EQUAL: r_op = Variant::OP_LESS_EQUAL; break;
+		case GDScriptParser::OperatorNode::OP_GREATER: r_op = Variant::OP_GREATER; break;
+		case GDScriptParser::OperatorNode::OP_GREATER_EQUAL: r_op = Variant::OP_GREATER_EQUAL; break;
+		case GDScriptParser::OperatorNode::OP_AND: r_op = Variant::OP_AND; break;
+		case GDScriptParser::OperatorNode::OP_OR: r_op = Variant::OP_OR; break;
+		case GDScriptParser::OperatorNode::OP_ADD: r_op = Variant::OP_ADD; break;
+		case GDScriptParser::OperatorNode::OP_SUB: r_op = Variant::OP_SUBTRACT; break;
+		case GDScriptParser::OperatorNode::OP_MUL: r_op = Variant::OP_MULTIPLY; break;
+		case GDScriptParser::OperatorNode::OP_DIV: r_op = Variant::OP_DIVIDE; break;
+		case GDScriptParser::OperatorNode::OP_MOD: r_op = Variant::OP_MODULE; break;
+		case GDScriptParser::OperatorNode::OP_SHIFT_LEFT: r_op = Variant::OP_SHIFT_LEFT; break;
+		case GDScriptParser::OperatorNode::OP_SHIFT_RIGHT: r_op = Variant::OP_SHIFT_RIGHT; break;
+		case GDScriptParser::OperatorNode::OP_BIT_AND: r_op = Variant::OP_BIT_AND; break;
+		case GDScriptParser::OperatorNode::OP_BIT_OR: r_op = Variant::OP_BIT_OR; break;
+		case GDScriptParser::OperatorNode::OP_BIT_XOR: r_op = Variant::OP_BIT_XOR; break;
+		default: return false;
+	}
+	return true;
+}
+
+GDScriptParser::ConstantNode *GDScriptOptimizer::_make_constant(const GDScriptParser::Node *p_from, const Variant &p_value) {
+
+	// Nodes are linked into the parser's list so they are freed along with the tree.
+	GDScriptParser::ConstantNode *cn = memnew(GDScriptParser::ConstantNode);
+	cn->next = parser->list;
+	parser->list = cn;
+	cn->line = p_from->line;
+	cn->column = p_from->column;
+
+	cn->value = p_value;
+	cn->datatype.has_type = true;
+	cn->datatype.is_constant = true;
+	cn->datatype.kind = GDScriptParser::DataType::BUILTIN;
+	cn->datatype.builtin_type = p_value.get_type();
+	return cn;
+}
+
+GDScriptOptimizer::Local *GDScriptOptimizer::_declare(const StringName &p_name, const GDScriptParser::LocalVarNode *p_var) {
+
+	Local local;
+	local.var = p_var;
+	Local *l = &locals.push_back(local)->get();
+	scopes.back()->get()[p_name] = l;
+	return l;
+}
+
+GDScriptOptimizer::Local *GDScriptOptimizer::_find(const StringName &p_name) const {
+
+	for (const List<Map<StringName, Local *> >::Element *E = scopes.back(); E; E = E->prev()) {
+		const Map<StringName, Local *>::Element *F = E->get().find(p_name);
+		if (F) {
+			return F->get();
+		}
+	}
+	return NULL;
+}
+
+GDScriptOptimizer::Local *GDScriptOptimizer::_get_assigned_local(const GDScriptParser::OperatorNode *p_assign) const {
+
+	if (p_assign->op != GDScriptParser::OperatorNode::OP_ASSIGN && p_assign->op != GDScriptParser::OperatorNode::OP_INIT_ASSIGN) {
+		return NULL;
+	}
+	const Map<const GDScriptParser::Node *, Local *>::Element *E = resolved.find(p_assign->arguments[0]);
+	return E ? E->get() : NULL;
+}
+
+bool GDScriptOptimizer::_get_class_constant(const StringName &p_name, Variant &r_value) const {
+
+	const Map<StringName, GDScriptParser::ClassNode::Constant>::Element *E = current_class->constant_expressions.find(p_name);
+	if (!E || E->get().expression->type != GDScriptParser::Node::TYPE_CONSTANT) {
+		return false;
+	}
+
+	// The compiler looks up members before constants. Only fold when the
+	// inheritance chain is known and nothing in it has a member of that name.
+	const GDScriptParser::ClassNode *c = current_class;
+	while (true) {
+		for (int i = 0; i < c->variables.size(); i++) {
+			if (c->variables[i].identifier == p_name) {
+				return false;
+			}
+		}
+		if (!c->base_type.has_type) {
+			return false;
+		}
+		if (c->base_type.kind == GDScriptParser::DataType::CLASS && c->base_type.class_type) {
+			c = c->base_type.class_type;
+			continue;
+		}
+		if (c->base_type.kind != GDScriptParser::DataType::NATIVE || ClassDB::has_property(c->base_type.native_type, p_name)) {
+			return false;
+		}
+		break;
+	}
+
+	r_value = static_cast<const GDScriptParser::ConstantNode *>(E->get().expression)->value;
+	return _is_value_type(r_value.get_type());
+}
+
+void GDScriptOptimizer::_scan_expression(const GDScriptParser::Node *p_expression) {
+
+	switch (p_expression->type) {
+
+		case GDScriptParser::Node::TYPE_IDENTIFIER: {
+
+			Local *l = _find(static_cast<const GDScriptParser::IdentifierNode *>(p_expression)->name);
+			if (l) {
+				resolved[p_expression] = l;
+				l->reads++;
+			}
+		} break;
+		case GDScriptParser::Node::TYPE_ARRAY: {
+
+			const GDScriptParser::ArrayNode *an = static_cast<const GDScriptParser::ArrayNode *>(p_expression);
+			for (int i = 0; i < an->elements.size(); i++) {
+				_scan_expression(an->elements[i]);
+			}
+		} break;
+		case GDScriptParser::Node::TYPE_DICTIONARY: {
+
+			const GDScriptParser::DictionaryNode *dn = static_cast<const GDScriptParser::DictionaryNode *>(p_expression);
+			for (int i = 0; i < dn->elements.size(); i++) {
+				_scan_expression(dn->elements[i].key);
+				_scan_expression(dn->elements[i].value);
+			}
+		} break;
+		case GDScriptParser::Node::TYPE_CAST: {
+
+			_scan_expression(static_cast<const GDScriptParser::CastNode *>(p_expression)->source_node);
+		} break;
+		case GDScriptParser::Node::TYPE_OPERATOR: {
+
+			const GDScriptParser::OperatorNode *on = static_cast<const GDScriptParser::OperatorNode *>(p_expression);
+
+			if (_is_assignment(on->op)) {
+
+				// Assigning to a member of a local (e.g. v.x = 1) modifies it too.
+				const GDScriptParser::Node *root = on->arguments[0];
+				while (root->type == GDScriptParser::Node::TYPE_OPERATOR && (static_cast<const GDScriptParser::OperatorNode *>(root)->op == GDScriptParser::OperatorNode::OP_INDEX || static_cast<const GDScriptParser::OperatorNode *>(root)->op == GDScriptParser::OperatorNode::OP_INDEX_NAMED)) {
+					root = static_cast<const GDScriptParser::OperatorNode *>(root)->arguments[0];
+				}
+
+				Local *l = root->type == GDScriptParser::Node::TYPE_IDENTIFIER ? _find(static_cast<const GDScriptParser::IdentifierNode *>(root)->name) : NULL;
+				bool plain = root == on->arguments[0] && (on->op == GDScriptParser::OperatorNode::OP_ASSIGN || on->op == GDScriptParser::OperatorNode::OP_INIT_ASSIGN);
+
+				if (l && !(l->var && l->var->assign_op == on)) {
+					l->writes++;
+				}
+				if (plain) {
+					if (l) {
+						resolved[root] = l;
+					}
+				} else {
+					_scan_expression(on->arguments[0]);
+				}
+				_scan_expression(on->arguments[1]);
+				break;
+			}
+
+			int from = 0;
+			switch (on->op) {
+				case GDScriptParser::OperatorNode::OP_CALL: {
+					const GDScriptParser::Node *base = on->arguments[0];
+					if (base->type == GDScriptParser::Node::TYPE_BUILT_IN_FUNCTION || base->type == GDScriptParser::Node::TYPE_TYPE) {
+						from = 1;
+						break;
+					}
+					// Methods of builtin types may modify the value they are called on.
+					if (base->type == GDScriptParser::Node::TYPE_IDENTIFIER) {
+						Local *l = _find(static_cast<const GDScriptParser::IdentifierNode *>(base)->name);
+						if (l) {
+							l->writes++;
+						}
+					}
+					_scan_expression(base);
+					from = 2; // Skip the method name.
+				} break;
+				case GDScriptParser::OperatorNode::OP_PARENT_CALL: {
+					from = 1;
+				} break;
+				case GDScriptParser::OperatorNode::OP_INDEX_NAMED:
+				case GDScriptParser::OperatorNode::OP_IS_BUILTIN: {
+					_scan_expression(on->arguments[0]);
+					from = on->arguments.size();
+				} break;
+				default: break;
+			}
+
+			for (int i = from; i < on->arguments.size(); i++) {
+				_scan_expression(on->arguments[i]);
+			}
+		} break;
+		default: break;
+	}
+}
+
+void GDScriptOptimizer::_scan_block(const GDScriptParser::BlockNode *p_block) {
+
+	scopes.push_back(Map<StringName, Local *>());
+
+	for (const List<GDScriptParser::Node *>::Element *E = p_block->statements.front(); E; E = E->next()) {
+
+		const GDScriptParser::Node *s = E->get();
+
+		switch (s->type) {
+			case GDScriptParser::Node::TYPE_NEWLINE:
+			case GDScriptParser::Node::TYPE_BREAKPOINT: {
+			} break;
+			case GDScriptParser::Node::TYPE_LOCAL_VAR: {
+
+				const GDScriptParser::LocalVarNode *lv = static_cast<const GDScriptParser::LocalVarNode *>(s);
+				_declare(lv->name, lv);
+			} break;
+			case GDScriptParser::Node::TYPE_ASSERT: {
+
+				const GDScriptParser::AssertNode *as = static_cast<const GDScriptParser::AssertNode *>(s);
+				_scan_expression(as->condition);
+				if (as->message) {
+					_scan_expression(as->message);
+				}
+			} break;
+			case GDScriptParser::Node::TYPE_CONTROL_FLOW: {
+
+				const GDScriptParser::ControlFlowNode *cf = static_cast<const GDScriptParser::ControlFlowNode *>(s);
+
+				switch (cf->cf_type) {
+					case GDScriptParser::ControlFlowNode::CF_IF:
+					case GDScriptParser::ControlFlowNode::CF_WHILE: {
+						_scan_expression(cf->arguments[0]);
+						_scan_block(cf->body);
+						if (cf->body_else) {
+							_scan_block(cf->body_else);
+						}
+					} break;
+					case GDScriptParser::ControlFlowNode::CF_FOR: {
+						_scan_expression(cf->arguments[1]);
+						scopes.push_back(Map<StringName, Local *>());
+						_declare(static_cast<const GDScriptParser::IdentifierNode *>(cf->arguments[0])->name, NULL);
+						_scan_block(cf->body);
+						scopes.pop_back();
+					} break;
+					case GDScriptParser::ControlFlowNode::CF_MATCH: {
+						_scan_expression(cf->match->val_to_match);
+						for (int i = 0; i < cf->match->compiled_pattern_branches.size(); i++) {
+							_scan_expression(cf->match->compiled_pattern_branches[i].compiled_pattern);
+							_scan_block(cf->match->compiled_pattern_branches[i].body);
+						}
+					} break;
+					default: {
+						for (int i = 0; i < cf->arguments.size(); i++) {
+							_scan_expression(cf->arguments[i]);
+						}
+					} break;
+				}
+			} break;
+			default: {
+				_scan_expression(s);
+			} break;
+		}
+	}
+
+	scopes.pop_back();
+}
+
+GDScriptParser::Node *GDScriptOptimizer::_optimize_expression(GDScriptParser::Node *p_expression) {
+
+	switch (p_expression->type) {
+
+		case GDScriptParser::Node::TYPE_IDENTIFIER: {
+
+			Map<const GDScriptParser::Node *, Local *>::Element *E = resolved.find(p_expression);
+			if (E) {
+				return E->get()->constant ? _make_constant(p_expression, E->get()->value) : p_expression;
+			}
+
+			Variant value;
+			if (_get_class_constant(static_cast<GDScriptParser::IdentifierNode *>(p_expression)->name, value)) {
+				return _make_constant(p_expression, value);
+			}
+		} break;
+		case GDScriptParser::Node::TYPE_ARRAY: {
+
+			GDScriptParser::ArrayNode *an = static_cast<GDScriptParser::ArrayNode *>(p_expression);
+			for (int i = 0; i < an->elements.size(); i++) {
+				an->elements.write[i] = _optimize_expression(an->elements[i]);
+			}
+		} break;
+		case GDScriptParser::Node::TYPE_DICTIONARY: {
+
+			GDScriptParser::DictionaryNode *dn = static_cast<GDScriptParser::DictionaryNode *>(p_expression);
+			for (int i = 0; i < dn->elements.size(); i++) {
+				dn->elements.write[i].key = _optimize_expression(dn->elements[i].key);
+				dn->elements.write[i].value = _optimize_expression(dn->elements[i].value);
+			}
+		} break;
+		case GDScriptParser::Node::TYPE_CAST: {
+
+			GDScriptParser::CastNode *cn = static_cast<GDScriptParser::CastNode *>(p_expression);
+			cn->source_node = _optimize_expression(cn->source_node);
+		} break;
+		case GDScriptParser::Node::TYPE_OPERATOR: {
+
+			GDScriptParser::OperatorNode *on = static_cast<GDScriptParser::OperatorNode *>(p_expression);
+
+			int from = 0;
+			switch (on->op) {
+				case GDScriptParser::OperatorNode::OP_CALL: {
+					GDScriptParser::Node::Type base_type = on->arguments[0]->type;
+					if (base_type == GDScriptParser::Node::TYPE_BUILT_IN_FUNCTION || base_type == GDScriptParser::Node::TYPE_TYPE) {
+						from = 1;
+						break;
+					}
+					// Methods are not called on a folded copy of a constant.
+					if (base_type != GDScriptParser::Node::TYPE_IDENTIFIER) {
+						on->arguments.write[0] = _optimize_expression(on->arguments[0]);
+					}
+					from = 2;
+				} break;
+				case GDScriptParser::OperatorNode::OP_PARENT_CALL: {
+					from = 1;
+				} break;
+				case GDScriptParser::OperatorNode::OP_INDEX_NAMED:
+				case GDScriptParser::OperatorNode::OP_IS_BUILTIN: {
+					on->arguments.write[0] = _optimize_expression(on->arguments[0]);
+					from = on->arguments.size();
+				} break;
+				default: {
+					if (!_is_assignment(on->op)) {
+						break;
+					}
+					// The target stays as written, only the indices in it are optimized.
+					GDScriptParser::Node **target = &on->arguments.write[0];
+					while ((*target)->type == GDScriptParser::Node::TYPE_OPERATOR) {
+						GDScriptParser::OperatorNode *index = static_cast<GDScriptParser::OperatorNode *>(*target);
+						if (index->op != GDScriptParser::OperatorNode::OP_INDEX && index->op != GDScriptParser::OperatorNode::OP_INDEX_NAMED) {
+							*target = _optimize_expression(index);
+							break;
+						}
+						if (index->op == GDScriptParser::OperatorNode::OP_INDEX) {
+							index->arguments.write[1] = _optimize_expression(index->arguments[1]);
+						}
+						target = &index->arguments.write[0];
+					}
+					from = 1;
+				} break;
+			}
+
+			bool all_constants = true;
+			for (int i = 0; i < on->arguments.size(); i++) {
+				if (i >= from) {
+					on->arguments.write[i] = _optimize_expression(on->arguments[i]);
+				}
+				if (on->arguments[i]->type != GDScriptParser::Node::TYPE_CONSTANT) {
+					all_constants = false;
+				}
+			}
+
+			if (on->op == GDScriptParser::OperatorNode::OP_TERNARY_IF && on->arguments[0]->type == GDScriptParser::Node::TYPE_CONSTANT) {
+				return static_cast<GDScriptParser::ConstantNode *>(on->arguments[0])->value.booleanize() ? on->arguments[1] : on->arguments[2];
+			}
+
+			Variant::Operator var_op;
+			if (!all_constants || !_get_variant_operator(on->op, var_op)) {
+				break;
+			}
+
+			Variant a = static_cast<GDScriptParser::ConstantNode *>(on->arguments[0])->value;
+			Variant b = on->arguments.size() > 1 ? static_cast<GDScriptParser::ConstantNode *>(on->arguments[1])->value : Variant();
+			Variant ret;
+			bool valid = false;
+			Variant::evaluate(var_op, a, b, ret, valid);
+
+			// Invalid operations are left for the runtime to report.
+			if (valid && _is_value_type(ret.get_type())) {
+				return _make_constant(on, ret);
+			}
+		} break;
+		default: break;
+	}
+
+	return p_expression;
+}
+
+void GDScriptOptimizer::_optimize_block(GDScriptParser::BlockNode *p_block) {
+
+	List<GDScriptParser::Node *>::Element *E = p_block->statements.front();
+
+	while (E) {
+
+		List<GDScriptParser::Node *>::Element *next = E->next();
+		GDScriptParser::Node *s = E->get();
+		bool remove = false;
+		bool terminates = false;
+
+		switch (s->type) {
+			case GDScriptParser::Node::TYPE_NEWLINE:
+			case GDScriptParser::Node::TYPE_BREAKPOINT:
+			case GDScriptParser::Node::TYPE_LOCAL_VAR: {
+			} break;
+			case GDScriptParser::Node::TYPE_ASSERT: {
+
+				GDScriptParser::AssertNode *as = static_cast<GDScriptParser::AssertNode *>(s);
+				as->condition = _optimize_expression(as->condition);
+				if (as->message) {
+					as->message = _optimize_expression(as->message);
+				}
+			} break;
+			case GDScriptParser::Node::TYPE_CONTROL_FLOW: {
+
+				GDScriptParser::ControlFlowNode *cf = static_cast<GDScriptParser::ControlFlowNode *>(s);
+
+				switch (cf->cf_type) {
+					case GDScriptParser::ControlFlowNode::CF_IF: {
+						cf->arguments.write[0] = _optimize_expression(cf->arguments[0]);
+						_optimize_block(cf->body);
+						if (cf->body_else) {
+							_optimize_block(cf->body_else);
+						}
+
+						// Keep only the branch that runs, as a nested block so its locals stay scoped.
+						if (cf->arguments[0]->type == GDScriptParser::Node::TYPE_CONSTANT) {
+							GDScriptParser::BlockNode *taken = static_cast<GDScriptParser::ConstantNode *>(cf->arguments[0])->value.booleanize() ? cf->body : cf->body_else;
+							if (taken) {
+								E->get() = taken;
+							} else {
+								remove = true;
+							}
+						}
+					} break;
+					case GDScriptParser::ControlFlowNode::CF_WHILE: {
+						cf->arguments.write[0] = _optimize_expression(cf->arguments[0]);
+						_optimize_block(cf->body);
+
+						if (cf->arguments[0]->type == GDScriptParser::Node::TYPE_CONSTANT && !static_cast<GDScriptParser::ConstantNode *>(cf->arguments[0])->value.booleanize()) {
+							remove = true;
+						}
+					} break;
+					case GDScriptParser::ControlFlowNode::CF_FOR: {
+						cf->arguments.write[1] = _optimize_expression(cf->arguments[1]);
+						_optimize_block(cf->body);
+					} break;
+					case GDScriptParser::ControlFlowNode::CF_MATCH: {
+						GDScriptParser::MatchNode *match = cf->match;
+						match->val_to_match = _optimize_expression(match->val_to_match);
+						for (int i = 0; i < match->compiled_pattern_branches.size(); i++) {
+							GDScriptParser::MatchNode::CompiledPatternBranch &branch = match->compiled_pattern_branches.write[i];
+							branch.compiled_pattern = _optimize_expression(branch.compiled_pattern);
+							_optimize_block(branch.body);
+						}
+					} break;
+					case GDScriptParser::ControlFlowNode::CF_BREAK:
+					case GDScriptParser::ControlFlowNode::CF_CONTINUE:
+					case GDScriptParser::ControlFlowNode::CF_RETURN: {
+						for (int i = 0; i < cf->arguments.size(); i++) {
+							cf->arguments.write[i] = _optimize_expression(cf->arguments[i]);
+						}
+						terminates = true;
+					} break;
+				}
+			} break;
+			default: {
+
+				E->get() = _optimize_expression(s);
+
+				if (s->type != GDScriptParser::Node::TYPE_OPERATOR || !_is_assignment(static_cast<GDScriptParser::OperatorNode *>(s)->op)) {
+					break;
+				}
+
+				GDScriptParser::OperatorNode *on = static_cast<GDScriptParser::OperatorNode *>(s);
+				Local *l = _get_assigned_local(on);
+				if (!l || on->arguments[1]->type != GDScriptParser::Node::TYPE_CONSTANT) {
+					break;
+				}
+
+				const Variant &value = static_cast<GDScriptParser::ConstantNode *>(on->arguments[1])->value;
+
+				if (l->var && l->var->assign_op == on && l->writes == 0 && _is_value_type(value.get_type())) {
+					// A local that keeps its initial value is replaced by it everywhere.
+					const GDScriptParser::DataType &type = l->var->datatype;
+					if (!type.has_type || (type.kind == GDScriptParser::DataType::BUILTIN && type.builtin_type == value.get_type())) {
+						l->constant = true;
+						l->value = value;
+					}
+				}
+
+				// Nothing reads the store, and a constant has no side effects.
+				remove = l->constant || l->reads == 0;
+			} break;
+		}
+
+		if (remove) {
+			p_block->statements.erase(E);
+		}
+
+		if (terminates) {
+			while (next) {
+				List<GDScriptParser::Node *>::Element *N = next->next();
+				p_block->statements.erase(next);
+				next = N;
+			}
+		}
+
+		E = next;
+	}
+}
+
+void GDScriptOptimizer::_optimize_function(GDScriptParser::FunctionNode *p_function) {
+
+	if (!p_function->body) {
+		return;
+	}
+
+	locals.clear();
+	resolved.clear();
+
+	scopes.push_back(Map<StringName, Local *>());
+	for (int i = 0; i < p_function->arguments.size(); i++) {
+		_declare(p_function->arguments[i], NULL);
+	}
+	_scan_block(p_function->body);
+	scopes.clear();
+
+	_optimize_block(p_function->body);
+}
+
+void GDScriptOptimizer::_optimize_class(GDScriptParser::ClassNode *p_class) {
+
+	current_class = p_class;
+
+	for (int i = 0; i < p_class->functions.size(); i++) {
+		_optimize_function(p_class->functions[i]);
+	}
+	for (int i = 0; i < p_class->static_functions.size(); i++) {
+		_optimize_function(p_class->static_functions[i]);
+	}
+
+	for (int i = 0; i < p_class->subclasses.size(); i++) {
+		_optimize_class(p_class->subclasses[i]);
+	}
+}
+
+void GDScriptOptimizer::optimize(GDScriptParser *p_parser) {
+
+	parser = p_parser;
+
+	GDScriptParser::Node *root = const_cast<GDScriptParser::Node *>(parser->get_parse_tree());
+	ERR_FAIL_COND(!root || root->type != GDScriptParser::Node::TYPE_CLASS);
+
+	_optimize_class(static_cast<GDScriptParser::ClassNode *>(root));
+
+	locals.clear();
+	resolved.clear();
+	current_class = NULL;
+}
+
+GDScriptOptimizer::GDScriptOptimizer() {
+
+	parser = NULL;
+	current_class = NULL;
+}
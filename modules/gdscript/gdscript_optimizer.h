@@ -0,0 +1,85 @@
+/*************************************************************************/
+/*  gdscript_optimizer.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_OPTIMIZER_H
+#define GDSCRIPT_OPTIMIZER_H
+
+#include "core/list.h"
+#include "core/map.h"
+#include "gdscript_parser.h"
+
+// Rewrites the parse tree of each function before it is compiled: folds
+// constant expressions, including locals that are only ever assigned a
+// constant, drops stores nothing reads and removes branches that can't run.
+class GDScriptOptimizer {
+
+	struct Local {
+		const GDScriptParser::LocalVarNode *var; // NULL for arguments and loop iterators.
+		int reads;
+		int writes; // Not counting the declaration.
+		bool constant;
+		Variant value;
+
+		Local() :
+				var(NULL),
+				reads(0),
+				writes(0),
+				constant(false) {}
+	};
+
+	GDScriptParser *parser;
+	const GDScriptParser::ClassNode *current_class;
+
+	List<Local> locals;
+	List<Map<StringName, Local *> > scopes;
+	Map<const GDScriptParser::Node *, Local *> resolved;
+
+	GDScriptParser::ConstantNode *_make_constant(const GDScriptParser::Node *p_from, const Variant &p_value);
+
+	Local *_declare(const StringName &p_name, const GDScriptParser::LocalVarNode *p_var);
+	Local *_find(const StringName &p_name) const;
+	Local *_get_assigned_local(const GDScriptParser::OperatorNode *p_assign) const;
+	bool _get_class_constant(const StringName &p_name, Variant &r_value) const;
+
+	void _scan_expression(const GDScriptParser::Node *p_expression);
+	void _scan_block(const GDScriptParser::BlockNode *p_block);
+
+	GDScriptParser::Node *_optimize_expression(GDScriptParser::Node *p_expression);
+	void _optimize_block(GDScriptParser::BlockNode *p_block);
+	void _optimize_function(GDScriptParser::FunctionNode *p_function);
+	void _optimize_class(GDScriptParser::ClassNode *p_class);
+
+public:
+	void optimize(GDScriptParser *p_parser);
+
+	GDScriptOptimizer();
+};
+
+#endif // GDSCRIPT_OPTIMIZER_H
@@ -497,7 +497,7 @@ GDScriptParser::Node *GDScriptParser::_parse_expression(Node *p_parent, bool p_s
 					if (for_completion && ScriptCodeCompletionCache::get_singleton() && FileAccess::exists(path)) {
 						res = ScriptCodeCompletionCache::get_singleton()->get_cached_resource(path);
 					} else if (!for_completion || FileAccess::exists(path)) {
-						res = ResourceLoader::load(path);
+						res = GDScriptCache::load_dependency(path);
 					}
 				} else {
 
@@ -833,7 +833,7 @@ GDScriptParser::Node *GDScriptParser::_parse_expression(Node *p_parent, bool p_s
 
 				if (!dependencies_only) {
 					if (!bfn && ScriptServer::is_global_class(identifier)) {
-						Ref<Script> scr = ResourceLoader::load(ScriptServer::get_global_class_path(identifier));
+						Ref<Script> scr = GDScriptCache::load_dependency(ScriptServer::get_global_class_path(identifier));
 						if (scr.is_valid() && scr->is_valid()) {
 							ConstantNode *constant = alloc_node<ConstantNode>();
 							constant->value = scr;
@@ -5262,7 +5262,7 @@ void GDScriptParser::_determine_inheritance(ClassNode *p_class, bool p_recursive
 				}
 				path = base.plus_file(path).simplify_path();
 			}
-			script = ResourceLoader::load(path);
+			script = GDScriptCache::load_dependency(path);
 			if (script.is_null()) {
 				_set_error("Couldn't load the base class: " + path, p_class->line);
 				return;
@@ -5304,7 +5304,7 @@ void GDScriptParser::_determine_inheritance(ClassNode *p_class, bool p_recursive
 			Ref<GDScript> base_script;
 
 			if (ScriptServer::is_global_class(base)) {
-				base_script = ResourceLoader::load(ScriptServer::get_global_class_path(base));
+				base_script = GDScriptCache::load_dependency(ScriptServer::get_global_class_path(base));
 				if (!base_script.is_valid()) {
 					_set_error("The class \"" + base + "\" couldn't be fully loaded (script error or cyclic dependency).", p_class->line);
 					return;
@@ -5327,7 +5327,7 @@ void GDScriptParser::_determine_inheritance(ClassNode *p_class, bool p_recursive
 						if (!singleton_path.begins_with("res://")) {
 							singleton_path = "res://" + singleton_path;
 						}
-						base_script = ResourceLoader::load(singleton_path);
+						base_script = GDScriptCache::load_dependency(singleton_path);
 						if (!base_script.is_valid()) {
 							_set_error("Class '" + base + "' could not be fully loaded (script error or cyclic inheritance).", p_class->line);
 							return;
@@ -5660,7 +5660,7 @@ GDScriptParser::DataType GDScriptParser::_resolve_type(const DataType &p_source,
 					result.kind = DataType::CLASS;
 					result.class_type = static_cast<ClassNode *>(head);
 				} else {
-					Ref<Script> script = ResourceLoader::load(script_path);
+					Ref<Script> script = GDScriptCache::load_dependency(script_path);
 					Ref<GDScript> gds = script;
 					if (gds.is_valid()) {
 						if (!gds->is_valid()) {
@@ -5701,7 +5701,7 @@ GDScriptParser::DataType GDScriptParser::_resolve_type(const DataType &p_source,
 				}
 			}
 			if (!singleton_path.empty()) {
-				Ref<Script> script = ResourceLoader::load(singleton_path);
+				Ref<Script> script = GDScriptCache::load_dependency(singleton_path);
 				Ref<GDScript> gds = script;
 				if (gds.is_valid()) {
 					if (!gds->is_valid()) {
@@ -7550,7 +7550,7 @@ GDScriptParser::DataType GDScriptParser::_reduce_identifier_type(const DataType
 		}
 
 		if (ScriptServer::is_global_class(p_identifier)) {
-			Ref<Script> scr = ResourceLoader::load(ScriptServer::get_global_class_path(p_identifier));
+			Ref<Script> scr = GDScriptCache::load_dependency(ScriptServer::get_global_class_path(p_identifier));
 			if (scr.is_valid()) {
 				DataType result;
 				result.has_type = true;
@@ -7602,7 +7602,7 @@ GDScriptParser::DataType GDScriptParser::_reduce_identifier_type(const DataType
 				if (!script.begins_with("res://")) {
 					script = "res://" + script;
 				}
-				Ref<Script> singleton = ResourceLoader::load(script);
+				Ref<Script> singleton = GDScriptCache::load_dependency(script);
 				if (singleton.is_valid()) {
 					DataType result;
 					result.has_type = true;
@@ -525,6 +525,8 @@ public:
 	};
 
 private:
+	friend class GDScriptOptimizer;
+
 	GDScriptTokenizer *tokenizer;
 
 	Node *head;
@@ -0,0 +1,316 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "gdscript.h"
+
+std::atomic<bool> GDScriptSamplingProfiler::active(false);
+std::atomic<uint32_t> GDScriptSamplingProfiler::generation(0);
+Mutex GDScriptSamplingProfiler::stacks_mutex;
+SelfList<GDScriptSamplingProfiler::ThreadStack>::List GDScriptSamplingProfiler::stacks;
+
+GDScriptSamplingProfiler::ThreadStack::ThreadStack() :
+		stack_list(this) {
+
+	for (int i = 0; i < MAX_DEPTH; i++) {
+		frames[i].store(NULL, std::memory_order_relaxed);
+	}
+	depth.store(0, std::memory_order_relaxed);
+	version.store(0, std::memory_order_relaxed);
+}
+
+GDScriptSamplingProfiler::ThreadStackOwner::~ThreadStackOwner() {
+
+	if (stack) {
+		MutexLock lock(stacks_mutex);
+		stacks.remove(&stack->stack_list);
+		memdelete(stack);
+	}
+}
+
+GDScriptSamplingProfiler::ThreadStack *GDScriptSamplingProfiler::_get_thread_stack() {
+
+	static thread_local ThreadStackOwner owner;
+
+	if (unlikely(!owner.stack)) {
+		owner.stack = memnew(ThreadStack);
+		MutexLock lock(stacks_mutex);
+		stacks.add(&owner.stack->stack_list);
+	}
+
+	return owner.stack;
+}
+
+void GDScriptSamplingProfiler::push(const GDScriptFunction *p_function) {
+
+	ThreadStack *stack = _get_thread_stack();
+	uint32_t v = stack->version.load(std::memory_order_relaxed);
+	uint32_t d = stack->depth.load(std::memory_order_relaxed);
+
+	stack->version.store(v + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	if (d < MAX_DEPTH) {
+		stack->frames[d].store(p_function, std::memory_order_relaxed);
+	}
+	stack->depth.store(d + 1, std::memory_order_relaxed);
+	stack->version.store(v + 2, std::memory_order_release);
+}
+
+void GDScriptSamplingProfiler::pop() {
+
+	ThreadStack *stack = _get_thread_stack();
+	uint32_t v = stack->version.load(std::memory_order_relaxed);
+	uint32_t d = stack->depth.load(std::memory_order_relaxed);
+	ERR_FAIL_COND(d == 0);
+
+	stack->version.store(v + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	stack->depth.store(d - 1, std::memory_order_relaxed);
+	stack->version.store(v + 2, std::memory_order_release);
+}
+
+void GDScriptSamplingProfiler::function_freed() {
+
+	if (!is_active() || !GDScriptLanguage::get_singleton()) {
+		return;
+	}
+
+	// A pending sample may point to this function, flush() discards samples
+	// taken before the last function was freed rather than resolve them.
+	GDScriptSamplingProfiler *profiler = GDScriptLanguage::get_singleton()->get_sampling_profiler();
+	MutexLock lock(profiler->mutex);
+	generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GDScriptSamplingProfiler::_thread_func(void *p_userdata) {
+
+	GDScriptSamplingProfiler *profiler = (GDScriptSamplingProfiler *)p_userdata;
+
+	while (!profiler->exit_thread.load(std::memory_order_acquire)) {
+		profiler->_take_samples();
+		OS::get_singleton()->delay_usec(profiler->interval_usec);
+	}
+}
+
+void GDScriptSamplingProfiler::_take_samples() {
+
+	MutexLock lock(stacks_mutex);
+
+	uint32_t sample_generation = generation.load(std::memory_order_relaxed);
+	const GDScriptFunction *frames[MAX_DEPTH];
+
+	for (SelfList<ThreadStack> *E = stacks.first(); E; E = E->next()) {
+
+		ThreadStack *stack = E->self();
+		uint32_t depth = 0;
+		bool consistent = false;
+
+		for (int attempt = 0; attempt < 4 && !consistent; attempt++) {
+
+			uint32_t v = stack->version.load(std::memory_order_acquire);
+			if (v & 1) {
+				continue;
+			}
+
+			depth = MIN(stack->depth.load(std::memory_order_relaxed), (uint32_t)MAX_DEPTH);
+			for (uint32_t i = 0; i < depth; i++) {
+				frames[i] = stack->frames[i].load(std::memory_order_relaxed);
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			consistent = stack->version.load(std::memory_order_relaxed) == v;
+		}
+
+		if (!consistent) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		if (depth == 0) {
+			continue; // Idle thread.
+		}
+
+		uint32_t read = ring_read.load(std::memory_order_acquire);
+		uint32_t write = ring_write.load(std::memory_order_relaxed);
+		if (RING_SIZE - (write - read) < SAMPLE_HEADER + depth) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		ring[write++ & (RING_SIZE - 1)] = sample_generation;
+		ring[write++ & (RING_SIZE - 1)] = depth;
+		for (uint32_t i = 0; i < depth; i++) {
+			ring[write++ & (RING_SIZE - 1)] = (uintptr_t)frames[i];
+		}
+		ring_write.store(write, std::memory_order_release);
+	}
+}
+
+Error GDScriptSamplingProfiler::start(uint32_t p_interval_usec) {
+
+	ERR_FAIL_COND_V(thread, ERR_ALREADY_IN_USE);
+	ERR_FAIL_COND_V(p_interval_usec == 0, ERR_INVALID_PARAMETER);
+
+	if (!ring) {
+		ring = memnew_arr(uintptr_t, RING_SIZE);
+	}
+
+	interval_usec = p_interval_usec;
+	ring_read.store(0, std::memory_order_relaxed);
+	ring_write.store(0, std::memory_order_relaxed);
+	exit_thread.store(false, std::memory_order_relaxed);
+	active.store(true, std::memory_order_release);
+
+	thread = Thread::create(_thread_func, this);
+	if (!thread) {
+		active.store(false, std::memory_order_release);
+		ERR_FAIL_V_MSG(ERR_CANT_CREATE, "Couldn't create the GDScript sampling thread.");
+	}
+
+	return OK;
+}
+
+void GDScriptSamplingProfiler::stop() {
+
+	if (!thread) {
+		return;
+	}
+
+	exit_thread.store(true, std::memory_order_release);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	thread = NULL;
+
+	// Pending samples may only be resolved while freed functions are still
+	// counted, so they are folded before sampling is turned off.
+	flush();
+	active.store(false, std::memory_order_release);
+}
+
+void GDScriptSamplingProfiler::flush() {
+
+	MutexLock lock(mutex);
+
+	uint32_t current_generation = generation.load(std::memory_order_relaxed);
+	uint32_t read = ring_read.load(std::memory_order_relaxed);
+	uint32_t write = ring_write.load(std::memory_order_acquire);
+
+	while (read != write) {
+
+		uint32_t sample_generation = ring[read++ & (RING_SIZE - 1)];
+		uint32_t depth = ring[read++ & (RING_SIZE - 1)];
+
+		if (sample_generation != current_generation) {
+			read += depth;
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		String stack;
+		for (uint32_t i = 0; i < depth; i++) {
+			const GDScriptFunction *function = (const GDScriptFunction *)ring[read++ & (RING_SIZE - 1)];
+			if (i > 0) {
+				stack += ";";
+			}
+			stack += String(function->get_source()) + "::" + String(function->get_name());
+		}
+
+		uint64_t *count = counts.getptr(stack);
+		if (count) {
+			(*count)++;
+		} else {
+			counts.set(stack, 1);
+		}
+		sample_count++;
+	}
+
+	ring_read.store(read, std::memory_order_release);
+}
+
+void GDScriptSamplingProfiler::clear() {
+
+	MutexLock lock(mutex);
+	counts.clear();
+	sample_count = 0;
+	dropped.store(0, std::memory_order_relaxed);
+}
+
+String GDScriptSamplingProfiler::get_folded_stacks() const {
+
+	MutexLock lock(mutex);
+
+	String folded;
+	const String *K = NULL;
+	while ((K = counts.next(K))) {
+		folded += *K + " " + itos(*counts.getptr(*K)) + "\n";
+	}
+
+	return folded;
+}
+
+Error GDScriptSamplingProfiler::save(const String &p_path) const {
+
+	Error err;
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(!f, err, "Cannot save GDScript samples to file '" + p_path + "'.");
+
+	f->store_string(get_folded_stacks());
+	return OK;
+}
+
+uint64_t GDScriptSamplingProfiler::get_sample_count() const {
+
+	MutexLock lock(mutex);
+	return sample_count;
+}
+
+GDScriptSamplingProfiler::GDScriptSamplingProfiler() :
+		thread(NULL),
+		exit_thread(false),
+		interval_usec(1000),
+		ring_read(0),
+		ring_write(0),
+		dropped(0),
+		sample_count(0) {
+
+	ring = NULL; // Allocated on start().
+}
+
+GDScriptSamplingProfiler::~GDScriptSamplingProfiler() {
+
+	stop();
+
+	if (ring) {
+		memdelete_arr(ring);
+	}
+}
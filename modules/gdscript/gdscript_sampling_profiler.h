@@ -0,0 +1,127 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/hash_map.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/self_list.h"
+#include "core/ustring.h"
+
+#include <atomic>
+
+class GDScriptFunction;
+
+// Statistical profiler meant to stay enabled on running games and servers.
+// Each thread running scripts publishes its call stack, a timer thread
+// copies the stacks into a ring buffer, and flush() folds the samples into
+// counts per call stack, in the format flame graph tools read.
+class GDScriptSamplingProfiler {
+
+	enum {
+		MAX_DEPTH = 64, // Deeper frames are not recorded, the sample keeps the outermost ones.
+		RING_SIZE = 1 << 16, // In words, a power of two.
+		SAMPLE_HEADER = 2, // Generation and depth.
+	};
+
+	// Written only by its own thread. Readers retry when the version is odd
+	// or changed while reading, same as GDScriptFunction::InlineCache.
+	struct ThreadStack {
+		std::atomic<const GDScriptFunction *> frames[MAX_DEPTH];
+		std::atomic<uint32_t> depth;
+		std::atomic<uint32_t> version;
+		SelfList<ThreadStack> stack_list;
+
+		ThreadStack();
+	};
+
+	struct ThreadStackOwner {
+		ThreadStack *stack;
+
+		ThreadStackOwner() :
+				stack(NULL) {}
+		~ThreadStackOwner();
+	};
+
+	static std::atomic<bool> active;
+	static std::atomic<uint32_t> generation; // Bumped when a function is freed.
+	static Mutex stacks_mutex;
+	static SelfList<ThreadStack>::List stacks;
+
+	static ThreadStack *_get_thread_stack();
+
+	Thread *thread;
+	std::atomic<bool> exit_thread;
+	uint32_t interval_usec;
+
+	// Single producer (the timer thread), single consumer (flush()).
+	uintptr_t *ring;
+	std::atomic<uint32_t> ring_read;
+	std::atomic<uint32_t> ring_write;
+	std::atomic<uint64_t> dropped;
+
+	mutable Mutex mutex; // Guards the counts, and freeing functions against flush().
+	HashMap<String, uint64_t> counts;
+	uint64_t sample_count;
+
+	static void _thread_func(void *p_userdata);
+	void _take_samples();
+
+public:
+	_FORCE_INLINE_ static bool is_active() { return active.load(std::memory_order_relaxed); }
+
+	// Called by GDScriptFunction::call() on entry and exit while active.
+	static void push(const GDScriptFunction *p_function);
+	static void pop();
+
+	// Called by ~GDScriptFunction(), samples taken before are discarded.
+	static void function_freed();
+
+	Error start(uint32_t p_interval_usec);
+	void stop();
+	bool is_running() const { return thread != NULL; }
+
+	void flush();
+	void clear();
+
+	// One "outer;...;inner count" line per sampled call stack.
+	String get_folded_stacks() const;
+	Error save(const String &p_path) const;
+
+	uint64_t get_sample_count() const;
+	uint64_t get_dropped_count() const { return dropped.load(std::memory_order_relaxed); }
+
+	GDScriptSamplingProfiler();
+	~GDScriptSamplingProfiler();
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -34,7 +34,9 @@
 #include "core/io/resource_loader.h"
 #include "core/os/dir_access.h"
 #include "core/os/file_access.h"
+#include "core/project_settings.h"
 #include "gdscript.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_tokenizer.h"
 
 GDScriptLanguage *script_language_gd = NULL;
@@ -57,7 +59,14 @@ class EditorExportGDScript : public EditorExportPlugin {
 
 	GDCLASS(EditorExportGDScript, EditorExportPlugin);
 
+	bool debug;
+
 public:
+	virtual void _export_begin(const Set<String> &p_features, bool p_debug, const String &p_path, int p_flags) {
+
+		debug = p_debug;
+	}
+
 	virtual void _export_file(const String &p_path, const String &p_type, const Set<String> &p_features) {
 
 		int script_mode = EditorExportPreset::MODE_SCRIPT_COMPILED;
@@ -81,6 +90,18 @@ public:
 		txt.parse_utf8((const char *)file.ptr(), file.size());
 		file = GDScriptTokenizerBuffer::parse_code_string(txt);
 
+		if (!file.empty() && GLOBAL_GET("editor/precompile_gdscript_on_export")) {
+
+			// Ship the code compiled for the template being exported, the
+			// tokens stay in the file for builds that can't use it.
+			Vector<uint8_t> compiled = GDScriptBytecodeCache::save(p_path, txt, file, debug);
+			if (!compiled.empty()) {
+				file = compiled;
+			} else {
+				print_verbose("GDScript: '" + p_path + "' can't be precompiled, exporting its tokens only.");
+			}
+		}
+
 		if (!file.empty()) {
 
 			if (script_mode == EditorExportPreset::MODE_SCRIPT_ENCRYPTED) {
@@ -132,10 +153,15 @@ public:
 			}
 		}
 	}
+
+	EditorExportGDScript() :
+			debug(false) {}
 };
 
 static void _editor_init() {
 
+	GLOBAL_DEF("editor/precompile_gdscript_on_export", true);
+
 	Ref<EditorExportGDScript> gd_export;
 	gd_export.instance();
 	EditorExport::get_singleton()->add_export_plugin(gd_export);
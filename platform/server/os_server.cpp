@@ -32,7 +32,9 @@
 
 #include "core/print_string.h"
 #include "drivers/dummy/rasterizer_dummy.h"
+#include "drivers/dummy/rendering_device_recording.h"
 #include "drivers/dummy/texture_loader_dummy.h"
+#include "servers/visual/rasterizer_rd/rasterizer_rd.h"
 #include "servers/visual/visual_server_raster.h"
 
 #include "main/main.h"
@@ -43,11 +45,16 @@
 
 int OS_Server::get_video_driver_count() const {
 
-	return 1;
+	return VIDEO_DRIVER_MAX;
 }
 const char *OS_Server::get_video_driver_name(int p_driver) const {
 
-	return "Dummy";
+	switch (p_driver) {
+		case VIDEO_DRIVER_RECORDING:
+			return "Recording";
+		default:
+			return "Dummy";
+	}
 }
 
 int OS_Server::get_audio_driver_count() const {
@@ -76,9 +83,17 @@ Error OS_Server::initialize(const VideoMode &p_desired, int p_video_driver, int
 	current_videomode = p_desired;
 	main_loop = NULL;
 
-	RasterizerDummy::make_current();
+	if (p_video_driver == VIDEO_DRIVER_RECORDING) {
+		// Runs the RD renderer against a device that only validates and records commands, for benchmarking.
+		rendering_device_recording = memnew(RenderingDeviceRecording);
+		rendering_device_recording->initialize();
+
+		RasterizerRD::make_current();
+	} else {
+		RasterizerDummy::make_current();
+	}
 
-	video_driver_index = p_video_driver; // unused in server platform, but should still be initialized
+	video_driver_index = p_video_driver;
 
 	visual_server = memnew(VisualServerRaster);
 	visual_server->init();
@@ -104,6 +119,12 @@ void OS_Server::finalize() {
 	visual_server->finish();
 	memdelete(visual_server);
 
+	if (rendering_device_recording) {
+		rendering_device_recording->finalize();
+		memdelete(rendering_device_recording);
+		rendering_device_recording = NULL;
+	}
+
 	memdelete(input);
 
 	ResourceLoader::remove_resource_format_loader(resource_loader_dummy);
@@ -174,7 +195,7 @@ void OS_Server::set_main_loop(MainLoop *p_main_loop) {
 
 bool OS_Server::can_draw() const {
 
-	return false; //can never draw
+	return rendering_device_recording != NULL; //only the recording driver draws
 };
 
 String OS_Server::get_name() const {
@@ -307,4 +328,5 @@ OS_Server::OS_Server() {
 
 	//adriver here
 	grab = false;
+	rendering_device_recording = NULL;
 };
@@ -31,6 +31,7 @@
 #ifndef OS_SERVER_H
 #define OS_SERVER_H
 
+#include "drivers/dummy/rendering_device_recording.h"
 #include "drivers/dummy/texture_loader_dummy.h"
 #include "drivers/unix/os_unix.h"
 #include "main/input_default.h"
@@ -63,7 +64,14 @@ class OS_Server : public OS_Unix {
 
 	CrashHandler crash_handler;
 
+	enum {
+		VIDEO_DRIVER_DUMMY,
+		VIDEO_DRIVER_RECORDING,
+		VIDEO_DRIVER_MAX
+	};
+
 	int video_driver_index;
+	RenderingDeviceRecording *rendering_device_recording;
 
 	Ref<ResourceFormatDummyTexture> resource_loader_dummy;
 
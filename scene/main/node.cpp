@@ -1228,12 +1228,20 @@ void Node::_generate_serial_child_name(const Node *p_child, StringName &name) co
 	}
 }
 
-void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
+void Node::_add_child_nocheck(Node *p_child, const StringName &p_name, int p_index) {
 	//add a child node quickly, without name validation
 
 	p_child->data.name = p_name;
-	p_child->data.pos = data.children.size();
-	data.children.push_back(p_child);
+	if (p_index >= 0 && p_index < data.children.size() && !data.tree) {
+		//placed directly while building a subtree, outside of the tree nothing needs to know siblings moved
+		data.children.insert(p_index, p_child);
+		for (int i = p_index; i < data.children.size(); i++) {
+			data.children[i]->data.pos = i;
+		}
+	} else {
+		p_child->data.pos = data.children.size();
+		data.children.push_back(p_child);
+	}
 	p_child->data.parent = this;
 	p_child->notification(NOTIFICATION_PARENTED);
 
@@ -1245,6 +1253,10 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
 	//recognize children created in this node constructor
 	p_child->data.parent_owned = data.in_constructor;
 	add_child_notify(p_child);
+
+	if (p_index >= 0 && p_index < data.children.size() - 1 && p_child->data.pos != p_index) {
+		move_child(p_child, p_index);
+	}
 }
 
 void Node::add_child(Node *p_child, bool p_legible_unique_name) {
@@ -30,6 +30,7 @@
 
 #include "mesh.h"
 
+#include "core/math/mesh_simplifier.h"
 #include "core/pair.h"
 #include "scene/resources/concave_polygon_shape.h"
 #include "scene/resources/convex_polygon_shape.h"
@@ -1548,6 +1549,89 @@ Error ArrayMesh::lightmap_unwrap(const Transform &p_base_transform, float p_texe
 	return OK;
 }
 
+Error ArrayMesh::generate_lods() {
+
+	struct LODSurface {
+		PrimitiveType primitive;
+		uint32_t format;
+		Array arrays;
+		Array blend_shape_arrays;
+		Dictionary lods;
+		Ref<Material> material;
+		String name;
+	};
+
+	Vector<LODSurface> lod_surfaces;
+
+	for (int i = 0; i < get_surface_count(); i++) {
+
+		LODSurface s;
+		s.primitive = surface_get_primitive_type(i);
+		s.format = surface_get_format(i);
+		s.arrays = surface_get_arrays(i);
+		s.blend_shape_arrays = surface_get_blend_shape_arrays(i);
+		s.lods = surface_get_lods(i);
+		s.material = surface_get_material(i);
+		s.name = surface_get_name(i);
+
+		if (s.primitive == PRIMITIVE_TRIANGLES && !(s.format & ARRAY_FLAG_USE_2D_VERTICES) && s.lods.empty()) {
+
+			if (s.arrays[ARRAY_INDEX].get_type() == Variant::NIL && s.blend_shape_arrays.empty()) {
+				//LODs are index buffers, so weld the vertices first
+				Ref<SurfaceTool> st;
+				st.instance();
+				st->create_from_triangle_arrays(s.arrays);
+				st->index();
+				s.arrays = st->commit_to_arrays();
+			}
+
+			if (s.arrays[ARRAY_INDEX].get_type() != Variant::NIL) {
+
+				Vector<Vector3> vertices = s.arrays[ARRAY_VERTEX];
+				Vector<int> indices = s.arrays[ARRAY_INDEX];
+
+				int last_index_count = indices.size();
+				float last_error = 0;
+
+				while (true) {
+
+					int target_index_count = (last_index_count / 6) * 3; //half the triangles
+					if (target_index_count < 12) {
+						break;
+					}
+
+					float error;
+					Vector<int> lod = MeshSimplifier::simplify(vertices, indices, target_index_count, 1e20, &error);
+
+					if (lod.size() == 0 || lod.size() > last_index_count * 0.9) {
+						break; //can't simplify further in a meaningful way
+					}
+
+					//errors are used as keys and switching distances, so keep them unique and increasing
+					error = MAX(error, last_error + CMP_EPSILON);
+
+					s.lods[error] = lod;
+					last_index_count = lod.size();
+					last_error = error;
+				}
+			}
+		}
+
+		lod_surfaces.push_back(s);
+	}
+
+	clear_surfaces();
+
+	for (int i = 0; i < lod_surfaces.size(); i++) {
+		const LODSurface &s = lod_surfaces[i];
+		add_surface_from_arrays(s.primitive, s.arrays, s.blend_shape_arrays, s.lods, s.format);
+		surface_set_material(i, s.material);
+		surface_set_name(i, s.name);
+	}
+
+	return OK;
+}
+
 void ArrayMesh::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("add_blend_shape", "name"), &ArrayMesh::add_blend_shape);
@@ -1574,6 +1658,8 @@ void ArrayMesh::_bind_methods() {
 	ClassDB::set_method_flags(get_class_static(), _scs_create("regen_normalmaps"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
 	ClassDB::bind_method(D_METHOD("lightmap_unwrap", "transform", "texel_size"), &ArrayMesh::lightmap_unwrap);
 	ClassDB::set_method_flags(get_class_static(), _scs_create("lightmap_unwrap"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
+	ClassDB::bind_method(D_METHOD("generate_lods"), &ArrayMesh::generate_lods);
+	ClassDB::set_method_flags(get_class_static(), _scs_create("generate_lods"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
 	ClassDB::bind_method(D_METHOD("get_faces"), &ArrayMesh::get_faces);
 	ClassDB::bind_method(D_METHOD("generate_triangle_mesh"), &ArrayMesh::generate_triangle_mesh);
 
@@ -46,6 +46,173 @@ bool SceneState::can_instance() const {
 	return nodes.size() > 0;
 }
 
+Vector<SceneState::InstancePlan> SceneState::_get_instance_plan() const {
+
+	MutexLock lock(instance_plan_mutex);
+
+	if (instance_plan_valid)
+		return instance_plan;
+
+	int nc = nodes.size();
+	Vector<InstancePlan> plan;
+	plan.resize(nc);
+
+	for (int i = 0; i < nc; i++) {
+
+		const NodeData &n = nodes[i];
+		InstancePlan &node_plan = plan.write[i];
+
+		node_plan.creation_func = NULL;
+
+		if ((i == 0 && base_scene_idx >= 0) || n.instance >= 0 || n.type == TYPE_INSTANCED || n.type < 0 || n.type >= names.size())
+			continue; // Not created from its class, or invalid and left for instance() to report.
+
+		StringName class_name;
+		ClassDB::CreationFunc creation_func = ClassDB::get_creation_func(names[n.type], &class_name);
+		if (!creation_func || !ClassDB::is_parent_class(class_name, "Node"))
+			continue;
+
+		node_plan.creation_func = creation_func;
+		node_plan.class_name = class_name;
+		node_plan.setters.resize(n.properties.size());
+
+		for (int j = 0; j < n.properties.size(); j++) {
+
+			InstancePlan::Setter &setter = node_plan.setters.write[j];
+			setter.psg = NULL;
+			setter.ptrcall_type = Variant::NIL;
+			setter.enum_argument = false;
+
+			int name = n.properties[j].name;
+			if (name >= 0 && name < names.size() && names[name] != CoreStringNames::get_singleton()->_script) {
+				setter.psg = ClassDB::get_property_setget(class_name, names[name]);
+			}
+
+#ifdef PTRCALL_ENABLED
+			// Plain single argument setters taking the type of the stored value can skip the Variant call.
+			int value = n.properties[j].value;
+			MethodBind *setptr = setter.psg && setter.psg->index < 0 ? setter.psg->_setptr : NULL;
+			if (setptr && value >= 0 && value < variants.size() && !setptr->is_vararg() && !setptr->has_return() && setptr->get_argument_count() == 1) {
+
+				Variant::Type type = variants[value].get_type();
+				switch (type) {
+					case Variant::BOOL:
+					case Variant::INT:
+					case Variant::FLOAT:
+					case Variant::STRING:
+					case Variant::VECTOR2:
+					case Variant::RECT2:
+					case Variant::VECTOR3:
+					case Variant::TRANSFORM2D:
+					case Variant::PLANE:
+					case Variant::QUAT:
+					case Variant::AABB:
+					case Variant::BASIS:
+					case Variant::TRANSFORM:
+					case Variant::COLOR:
+					case Variant::STRING_NAME:
+					case Variant::NODE_PATH: {
+						if (setptr->get_argument_type(0) == type) {
+							setter.ptrcall_type = type;
+							setter.enum_argument = setptr->is_argument_enum(0);
+						}
+					} break;
+					default: {
+					}
+				}
+			}
+#endif
+		}
+	}
+
+	instance_plan = plan;
+	instance_plan_valid = true;
+	return instance_plan;
+}
+
+void SceneState::_invalidate_instance_plan() {
+
+	MutexLock lock(instance_plan_mutex);
+	instance_plan_valid = false;
+	instance_plan.clear();
+}
+
+#ifdef PTRCALL_ENABLED
+template <class T>
+static _FORCE_INLINE_ void _ptrcall_setter(Node *p_node, MethodBind *p_setter, const T &p_value) {
+
+	const void *arg = &p_value;
+	p_setter->ptrcall(p_node, &arg, NULL);
+}
+#endif
+
+void SceneState::_call_setter(Node *p_node, const InstancePlan::Setter &p_setter, const Variant &p_value) {
+
+#ifdef PTRCALL_ENABLED
+	// Passed the way ptrcall() reads them, integers and reals widened except for enums.
+	MethodBind *setptr = p_setter.psg->_setptr;
+	switch (p_setter.ptrcall_type) {
+		case Variant::BOOL: {
+			_ptrcall_setter<bool>(p_node, setptr, p_value);
+		} break;
+		case Variant::INT: {
+			if (p_setter.enum_argument) {
+				_ptrcall_setter<int>(p_node, setptr, p_value);
+			} else {
+				_ptrcall_setter<int64_t>(p_node, setptr, p_value);
+			}
+		} break;
+		case Variant::FLOAT: {
+			_ptrcall_setter<double>(p_node, setptr, p_value);
+		} break;
+		case Variant::STRING: {
+			_ptrcall_setter<String>(p_node, setptr, p_value);
+		} break;
+		case Variant::VECTOR2: {
+			_ptrcall_setter<Vector2>(p_node, setptr, p_value);
+		} break;
+		case Variant::RECT2: {
+			_ptrcall_setter<Rect2>(p_node, setptr, p_value);
+		} break;
+		case Variant::VECTOR3: {
+			_ptrcall_setter<Vector3>(p_node, setptr, p_value);
+		} break;
+		case Variant::TRANSFORM2D: {
+			_ptrcall_setter<Transform2D>(p_node, setptr, p_value);
+		} break;
+		case Variant::PLANE: {
+			_ptrcall_setter<Plane>(p_node, setptr, p_value);
+		} break;
+		case Variant::QUAT: {
+			_ptrcall_setter<Quat>(p_node, setptr, p_value);
+		} break;
+		case Variant::AABB: {
+			_ptrcall_setter<AABB>(p_node, setptr, p_value);
+		} break;
+		case Variant::BASIS: {
+			_ptrcall_setter<Basis>(p_node, setptr, p_value);
+		} break;
+		case Variant::TRANSFORM: {
+			_ptrcall_setter<Transform>(p_node, setptr, p_value);
+		} break;
+		case Variant::COLOR: {
+			_ptrcall_setter<Color>(p_node, setptr, p_value);
+		} break;
+		case Variant::STRING_NAME: {
+			_ptrcall_setter<StringName>(p_node, setptr, p_value);
+		} break;
+		case Variant::NODE_PATH: {
+			_ptrcall_setter<NodePath>(p_node, setptr, p_value);
+		} break;
+		default: {
+			ClassDB::set_property_setget(p_node, p_setter.psg, p_value);
+		}
+	}
+#else
+	ClassDB::set_property_setget(p_node, p_setter.psg, p_value);
+#endif
+}
+
 Node *SceneState::instance(GenEditState p_edit_state) const {
 
 	// nodes where instancing failed (because something is missing)
@@ -84,6 +251,17 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 
 	Map<Ref<Resource>, Ref<Resource> > resources_local_to_scene;
 
+	// At runtime, create nodes and set their properties with what was resolved from ClassDB the first time.
+	// The editor goes through Object::set(), which also tracks edits.
+	Vector<InstancePlan> plan_ref;
+	const InstancePlan *plan = NULL;
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED) {
+		plan_ref = _get_instance_plan();
+		if (plan_ref.size() == nc) {
+			plan = plan_ref.ptr();
+		}
+	}
+
 	for (int i = 0; i < nc; i++) {
 
 		const NodeData &n = nd[i];
@@ -149,6 +327,10 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 				}
 #endif
 			}
+		} else if (plan && plan[i].creation_func) {
+			//node belongs to this scene, its class was already resolved
+			node = static_cast<Node *>(plan[i].creation_func());
+
 		} else if (ClassDB::is_class_enabled(snames[n.type])) {
 			//node belongs to this scene and must be created
 			Object *obj = ClassDB::instance(snames[n.type]);
@@ -189,6 +371,10 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 			if (nprop_count) {
 
 				const NodeData::Property *nprops = &n.properties[0];
+				const InstancePlan::Setter *setters = NULL;
+				if (plan && plan[i].creation_func && node->get_class_name() == plan[i].class_name) {
+					setters = plan[i].setters.ptr();
+				}
 
 				for (int j = 0; j < nprop_count; j++) {
 
@@ -250,7 +436,13 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 						} else if (p_edit_state == GEN_EDIT_STATE_INSTANCE) {
 							value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
 						}
-						node->set(snames[nprops[j].name], value, &valid);
+						if (setters && setters[j].ptrcall_type != Variant::NIL && setters[j].ptrcall_type == value.get_type() && !node->get_script_instance()) {
+							_call_setter(node, setters[j], value);
+						} else if (setters && setters[j].psg && !node->get_script_instance()) {
+							ClassDB::set_property_setget(node, setters[j].psg, value, &valid);
+						} else {
+							node->set(snames[nprops[j].name], value, &valid);
+						}
 					}
 				}
 			}
@@ -268,9 +460,8 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 				//if node was not part of instance, must set its name, parenthood and ownership
 				if (i > 0) {
 					if (parent) {
-						parent->_add_child_nocheck(node, snames[n.name]);
-						if (n.index >= 0 && n.index < parent->get_child_count() - 1)
-							parent->move_child(node, n.index);
+						//inserted at its index right away instead of moved there, NOTIFICATION_PARENTED and add_child_notify() are still sent for each child
+						parent->_add_child_nocheck(node, snames[n.name], n.index);
 					} else {
 						//it may be possible that an instanced scene has changed
 						//and the node has nowhere to go anymore
@@ -932,6 +1123,7 @@ void SceneState::clear() {
 	node_paths.clear();
 	editable_instances.clear();
 	base_scene_idx = -1;
+	_invalidate_instance_plan();
 }
 
 Ref<SceneState> SceneState::_get_base_scene_state() const {
@@ -1105,6 +1297,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 	const Vector<int> sconns = p_dictionary["conns"];
 	ERR_FAIL_COND(sconns.size() < conn_count);
 
+	_invalidate_instance_plan();
+
 	Vector<String> snames = p_dictionary["names"];
 	if (snames.size()) {
 
@@ -1565,6 +1759,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.index = p_index;
 
 	nodes.push_back(nd);
+	_invalidate_instance_plan();
 
 	return nodes.size() - 1;
 }
@@ -1578,6 +1773,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	prop.name = p_name;
 	prop.value = p_value;
 	nodes.write[p_node].properties.push_back(prop);
+	_invalidate_instance_plan();
 }
 void SceneState::add_node_group(int p_node, int p_group) {
 
@@ -1657,6 +1853,7 @@ SceneState::SceneState() {
 
 	base_scene_idx = -1;
 	last_modified_time = 0;
+	instance_plan_valid = false;
 }
 
 ////////////////
@@ -92,6 +92,30 @@ class SceneState : public Reference {
 
 	Vector<ConnectionData> connections;
 
+	// What instancing nodes at runtime needs from ClassDB, resolved once instead of by name for each node.
+	struct InstancePlan {
+
+		struct Setter {
+			const ClassDB::PropertySetGet *psg; // NULL to set the property by name.
+			Variant::Type ptrcall_type; // NIL unless the value can be passed to the bound setter with ptrcall().
+			bool enum_argument;
+		};
+
+		ClassDB::CreationFunc creation_func; // NULL for nodes not created from their class.
+		StringName class_name;
+		Vector<Setter> setters; // For each property.
+	};
+
+	// Never modified once built, changing the state drops it and the next instance builds a new one.
+	// Instancing holds a reference to the one it uses, so it stays valid meanwhile.
+	mutable Vector<InstancePlan> instance_plan;
+	mutable bool instance_plan_valid;
+	Mutex instance_plan_mutex;
+
+	Vector<InstancePlan> _get_instance_plan() const;
+	void _invalidate_instance_plan();
+	static void _call_setter(Node *p_node, const InstancePlan::Setter &p_setter, const Variant &p_value);
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -168,7 +168,11 @@ Error ResourceLoaderText::_parse_ext_resource(VariantParser::Stream *p_stream, R
 			r_res = ext_resources[id].cache;
 		} else if (use_sub_threads) {
 
-			RES res = ResourceLoader::load_threaded_get(path);
+			RES res;
+			if (ext_resources[id].pending) {
+				res = ResourceLoader::load_threaded_get(path);
+				ext_resources[id].pending = false;
+			}
 			if (res.is_null()) {
 
 				if (ResourceLoader::get_abort_on_missing_resources()) {
@@ -180,6 +184,10 @@ Error ResourceLoaderText::_parse_ext_resource(VariantParser::Stream *p_stream, R
 					ResourceLoader::notify_dependency_error(local_path, path, type);
 				}
 			} else {
+#ifdef TOOLS_ENABLED
+				//remember ID for saving
+				res->set_id_for_path(local_path, id);
+#endif
 				ext_resources[id].cache = res;
 				r_res = res;
 			}
@@ -455,9 +463,12 @@ Error ResourceLoaderText::load() {
 
 		if (use_sub_threads) {
 
+			// Keep parsing while the dependency loads, it is only waited for when referenced.
 			Error err = ResourceLoader::load_threaded_request(path, type, use_sub_threads, local_path);
 
-			if (err != OK) {
+			if (err == OK) {
+				er.pending = true;
+			} else {
 				if (ResourceLoader::get_abort_on_missing_resources()) {
 					error = ERR_FILE_CORRUPT;
 					error_text = "[ext_resource] referenced broken resource at: " + path;
@@ -738,6 +749,13 @@ ResourceLoaderText::ResourceLoaderText() {
 
 ResourceLoaderText::~ResourceLoaderText() {
 
+	// Dependencies nothing referenced (or left behind by an error) still hold a request.
+	for (Map<int, ExtResource>::Element *E = ext_resources.front(); E; E = E->next()) {
+		if (E->get().pending) {
+			ResourceLoader::load_threaded_get(E->get().path);
+		}
+	}
+
 	memdelete(f);
 }
 
@@ -799,7 +817,7 @@ Error ResourceLoaderText::rename_dependencies(FileAccess *p_f, const String &p_p
 
 	String base_path = local_path.get_base_dir();
 
-	uint64_t tag_end = f->get_position();
+	uint64_t tag_end = stream.get_position();
 
 	while (true) {
 
@@ -861,7 +879,7 @@ Error ResourceLoaderText::rename_dependencies(FileAccess *p_f, const String &p_p
 
 			fw->store_line("[ext_resource path=\"" + path + "\" type=\"" + type + "\" id=" + itos(index) + "]");
 
-			tag_end = f->get_position();
+			tag_end = stream.get_position();
 		}
 	}
 
@@ -994,7 +1012,7 @@ Error ResourceLoaderText::save_as_binary(FileAccess *p_f, const String &p_path)
 	wf->store_32(0); //64 bits file, false for now
 	wf->store_32(VERSION_MAJOR);
 	wf->store_32(VERSION_MINOR);
-	static const int save_format_version = 3; //use format version 3 for saving
+	static const int save_format_version = 4; //use format version 4 for saving
 	wf->store_32(save_format_version);
 
 	bs_save_unicode_string(wf.f, is_scene ? "PackedScene" : resource_type);
@@ -52,6 +52,7 @@ class ResourceLoaderText {
 		RES cache;
 		String path;
 		String type;
+		bool pending = false; // Requested on a sub-thread, not yet taken.
 	};
 
 	bool is_scene;
@@ -0,0 +1,236 @@
+/*************************************************************************/
+/*  scene_pool.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "scene_pool.h"
+
+#include "core/core_string_names.h"
+
+void ScenePool::_capture_node_state(Node *p_root, Node *p_node) {
+
+	NodeState state;
+	state.path = p_root->get_path_to(p_node);
+	state.class_name = p_node->get_class_name();
+
+	List<PropertyInfo> plist;
+	p_node->get_property_list(&plist);
+
+	for (List<PropertyInfo>::Element *E = plist.front(); E; E = E->next()) {
+
+		if (!(E->get().usage & PROPERTY_USAGE_STORAGE) || E->get().name == CoreStringNames::get_singleton()->_script)
+			continue;
+
+		Variant value = p_node->get(E->get().name);
+
+		if (value.get_type() == Variant::OBJECT) {
+			// Each instance has its own copy of resources local to scene, keep them.
+			Ref<Resource> res = value;
+			if (res.is_valid() && res->is_local_to_scene())
+				continue;
+		}
+
+		NodeState::Property prop;
+		prop.name = E->get().name;
+		prop.setter = ClassDB::get_property_setget(state.class_name, prop.name);
+		prop.shared = value.get_type() == Variant::ARRAY || value.get_type() == Variant::DICTIONARY;
+		// The instance keeps using its values, the snapshot must not change with them.
+		prop.value = prop.shared ? value.duplicate(true) : value;
+		state.properties.push_back(prop);
+	}
+
+	node_states.push_back(state);
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_capture_node_state(p_root, p_node->get_child(i));
+	}
+}
+
+bool ScenePool::_reset(Node *p_root) {
+
+	for (int i = 0; i < node_states.size(); i++) {
+
+		const NodeState &state = node_states[i];
+		Node *node = i == 0 ? p_root : p_root->get_node_or_null(state.path);
+		if (!node || node->get_class_name() != state.class_name)
+			return false; // Nodes were removed or replaced, can't be reused.
+
+		// Acquired again, it's a new spawn for its scripts too.
+		node->request_ready();
+
+		const NodeState::Property *props = state.properties.ptr();
+		for (int j = 0; j < state.properties.size(); j++) {
+
+			Variant copy;
+			const Variant *value = &props[j].value;
+			if (props[j].shared) {
+				copy = value->duplicate(true);
+				value = &copy;
+			}
+
+			if (props[j].setter && !node->get_script_instance()) {
+				ClassDB::set_property_setget(node, props[j].setter, *value);
+			} else {
+				node->set(props[j].name, *value);
+			}
+		}
+	}
+
+	return true;
+}
+
+Node *ScenePool::_instance() {
+
+	ERR_FAIL_COND_V_MSG(scene.is_null(), NULL, "No scene set to instance.");
+
+	Node *node = scene->instance();
+	ERR_FAIL_COND_V(!node, NULL);
+
+	if (node_states.empty()) {
+		_capture_node_state(node, node);
+	}
+
+	return node;
+}
+
+void ScenePool::set_scene(const Ref<PackedScene> &p_scene) {
+
+	if (scene == p_scene)
+		return;
+
+	clear();
+	node_states.clear();
+	scene = p_scene;
+}
+
+Ref<PackedScene> ScenePool::get_scene() const {
+
+	return scene;
+}
+
+void ScenePool::set_max_size(int p_max_size) {
+
+	ERR_FAIL_COND(p_max_size < 0);
+	max_size = p_max_size;
+
+	while (max_size > 0 && available.size() > max_size) {
+		Node *node = available[available.size() - 1];
+		available.resize(available.size() - 1);
+		pooled.erase(node);
+		memdelete(node);
+	}
+}
+
+int ScenePool::get_max_size() const {
+
+	return max_size;
+}
+
+void ScenePool::fill(int p_count) {
+
+	if (max_size > 0)
+		p_count = MIN(p_count, max_size);
+
+	while (available.size() < p_count) {
+		Node *node = _instance();
+		ERR_FAIL_COND(!node);
+		available.push_back(node);
+		pooled.insert(node);
+	}
+}
+
+Node *ScenePool::acquire() {
+
+	if (available.empty())
+		return _instance();
+
+	Node *node = available[available.size() - 1];
+	available.resize(available.size() - 1);
+	pooled.erase(node);
+	return node;
+}
+
+void ScenePool::release(Node *p_node) {
+
+	ERR_FAIL_NULL(p_node);
+	ERR_FAIL_COND_MSG(pooled.has(p_node), "Node '" + p_node->get_name() + "' was already released to this pool.");
+	ERR_FAIL_COND_MSG(scene.is_valid() && scene->get_path() != String() && p_node->get_filename() != scene->get_path(), "Node '" + p_node->get_name() + "' was not instanced from the scene of this pool.");
+
+	if (p_node->get_parent()) {
+		p_node->get_parent()->remove_child(p_node);
+	}
+
+	if ((max_size > 0 && available.size() >= max_size) || node_states.empty() || !_reset(p_node)) {
+		p_node->queue_delete();
+		return;
+	}
+
+	available.push_back(p_node);
+	pooled.insert(p_node);
+}
+
+int ScenePool::get_available_count() const {
+
+	return available.size();
+}
+
+void ScenePool::clear() {
+
+	for (int i = 0; i < available.size(); i++) {
+		memdelete(available[i]);
+	}
+	available.clear();
+	pooled.clear();
+}
+
+void ScenePool::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("set_scene", "scene"), &ScenePool::set_scene);
+	ClassDB::bind_method(D_METHOD("get_scene"), &ScenePool::get_scene);
+	ClassDB::bind_method(D_METHOD("set_max_size", "max_size"), &ScenePool::set_max_size);
+	ClassDB::bind_method(D_METHOD("get_max_size"), &ScenePool::get_max_size);
+
+	ClassDB::bind_method(D_METHOD("fill", "count"), &ScenePool::fill);
+	ClassDB::bind_method(D_METHOD("acquire"), &ScenePool::acquire);
+	ClassDB::bind_method(D_METHOD("release", "node"), &ScenePool::release);
+	ClassDB::bind_method(D_METHOD("get_available_count"), &ScenePool::get_available_count);
+	ClassDB::bind_method(D_METHOD("clear"), &ScenePool::clear);
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "scene", PROPERTY_HINT_RESOURCE_TYPE, "PackedScene"), "set_scene", "get_scene");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_size", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_max_size", "get_max_size");
+}
+
+ScenePool::ScenePool() {
+
+	max_size = 0;
+}
+
+ScenePool::~ScenePool() {
+
+	clear();
+}
@@ -0,0 +1,89 @@
+/*************************************************************************/
+/*  scene_pool.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SCENE_POOL_H
+#define SCENE_POOL_H
+
+#include "core/reference.h"
+#include "core/set.h"
+#include "scene/resources/packed_scene.h"
+
+class ScenePool : public Reference {
+
+	GDCLASS(ScenePool, Reference);
+
+	// The stored properties of each node of a fresh instance, what released instances are reset to.
+	struct NodeState {
+
+		struct Property {
+
+			StringName name;
+			const ClassDB::PropertySetGet *setter; // NULL to set it by name.
+			Variant value;
+			bool shared; // Arrays and dictionaries, each instance gets its own copy.
+		};
+
+		NodePath path;
+		StringName class_name;
+		Vector<Property> properties;
+	};
+
+	Ref<PackedScene> scene;
+	Vector<NodeState> node_states;
+	Vector<Node *> available;
+	Set<Node *> pooled; // The nodes in available, to catch double releases.
+	int max_size;
+
+	void _capture_node_state(Node *p_root, Node *p_node);
+	bool _reset(Node *p_root);
+	Node *_instance();
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_scene(const Ref<PackedScene> &p_scene);
+	Ref<PackedScene> get_scene() const;
+
+	void set_max_size(int p_max_size);
+	int get_max_size() const;
+
+	void fill(int p_count);
+	Node *acquire();
+	void release(Node *p_node);
+
+	int get_available_count() const;
+	void clear();
+
+	ScenePool();
+	~ScenePool();
+};
+
+#endif // SCENE_POOL_H
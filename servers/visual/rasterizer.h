@@ -153,6 +153,7 @@ public:
 		bool redraw_if_visible : 4;
 
 		float depth; //used for sorting
+		float lod_error_threshold; //largest mesh LOD error (in mesh space) that remains invisible, computed when culling
 
 		SelfList<InstanceBase> dependency_item;
 
@@ -219,6 +220,7 @@ public:
 			dynamic_gi = false;
 			redraw_if_visible = false;
 			lightmap_capture = NULL;
+			lod_error_threshold = 0;
 		}
 
 		virtual ~InstanceBase() {
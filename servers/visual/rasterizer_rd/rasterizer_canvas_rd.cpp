@@ -496,6 +496,142 @@ Size2i RasterizerCanvasRD::_bind_texture_binding(TextureBindingID p_binding, RD:
 	}
 }
 
+uint32_t RasterizerCanvasRD::_fill_rect_instance(const Item::CommandRect *p_rect, const Color &p_base_color, const Size2 &p_texpixel_size, const float *p_world, RectInstance &r_instance) {
+
+	uint32_t flags = 0;
+
+	Rect2 src_rect;
+	Rect2 dst_rect(p_rect->rect.position, p_rect->rect.size);
+
+	if (dst_rect.size.width < 0) {
+		dst_rect.position.x += dst_rect.size.width;
+		dst_rect.size.width *= -1;
+	}
+	if (dst_rect.size.height < 0) {
+		dst_rect.position.y += dst_rect.size.height;
+		dst_rect.size.height *= -1;
+	}
+
+	if (p_texpixel_size != Vector2()) {
+
+		src_rect = (p_rect->flags & CANVAS_RECT_REGION) ? Rect2(p_rect->source.position * p_texpixel_size, p_rect->source.size * p_texpixel_size) : Rect2(0, 0, 1, 1);
+
+		if (p_rect->flags & CANVAS_RECT_FLIP_H) {
+			src_rect.size.x *= -1;
+		}
+
+		if (p_rect->flags & CANVAS_RECT_FLIP_V) {
+			src_rect.size.y *= -1;
+		}
+
+		if (p_rect->flags & CANVAS_RECT_TRANSPOSE) {
+			dst_rect.size.x *= -1; // Encoding in the dst_rect.z uniform
+		}
+
+		if (p_rect->flags & CANVAS_RECT_CLIP_UV) {
+			flags |= FLAGS_CLIP_RECT_UV;
+		}
+
+	} else {
+		src_rect = Rect2(0, 0, 1, 1);
+	}
+
+	r_instance.modulation[0] = p_rect->modulate.r * p_base_color.r;
+	r_instance.modulation[1] = p_rect->modulate.g * p_base_color.g;
+	r_instance.modulation[2] = p_rect->modulate.b * p_base_color.b;
+	r_instance.modulation[3] = p_rect->modulate.a * p_base_color.a;
+
+	r_instance.src_rect[0] = src_rect.position.x;
+	r_instance.src_rect[1] = src_rect.position.y;
+	r_instance.src_rect[2] = src_rect.size.width;
+	r_instance.src_rect[3] = src_rect.size.height;
+
+	r_instance.dst_rect[0] = dst_rect.position.x;
+	r_instance.dst_rect[1] = dst_rect.position.y;
+	r_instance.dst_rect[2] = dst_rect.size.width;
+	r_instance.dst_rect[3] = dst_rect.size.height;
+
+	for (int i = 0; i < 6; i++) {
+		r_instance.world[i] = p_world[i];
+	}
+	r_instance.pad[0] = 0;
+	r_instance.pad[1] = 0;
+
+	return flags;
+}
+
+void RasterizerCanvasRD::_rect_batch_create_buffer() {
+
+	state.rect_batch_buffer = RD::get_singleton()->storage_buffer_create(sizeof(RectInstance) * state.max_batched_rects);
+
+	Vector<RD::Uniform> uniforms;
+
+	{
+		RD::Uniform u;
+		u.type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+		u.binding = 0;
+		u.ids.push_back(state.rect_batch_buffer);
+		uniforms.push_back(u);
+	}
+
+	state.rect_batch_uniform_set = RD::get_singleton()->uniform_set_create(uniforms, shader.default_version_rd_shader, 4);
+}
+
+void RasterizerCanvasRD::_rect_batch_reserve(RD::DrawListID p_draw_list, uint32_t p_count) {
+
+	if (state.rect_batch_count + p_count <= state.max_batched_rects) {
+		return;
+	}
+
+	// Out of space for this frame. Draws already recorded read the current buffer, so it is
+	// kept until the frame is over and the rest of the frame fills a bigger one from the start.
+	_rect_batch_flush(p_draw_list);
+	_rect_batch_upload();
+
+	state.rect_batch_buffers_to_free.push_back(state.rect_batch_buffer); //its uniform set goes with it
+
+	uint32_t new_max = state.max_batched_rects << 1;
+	while (p_count > new_max) {
+		new_max <<= 1;
+	}
+
+	memdelete_arr(state.rect_batch);
+	state.rect_batch = memnew_arr(RectInstance, new_max);
+	state.max_batched_rects = new_max;
+	state.rect_batch_count = 0;
+	state.rect_batch_uploaded = 0;
+
+	_rect_batch_create_buffer();
+	RD::get_singleton()->draw_list_bind_uniform_set(p_draw_list, state.rect_batch_uniform_set, 4);
+}
+
+void RasterizerCanvasRD::_rect_batch_flush(RD::DrawListID p_draw_list) {
+
+	if (rect_batch_draw.instance_count == 0) {
+		return;
+	}
+
+	RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &rect_batch_draw.push_constant, sizeof(PushConstant));
+	RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
+	RD::get_singleton()->draw_list_draw(p_draw_list, true, rect_batch_draw.instance_count);
+
+	rect_batch_draw.instance_count = 0;
+}
+
+void RasterizerCanvasRD::_rect_batch_upload() {
+
+	if (state.rect_batch_count == state.rect_batch_uploaded) {
+		return;
+	}
+
+	// Not synced with draw, so this takes effect before the frame's draw lists execute. Every
+	// rect drawn in the frame owns its own instance, so nothing is overwritten.
+	uint32_t from = state.rect_batch_uploaded;
+	uint32_t count = state.rect_batch_count - from;
+	RD::get_singleton()->buffer_update(state.rect_batch_buffer, from * sizeof(RectInstance), count * sizeof(RectInstance), &state.rect_batch[from]);
+	state.rect_batch_uploaded = state.rect_batch_count;
+}
+
 ////////////////////
 void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants) {
 
@@ -517,8 +653,8 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 	push_constant.color_texture_pixel_size[0] = 0;
 	push_constant.color_texture_pixel_size[1] = 0;
 
-	push_constant.pad[0] = 0;
-	push_constant.pad[1] = 0;
+	push_constant.rect_batch_offset = 0;
+	push_constant.pad = 0;
 
 	push_constant.lights[0] = 0;
 	push_constant.lights[1] = 0;
@@ -574,6 +710,11 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 		base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
 	}
 
+	if (light_count > 0) {
+		//lit items bind their own lights, so their rects can't share draws with other items
+		_rect_batch_flush(p_draw_list);
+	}
+
 	{
 
 		RID &canvas_item_state = light_count ? state_data->state_uniform_set_with_light : state_data->state_uniform_set;
@@ -701,104 +842,72 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 		push_constant.flags = base_flags; //reset on each command for sanity
 		push_constant.specular_shininess = 0xFFFFFFFF;
 
+		if (c->type != Item::Command::TYPE_RECT) {
+			//everything else binds its own state and draws right away
+			_rect_batch_flush(p_draw_list);
+		}
+
 		switch (c->type) {
 			case Item::Command::TYPE_RECT: {
 
 				const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(c);
 
-				//bind pipeline
-				{
-					RID pipeline = pipeline_variants->variants[light_mode][PIPELINE_VARIANT_QUAD].get_render_pipeline(RD::INVALID_ID, p_framebuffer_format);
-					RD::get_singleton()->draw_list_bind_render_pipeline(p_draw_list, pipeline);
+				//growing draws the rects already waiting, so make room before looking at the batch
+				_rect_batch_reserve(p_draw_list, 1);
+
+				RID pipeline = pipeline_variants->variants[light_mode][PIPELINE_VARIANT_QUAD].get_render_pipeline(RD::INVALID_ID, p_framebuffer_format);
+
+				if (rect_batch_draw.instance_count > 0 && (rect_batch_draw.pipeline != pipeline || rect_batch_draw.texture_binding != rect->texture_binding.binding_id)) {
+					_rect_batch_flush(p_draw_list);
 				}
 
-				//bind textures
+				if (rect_batch_draw.instance_count == 0) {
+					//bind pipeline and textures, they stay bound while the batch grows
 
-				Size2 texpixel_size;
-				{
-					texpixel_size = _bind_texture_binding(rect->texture_binding.binding_id, p_draw_list, push_constant.flags);
+					RD::get_singleton()->draw_list_bind_render_pipeline(p_draw_list, pipeline);
+
+					rect_batch_draw.pipeline = pipeline;
+					rect_batch_draw.texture_binding = rect->texture_binding.binding_id;
+					rect_batch_draw.binding_flags = 0;
+
+					Size2 texpixel_size = _bind_texture_binding(rect->texture_binding.binding_id, p_draw_list, rect_batch_draw.binding_flags);
 					texpixel_size.x = 1.0 / texpixel_size.x;
 					texpixel_size.y = 1.0 / texpixel_size.y;
+					rect_batch_draw.texpixel_size = texpixel_size;
 				}
 
+				push_constant.flags |= rect_batch_draw.binding_flags;
+
 				if (rect->specular_shininess.a < 0.999) {
 					push_constant.flags |= FLAGS_DEFAULT_SPECULAR_MAP_USED;
 				}
 
 				_update_specular_shininess(rect->specular_shininess, &push_constant.specular_shininess);
 
-				Rect2 src_rect;
-				Rect2 dst_rect;
-
-				if (texpixel_size != Vector2()) {
-					push_constant.color_texture_pixel_size[0] = texpixel_size.x;
-					push_constant.color_texture_pixel_size[1] = texpixel_size.y;
-
-					src_rect = (rect->flags & CANVAS_RECT_REGION) ? Rect2(rect->source.position * texpixel_size, rect->source.size * texpixel_size) : Rect2(0, 0, 1, 1);
-					dst_rect = Rect2(rect->rect.position, rect->rect.size);
-
-					if (dst_rect.size.width < 0) {
-						dst_rect.position.x += dst_rect.size.width;
-						dst_rect.size.width *= -1;
-					}
-					if (dst_rect.size.height < 0) {
-						dst_rect.position.y += dst_rect.size.height;
-						dst_rect.size.height *= -1;
-					}
-
-					if (rect->flags & CANVAS_RECT_FLIP_H) {
-						src_rect.size.x *= -1;
-					}
-
-					if (rect->flags & CANVAS_RECT_FLIP_V) {
-						src_rect.size.y *= -1;
-					}
+				push_constant.flags |= _fill_rect_instance(rect, base_color, rect_batch_draw.texpixel_size, push_constant.world, state.rect_batch[state.rect_batch_count]);
 
-					if (rect->flags & CANVAS_RECT_TRANSPOSE) {
-						dst_rect.size.x *= -1; // Encoding in the dst_rect.z uniform
-					}
+				if (rect_batch_draw.instance_count > 0 && (push_constant.flags != rect_batch_draw.push_constant.flags || push_constant.specular_shininess != rect_batch_draw.push_constant.specular_shininess)) {
+					//pipeline and textures are the same, so a new batch can start right away
+					_rect_batch_flush(p_draw_list);
+				}
 
-					if (rect->flags & CANVAS_RECT_CLIP_UV) {
-						push_constant.flags |= FLAGS_CLIP_RECT_UV;
+				if (rect_batch_draw.instance_count == 0) {
+					Size2 texpixel_size = rect_batch_draw.texpixel_size;
+					if (texpixel_size == Vector2()) {
+						texpixel_size = Vector2(1, 1);
 					}
 
-				} else {
-					dst_rect = Rect2(rect->rect.position, rect->rect.size);
-
-					if (dst_rect.size.width < 0) {
-						dst_rect.position.x += dst_rect.size.width;
-						dst_rect.size.width *= -1;
-					}
-					if (dst_rect.size.height < 0) {
-						dst_rect.position.y += dst_rect.size.height;
-						dst_rect.size.height *= -1;
-					}
+					push_constant.color_texture_pixel_size[0] = texpixel_size.x;
+					push_constant.color_texture_pixel_size[1] = texpixel_size.y;
+					push_constant.rect_batch_offset = state.rect_batch_count;
 
-					src_rect = Rect2(0, 0, 1, 1);
-					texpixel_size = Vector2(1, 1);
+					rect_batch_draw.push_constant = push_constant;
 				}
 
-				push_constant.modulation[0] = rect->modulate.r * base_color.r;
-				push_constant.modulation[1] = rect->modulate.g * base_color.g;
-				push_constant.modulation[2] = rect->modulate.b * base_color.b;
-				push_constant.modulation[3] = rect->modulate.a * base_color.a;
-
-				push_constant.src_rect[0] = src_rect.position.x;
-				push_constant.src_rect[1] = src_rect.position.y;
-				push_constant.src_rect[2] = src_rect.size.width;
-				push_constant.src_rect[3] = src_rect.size.height;
-
-				push_constant.dst_rect[0] = dst_rect.position.x;
-				push_constant.dst_rect[1] = dst_rect.position.y;
-				push_constant.dst_rect[2] = dst_rect.size.width;
-				push_constant.dst_rect[3] = dst_rect.size.height;
-
-				push_constant.color_texture_pixel_size[0] = texpixel_size.x;
-				push_constant.color_texture_pixel_size[1] = texpixel_size.y;
-
-				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
-				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
-				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				// Rects are drawn as instances of the batch, reading their data (transform included)
+				// from the frame's rect batch buffer.
+				state.rect_batch_count++;
+				rect_batch_draw.instance_count++;
 
 			} break;
 
@@ -1312,6 +1421,10 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 		c = c->next;
 	}
 
+	if (light_count > 0) {
+		_rect_batch_flush(p_draw_list);
+	}
+
 	if (current_clip && reclip) {
 		//will make it re-enable clipping if needed afterwards
 		current_clip = NULL;
@@ -1344,6 +1457,8 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 	if (p_screen_uniform_set.is_valid()) {
 		RD::get_singleton()->draw_list_bind_uniform_set(draw_list, p_screen_uniform_set, 3);
 	}
+	RD::get_singleton()->draw_list_bind_uniform_set(draw_list, state.rect_batch_uniform_set, 4);
+
 	RID prev_material;
 
 	PipelineVariants *pipeline_variants = &shader.pipeline_variants;
@@ -1354,6 +1469,8 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 
 		if (current_clip != ci->final_clip_owner) {
 
+			_rect_batch_flush(draw_list);
+
 			current_clip = ci->final_clip_owner;
 
 			//setup clip
@@ -1369,6 +1486,8 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 
 		if (ci->material != prev_material) {
 
+			_rect_batch_flush(draw_list);
+
 			MaterialData *material_data = NULL;
 			if (ci->material.is_valid()) {
 				material_data = (MaterialData *)storage->material_get_data(ci->material, RasterizerStorageRD::SHADER_TYPE_2D);
@@ -1394,6 +1513,9 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 		prev_material = ci->material;
 	}
 
+	_rect_batch_flush(draw_list);
+	_rect_batch_upload();
+
 	RD::get_singleton()->draw_list_end();
 }
 
@@ -2197,6 +2319,15 @@ void RasterizerCanvasRD::set_time(double p_time) {
 
 void RasterizerCanvasRD::update() {
 	_dispose_bindings();
+
+	//rect instances are only valid for the frame they were drawn in
+	state.rect_batch_count = 0;
+	state.rect_batch_uploaded = 0;
+
+	for (int i = 0; i < state.rect_batch_buffers_to_free.size(); i++) {
+		RD::get_singleton()->free(state.rect_batch_buffers_to_free[i]);
+	}
+	state.rect_batch_buffers_to_free.clear();
 }
 
 RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
@@ -2240,14 +2371,14 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 		state.light_uniforms = memnew_arr(LightUniform, state.max_lights_per_render);
 		Vector<String> variants;
 		//non light variants
-		variants.push_back(""); //none by default is first variant
+		variants.push_back("#define USE_RECT_BATCH\n"); //batched rects are the first variant
 		variants.push_back("#define USE_NINEPATCH\n"); //ninepatch is the second variant
 		variants.push_back("#define USE_PRIMITIVE\n"); //primitve is the third
 		variants.push_back("#define USE_PRIMITIVE\n#define USE_POINT_SIZE\n"); //points need point size
 		variants.push_back("#define USE_ATTRIBUTES\n"); // attributes for vertex arrays
 		variants.push_back("#define USE_ATTRIBUTES\n#define USE_POINT_SIZE\n"); //attributes with point size
 		//light variants
-		variants.push_back("#define USE_LIGHTING\n"); //none by default is first variant
+		variants.push_back("#define USE_LIGHTING\n#define USE_RECT_BATCH\n"); //batched rects are the first variant
 		variants.push_back("#define USE_LIGHTING\n#define USE_NINEPATCH\n"); //ninepatch is the second variant
 		variants.push_back("#define USE_LIGHTING\n#define USE_PRIMITIVE\n"); //primitve is the third
 		variants.push_back("#define USE_LIGHTING\n#define USE_PRIMITIVE\n#define USE_POINT_SIZE\n"); //points need point size
@@ -2424,6 +2555,14 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 			state.canvas_state_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(State::Buffer));
 			state.lights_uniform_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(LightUniform) * state.max_lights_per_render);
 
+			state.max_batched_rects = DEFAULT_MAX_BATCHED_RECTS;
+			state.rect_batch = memnew_arr(RectInstance, state.max_batched_rects);
+			state.rect_batch_count = 0;
+			state.rect_batch_uploaded = 0;
+			_rect_batch_create_buffer();
+
+			rect_batch_draw.instance_count = 0;
+
 			RD::SamplerState shadow_sampler_state;
 			shadow_sampler_state.mag_filter = RD::SAMPLER_FILTER_LINEAR;
 			shadow_sampler_state.min_filter = RD::SAMPLER_FILTER_LINEAR;
@@ -2511,6 +2650,11 @@ RasterizerCanvasRD::~RasterizerCanvasRD() {
 
 		memdelete_arr(state.light_uniforms);
 		RD::get_singleton()->free(state.lights_uniform_buffer);
+		memdelete_arr(state.rect_batch);
+		RD::get_singleton()->free(state.rect_batch_buffer);
+		for (int i = 0; i < state.rect_batch_buffers_to_free.size(); i++) {
+			RD::get_singleton()->free(state.rect_batch_buffers_to_free[i]);
+		}
 		RD::get_singleton()->free(shader.default_skeleton_uniform_buffer);
 		RD::get_singleton()->free(shader.default_skeleton_texture_buffer);
 	}
@@ -100,6 +100,7 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 
 	enum {
 		MAX_RENDER_ITEMS = 256 * 1024,
+		DEFAULT_MAX_BATCHED_RECTS = 16 * 1024,
 		MAX_LIGHT_TEXTURES = 1024,
 		DEFAULT_MAX_LIGHTS_PER_ITEM = 16,
 		DEFAULT_MAX_LIGHTS_PER_RENDER = 256
@@ -398,6 +399,14 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 		}
 	};
 
+	struct RectInstance {
+		float modulation[4];
+		float dst_rect[4];
+		float src_rect[4];
+		float world[6]; //rects of different items can share a draw
+		float pad[2];
+	};
+
 	struct State {
 
 		//state buffer
@@ -423,6 +432,15 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 		uint32_t max_lights_per_render;
 		uint32_t max_lights_per_item;
 
+		//rect instances for the whole frame, referenced by batched rect draws
+		RID rect_batch_buffer;
+		RID rect_batch_uniform_set;
+		Vector<RID> rect_batch_buffers_to_free; //replaced while drawing, still read by the frame
+		RectInstance *rect_batch;
+		uint32_t rect_batch_count;
+		uint32_t rect_batch_uploaded;
+		uint32_t max_batched_rects;
+
 		double time;
 	} state;
 
@@ -437,7 +455,8 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 				float ninepatch_margins[4];
 				float dst_rect[4];
 				float src_rect[4];
-				float pad[2];
+				uint32_t rect_batch_offset;
+				uint32_t pad;
 			};
 			//primitive
 			struct {
@@ -450,6 +469,16 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 		uint32_t lights[4];
 	};
 
+	//rects waiting to be drawn as a single instanced draw, they may come from several items
+	struct RectBatchDraw {
+		PushConstant push_constant;
+		RID pipeline;
+		TextureBindingID texture_binding;
+		uint32_t binding_flags;
+		Size2 texpixel_size;
+		uint32_t instance_count;
+	} rect_batch_draw;
+
 	struct SkeletonUniform {
 		float skeleton_transform[16];
 		float skeleton_inverse[16];
@@ -458,6 +487,11 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 	Item *items[MAX_RENDER_ITEMS];
 
 	Size2i _bind_texture_binding(TextureBindingID p_binding, RenderingDevice::DrawListID p_draw_list, uint32_t &flags);
+	void _rect_batch_create_buffer();
+	void _rect_batch_reserve(RenderingDevice::DrawListID p_draw_list, uint32_t p_count);
+	void _rect_batch_flush(RenderingDevice::DrawListID p_draw_list);
+	void _rect_batch_upload();
+	_FORCE_INLINE_ uint32_t _fill_rect_instance(const Item::CommandRect *p_rect, const Color &p_base_color, const Size2 &p_texpixel_size, const float *p_world, RectInstance &r_instance);
 	void _render_item(RenderingDevice::DrawListID p_draw_list, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants);
 	void _render_items(RID p_to_render_target, int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights, RID p_screen_uniform_set);
 
@@ -150,13 +150,10 @@ void RasterizerRD::initialize() {
 	}
 }
 
-ThreadWorkPool RasterizerRD::thread_work_pool;
 uint32_t RasterizerRD::frame = 1;
 
 void RasterizerRD::finalize() {
 
-	thread_work_pool.finish();
-
 	memdelete(scene);
 	memdelete(canvas);
 	memdelete(storage);
@@ -168,7 +165,6 @@ void RasterizerRD::finalize() {
 }
 
 RasterizerRD::RasterizerRD() {
-	thread_work_pool.init();
 	time = 0;
 
 	storage = memnew(RasterizerStorageRD);
@@ -662,7 +662,7 @@ public:
 		return mesh->surfaces[p_surface_index]->primitive;
 	}
 
-	_FORCE_INLINE_ void mesh_surface_get_arrays_and_format(RID p_mesh, uint32_t p_surface_index, uint32_t p_input_mask, RID &r_vertex_array_rd, RID &r_index_array_rd, RD::VertexFormatID &r_vertex_format) {
+	_FORCE_INLINE_ void mesh_surface_get_arrays_and_format(RID p_mesh, uint32_t p_surface_index, uint32_t p_input_mask, float p_lod_error_threshold, RID &r_vertex_array_rd, RID &r_index_array_rd, RD::VertexFormatID &r_vertex_format) {
 		Mesh *mesh = mesh_owner.getornull(p_mesh);
 		ERR_FAIL_COND(!mesh);
 		ERR_FAIL_UNSIGNED_INDEX(p_surface_index, mesh->surface_count);
@@ -671,6 +671,15 @@ public:
 
 		r_index_array_rd = s->index_array;
 
+		//use the simplest LOD whose error is still not noticeable
+		float lod_error = 0;
+		for (uint32_t i = 0; i < s->lod_count; i++) {
+			if (s->lods[i].edge_length <= p_lod_error_threshold && s->lods[i].edge_length > lod_error) {
+				lod_error = s->lods[i].edge_length;
+				r_index_array_rd = s->lods[i].index_array;
+			}
+		}
+
 		s->version_lock.lock();
 
 		//there will never be more than, at much, 3 or 4 versions, so iterating is the fastest way
@@ -27,6 +27,29 @@ layout(location = 3) out vec2 pixel_size_interp;
 
 #endif
 
+#ifdef USE_RECT_BATCH
+
+layout(location = 3) flat out vec4 src_rect_interp;
+
+/* SET4: Rect instances of the frame, each batched rect reads its own data */
+
+struct RectInstance {
+	vec4 modulation;
+	vec4 dst_rect;
+	vec4 src_rect;
+	vec2 world_x;
+	vec2 world_y;
+	vec2 world_ofs;
+	vec2 world_pad;
+};
+
+layout(set = 4, binding = 0, std430) restrict readonly buffer RectBatch {
+	RectInstance data[];
+}
+rect_batch;
+
+#endif
+
 #ifdef USE_MATERIAL_UNIFORMS
 layout(set = 1, binding = 1, std140) uniform MaterialUniforms{
 	/* clang-format off */
@@ -72,6 +95,20 @@ void main() {
 	vec2 uv = uv_attrib;
 
 	uvec4 bones = bones_attrib;
+#elif defined(USE_RECT_BATCH)
+
+	vec2 vertex_base_arr[4] = vec2[](vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0), vec2(1.0, 0.0));
+	vec2 vertex_base = vertex_base_arr[gl_VertexIndex];
+
+	RectInstance rect = rect_batch.data[draw_data.rect_batch_offset + gl_InstanceIndex];
+
+	vec2 uv = rect.src_rect.xy + abs(rect.src_rect.zw) * ((draw_data.flags & FLAGS_TRANSPOSE_RECT) != 0 ? vertex_base.yx : vertex_base.xy);
+	vec4 color = rect.modulation;
+	vec2 vertex = rect.dst_rect.xy + abs(rect.dst_rect.zw) * mix(vertex_base, vec2(1.0, 1.0) - vertex_base, lessThan(rect.src_rect.zw, vec2(0.0, 0.0)));
+	uvec4 bones = uvec4(0, 0, 0, 0);
+
+	src_rect_interp = rect.src_rect;
+
 #else
 
 	vec2 vertex_base_arr[4] = vec2[](vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0), vec2(1.0, 0.0));
@@ -84,7 +121,12 @@ void main() {
 
 #endif
 
+#ifdef USE_RECT_BATCH
+	//rects of different items can share a draw, so the transform comes with the instance
+	mat4 world_matrix = mat4(vec4(rect.world_x, 0.0, 0.0), vec4(rect.world_y, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), vec4(rect.world_ofs, 0.0, 1.0));
+#else
 	mat4 world_matrix = mat4(vec4(draw_data.world_x, 0.0, 0.0), vec4(draw_data.world_y, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), vec4(draw_data.world_ofs, 0.0, 1.0));
+#endif
 
 #if 0
 	if (draw_data.flags & FLAGS_INSTANCING_ENABLED) {
@@ -231,6 +273,12 @@ layout(location = 3) in vec2 pixel_size_interp;
 
 #endif
 
+#ifdef USE_RECT_BATCH
+
+layout(location = 3) flat in vec4 src_rect_interp;
+
+#endif
+
 layout(location = 0) out vec4 frag_color;
 
 #ifdef USE_MATERIAL_UNIFORMS
@@ -336,7 +384,11 @@ void main() {
 #endif
 	if (bool(draw_data.flags & FLAGS_CLIP_RECT_UV)) {
 
+#ifdef USE_RECT_BATCH
+		uv = clamp(uv, src_rect_interp.xy, src_rect_interp.xy + abs(src_rect_interp.zw));
+#else
 		uv = clamp(uv, draw_data.src_rect.xy, draw_data.src_rect.xy + abs(draw_data.src_rect.zw));
+#endif
 	}
 
 #endif
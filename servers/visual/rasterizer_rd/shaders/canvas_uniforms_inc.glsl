@@ -45,7 +45,8 @@ layout(push_constant, binding = 0, std430) uniform DrawData {
 	vec4 ninepatch_margins;
 	vec4 dst_rect; //for built-in rect and UV
 	vec4 src_rect;
-	vec2 pad;
+	uint rect_batch_offset;
+	uint pad;
 
 #endif
 	vec2 color_texture_pixel_size;
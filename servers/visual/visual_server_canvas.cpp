@@ -29,21 +29,295 @@
 /*************************************************************************/
 
 #include "visual_server_canvas.h"
+
+#include "core/project_settings.h"
 #include "visual_server_globals.h"
 #include "visual_server_raster.h"
 #include "visual_server_viewport.h"
 
 static const int z_range = VS::CANVAS_ITEM_Z_MAX - VS::CANVAS_ITEM_Z_MIN + 1;
 
-void VisualServerCanvas::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights) {
+bool VisualServerCanvas::ItemCullGrid::_is_bounded(const Item *p_item) {
+
+	// Anything that is visited by culling for reasons other than its own rect
+	// being on screen must always be visited.
+	return p_item->child_items.empty() && !p_item->copy_back_buffer && !p_item->vp_render && !p_item->update_when_visible;
+}
+
+void VisualServerCanvas::ItemCullGrid::_insert(Item *p_item) {
+
+	p_item->cull_unbounded = true;
+
+	if (_is_bounded(p_item)) {
+
+		Rect2 rect = p_item->xform.xform(p_item->get_rect());
+		Vector2 half_extent = rect.size * 0.5;
+
+		if (half_extent.x <= cell_size * 2.0 && half_extent.y <= cell_size * 2.0) {
+
+			Vector2 center = rect.position + half_extent;
+			uint64_t key = cell_key(Math::floor(center.x / cell_size), Math::floor(center.y / cell_size));
+
+			Vector<Item *> &cell = cells[key];
+
+			p_item->cull_unbounded = false;
+			p_item->cull_rect = rect;
+			p_item->cull_cell = key;
+			p_item->cull_cell_index = cell.size();
+			cell.push_back(p_item);
+
+			max_half_extent.x = MAX(max_half_extent.x, half_extent.x);
+			max_half_extent.y = MAX(max_half_extent.y, half_extent.y);
+			return;
+		}
+	}
+
+	p_item->cull_cell_index = unbounded.size();
+	unbounded.push_back(p_item);
+}
+
+void VisualServerCanvas::ItemCullGrid::_erase(Item *p_item) {
+
+	Vector<Item *> *list = p_item->cull_unbounded ? &unbounded : cells.getptr(p_item->cull_cell);
+	ERR_FAIL_COND(!list);
+
+	int last = list->size() - 1;
+	if (p_item->cull_cell_index != last) {
+		Item *moved = (*list)[last];
+		list->write[p_item->cull_cell_index] = moved;
+		moved->cull_cell_index = p_item->cull_cell_index;
+	}
+	list->resize(last);
+
+	if (last == 0 && !p_item->cull_unbounded) {
+		cells.erase(p_item->cull_cell);
+	}
+
+	p_item->cull_cell_index = -1;
+}
+
+void VisualServerCanvas::ItemCullGrid::_rebuild() {
+
+	Vector<Item *> items;
+	items.resize(item_count);
+	Item **items_ptr = items.ptrw();
+	int idx = 0;
+
+	const uint64_t *k = NULL;
+	while ((k = cells.next(k))) {
+		const Vector<Item *> &cell = cells[*k];
+		for (int i = 0; i < cell.size(); i++) {
+			items_ptr[idx++] = cell[i];
+		}
+	}
+	for (int i = 0; i < unbounded.size(); i++) {
+		items_ptr[idx++] = unbounded[i];
+	}
+	for (int i = 0; i < dirty_items.size(); i++) {
+		if (dirty_items[i]->cull_cell_index == -1) {
+			items_ptr[idx++] = dirty_items[i];
+		}
+	}
+	ERR_FAIL_COND(idx != item_count);
+
+	cells.clear();
+	unbounded.clear();
+	dirty_items.clear();
+	max_half_extent = Vector2();
+
+	// Size cells after the typical child, so most of them land in a single
+	// cell and a query touches few cells around the visible rect.
+	real_t extent_sum = 0;
+	int bounded_count = 0;
+	for (int i = 0; i < item_count; i++) {
+		if (_is_bounded(items_ptr[i])) {
+			Size2 size = items_ptr[i]->xform.xform(items_ptr[i]->get_rect()).size;
+			extent_sum += MAX(size.x, size.y);
+			bounded_count++;
+		}
+	}
+	cell_size = bounded_count ? MAX(extent_sum / bounded_count * 2.0, 8.0) : 64.0;
+
+	for (int i = 0; i < item_count; i++) {
+		items_ptr[i]->cull_dirty = false;
+		_insert(items_ptr[i]);
+	}
+}
+
+void VisualServerCanvas::ItemCullGrid::add(Item *p_item) {
+
+	p_item->cull_grid = this;
+	p_item->cull_cell_index = -1;
+	p_item->cull_dirty = true;
+	dirty_items.push_back(p_item);
+	item_count++;
+}
+
+void VisualServerCanvas::ItemCullGrid::remove(Item *p_item) {
+
+	ERR_FAIL_COND(p_item->cull_grid != this);
+
+	if (p_item->cull_cell_index != -1) {
+		_erase(p_item);
+	}
+	if (p_item->cull_dirty) {
+		dirty_items.erase(p_item);
+		p_item->cull_dirty = false;
+	}
+
+	p_item->cull_grid = NULL;
+	item_count--;
+}
+
+void VisualServerCanvas::ItemCullGrid::update() {
+
+	if (dirty_items.empty()) {
+		return;
+	}
+
+	if (cell_size == 0 || dirty_items.size() > item_count / 4) {
+		_rebuild();
+		return;
+	}
+
+	for (int i = 0; i < dirty_items.size(); i++) {
+		Item *item = dirty_items[i];
+		if (item->cull_cell_index != -1) {
+			_erase(item);
+		}
+		_insert(item);
+		item->cull_dirty = false;
+	}
+
+	dirty_items.clear();
+}
+
+void VisualServerCanvas::ItemCullGrid::query(const Rect2 &p_rect) {
+
+	update();
+
+	if (visible.size() < item_count) {
+		visible.resize(item_count);
+	}
+	Item **visible_ptr = visible.ptrw();
+	visible_count = 0;
+
+	for (int i = 0; i < unbounded.size(); i++) {
+		visible_ptr[visible_count++] = unbounded[i];
+	}
+
+	// Items are filed by their center, so look at every cell whose items could
+	// reach into the rect.
+	Rect2 search = p_rect.grow_individual(max_half_extent.x, max_half_extent.y, max_half_extent.x, max_half_extent.y);
+	const real_t limit = 1 << 30;
+	real_t from_x = CLAMP(Math::floor(search.position.x / cell_size), -limit, limit);
+	real_t from_y = CLAMP(Math::floor(search.position.y / cell_size), -limit, limit);
+	real_t to_x = CLAMP(Math::floor((search.position.x + search.size.x) / cell_size), -limit, limit);
+	real_t to_y = CLAMP(Math::floor((search.position.y + search.size.y) / cell_size), -limit, limit);
+
+	if ((to_x - from_x + 1) * (to_y - from_y + 1) > cells.size()) {
+
+		// Zoomed out, walking the occupied cells is cheaper.
+		const uint64_t *k = NULL;
+		while ((k = cells.next(k))) {
+			int x = int32_t(*k & 0xFFFFFFFF);
+			int y = int32_t(*k >> 32);
+			if (x < from_x || x > to_x || y < from_y || y > to_y) {
+				continue;
+			}
+			const Vector<Item *> &cell = cells[*k];
+			for (int i = 0; i < cell.size(); i++) {
+				if (cell[i]->cull_rect.intersects(p_rect, true)) {
+					visible_ptr[visible_count++] = cell[i];
+				}
+			}
+		}
+	} else {
+
+		for (int y = from_y; y <= to_y; y++) {
+			for (int x = from_x; x <= to_x; x++) {
+				const Vector<Item *> *cell = cells.getptr(cell_key(x, y));
+				if (!cell) {
+					continue;
+				}
+				for (int i = 0; i < cell->size(); i++) {
+					if ((*cell)[i]->cull_rect.intersects(p_rect, true)) {
+						visible_ptr[visible_count++] = (*cell)[i];
+					}
+				}
+			}
+		}
+	}
+
+	// Restore draw order.
+	SortArray<Item *, ItemCullOrderSort> sorter;
+	sorter.sort(visible_ptr, visible_count);
+}
+
+VisualServerCanvas::ItemCullGrid::~ItemCullGrid() {
+
+	// Children outlive their parent's grid, leave them unindexed.
+	const uint64_t *k = NULL;
+	while ((k = cells.next(k))) {
+		const Vector<Item *> &cell = cells[*k];
+		for (int i = 0; i < cell.size(); i++) {
+			cell[i]->cull_grid = NULL;
+			cell[i]->cull_cell_index = -1;
+		}
+	}
+	for (int i = 0; i < unbounded.size(); i++) {
+		unbounded[i]->cull_grid = NULL;
+		unbounded[i]->cull_cell_index = -1;
+	}
+	for (int i = 0; i < dirty_items.size(); i++) {
+		dirty_items[i]->cull_grid = NULL;
+		dirty_items[i]->cull_cell_index = -1;
+		dirty_items[i]->cull_dirty = false;
+	}
+}
+
+bool VisualServerCanvas::_update_child_cull_grid(ItemCullGrid *&r_grid, int p_child_count, bool p_allow) {
+
+	if (r_grid) {
+		// Some hysteresis, so a parent hovering around the threshold doesn't
+		// keep rebuilding its grid.
+		if (!p_allow || cull_grid_min_children <= 0 || p_child_count < cull_grid_min_children / 2) {
+			memdelete(r_grid);
+			r_grid = NULL;
+		}
+		return false;
+	}
+
+	if (!p_allow || cull_grid_min_children <= 0 || p_child_count < cull_grid_min_children) {
+		return false;
+	}
+
+	r_grid = memnew(ItemCullGrid);
+	return true;
+}
+
+void VisualServerCanvas::_detach_from_cull_grid(Item *p_item) {
+
+	if (p_item->cull_grid) {
+		p_item->cull_grid->remove(p_item);
+	}
+}
+
+void VisualServerCanvas::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, ItemCullGrid *p_cull_grid, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights) {
 
 	RENDER_TIMESTAMP("Cull CanvasItem Tree");
 
 	memset(z_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
 
-	for (int i = 0; i < p_child_item_count; i++) {
-		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, NULL, NULL);
+	if (p_cull_grid) {
+		for (int i = 0; i < p_cull_grid->visible_count; i++) {
+			_cull_canvas_item(p_cull_grid->visible[i], p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, NULL, NULL);
+		}
+	} else {
+		for (int i = 0; i < p_child_item_count; i++) {
+			_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, NULL, NULL);
+		}
 	}
 	if (p_canvas_item) {
 		_cull_canvas_item(p_canvas_item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, NULL, NULL);
@@ -103,10 +377,12 @@ void VisualServerCanvas::_cull_canvas_item(Item *p_canvas_item, const Transform2
 	if (!ci->visible)
 		return;
 
+	bool order_changed = false;
 	if (ci->children_order_dirty) {
 
 		ci->child_items.sort_custom<ItemIndexSort>();
 		ci->children_order_dirty = false;
+		order_changed = true;
 	}
 
 	Rect2 rect = ci->get_rect();
@@ -158,6 +434,28 @@ void VisualServerCanvas::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		sorter.sort(child_items, child_item_count);
 	}
 
+	if (_update_child_cull_grid(ci->child_cull_grid, ci->child_items.size(), !ci->sort_y)) {
+		for (int i = 0; i < child_item_count; i++) {
+			ci->child_cull_grid->add(child_items[i]);
+		}
+		order_changed = true;
+	}
+
+	if (ci->child_cull_grid) {
+		if (order_changed) {
+			for (int i = 0; i < child_item_count; i++) {
+				child_items[i]->cull_order = i;
+			}
+		}
+
+		if (xform.basis_determinant() != 0) {
+			// Only visit the children that may overlap the clip rect.
+			ci->child_cull_grid->query(xform.affine_inverse().xform(Rect2(Point2(), p_clip_rect.size)));
+			child_items = ci->child_cull_grid->visible.ptrw();
+			child_item_count = ci->child_cull_grid->visible_count;
+		}
+	}
+
 	if (ci->z_relative)
 		p_z = CLAMP(p_z + ci->z_index, VS::CANVAS_ITEM_Z_MIN, VS::CANVAS_ITEM_Z_MAX);
 	else
@@ -246,10 +544,12 @@ void VisualServerCanvas::render_canvas(RID p_render_target, Canvas *p_canvas, co
 
 	RENDER_TIMESTAMP(">Render Canvas");
 
+	bool order_changed = false;
 	if (p_canvas->children_order_dirty) {
 
 		p_canvas->child_items.sort();
 		p_canvas->children_order_dirty = false;
+		order_changed = true;
 	}
 
 	int l = p_canvas->child_items.size();
@@ -263,32 +563,50 @@ void VisualServerCanvas::render_canvas(RID p_render_target, Canvas *p_canvas, co
 		}
 	}
 
+	if (_update_child_cull_grid(p_canvas->child_cull_grid, l, !has_mirror)) {
+		for (int i = 0; i < l; i++) {
+			p_canvas->child_cull_grid->add(ci[i].item);
+		}
+		order_changed = true;
+	}
+
 	if (!has_mirror) {
 
-		_render_canvas_item_tree(p_render_target, ci, l, NULL, p_transform, p_clip_rect, p_canvas->modulate, p_lights);
+		ItemCullGrid *cull_grid = NULL;
+		if (p_canvas->child_cull_grid && order_changed) {
+			for (int i = 0; i < l; i++) {
+				ci[i].item->cull_order = i;
+			}
+		}
+		if (p_canvas->child_cull_grid && p_transform.basis_determinant() != 0) {
+			cull_grid = p_canvas->child_cull_grid;
+			cull_grid->query(p_transform.affine_inverse().xform(Rect2(Point2(), p_clip_rect.size)));
+		}
+
+		_render_canvas_item_tree(p_render_target, ci, l, cull_grid, NULL, p_transform, p_clip_rect, p_canvas->modulate, p_lights);
 
 	} else {
 		//used for parallaxlayer mirroring
 		for (int i = 0; i < l; i++) {
 
 			const Canvas::ChildItem &ci2 = p_canvas->child_items[i];
-			_render_canvas_item_tree(p_render_target, NULL, 0, ci2.item, p_transform, p_clip_rect, p_canvas->modulate, p_lights);
+			_render_canvas_item_tree(p_render_target, NULL, 0, NULL, ci2.item, p_transform, p_clip_rect, p_canvas->modulate, p_lights);
 
 			//mirroring (useful for scrolling backgrounds)
 			if (ci2.mirror.x != 0) {
 
 				Transform2D xform2 = p_transform * Transform2D(0, Vector2(ci2.mirror.x, 0));
-				_render_canvas_item_tree(p_render_target, NULL, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights);
+				_render_canvas_item_tree(p_render_target, NULL, 0, NULL, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights);
 			}
 			if (ci2.mirror.y != 0) {
 
 				Transform2D xform2 = p_transform * Transform2D(0, Vector2(0, ci2.mirror.y));
-				_render_canvas_item_tree(p_render_target, NULL, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights);
+				_render_canvas_item_tree(p_render_target, NULL, 0, NULL, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights);
 			}
 			if (ci2.mirror.y != 0 && ci2.mirror.x != 0) {
 
 				Transform2D xform2 = p_transform * Transform2D(0, ci2.mirror);
-				_render_canvas_item_tree(p_render_target, NULL, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights);
+				_render_canvas_item_tree(p_render_target, NULL, 0, NULL, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights);
 			}
 		}
 	}
@@ -351,14 +669,25 @@ void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 
 	if (canvas_item->parent.is_valid()) {
 
+		_detach_from_cull_grid(canvas_item);
+
 		if (canvas_owner.owns(canvas_item->parent)) {
 
 			Canvas *canvas = canvas_owner.getornull(canvas_item->parent);
 			canvas->erase_item(canvas_item);
+			if (canvas->child_cull_grid) {
+				canvas->children_order_dirty = true;
+			}
 		} else if (canvas_item_owner.owns(canvas_item->parent)) {
 
 			Item *item_owner = canvas_item_owner.getornull(canvas_item->parent);
 			item_owner->child_items.erase(canvas_item);
+			if (item_owner->child_cull_grid) {
+				item_owner->children_order_dirty = true;
+			}
+			if (item_owner->child_items.empty()) {
+				_mark_cull_dirty(item_owner);
+			}
 
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -376,11 +705,18 @@ void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 			ci.item = canvas_item;
 			canvas->child_items.push_back(ci);
 			canvas->children_order_dirty = true;
+			if (canvas->child_cull_grid) {
+				canvas->child_cull_grid->add(canvas_item);
+			}
 		} else if (canvas_item_owner.owns(p_parent)) {
 
 			Item *item_owner = canvas_item_owner.getornull(p_parent);
 			item_owner->child_items.push_back(canvas_item);
 			item_owner->children_order_dirty = true;
+			if (item_owner->child_cull_grid) {
+				item_owner->child_cull_grid->add(canvas_item);
+			}
+			_mark_cull_dirty(item_owner);
 
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -415,6 +751,7 @@ void VisualServerCanvas::canvas_item_set_transform(RID p_item, const Transform2D
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	canvas_item->xform = p_transform;
 }
@@ -436,6 +773,7 @@ void VisualServerCanvas::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
@@ -467,6 +805,7 @@ void VisualServerCanvas::canvas_item_set_update_when_visible(RID p_item, bool p_
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	canvas_item->update_when_visible = p_update;
 }
@@ -489,6 +828,7 @@ void VisualServerCanvas::canvas_item_add_line(RID p_item, const Point2 &p_from,
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandPrimitive *line = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!line);
@@ -516,6 +856,7 @@ void VisualServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Point
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandPolygon *pline = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!pline);
@@ -608,6 +949,7 @@ void VisualServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<Poin
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandPolygon *pline = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!pline);
@@ -628,6 +970,7 @@ void VisualServerCanvas::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -639,6 +982,7 @@ void VisualServerCanvas::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandPolygon *circle = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!circle);
@@ -677,6 +1021,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -711,6 +1056,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const R
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -756,6 +1102,7 @@ void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_r
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_COND(!style);
@@ -779,6 +1126,7 @@ void VisualServerCanvas::canvas_item_add_primitive(RID p_item, const Vector<Poin
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!prim);
@@ -807,6 +1155,7 @@ void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 #ifdef DEBUG_ENABLED
 	int pointcount = p_points.size();
 	ERR_FAIL_COND(pointcount < 3);
@@ -830,6 +1179,7 @@ void VisualServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	int vertex_count = p_points.size();
 	ERR_FAIL_COND(vertex_count == 0);
@@ -853,6 +1203,7 @@ void VisualServerCanvas::canvas_item_add_set_transform(RID p_item, const Transfo
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_COND(!tr);
@@ -863,6 +1214,7 @@ void VisualServerCanvas::canvas_item_add_mesh(RID p_item, const RID &p_mesh, con
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
 	ERR_FAIL_COND(!m);
@@ -876,6 +1228,7 @@ void VisualServerCanvas::canvas_item_add_particles(RID p_item, RID p_particles,
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_COND(!part);
@@ -891,6 +1244,7 @@ void VisualServerCanvas::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_COND(!mm);
@@ -903,6 +1257,7 @@ void VisualServerCanvas::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_COND(!ci);
@@ -946,6 +1301,7 @@ void VisualServerCanvas::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_e
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 	if (bool(canvas_item->copy_back_buffer != NULL) != p_enable) {
 		if (p_enable) {
 			canvas_item->copy_back_buffer = memnew(RasterizerCanvas::Item::CopyBackBuffer);
@@ -965,6 +1321,7 @@ void VisualServerCanvas::canvas_item_clear(RID p_item) {
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_mark_cull_dirty(canvas_item);
 
 	canvas_item->clear();
 }
@@ -1375,14 +1732,25 @@ bool VisualServerCanvas::free(RID p_rid) {
 
 		if (canvas_item->parent.is_valid()) {
 
+			_detach_from_cull_grid(canvas_item);
+
 			if (canvas_owner.owns(canvas_item->parent)) {
 
 				Canvas *canvas = canvas_owner.getornull(canvas_item->parent);
 				canvas->erase_item(canvas_item);
+				if (canvas->child_cull_grid) {
+					canvas->children_order_dirty = true;
+				}
 			} else if (canvas_item_owner.owns(canvas_item->parent)) {
 
 				Item *item_owner = canvas_item_owner.getornull(canvas_item->parent);
 				item_owner->child_items.erase(canvas_item);
+				if (item_owner->child_cull_grid) {
+					item_owner->children_order_dirty = true;
+				}
+				if (item_owner->child_items.empty()) {
+					_mark_cull_dirty(item_owner);
+				}
 
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -1470,6 +1838,7 @@ VisualServerCanvas::VisualServerCanvas() {
 	z_last_list = (RasterizerCanvas::Item **)memalloc(z_range * sizeof(RasterizerCanvas::Item *));
 
 	disable_scale = false;
+	cull_grid_min_children = GLOBAL_GET("rendering/quality/2d/cull_grid_min_children");
 }
 
 VisualServerCanvas::~VisualServerCanvas() {
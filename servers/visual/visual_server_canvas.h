@@ -31,11 +31,56 @@
 #ifndef VISUALSERVERCANVAS_H
 #define VISUALSERVERCANVAS_H
 
+#include "core/hash_map.h"
 #include "rasterizer.h"
 #include "visual_server_viewport.h"
 
 class VisualServerCanvas {
 public:
+	struct Item;
+
+	// Loose grid over the children of an item (or canvas) with many children,
+	// so culling only visits the ones near the visible rect. Each child is
+	// stored in the cell containing the center of its rect in parent space;
+	// queries grow by the largest half extent stored. Children whose bounds
+	// don't cover everything they draw (they have children of their own, copy
+	// the back buffer, etc.) are kept in an unbounded list and always visited.
+	struct ItemCullGrid {
+
+		real_t cell_size;
+		Vector2 max_half_extent;
+		int item_count;
+
+		HashMap<uint64_t, Vector<Item *> > cells;
+		Vector<Item *> unbounded;
+		Vector<Item *> dirty_items;
+
+		Vector<Item *> visible;
+		int visible_count;
+
+		_FORCE_INLINE_ uint64_t cell_key(int p_x, int p_y) const {
+			return uint64_t(uint32_t(p_x)) | (uint64_t(uint32_t(p_y)) << 32);
+		}
+
+		void add(Item *p_item);
+		void remove(Item *p_item);
+		void update();
+		void query(const Rect2 &p_rect);
+
+		ItemCullGrid() {
+			cell_size = 0;
+			item_count = 0;
+			visible_count = 0;
+		}
+		~ItemCullGrid();
+
+	private:
+		static bool _is_bounded(const Item *p_item);
+		void _insert(Item *p_item);
+		void _erase(Item *p_item);
+		void _rebuild();
+	};
+
 	struct Item : public RasterizerCanvas::Item {
 
 		RID parent; // canvas it belongs to
@@ -57,6 +102,15 @@ public:
 
 		Vector<Item *> child_items;
 
+		ItemCullGrid *child_cull_grid; // index over child_items, if large enough
+		ItemCullGrid *cull_grid; // grid of the parent this item is indexed in
+		Rect2 cull_rect;
+		uint64_t cull_cell;
+		int cull_cell_index;
+		int cull_order;
+		bool cull_unbounded;
+		bool cull_dirty;
+
 		Item() {
 			children_order_dirty = true;
 			E = NULL;
@@ -72,6 +126,18 @@ public:
 			ysort_pos = Vector2();
 			texture_filter = VS::CANVAS_ITEM_TEXTURE_FILTER_DEFAULT;
 			texture_repeat = VS::CANVAS_ITEM_TEXTURE_REPEAT_DEFAULT;
+			child_cull_grid = NULL;
+			cull_grid = NULL;
+			cull_cell = 0;
+			cull_cell_index = -1;
+			cull_order = 0;
+			cull_unbounded = false;
+			cull_dirty = false;
+		}
+		~Item() {
+			if (child_cull_grid) {
+				memdelete(child_cull_grid);
+			}
 		}
 	};
 
@@ -83,6 +149,14 @@ public:
 		}
 	};
 
+	struct ItemCullOrderSort {
+
+		_FORCE_INLINE_ bool operator()(const Item *p_left, const Item *p_right) const {
+
+			return p_left->cull_order < p_right->cull_order;
+		}
+	};
+
 	struct ItemPtrSort {
 
 		_FORCE_INLINE_ bool operator()(const Item *p_left, const Item *p_right) const {
@@ -133,6 +207,7 @@ public:
 		Color modulate;
 		RID parent;
 		float parent_scale;
+		ItemCullGrid *child_cull_grid;
 
 		int find_item(Item *p_item) {
 			for (int i = 0; i < child_items.size(); i++) {
@@ -151,6 +226,12 @@ public:
 			modulate = Color(1, 1, 1, 1);
 			children_order_dirty = true;
 			parent_scale = 1.0;
+			child_cull_grid = NULL;
+		}
+		~Canvas() {
+			if (child_cull_grid) {
+				memdelete(child_cull_grid);
+			}
 		}
 	};
 
@@ -159,12 +240,23 @@ public:
 	RID_PtrOwner<RasterizerCanvas::Light> canvas_light_owner;
 
 	bool disable_scale;
+	int cull_grid_min_children;
 
 private:
-	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
+	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, ItemCullGrid *p_cull_grid, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
 	void _light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights);
 
+	bool _update_child_cull_grid(ItemCullGrid *&r_grid, int p_child_count, bool p_allow);
+	void _detach_from_cull_grid(Item *p_item);
+
+	_FORCE_INLINE_ void _mark_cull_dirty(Item *p_item) {
+		if (p_item->cull_grid && !p_item->cull_dirty) {
+			p_item->cull_dirty = true;
+			p_item->cull_grid->dirty_items.push_back(p_item);
+		}
+	}
+
 	RasterizerCanvas::Item **z_list;
 	RasterizerCanvas::Item **z_last_list;
 
@@ -38,3 +38,5 @@ Rasterizer *VisualServerGlobals::rasterizer = NULL;
 VisualServerCanvas *VisualServerGlobals::canvas = NULL;
 VisualServerViewport *VisualServerGlobals::viewport = NULL;
 VisualServerScene *VisualServerGlobals::scene = NULL;
+
+ThreadWorkPool VisualServerGlobals::thread_work_pool;
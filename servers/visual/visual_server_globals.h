@@ -31,6 +31,7 @@
 #ifndef VISUAL_SERVER_GLOBALS_H
 #define VISUAL_SERVER_GLOBALS_H
 
+#include "core/thread_work_pool.h"
 #include "rasterizer.h"
 
 class VisualServerCanvas;
@@ -47,6 +48,9 @@ public:
 	static VisualServerCanvas *canvas;
 	static VisualServerViewport *viewport;
 	static VisualServerScene *scene;
+
+	// Shared by the server and the rasterizer for work split across cores (shader variants, dirty instances).
+	static ThreadWorkPool thread_work_pool;
 };
 
 #define VSG VisualServerGlobals
@@ -169,6 +169,8 @@ void VisualServerRaster::finish() {
 	}
 
 	VSG::rasterizer->finalize();
+
+	VSG::thread_work_pool.finish();
 }
 
 /* STATUS INFORMATION */
@@ -246,6 +248,8 @@ bool VisualServerRaster::is_low_end() const {
 }
 VisualServerRaster::VisualServerRaster() {
 
+	VSG::thread_work_pool.init();
+
 	VSG::canvas = memnew(VisualServerCanvas);
 	VSG::viewport = memnew(VisualServerViewport);
 	VSG::scene = memnew(VisualServerScene);
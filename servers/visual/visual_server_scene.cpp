@@ -31,6 +31,7 @@
 #include "visual_server_scene.h"
 
 #include "core/os/os.h"
+#include "core/project_settings.h"
 #include "visual_server_globals.h"
 #include "visual_server_raster.h"
 
@@ -925,6 +926,11 @@ void VisualServerScene::instance_geometry_set_as_instance_lod(RID p_instance, RI
 
 void VisualServerScene::_update_instance(Instance *p_instance) {
 
+	_update_instance_with_transformed_aabb(p_instance, p_instance->transform.xform(p_instance->aabb), p_instance->transform.basis.determinant() < 0.0);
+}
+
+void VisualServerScene::_update_instance_with_transformed_aabb(Instance *p_instance, const AABB &p_transformed_aabb, bool p_mirror) {
+
 	p_instance->version++;
 
 	if (p_instance->base_type == VS::INSTANCE_LIGHT) {
@@ -981,11 +987,9 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 		}
 	}
 
-	p_instance->mirror = p_instance->transform.basis.determinant() < 0.0;
+	p_instance->mirror = p_mirror;
 
-	AABB new_aabb;
-
-	new_aabb = p_instance->transform.xform(p_instance->aabb);
+	const AABB &new_aabb = p_transformed_aabb;
 
 	p_instance->transformed_aabb = new_aabb;
 
@@ -1334,7 +1338,32 @@ void VisualServerScene::_update_instance_lightmap_captures(Instance *p_instance)
 	}
 }
 
-bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
+void VisualServerScene::_update_instance_lod_error(Instance *p_instance, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, float p_screen_lod_threshold) {
+
+	if (p_instance->base_type != VS::INSTANCE_MESH && p_instance->base_type != VS::INSTANCE_MULTIMESH) {
+		return;
+	}
+
+	// Largest mesh space error that still projects below the screen space threshold, used to pick the mesh LOD.
+	Vector3 scale = p_instance->transform.basis.get_scale_abs();
+	float max_scale = MAX(scale.x, MAX(scale.y, scale.z));
+	float projection_scale = p_cam_projection.matrix[1][1] * max_scale;
+
+	if (p_screen_lod_threshold <= 0 || projection_scale <= 0) {
+		p_instance->lod_error_threshold = 0;
+	} else if (p_cam_orthogonal) {
+		p_instance->lod_error_threshold = p_screen_lod_threshold / projection_scale;
+	} else {
+		const AABB &aabb = p_instance->transformed_aabb;
+		Vector3 closest = p_cam_transform.origin;
+		closest.x = CLAMP(closest.x, aabb.position.x, aabb.position.x + aabb.size.x);
+		closest.y = CLAMP(closest.y, aabb.position.y, aabb.position.y + aabb.size.y);
+		closest.z = CLAMP(closest.z, aabb.position.z, aabb.position.z + aabb.size.z);
+		p_instance->lod_error_threshold = p_screen_lod_threshold * p_cam_transform.origin.distance_to(closest) / projection_scale;
+	}
+}
+
+bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, float p_screen_lod_threshold, RID p_shadow_atlas, Scenario *p_scenario) {
 
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
@@ -1599,6 +1628,10 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 					VSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, 0, distances[i + 1], i, bias_scale);
 				}
 
+				for (int j = 0; j < cull_count; j++) {
+					_update_instance_lod_error(instance_shadow_cull_result[j], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_screen_lod_threshold);
+				}
+
 				VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
 			}
 
@@ -1646,6 +1679,10 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 					}
 
 					VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i);
+					for (int j = 0; j < cull_count; j++) {
+						_update_instance_lod_error(instance_shadow_cull_result[j], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_screen_lod_threshold);
+					}
+
 					VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
 				}
 			} else { //shadow cube
@@ -1700,6 +1737,10 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 					}
 
 					VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i);
+					for (int j = 0; j < cull_count; j++) {
+						_update_instance_lod_error(instance_shadow_cull_result[j], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_screen_lod_threshold);
+					}
+
 					VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
 				}
 
@@ -1739,6 +1780,10 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			}
 
 			VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0);
+			for (int j = 0; j < cull_count; j++) {
+				_update_instance_lod_error(instance_shadow_cull_result[j], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_screen_lod_threshold);
+			}
+
 			VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
 
 		} break;
@@ -1793,7 +1838,7 @@ void VisualServerScene::render_camera(RID p_render_buffers, RID p_camera, RID p_
 		} break;
 	}
 
-	_prepare_scene(camera->transform, camera_matrix, ortho, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+	_prepare_scene(camera->transform, camera_matrix, ortho, camera->env, camera->effects, camera->visible_layers, _get_screen_lod_threshold(p_viewport_size.height), p_scenario, p_shadow_atlas, RID());
 	_render_scene(p_render_buffers, camera->transform, camera_matrix, ortho, camera->env, camera->effects, p_scenario, p_shadow_atlas, RID(), -1);
 #endif
 }
@@ -1872,17 +1917,25 @@ void VisualServerScene::render_camera(RID p_render_buffers, Ref<ARVRInterface> &
 		mono_transform *= apply_z_shift;
 
 		// now prepare our scene with our adjusted transform projection matrix
-		_prepare_scene(mono_transform, combined_matrix, false, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+		_prepare_scene(mono_transform, combined_matrix, false, camera->env, camera->effects, camera->visible_layers, _get_screen_lod_threshold(p_viewport_size.height), p_scenario, p_shadow_atlas, RID());
 	} else if (p_eye == ARVRInterface::EYE_MONO) {
 		// For mono render, prepare as per usual
-		_prepare_scene(cam_transform, camera_matrix, false, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+		_prepare_scene(cam_transform, camera_matrix, false, camera->env, camera->effects, camera->visible_layers, _get_screen_lod_threshold(p_viewport_size.height), p_scenario, p_shadow_atlas, RID());
 	}
 
 	// And render our scene...
 	_render_scene(p_render_buffers, cam_transform, camera_matrix, false, camera->env, camera->effects, p_scenario, p_shadow_atlas, RID(), -1);
 };
 
-void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, RID p_force_camera_effects, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows) {
+float VisualServerScene::_get_screen_lod_threshold(float p_view_height) const {
+
+	if (p_view_height <= 0) {
+		return 0;
+	}
+	return screen_lod_threshold_pixels / (p_view_height * 0.5);
+}
+
+void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, RID p_force_camera_effects, uint32_t p_visible_layers, float p_screen_lod_threshold, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows) {
 	// Note, in stereo rendering:
 	// - p_cam_transform will be a transform in the middle of our two eyes
 	// - p_cam_projection is a wider frustrum that encompasses both eyes
@@ -2058,6 +2111,8 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 			}
 
 			ins->depth = near_plane.distance_to(ins->transform.origin);
+
+			_update_instance_lod_error(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_screen_lod_threshold);
 			ins->depth_layer = CLAMP(int(ins->depth * 16 / z_far), 0, 15);
 		}
 
@@ -2112,7 +2167,7 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 
 			RENDER_TIMESTAMP(">Rendering Directional Light " + itos(i));
 
-			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_screen_lod_threshold, p_shadow_atlas, scenario);
 
 			RENDER_TIMESTAMP("<Rendering Directional Light " + itos(i));
 		}
@@ -2214,7 +2269,7 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 			if (redraw) {
 				//must redraw!
 				RENDER_TIMESTAMP(">Rendering Light " + itos(i));
-				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_screen_lod_threshold, p_shadow_atlas, scenario);
 				RENDER_TIMESTAMP("<Rendering Light " + itos(i));
 			}
 		}
@@ -2324,7 +2379,7 @@ bool VisualServerScene::_render_reflection_probe_step(Instance *p_instance, int
 		}
 
 		RENDER_TIMESTAMP("Render Reflection Probe, Step " + itos(p_step));
-		_prepare_scene(xform, cm, false, RID(), RID(), VSG::storage->reflection_probe_get_cull_mask(p_instance->base), p_instance->scenario->self, shadow_atlas, reflection_probe->instance, use_shadows);
+		_prepare_scene(xform, cm, false, RID(), RID(), VSG::storage->reflection_probe_get_cull_mask(p_instance->base), _get_screen_lod_threshold(GLOBAL_GET("rendering/quality/reflection_atlas/reflection_size")), p_instance->scenario->self, shadow_atlas, reflection_probe->instance, use_shadows);
 		_render_scene(RID(), xform, cm, false, RID(), RID(), p_instance->scenario->self, shadow_atlas, reflection_probe->instance, p_step);
 
 	} else {
@@ -2579,7 +2634,7 @@ void VisualServerScene::render_probes() {
 	}
 }
 
-void VisualServerScene::_update_dirty_instance(Instance *p_instance) {
+void VisualServerScene::_update_dirty_instance_base(Instance *p_instance) {
 
 	if (p_instance->update_aabb) {
 		_update_instance_aabb(p_instance);
@@ -2766,19 +2821,151 @@ void VisualServerScene::_update_dirty_instance(Instance *p_instance) {
 
 	_instance_update_list.remove(&p_instance->update_item);
 
-	_update_instance(p_instance);
-
 	p_instance->update_aabb = false;
 	p_instance->update_dependencies = false;
 }
 
+void VisualServerScene::_update_dirty_instance(Instance *p_instance) {
+
+	_update_dirty_instance_base(p_instance);
+	_update_instance(p_instance);
+}
+
+void VisualServerScene::DirtyInstanceBatch::reserve(uint32_t p_capacity) {
+
+	if (p_capacity <= capacity) {
+		return;
+	}
+
+	uint32_t old_capacity = capacity;
+	capacity = next_power_of_2(p_capacity);
+	instances.resize(capacity);
+	data.resize(capacity * DIRTY_FIELD_MAX);
+
+	real_t *w = data.ptrw();
+
+	// Fields already gathered move to their new offsets, starting from the last one so none is overwritten before it's moved.
+	for (int i = DIRTY_FIELD_MAX - 1; i > 0; i--) {
+		if (count > 0) {
+			memmove(w + i * capacity, w + i * old_capacity, count * sizeof(real_t));
+		}
+	}
+
+	for (int i = 0; i < DIRTY_FIELD_MAX; i++) {
+		fields[i] = w + i * capacity;
+	}
+}
+
+void VisualServerScene::_transform_dirty_instance_chunk(uint32_t p_chunk, void *p_userdata) {
+
+	DirtyInstanceBatch &batch = dirty_instance_batch;
+
+	uint32_t from = p_chunk * DIRTY_INSTANCE_CHUNK_SIZE;
+	uint32_t to = MIN(from + DIRTY_INSTANCE_CHUNK_SIZE, batch.count);
+
+	/* http://dev.theomader.com/transform-bounding-boxes/ */
+	// Every loop runs over a contiguous range of a single field, so the compiler can vectorize it.
+
+	for (int i = 0; i < 3; i++) {
+
+		real_t *world_min = batch.fields[DIRTY_FIELD_WORLD_MIN_X + i];
+		real_t *world_max = batch.fields[DIRTY_FIELD_WORLD_MAX_X + i];
+		const real_t *origin = batch.fields[DIRTY_FIELD_ORIGIN_X + i];
+
+		for (uint32_t k = from; k < to; k++) {
+			world_min[k] = origin[k];
+			world_max[k] = origin[k];
+		}
+
+		for (int j = 0; j < 3; j++) {
+
+			const real_t *basis = batch.fields[DIRTY_FIELD_BASIS_XX + i * 3 + j];
+			const real_t *local_min = batch.fields[DIRTY_FIELD_LOCAL_MIN_X + j];
+			const real_t *local_max = batch.fields[DIRTY_FIELD_LOCAL_MAX_X + j];
+
+			for (uint32_t k = from; k < to; k++) {
+				real_t e = basis[k] * local_min[k];
+				real_t f = basis[k] * local_max[k];
+				world_min[k] += MIN(e, f);
+				world_max[k] += MAX(e, f);
+			}
+		}
+	}
+
+	const real_t *xx = batch.fields[DIRTY_FIELD_BASIS_XX];
+	const real_t *xy = batch.fields[DIRTY_FIELD_BASIS_XY];
+	const real_t *xz = batch.fields[DIRTY_FIELD_BASIS_XZ];
+	const real_t *yx = batch.fields[DIRTY_FIELD_BASIS_YX];
+	const real_t *yy = batch.fields[DIRTY_FIELD_BASIS_YY];
+	const real_t *yz = batch.fields[DIRTY_FIELD_BASIS_YZ];
+	const real_t *zx = batch.fields[DIRTY_FIELD_BASIS_ZX];
+	const real_t *zy = batch.fields[DIRTY_FIELD_BASIS_ZY];
+	const real_t *zz = batch.fields[DIRTY_FIELD_BASIS_ZZ];
+	real_t *determinant = batch.fields[DIRTY_FIELD_DETERMINANT];
+
+	for (uint32_t k = from; k < to; k++) {
+		determinant[k] = xx[k] * (yy[k] * zz[k] - zy[k] * yz[k]) - yx[k] * (xy[k] * zz[k] - zy[k] * xz[k]) + zx[k] * (xy[k] * yz[k] - yy[k] * xz[k]);
+	}
+}
+
 void VisualServerScene::update_dirty_instances() {
 
+	// Refreshed once per frame rather than on every pass, so edits to the project setting still apply on the next frame.
+	screen_lod_threshold_pixels = GLOBAL_GET("rendering/quality/mesh_lod/threshold_pixels");
+
 	VSG::storage->update_dirty_resources();
 
+	DirtyInstanceBatch &batch = dirty_instance_batch;
+
+	// Updating instances may queue others (pairing), so keep flushing until the list is empty.
 	while (_instance_update_list.first()) {
 
-		_update_dirty_instance(_instance_update_list.first()->self());
+		// Gather dirty instances, resolving their base AABB and dependencies (this talks to storage, so it's serial).
+
+		batch.count = 0;
+
+		while (_instance_update_list.first()) {
+
+			Instance *instance = _instance_update_list.first()->self();
+			_update_dirty_instance_base(instance);
+
+			batch.reserve(batch.count + 1);
+			uint32_t k = batch.count++;
+			batch.instances.write[k] = instance;
+
+			const Basis &basis = instance->transform.basis;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					batch.fields[DIRTY_FIELD_BASIS_XX + i * 3 + j][k] = basis.elements[i][j];
+				}
+				batch.fields[DIRTY_FIELD_ORIGIN_X + i][k] = instance->transform.origin[i];
+				batch.fields[DIRTY_FIELD_LOCAL_MIN_X + i][k] = instance->aabb.position[i];
+				batch.fields[DIRTY_FIELD_LOCAL_MAX_X + i][k] = instance->aabb.position[i] + instance->aabb.size[i];
+			}
+		}
+
+		// Transform all AABBs at once.
+
+		uint32_t chunks = (batch.count + DIRTY_INSTANCE_CHUNK_SIZE - 1) / DIRTY_INSTANCE_CHUNK_SIZE;
+
+		if (chunks > 1) {
+			VSG::thread_work_pool.do_work(chunks, this, &VisualServerScene::_transform_dirty_instance_chunk, (void *)NULL);
+		} else if (chunks == 1) {
+			_transform_dirty_instance_chunk(0, NULL);
+		}
+
+		// Apply results (octree and pairing are not thread safe, so this is serial again).
+
+		for (uint32_t k = 0; k < batch.count; k++) {
+
+			AABB transformed_aabb;
+			for (int i = 0; i < 3; i++) {
+				transformed_aabb.position[i] = batch.fields[DIRTY_FIELD_WORLD_MIN_X + i][k];
+				transformed_aabb.size[i] = batch.fields[DIRTY_FIELD_WORLD_MAX_X + i][k] - transformed_aabb.position[i];
+			}
+
+			_update_instance_with_transformed_aabb(batch.instances[k], transformed_aabb, batch.fields[DIRTY_FIELD_DETERMINANT][k] < 0.0);
+		}
 	}
 }
 
@@ -2832,6 +3019,7 @@ VisualServerScene *VisualServerScene::singleton = NULL;
 VisualServerScene::VisualServerScene() {
 
 	render_pass = 1;
+	screen_lod_threshold_pixels = 1.0;
 	singleton = this;
 }
 
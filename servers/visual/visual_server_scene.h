@@ -54,6 +54,7 @@ public:
 	};
 
 	uint64_t render_pass;
+	float screen_lod_threshold_pixels;
 
 	static VisualServerScene *singleton;
 
@@ -230,6 +231,59 @@ public:
 	SelfList<Instance>::List _instance_update_list;
 	void _instance_queue_update(Instance *p_instance, bool p_update_aabb, bool p_update_dependencies = false);
 
+	/* DIRTY INSTANCE BATCH */
+
+	// Dirty instances are flushed in batches: transforms and local AABBs are copied
+	// into structure-of-arrays storage so world AABBs can be computed in tight,
+	// vectorizable loops (and across threads for large batches).
+
+	enum {
+		DIRTY_INSTANCE_CHUNK_SIZE = 512,
+	};
+
+	enum DirtyInstanceField {
+		DIRTY_FIELD_BASIS_XX,
+		DIRTY_FIELD_BASIS_XY,
+		DIRTY_FIELD_BASIS_XZ,
+		DIRTY_FIELD_BASIS_YX,
+		DIRTY_FIELD_BASIS_YY,
+		DIRTY_FIELD_BASIS_YZ,
+		DIRTY_FIELD_BASIS_ZX,
+		DIRTY_FIELD_BASIS_ZY,
+		DIRTY_FIELD_BASIS_ZZ,
+		DIRTY_FIELD_ORIGIN_X,
+		DIRTY_FIELD_ORIGIN_Y,
+		DIRTY_FIELD_ORIGIN_Z,
+		DIRTY_FIELD_LOCAL_MIN_X,
+		DIRTY_FIELD_LOCAL_MIN_Y,
+		DIRTY_FIELD_LOCAL_MIN_Z,
+		DIRTY_FIELD_LOCAL_MAX_X,
+		DIRTY_FIELD_LOCAL_MAX_Y,
+		DIRTY_FIELD_LOCAL_MAX_Z,
+		DIRTY_FIELD_WORLD_MIN_X,
+		DIRTY_FIELD_WORLD_MIN_Y,
+		DIRTY_FIELD_WORLD_MIN_Z,
+		DIRTY_FIELD_WORLD_MAX_X,
+		DIRTY_FIELD_WORLD_MAX_Y,
+		DIRTY_FIELD_WORLD_MAX_Z,
+		DIRTY_FIELD_DETERMINANT,
+		DIRTY_FIELD_MAX
+	};
+
+	struct DirtyInstanceBatch {
+		Vector<Instance *> instances;
+		Vector<real_t> data;
+		real_t *fields[DIRTY_FIELD_MAX];
+		uint32_t count = 0;
+		uint32_t capacity = 0;
+
+		void reserve(uint32_t p_capacity);
+	};
+
+	DirtyInstanceBatch dirty_instance_batch;
+
+	void _transform_dirty_instance_chunk(uint32_t p_chunk, void *p_userdata);
+
 	struct InstanceGeometryData : public InstanceBaseData {
 
 		List<Instance *> lighting;
@@ -414,14 +468,18 @@ public:
 	virtual void instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance);
 
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
+	_FORCE_INLINE_ void _update_instance_with_transformed_aabb(Instance *p_instance, const AABB &p_transformed_aabb, bool p_mirror);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
+	_FORCE_INLINE_ void _update_dirty_instance_base(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
-	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
+	_FORCE_INLINE_ void _update_instance_lod_error(Instance *p_instance, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, float p_screen_lod_threshold);
+	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, float p_screen_lod_threshold, RID p_shadow_atlas, Scenario *p_scenario);
+	float _get_screen_lod_threshold(float p_view_height) const;
 
 	bool _render_reflection_probe_step(Instance *p_instance, int p_step);
-	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, RID p_force_camera_effects, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows = true);
+	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, RID p_force_camera_effects, uint32_t p_visible_layers, float p_screen_lod_threshold, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows = true);
 	void _render_scene(RID p_render_buffers, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, RID p_force_camera_effects, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);
 	void render_empty_scene(RID p_render_buffers, RID p_scenario, RID p_shadow_atlas);
 